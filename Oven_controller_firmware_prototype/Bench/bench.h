@@ -0,0 +1,102 @@
+/**
+ * @file bench.h
+ * @brief Benchmark firmware: JTest groups timing the firmware's hot paths, with the results sent over USART2. See bench_port.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Built on the JTest framework vendored with CMSIS-DSP: groups, tests, pass/fail counts and its string dumps, which are routed to the UART instead of a debugger
+- Every case is timed BENCH_RUNS times, each call with interrupts disabled. The cost of an empty measurement is subtracted and the minimum, median and maximum are reported.
+- Core cycles from the DWT cycle counter on the target. The host build uses the same sources and reports nanoseconds of the monotonic clock, comparable between host runs only.
+- Machine-readable result lines among the JTest text (every other line can be ignored):
+
+BENCH_START,<platform>,<unit>,<runs>,<overhead>
+BENCH,<case>,<runs>,<min>,<median>,<max>,<unit>
+BENCH_END,<passed>,<failed>
+
+- Two result logs can be compared with bench_compare.cmake, e.g. a build configured with -DOVEN_CCMRAM=OFF against the default one (see ccmram.h) or the LCD's LL transport against the HAL one (see bench_lcd.c)
+
+# Limitations
+- Runs on the prototype board: the LCD cases send real transfers and need the display to acknowledge (the host build has it simulated)
+- Flash wait states make target numbers depend on code alignment, compare builds of the same configuration
+
+# Requirements:
+- USART2 at 115200 baud, read until the BENCH_END line
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "jtest_fw.h"
+#include "jtest_test_define.h"
+#include "jtest_test_call.h"
+#include "jtest_group_define.h"
+#include "jtest_group_call.h"
+#include "stdbool.h"
+#include "stdint.h"
+
+#define BENCH_RUNS      32      // timed calls per case
+
+#ifdef OVEN_HOST_BUILD
+#define BENCH_PLATFORM  "host"
+#define BENCH_UNIT      "ns"
+uint32_t benchCounter(void);
+#else
+#define BENCH_PLATFORM  "stm32f303"
+#define BENCH_UNIT      "cycles"
+#define benchCounter()  (DWT->CYCCNT)
+#endif
+
+/**
+ * Times `call` BENCH_RUNS times and reports the case as `name`. `setup` runs before each call, untimed.
+ */
+#define BENCH_MEASURE(name, setup, call)                            \
+    do {                                                            \
+        uint32_t benchSamples_[BENCH_RUNS];                         \
+        for (uint32_t benchRun = 0; benchRun < BENCH_RUNS; benchRun++) { \
+            setup;                                                  \
+            uint32_t benchPrimask_ = __get_PRIMASK();               \
+            __disable_irq();                                        \
+            uint32_t benchStart_ = benchCounter();                  \
+            call;                                                   \
+            uint32_t benchEnd_ = benchCounter();                    \
+            __set_PRIMASK(benchPrimask_);                           \
+            benchSamples_[benchRun] = benchEnd_ - benchStart_;      \
+        }                                                           \
+        benchReport(name, benchSamples_);                           \
+    } while (0)
+
+/* Groups */
+
+JTEST_DECLARE_GROUP(lcdBenchGroup);
+JTEST_DECLARE_GROUP(controlBenchGroup);
+JTEST_DECLARE_GROUP(temperatureBenchGroup);
+
+/* API functions */
+
+/**
+ * @brief Starts the cycle counter, initialises JTest and measures the overhead of an empty measurement
+ */
+void benchInit(void);
+
+/**
+ * @brief Subtracts the measurement overhead and sends the case's result line
+ * @param name case name
+ * @param samples BENCH_RUNS raw measurements (sorted in place)
+ */
+void benchReport(const char* name, uint32_t* samples);
+
+/**
+ * @brief Sends the final line with JTest's pass/fail counts
+ */
+void benchFinish(void);
+
+/**
+ * @brief Waits until the I2C handle is ready for the next transfer
+ * @param hi2c pointer to HAL's I2C handle struct
+ * @return false on a 10 ms timeout
+ */
+bool benchWaitI2C(I2C_HandleTypeDef* hi2c);
+
+#endif
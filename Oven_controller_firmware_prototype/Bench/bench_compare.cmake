@@ -0,0 +1,45 @@
+#
+# Compares the medians of two benchmark logs (the UART output of oven_bench, see bench.h), e.g. of a build configured
+# with -DOVEN_CCMRAM=OFF against the default one:
+#   cmake -DBEFORE=flash.log -DAFTER=ccmram.log -P Bench/bench_compare.cmake
+#
+# When both logs have lcd.txbyte and lcd.isr (target builds with an I2C transport), their sum is added as lcd.char, the
+# CPU cost of one LCD character. For the HAL against the LL transport, flash oven_bench from two builds configured with
+# -DLCD_TRANSPORT=HAL and -DLCD_TRANSPORT=LL, log each board run and compare the logs.
+#
+
+foreach(log BEFORE AFTER)
+    if(NOT DEFINED ${log})
+        message(FATAL_ERROR "usage: cmake -DBEFORE=<log> -DAFTER=<log> -P bench_compare.cmake")
+    endif()
+    file(STRINGS ${${log}} lines REGEX "^BENCH,")
+    set(${log}_CASES "")
+    foreach(line IN LISTS lines)
+        # BENCH,<case>,<runs>,<min>,<median>,<max>,<unit>
+        string(REPLACE "," ";" fields "${line}")
+        list(GET fields 1 case)
+        list(GET fields 4 median)
+        list(GET fields 6 unit)
+        list(APPEND ${log}_CASES ${case})
+        set(${log}_${case} ${median})
+    endforeach()
+    if(DEFINED ${log}_lcd.txbyte AND DEFINED ${log}_lcd.isr)
+        math(EXPR ${log}_lcd.char "${${log}_lcd.txbyte} + ${${log}_lcd.isr}")
+        list(APPEND ${log}_CASES lcd.char)
+    endif()
+endforeach()
+
+set(report "case\tbefore [${unit}]\tafter [${unit}]\tchange\n")
+foreach(case IN LISTS BEFORE_CASES)
+    if(NOT DEFINED AFTER_${case})
+        string(APPEND report "${case}\t${BEFORE_${case}}\t-\n")
+        continue()
+    endif()
+    set(change "")
+    if(BEFORE_${case} GREATER 0)
+        math(EXPR change "(${AFTER_${case}} - ${BEFORE_${case}}) * 100 / ${BEFORE_${case}}")
+        set(change "${change} %")
+    endif()
+    string(APPEND report "${case}\t${BEFORE_${case}}\t${AFTER_${case}}\t${change}\n")
+endforeach()
+message("${report}")
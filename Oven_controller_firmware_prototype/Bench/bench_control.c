@@ -0,0 +1,99 @@
+/**
+ * @file bench_control.c
+ * @brief Control benchmarks: PID step with the derivative filter, Kalman filter step, MPC step, Smith predictor step, power split and the complete oven control tick.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The measurements change between the runs, so the controllers don't settle into a saturated output where some branches are skipped.
+ */
+
+#include "bench.h"
+#include "mpc_controller.h"
+#include "oven_control.h"
+#include "pid_controller.h"
+#include "power_splitter.h"
+#include "smith_predictor.h"
+#include "state_estimator.h"
+#include "ccmram.h"
+
+static StateEstimator_t est;    // too large for the stack
+static MPCController_t mpc;
+static SmithPredictor_t smith;    // the delay line is 128 samples
+static OvenControl_t oven CCMRAM_BSS;   // where the firmware keeps it
+
+JTEST_DEFINE_TEST(pidStepBench, pidStep) {
+    PIDController_t pid;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, ovenControlDefaultConfig.derivativeFilter);
+    float out = 0.0f;
+    uint32_t failures = 0;
+    BENCH_MEASURE("pid.step", (void)0, out = pidStep(&pid, 250.0f, 240.0f + (float)(benchRun & 7)));
+    failures += (out < 0.0f || out > 1.0f);
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_TEST(estStepBench, estStep) {
+    estInit(&est, &estDefaultModel, 0.1f, 25.0f);
+    const float duty[EST_NU] = { 0.6f, 0.4f };
+    float meas[EST_NY];
+    uint32_t failures = 0;
+    BENCH_MEASURE("est.step",
+        (meas[0] = 25.0f + 0.5f * (float)benchRun, meas[1] = 25.0f + 0.3f * (float)benchRun),
+        failures += (estStep(&est, duty, meas) != EST_OK));
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+// The model Host/MpcCompare identifies on the thermal plant, at the PID's 1 s tick. The setpoint jumps every run, so each solve starts away from its warm start.
+JTEST_DEFINE_TEST(mpcStepBench, mpcStep) {
+    const MPCModel_t model = { .gain = 1100.0f, .elementTau = 20.0f, .chamberTau = 3160.0f, .directShare = 0.09f };
+    const MPCConfig_t cfg = { .dt = 1.0f, .maxDuty = 1.0f, .maxRate = 1.0f, .moveWeight = 1000.0f };
+    uint32_t failures = (mpcInit(&mpc, &model, &cfg, 25.0f) != MPC_OK);
+    float out = 0.0f;
+    BENCH_MEASURE("mpc.step", (void)0, out = mpcStep(&mpc, (benchRun & 1) ? 450.0f : 250.0f, 240.0f + (float)(benchRun & 7)));
+    failures += (out < 0.0f || out > 1.0f);
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+// The model Host/DeadTime identifies on the thermal plant, with 60 s of measurement dead time. On top of pid.step it's the model update and the delay line.
+JTEST_DEFINE_TEST(smithStepBench, smithStep) {
+    PIDController_t pid;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, ovenControlDefaultConfig.derivativeFilter);
+    const SmithModel_t model = { .gain = 276.0f, .tau = 338.0f, .deadTime = 60.0f };
+    uint32_t failures = (smithInit(&smith, &pid, model) != SMITH_OK);
+    float out = 0.0f;
+    BENCH_MEASURE("smith.step", (void)0, out = smithStep(&smith, 250.0f, 240.0f + (float)(benchRun & 7)));
+    failures += (out < 0.0f || out > 1.0f);
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+// The prototype's heaters at the pizza soak's ratio, the demand sweeps the table including the bottom heater's saturation point
+JTEST_DEFINE_TEST(psplitApplyBench, psplitApply) {
+    PowerSplitter_t split;
+    psplitInit(&split, ovenControlDefaultConfig.topPower, ovenControlDefaultConfig.bottomPower, 0.3f);
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    uint32_t failures = 0;
+    BENCH_MEASURE("psplit.apply", (void)0, psplitApply(&split, (uint16_t)(benchRun * 1021u), duty));
+    failures += (duty[HEATER_TOP] > HEATER_OUT_DUTY_ONE || duty[HEATER_BOTTOM] > HEATER_OUT_DUTY_ONE);
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_TEST(ovenStepBench, ovenControlStep) {
+    ovenControlInit(&oven, &ovenControlDefaultConfig);
+    ovenControlStep(&oven, 25.0f);
+    ovenControlCommand(&oven, OVEN_CMD_PIZZA);
+    ProfilePhase_t phase = PROFILE_IDLE;
+    uint32_t failures = 0;
+    BENCH_MEASURE("oven.step", (void)0, phase = ovenControlStep(&oven, 25.0f + 2.0f * (float)benchRun));
+    failures += (phase == PROFILE_IDLE || phase == PROFILE_DONE);
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_GROUP(controlBenchGroup) {
+    JTEST_TEST_CALL(pidStepBench);
+    JTEST_TEST_CALL(estStepBench);
+    JTEST_TEST_CALL(mpcStepBench);
+    JTEST_TEST_CALL(smithStepBench);
+    JTEST_TEST_CALL(psplitApplyBench);
+    JTEST_TEST_CALL(ovenStepBench);
+}
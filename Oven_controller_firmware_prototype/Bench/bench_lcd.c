@@ -0,0 +1,139 @@
+/**
+ * @file bench_lcd.c
+ * @brief LCD driver benchmarks: enqueueing, flushing an entry, the nibble expansion with the transfer start in txByte and the interrupt path from the end of one character to the start of the next.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The queue is paused for the whole group, so nothing requests the bus and each case only times its own path. flush and txByte are called directly, between the cases the setup waits for the previous transfer to finish.
+ *
+ * lcd.isr (target only) resumes the queue with two characters and keeps the I2C event and DMA interrupts masked in the NVIC until the first one is on the wire. The call then runs the handlers the hardware would, which complete the character through the arbiter and start the next one. With lcd.txbyte it makes up the CPU cost of a character, compare builds with LCD_TRANSPORT=HAL and LL (bench_compare.cmake). The GPIO transport has no per-character interrupt, the case is left out there.
+ */
+
+#include "bench.h"
+#include "i2c.h"
+#include "lcd_hd44780_pcf8574_driver.h"
+#include "lcd_transport.h"
+#ifndef OVEN_HOST_BUILD
+#include "stm32f3xx_it.h"
+#endif
+
+// driver internals (not static, but not in the public header)
+LCDStatus_t txByte(uint8_t rs, uint8_t data);
+LCDStatus_t flush(void);
+LCDStatus_t deq(void);
+
+#define RS_DATA_REG     (uint8_t)0x01
+#define RS_INSTR_REG    (uint8_t)0
+#define NOP             (uint8_t)0      // dummy entry, same byte repeated without EN pulses
+
+static void drainQueue(void) {
+    while (deq() == LCD_OK) {
+    }
+}
+
+// the LL transport leaves HAL's handle ready, its own busy flag tells when the transfer is done
+static bool waitLcd(void) {
+    uint32_t tickStart = HAL_GetTick();
+    while (lcdTransportIsBusy()) {
+        if (HAL_GetTick() - tickStart > 10)
+            return false;
+    }
+    return benchWaitI2C(&hi2c1);
+}
+
+JTEST_DEFINE_TEST(lcdEnqueueBench, lcdPrintChar) {
+    uint32_t failures = 0;
+    BENCH_MEASURE("lcd.enqueue", drainQueue(), failures += (lcdPrintChar('A') != LCD_OK));
+    drainQueue();
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_TEST(lcdFlushBench, flush) {
+    uint32_t failures = 0;
+    BENCH_MEASURE("lcd.flush",
+        (drainQueue(), lcdPrintChar('A'), failures += !waitLcd()),
+        failures += (flush() != LCD_OK));
+    failures += !waitLcd();
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_TEST(lcdTxByteBench, txByte) {
+    uint32_t failures = 0;
+    BENCH_MEASURE("lcd.txbyte", failures += !waitLcd(), failures += (txByte(RS_DATA_REG, 'A') != LCD_OK));
+    BENCH_MEASURE("lcd.txbyte_nop", failures += !waitLcd(), failures += (txByte(RS_INSTR_REG, NOP) != LCD_OK));
+    failures += !waitLcd();
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+#if !defined(OVEN_HOST_BUILD) && !defined(LCD_TRANSPORT_GPIO)
+// what the I2C1 event and DMA1 channel 6 interrupts of one character do, the LL transport doesn't use the DMA interrupt
+static void isrPath(void) {
+#ifndef LCD_TRANSPORT_LL
+    DMA1_Channel6_IRQHandler();
+#endif
+    I2C1_EV_IRQHandler();
+}
+
+static void maskLcdIRQs(bool mask) {
+    if (mask) {
+        HAL_NVIC_DisableIRQ(I2C1_EV_IRQn);
+        HAL_NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+    } else {
+        HAL_NVIC_ClearPendingIRQ(I2C1_EV_IRQn);
+        HAL_NVIC_ClearPendingIRQ(DMA1_Channel6_IRQn);
+        HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+        HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+    }
+}
+
+// waits with the interrupts masked until the transfer on the wire has ended (STOP sent)
+static bool waitStop(void) {
+    uint32_t tickStart = HAL_GetTick();
+    while (!__HAL_I2C_GET_FLAG(&hi2c1, I2C_FLAG_STOPF)) {
+        if (HAL_GetTick() - tickStart > 10)
+            return false;
+    }
+    return true;
+}
+
+// completes the character the previous call started, then puts two new ones in and waits for the first to be sent
+static bool isrSetup(void) {
+    bool ok = true;
+    if (lcdTransportIsBusy() || !i2cBusIsIdle()) {
+        ok &= waitStop();
+        isrPath();
+    }
+    ok &= (lcdPrintChar('A') == LCD_OK);    // the queue is running, this one starts right away
+    ok &= (lcdPrintChar('B') == LCD_OK);
+    ok &= waitStop();
+    return ok;
+}
+
+JTEST_DEFINE_TEST(lcdIsrBench, I2C1_EV_IRQHandler) {
+    uint32_t failures = 0;
+    maskLcdIRQs(true);
+    lcdQueueResume();
+    BENCH_MEASURE("lcd.isr", failures += !isrSetup(), isrPath());
+    failures += !waitStop();
+    isrPath();
+    lcdQueuePause();
+    maskLcdIRQs(false);
+    failures += !waitLcd();
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+#endif
+
+JTEST_DEFINE_GROUP(lcdBenchGroup) {
+    lcdQueuePause();
+    uint32_t tickStart = HAL_GetTick();
+    while (!lcdQueueIsPaused() && HAL_GetTick() - tickStart < 10) {
+    }
+    drainQueue();
+
+    JTEST_TEST_CALL(lcdEnqueueBench);
+    JTEST_TEST_CALL(lcdFlushBench);
+    JTEST_TEST_CALL(lcdTxByteBench);
+#if !defined(OVEN_HOST_BUILD) && !defined(LCD_TRANSPORT_GPIO)
+    JTEST_TEST_CALL(lcdIsrBench);
+#endif
+}
@@ -0,0 +1,103 @@
+/**
+ * @file bench_main.c
+ * @brief Entry point of the benchmark firmware. See bench.h for details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The peripherals are initialised with the same CubeMX code and clock configuration as the firmware, so the cases run with the same flash wait states and bus clocks. The LCD goes through its normal initialisation before the groups run. The results are sent once, then the LED blinks.
+ */
+
+#include "main.h"
+#include "crc.h"
+#include "dma.h"
+#include "i2c.h"
+#include "spi.h"
+#include "usart.h"
+#include "gpio.h"
+#include "bench.h"
+#include "i2c_bus.h"
+#include "lcd_hd44780_pcf8574_driver.h"
+
+static void SystemClock_Config(void);
+
+int main(void) {
+    HAL_Init();
+    SystemClock_Config();
+
+    MX_GPIO_Init();
+    MX_DMA_Init();
+    MX_USART2_UART_Init();
+    MX_I2C1_Init();
+    MX_SPI2_Init();
+    MX_CRC_Init();
+
+    i2cBusInit(&hi2c1);
+    lcdInit(&hi2c1, 0x27, 2, 8, true);
+    uint32_t tickStart = HAL_GetTick();
+    while (!i2cBusIsIdle() && HAL_GetTick() - tickStart < 100) {    // let the initialisation entries go out
+    }
+
+    benchInit();
+    JTEST_GROUP_CALL(lcdBenchGroup);
+    JTEST_GROUP_CALL(controlBenchGroup);
+    JTEST_GROUP_CALL(temperatureBenchGroup);
+    benchFinish();
+
+    while (1) {
+        HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin);
+        HAL_Delay(500);
+    }
+}
+
+// same as in main.c
+static void SystemClock_Config(void) {
+    RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
+    RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
+    RCC_PeriphCLKInitTypeDef PeriphClkInit = { 0 };
+
+    RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    RCC_OscInitStruct.HSEState = RCC_HSE_BYPASS;
+    RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+    RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+    RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+    RCC_OscInitStruct.PLL.PLLMUL = RCC_PLL_MUL9;
+    RCC_OscInitStruct.PLL.PREDIV = RCC_PREDIV_DIV1;
+    if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+        Error_Handler();
+    }
+
+    RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK
+        | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
+    RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+    if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK) {
+        Error_Handler();
+    }
+
+    PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_USART2 | RCC_PERIPHCLK_I2C1;
+    PeriphClkInit.Usart2ClockSelection = RCC_USART2CLKSOURCE_PCLK1;
+    PeriphClkInit.I2c1ClockSelection = RCC_I2C1CLKSOURCE_SYSCLK;
+    if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+/* HAL callbacks */
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    if (hi2c == &hi2c1)
+        i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    if (hi2c == &hi2c1)
+        i2cBusErrorHandler();
+}
+
+void Error_Handler(void) {
+    __disable_irq();
+    while (1) {
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file bench_port.c
+ * @brief JTest port and result reporting of the benchmark firmware. See bench.h for the output format.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * JTest's action triggers are meant to be watched by the Keil debugger, which reads the string buffer whenever dump_str is called. Here dump_str sends the buffer over USART2 with a blocking transfer instead, and the other triggers only count like in the original. The framework's globals are defined here rather than by compiling jtest_fw.c, which pulls in jtest_cycle.h: its SysTick-based counting would stop the HAL tick, so the cases are timed with the DWT cycle counter (BENCH_MEASURE) instead.
+ */
+
+#include "bench.h"
+#include "usart.h"
+#include "inttypes.h"
+
+#ifdef OVEN_HOST_BUILD
+#include "time.h"
+#endif
+
+char JTEST_FW_STR_BUFFER[JTEST_BUF_SIZE] = { 0 };
+volatile JTEST_FW_t JTEST_FW = { 0 };
+
+static uint32_t overhead = 0;   // cost of an empty measurement
+
+/* JTest action triggers */
+
+void test_start(void) {
+    JTEST_FW.test_start++;
+}
+
+void test_end(void) {
+    JTEST_FW.test_end++;
+}
+
+void group_start(void) {
+    JTEST_FW.group_start++;
+}
+
+void group_end(void) {
+    JTEST_FW.group_end++;
+}
+
+void dump_str(void) {   // one segment of at most JTEST_STR_MAX_OUTPUT_SIZE characters
+    JTEST_FW.dump_str++;
+    uint16_t len = 0;
+    while (len < JTEST_STR_MAX_OUTPUT_SIZE && JTEST_FW.str_buffer[len] != '\0')
+        len++;
+    if (len > 0)
+        HAL_UART_Transmit(&huart2, (uint8_t*)JTEST_FW.str_buffer, len, HAL_MAX_DELAY);
+}
+
+void dump_data(void) {
+    JTEST_FW.dump_data++;
+}
+
+void exit_fw(void) {
+    JTEST_FW.exit_fw++;
+}
+
+/* Cycle counter */
+
+#ifdef OVEN_HOST_BUILD
+uint32_t benchCounter(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+static void sort(uint32_t* samples) {
+    for (uint32_t i = 1; i < BENCH_RUNS; i++) {
+        uint32_t v = samples[i];
+        uint32_t j = i;
+        for (; j > 0 && samples[j - 1] > v; j--)
+            samples[j] = samples[j - 1];
+        samples[j] = v;
+    }
+}
+
+/* API functions */
+
+void benchInit(void) {
+#ifndef OVEN_HOST_BUILD
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    JTEST_INIT();
+
+    uint32_t samples[BENCH_RUNS];
+    for (uint32_t i = 0; i < BENCH_RUNS; i++) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uint32_t start = benchCounter();
+        uint32_t end = benchCounter();
+        __set_PRIMASK(primask);
+        samples[i] = end - start;
+    }
+    sort(samples);
+    overhead = samples[0];
+
+    JTEST_DUMP_STRF("BENCH_START,%s,%s,%u,%" PRIu32 "\n", BENCH_PLATFORM, BENCH_UNIT, BENCH_RUNS, overhead);
+}
+
+void benchReport(const char* name, uint32_t* samples) {
+    for (uint32_t i = 0; i < BENCH_RUNS; i++)
+        samples[i] = (samples[i] > overhead) ? samples[i] - overhead : 0;
+    sort(samples);
+    JTEST_DUMP_STRF("BENCH,%s,%u,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%s\n",
+        name, BENCH_RUNS, samples[0], samples[BENCH_RUNS / 2], samples[BENCH_RUNS - 1], BENCH_UNIT);
+}
+
+void benchFinish(void) {
+    JTEST_DUMP_STRF("BENCH_END,%" PRIu32 ",%" PRIu32 "\n", JTEST_FW.passed, JTEST_FW.failed);
+}
+
+bool benchWaitI2C(I2C_HandleTypeDef* hi2c) {
+    uint32_t tickStart = HAL_GetTick();
+    while (HAL_I2C_GetState(hi2c) != HAL_I2C_STATE_READY) {
+        if (HAL_GetTick() - tickStart > 10)
+            return false;
+    }
+    return true;
+}
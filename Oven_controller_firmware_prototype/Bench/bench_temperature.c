@@ -0,0 +1,35 @@
+/**
+ * @file bench_temperature.c
+ * @brief Temperature conversion benchmarks: type K inverse lookup and the full conversion with cold-junction compensation.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The emf sweeps the whole table range over the runs, so the median covers the segments with the longest search as well.
+ */
+
+#include "bench.h"
+#include "thermocouple.h"
+
+#define UV_START        -5000   // [uV]
+#define UV_STEP         1800    // [uV], BENCH_RUNS steps stay below TC_K_UV_MAX
+
+JTEST_DEFINE_TEST(tcToCelsiusBench, tcTypeKToCelsius) {
+    int32_t temp;
+    uint32_t failures = 0;
+    BENCH_MEASURE("tc.to_celsius", (void)0,
+        failures += (tcTypeKToCelsius(UV_START + UV_STEP * (int32_t)benchRun, &temp) != TC_OK));
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_TEST(tcConvertBench, tcConvert) {
+    int32_t temp;
+    uint32_t failures = 0;
+    BENCH_MEASURE("tc.convert", (void)0,
+        failures += (tcConvert(UV_START + UV_STEP * (int32_t)benchRun, 25 * TC_Q16_ONE, &temp) != TC_OK));
+    return (failures == 0) ? JTEST_TEST_PASSED : JTEST_TEST_FAILED;
+}
+
+JTEST_DEFINE_GROUP(temperatureBenchGroup) {
+    JTEST_TEST_CALL(tcToCelsiusBench);
+    JTEST_TEST_CALL(tcConvertBench);
+}
@@ -66,6 +66,10 @@ void Error_Handler(void);
 #define USART_RX_GPIO_Port GPIOA
 #define LED_Pin GPIO_PIN_5
 #define LED_GPIO_Port GPIOA
+#define TC2_CS_Pin GPIO_PIN_2
+#define TC2_CS_GPIO_Port GPIOB
+#define TC1_CS_Pin GPIO_PIN_12
+#define TC1_CS_GPIO_Port GPIOB
 #define TMS_Pin GPIO_PIN_13
 #define TMS_GPIO_Port GPIOA
 #define TCK_Pin GPIO_PIN_14
@@ -19,14 +19,23 @@
   /* USER CODE END Header */
   /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "crc.h"
 #include "dma.h"
 #include "i2c.h"
+#include "spi.h"
 #include "usart.h"
 #include "gpio.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include "LCD_HD44780_PCF8574_driver.h"
+#include "lcd_hd44780_pcf8574_driver.h"
+#include "max318xx_driver.h"
+#include "i2c_bus.h"
+#include "mcp9600_driver.h"
+#include "mlx90614_driver.h"
+#include "oven_control.h"
+#include "bake_log.h"
+#include "ccmram.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,6 +45,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define CONTROL_PERIOD_MS   1000    // must match ovenControlDefaultConfig.dt
 
 /* USER CODE END PD */
 
@@ -47,6 +57,15 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+static uint8_t tcChamber, tcTop, tcBottom;
+
+static OvenControl_t oven CCMRAM_BSS;  // control loop and filter state
+
+// button presses and UART commands, in arrival order, consumed by the next control tick
+static volatile uint8_t events[BLOG_MAX_EVENTS];
+static volatile uint8_t eventCount = 0;
+static uint8_t uartRxByte;
+static uint32_t lastRound[BLOG_SENSORS];
 
 /* USER CODE END PV */
 
@@ -58,6 +77,47 @@ void SystemClock_Config(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+static void pushEvent(uint8_t e) {
+    if (eventCount < BLOG_MAX_EVENTS)
+        events[eventCount++] = e;
+}
+
+static void addSample(BakeLogTick_t* tick, BakeLogSensor_t s, int32_t value, uint32_t timestamp, uint32_t round) {
+    if (round == lastRound[s])
+        return;
+    lastRound[s] = round;
+    tick->sampleMask |= (uint8_t)(1U << s);
+    tick->sample[s] = value;
+    tick->sampleAge[s] = tick->time - timestamp;
+}
+
+// everything the control loop sees goes through the tick record, so the bake log can replay it exactly
+static void controlTick(void) {
+    BakeLogTick_t tick = { 0 };
+    tick.time = HAL_GetTick();
+
+    MCP9600Reading_t mcp;
+    if (mcp9600GetReading(tcChamber, &mcp) == MCP9600_OK)
+        addSample(&tick, BLOG_SENSOR_CHAMBER, mcp.temperature, mcp.timestamp, mcp.round);
+    MAX318xxReading_t max;
+    if (max318xxGetReading(tcTop, &max) == MAX318XX_OK)
+        addSample(&tick, BLOG_SENSOR_TOP, max.temperature, max.timestamp, max.round);
+    if (max318xxGetReading(tcBottom, &max) == MAX318XX_OK)
+        addSample(&tick, BLOG_SENSOR_BOTTOM, max.temperature, max.timestamp, max.round);
+    MLX90614Reading_t mlx;
+    if (mlx90614GetReading(&mlx) == MLX90614_OK)
+        addSample(&tick, BLOG_SENSOR_STONE, mlx.object, mlx.timestamp, mlx.round);
+
+    __disable_irq();
+    tick.eventCount = eventCount;
+    for (uint8_t i = 0; i < eventCount; i++)
+        tick.event[i] = events[i];
+    eventCount = 0;
+    __enable_irq();
+
+    bakeLogRunTick(&oven, &tick);
+    bakeLogRecord(&tick);
+}
 
 /* USER CODE END 0 */
 
@@ -92,18 +152,43 @@ int main(void) {
     MX_DMA_Init();
     MX_USART2_UART_Init();
     MX_I2C1_Init();
+    MX_SPI2_Init();
+    MX_CRC_Init();
     /* USER CODE BEGIN 2 */
 
+    i2cBusInit(&hi2c1);
+
+    mcp9600Init();
+    mcp9600AddSensor(0x60, &tcChamber);     // blocking configuration, before the LCD starts using the bus
+    mlx90614Init(&hcrc, MLX90614_DEFAULT_ADDRESS);
+
     lcdInit(&hi2c1, 0x27, 2, 8, true);
     uint8_t c = '!';
 
+    max318xxInit(&hspi2);
+    max318xxAddSensor(MAX318XX_TYPE_MAX31855, TC1_CS_GPIO_Port, TC1_CS_Pin, &tcTop);
+    max318xxAddSensor(MAX318XX_TYPE_MAX31856, TC2_CS_GPIO_Port, TC2_CS_Pin, &tcBottom);
+
+    ovenControlInit(&oven, &ovenControlDefaultConfig);
+    bakeLogInit(&huart2, CONTROL_PERIOD_MS);
+    HAL_UART_Receive_IT(&huart2, &uartRxByte, 1);
+    uint32_t lastControl = HAL_GetTick();
+
     /* USER CODE END 2 */
 
     /* Infinite loop */
     /* USER CODE BEGIN WHILE */
     while (1) {
         lcdPrintChar(c++);
-        
+        max318xxStartRound();
+        mcp9600Process();
+        mlx90614Process();
+
+        if (HAL_GetTick() - lastControl >= CONTROL_PERIOD_MS) {
+            lastControl += CONTROL_PERIOD_MS;
+            controlTick();
+        }
+
         HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin);
         HAL_Delay(250);
         /* USER CODE END WHILE */
@@ -163,12 +248,44 @@ void SystemClock_Config(void) {
 /* USER CODE BEGIN 4 */
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
     if (hi2c == &hi2c1)
-        lcdFlushQueue();
+        i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    if (hi2c == &hi2c1)
+        i2cBusTransferCompleteHandler();
 }
 
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
     if (hi2c == &hi2c1)
-        lcdi2cErrorHandler();
+        i2cBusErrorHandler();
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi == &hspi2)
+        max318xxTransferCompleteHandler();
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi == &hspi2)
+        max318xxSpiErrorHandler();
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    if (huart == &huart2)
+        bakeLogTxCompleteHandler();
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+    if (huart == &huart2) {
+        pushEvent(uartRxByte);
+        HAL_UART_Receive_IT(&huart2, &uartRxByte, 1);
+    }
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    if (GPIO_Pin == BTN_Pin)
+        pushEvent(BLOG_EVENT_BUTTON);
 }
 /* USER CODE END 4 */
 
@@ -0,0 +1,254 @@
+/**
+ * @file adaptive_tracking.c
+ * @brief Runs the self-tuning PID on a thermal plant that changes halfway through, and reports how the identified model follows it and how both halves are controlled, against the firmware's fixed gains.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The chamber setpoint alternates between SETPOINT_LOW_C and SETPOINT_HIGH_C every STEP_PERIOD_S, which gives the identifier the excitation it needs. At CHANGE_S the plant changes: both heaters lose POWER_FACTOR of their power (a sagging mains voltage or aged elements) and the door leaks LEAK_FACTOR times as much (a worn gasket), so the oven gets a lower gain and a shorter time constant.
+ *
+ * Both loops start from the firmware's gains (ovenControlDefaultConfig) and drive the heaters through the power splitter and the joint modulator, like oven_control. The adaptive loop wraps the same PID with adaptive_pid.
+ *
+ * The plant's own first-order gain and time constant, for comparing with the identified ones, come from open-loop steps of the combined demand on each version of the plant: the gain is the final rise of the chamber thermocouple, the time constant the area above the normalised step response. Neither plant is first order, so these are references, not the answer.
+ *
+ * The identifier is given the room's ambient (adaptiveSetAmbient; the firmware has it from the thermocouple converter's cold junction). With the ambient identified too, a first-order fit of closed-loop data around a hold takes the slow stone and walls for a hot ambient (150 degC and more on this plant) and the fitted gain and time constant for a local mode, a fraction of the plant's; they only ever passed the ambient check in transients. With the ambient fixed, the gain is the plant's static gain. The time constant stays below the reference: the setpoint steps mostly excite the fast part of the plant, which a first-order model can't separate from the slow one, so it isn't judged.
+ *
+ * Reported per half: the RMS error of the air against the setpoint and the worst overshoot and settling time (+-BAND_C) over the setpoint steps, plus the retune count, the time from the start of the half (for the second, from the plant change) to its first retune, the identified model, the identifier's uncertainty and the gains at the end of each half.
+ *
+ * Usage: adaptive_tracking [-v]
+ * Exit code: 0 - the adaptive loop retuned after the change, its identified gain was within GAIN_TOLERANCE of the plant's reference in both halves, every step settled in both halves, and after the change its RMS error and settling time were no worse than with the fixed gains, 1 - it didn't
+ */
+
+#include "adaptive_pid.h"
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define BAND_C                  2.0f
+
+#define SETPOINT_LOW_C          230.0f
+#define SETPOINT_HIGH_C         260.0f
+#define STEP_PERIOD_S           1800
+#define CHANGE_S                21600   // 6 h
+#define END_S                   43200
+#define POWER_FACTOR            0.75f
+#define LEAK_FACTOR             4.0f
+
+#define ID_TIME_S               36000
+
+#define ADAPT_DECIMATION        10      // identifier sample every 10 s
+#define ADAPT_FORGETTING        0.998f  // memory about 5000 s
+#define ADAPT_DELAY             1       // samples
+#define ADAPT_CLOSED_LOOP_TAU   10.0f   // [s], the dead time (SIMC's tight setting), slower targets settle slower than the firmware's gains
+#define GAIN_TOLERANCE          0.2f    // identified gain against the plant's reference, relative
+
+#define HALVES                  2
+
+typedef struct HalfResult_t {
+    double squares;
+    uint32_t ticks;
+    float overshoot;            // worst over the steps [degC]
+    float settling;             // worst over the steps that settled [s]
+    bool allSettled;
+    RLSModel_t model;           // identified at the end of the half
+    bool modelValid;
+    float uncertainty;          // identifier covariance trace at the end of the half
+    uint16_t retunes;           // at the end of the half
+    int32_t firstRetune;        // from the start of the half (the plant change for the second one) [s], -1 if none
+    PIDGains_t gains;
+} HalfResult_t;
+
+static const char* halfNames[HALVES] = { "before", "after" };
+
+static void changedPlant(PlantParams_t* p) {
+    *p = plantDefaultParams;
+    p->topPower *= POWER_FACTOR;
+    p->bottomPower *= POWER_FACTOR;
+    for (uint8_t l = 0; l < p->linkCount; l++)
+        if (p->links[l].a == PLANT_AIR && p->links[l].b == PLANT_AMBIENT)
+            p->links[l].conductance *= LEAK_FACTOR;
+}
+
+static void heatersInit(PowerSplitter_t* split, HeaterOutput_t* ho) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    psplitInit(split, pp->topPower, pp->bottomPower, 0.5f);
+    heaterOutInit(ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, ovenControlDefaultConfig.currentCap);
+}
+
+static void applyDemand(const PowerSplitter_t* split, HeaterOutput_t* ho, float demand) {
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(split, (uint16_t)(demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutSetDutyQ15(ho, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+}
+
+static void reference(const PlantParams_t* pp, RLSModel_t* model) {
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    heatersInit(&split, &ho);
+    applyDemand(&split, &ho, 1.0f);
+    plantInit(&tp, pp, AMBIENT_C);
+
+    static float rise[ID_TIME_S];
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    for (uint32_t t = 0; t < ID_TIME_S; t++) {
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = heaterOutNextHalfCycle(&ho);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+        rise[t] = tp.sensor - AMBIENT_C;
+    }
+    double area = 0.0;
+    for (uint32_t t = 0; t < ID_TIME_S; t++)
+        area += 1.0 - rise[t] / rise[ID_TIME_S - 1];
+    model->gain = rise[ID_TIME_S - 1];
+    model->tau = (float)area;
+    model->ambient = AMBIENT_C;
+}
+
+static void run(bool adaptive, bool verbose, HalfResult_t r[HALVES]) {
+    PlantParams_t changed;
+    changedPlant(&changed);
+    const OvenControlConfig_t* occ = &ovenControlDefaultConfig;
+    PIDController_t pid;
+    AdaptivePID_t ap;
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    pidInit(&pid, occ->gains, occ->dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, occ->derivativeFilter);
+    adaptiveInit(&ap, &pid, ADAPT_DECIMATION, ADAPT_FORGETTING, ADAPT_DELAY, ADAPT_CLOSED_LOOP_TAU);
+    adaptiveSetAmbient(&ap, AMBIENT_C);
+    heatersInit(&split, &ho);
+    plantInit(&tp, &plantDefaultParams, AMBIENT_C);
+    memset(r, 0, HALVES * sizeof(HalfResult_t));
+    for (uint8_t h = 0; h < HALVES; h++) {
+        r[h].allSettled = true;
+        r[h].firstRetune = -1;
+    }
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    float setpoint = SETPOINT_LOW_C;
+    float from = AMBIENT_C;
+    uint32_t stepStart = 0;
+    float lastOutside = 0.0f;
+    float overshoot = 0.0f;
+    for (uint32_t t = 0; t <= END_S; t++) {
+        uint8_t half = (t < CHANGE_S) ? 0 : 1;
+        // a step ends when the next one starts, the preheat isn't scored
+        if (t % STEP_PERIOD_S == 0 && t > 0) {
+            HalfResult_t* hr = &r[(t - 1 < CHANGE_S) ? 0 : 1];
+            float air = tp.temperature[PLANT_AIR];
+            if (stepStart > 0) {
+                if (fabsf(air - setpoint) > BAND_C) {
+                    hr->allSettled = false;
+                } else if (lastOutside - stepStart > hr->settling) {
+                    hr->settling = lastOutside - stepStart;
+                }
+                if (overshoot > hr->overshoot)
+                    hr->overshoot = overshoot;
+            }
+            if (t == CHANGE_S || t == END_S) {
+                hr->modelValid = rlsGetModel(&ap.rls, &hr->model);
+                hr->uncertainty = rlsGetUncertainty(&ap.rls);
+                hr->retunes = adaptiveGetRetuneCount(&ap);
+                hr->gains = pid.gains;
+            }
+            if (t == CHANGE_S)
+                tp.params = &changed;
+            if (t == END_S)
+                break;
+            from = setpoint;
+            setpoint = (setpoint == SETPOINT_LOW_C) ? SETPOINT_HIGH_C : SETPOINT_LOW_C;
+            stepStart = t;
+            lastOutside = (float)t;
+            overshoot = 0.0f;
+        }
+
+        uint16_t retunes = adaptiveGetRetuneCount(&ap);
+        float demand = adaptive ? adaptiveStep(&ap, setpoint, tp.sensor) : pidStep(&pid, setpoint, tp.sensor);
+        if (adaptiveGetRetuneCount(&ap) != retunes && r[half].firstRetune < 0)
+            r[half].firstRetune = (int32_t)(t - (half ? CHANGE_S : 0));
+        applyDemand(&split, &ho, demand);
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = heaterOutNextHalfCycle(&ho);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+
+        float air = tp.temperature[PLANT_AIR];
+        float err = air - setpoint;
+        if (fabsf(err) > BAND_C)
+            lastOutside = (float)(t + 1);
+        float beyond = (setpoint > from) ? err : -err;
+        if (beyond > overshoot)
+            overshoot = beyond;
+        if (stepStart > 0) {
+            r[half].squares += (double)(err * err);
+            r[half].ticks++;
+        }
+        if (verbose && t % 30 == 0)
+            printf("%s,%u,%.1f,%.2f,%.3f,%.4f,%.6f\n", adaptive ? "adaptive" : "fixed", t, setpoint, air, demand, pid.gains.kp, pid.gains.ki);
+    }
+}
+
+static void printModel(const char* name, const RLSModel_t* m) {
+    printf("  %-28s gain %7.1f degC  tau %7.0f s\n", name, m->gain, m->tau);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+
+    PlantParams_t changed;
+    changedPlant(&changed);
+    RLSModel_t refBefore, refAfter;
+    reference(&plantDefaultParams, &refBefore);
+    reference(&changed, &refAfter);
+
+    if (verbose)
+        printf("loop,t,setpoint,air,demand,kp,ki\n");
+    HalfResult_t fixed[HALVES], adaptive[HALVES];
+    run(false, verbose, fixed);
+    run(true, verbose, adaptive);
+
+    printf("setpoint %.0f <-> %.0f degC every %u s, plant changes at %u s: heater power x%.2f, door leak x%.1f\n", SETPOINT_LOW_C, SETPOINT_HIGH_C,
+        STEP_PERIOD_S, CHANGE_S, POWER_FACTOR, LEAK_FACTOR);
+    printf("plant's first-order reference (open-loop step at full demand):\n");
+    printModel("before", &refBefore);
+    printModel("after", &refAfter);
+    printf("%-9s %-7s %9s %13s %11s %9s %13s %10s %10s %12s %8s %10s\n", "loop", "half", "RMS[C]", "overshoot[C]", "settled[s]", "retunes", "1st retune[s]", "gain[C]", "tau[s]",
+        "uncertainty", "kp", "ki");
+    for (uint8_t l = 0; l < 2; l++) {
+        const HalfResult_t* hr = l ? adaptive : fixed;
+        for (uint8_t h = 0; h < HALVES; h++) {
+            printf("%-9s %-7s %9.2f %13.2f", h == 0 ? (l ? "adaptive" : "fixed") : "", halfNames[h], hr[h].ticks ? sqrt(hr[h].squares / hr[h].ticks) : 0.0,
+                hr[h].overshoot);
+            if (hr[h].allSettled)
+                printf(" %11.0f", hr[h].settling);
+            else
+                printf(" %11s", "-");
+            printf(" %9u", l ? hr[h].retunes : 0u);
+            if (l && hr[h].firstRetune >= 0)
+                printf(" %13d", hr[h].firstRetune);
+            else
+                printf(" %13s", "-");
+            if (l && hr[h].modelValid)
+                printf(" %10.1f %10.0f %12.3f", hr[h].model.gain, hr[h].model.tau, hr[h].uncertainty);
+            else
+                printf(" %10s %10s %12s", "-", "-", "-");
+            printf(" %8.4f %10.6f\n", hr[h].gains.kp, hr[h].gains.ki);
+        }
+    }
+
+    const RLSModel_t* refs[HALVES] = { &refBefore, &refAfter };
+    bool ok = adaptive[1].firstRetune >= 0 && adaptive[0].allSettled && adaptive[1].allSettled;
+    for (uint8_t h = 0; h < HALVES; h++)
+        ok &= adaptive[h].modelValid && fabsf(adaptive[h].model.gain - refs[h]->gain) <= GAIN_TOLERANCE * refs[h]->gain;
+    ok &= sqrt(adaptive[1].squares / adaptive[1].ticks) <= sqrt(fixed[1].squares / fixed[1].ticks) && adaptive[1].settling <= fixed[1].settling;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file cascade_preheat.c
+ * @brief Preheats the thermal plant with the single chamber loop and with the cascade mode, reporting the preheat time and how hot the elements got.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Plants:
+ * - two nodes: both elements lumped into one element node, the air, stone and walls into one chamber node, all the plant's links between them and to ambient folded into one conductance each (walls in series with the insulation)
+ * - the five-node default plant, where the stone and walls lag behind the air
+ *
+ * Both heaters get the same duty. The single loop is the firmware's PID (ovenControlDefaultConfig) on the chamber thermocouple. The cascade's inner loop runs every INNER_DT_S on the top element's temperature (an element thermocouple, without lag), the outer loop every OUTER_DT_S on the chamber thermocouple, with the element setpoint limited to the plant's maxElement. At LIMIT_S, still in the preheat, the limit is lowered to lowerElement with cascadeSetMaxElement, as the firmware would do when the element overheats. Both limits sit between the element temperature that holds the target and the single loop's peak, the two-node plant's element runs cooler (the bottom element's link to the stone is folded into its conductance).
+ *
+ * Reported per run: the preheat time (until the air first reaches within BAND_C of TARGET_C), the settling time (until it last entered the band), the air's overshoot and the top element's peak over the run and from LIMIT_COOL_S after the limit was lowered.
+ *
+ * Usage: cascade_preheat [-v]
+ * Exit code: 0 - on both plants the cascade kept the element below the single loop's peak and within ELEMENT_MARGIN_C of each limit, and settled, 1 - it didn't
+ */
+
+#include "cascade_controller.h"
+#include "heater_output.h"
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s, the inner loop's period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define TARGET_C                450.0f
+#define BAND_C                  2.0f
+#define END_S                   10800
+#define LIMIT_S                 1200
+#define LIMIT_COOL_S            60      // for the element to come down to the new limit
+
+#define INNER_DT_S              1.0f
+#define OUTER_DT_S              10.0f
+#define ELEMENT_MARGIN_C        10.0f
+
+typedef struct RunResult_t {
+    float preheat;              // [s], NAN if the air never got into the band
+    float settling;             // [s], NAN if it wasn't in the band at the end
+    float overshoot;            // [degC]
+    float peakElement;          // over the whole run [degC]
+    float peakElementLimited;   // from LIMIT_S + LIMIT_COOL_S [degC]
+} RunResult_t;
+
+typedef struct PlantCase_t {
+    const char* name;
+    const PlantParams_t* params;
+    float maxElement;           // [degC]
+    float lowerElement;         // from LIMIT_S [degC]
+} PlantCase_t;
+
+static const CascadeConfig_t cascadeConfig = {
+    .outerGains = { .kp = 8.0f, .ki = 0.05f, .kd = 0.0f },
+    .innerGains = { .kp = 0.02f, .ki = 0.002f, .kd = 0.0f },
+    .outerDt = OUTER_DT_S,
+    .innerDt = INNER_DT_S,
+    .maxDuty = 1.0f,
+};
+
+/* Plants */
+
+static PlantParams_t twoNodeParams;
+
+// Folds the default plant into an element node (PLANT_TOP_ELEMENT) and a chamber node (PLANT_AIR)
+static void lumpTwoNodes(const PlantParams_t* p, PlantParams_t* two) {
+    memset(two, 0, sizeof(*two));
+    float toChamber = 0.0f, airLoss = 0.0f, airToWalls = 0.0f, wallsLoss = 0.0f;
+    for (uint8_t l = 0; l < p->linkCount; l++) {
+        const PlantLink_t* link = &p->links[l];
+        bool element = (link->a == PLANT_TOP_ELEMENT || link->a == PLANT_BOTTOM_ELEMENT);
+        if (element)
+            toChamber += link->conductance;
+        else if (link->a == PLANT_AIR && link->b == PLANT_WALLS)
+            airToWalls = link->conductance;
+        else if (link->a == PLANT_AIR && link->b == PLANT_AMBIENT)
+            airLoss = link->conductance;
+        else if (link->a == PLANT_WALLS && link->b == PLANT_AMBIENT)
+            wallsLoss = link->conductance;
+    }
+    two->capacity[PLANT_TOP_ELEMENT] = p->capacity[PLANT_TOP_ELEMENT] + p->capacity[PLANT_BOTTOM_ELEMENT];
+    two->capacity[PLANT_AIR] = p->capacity[PLANT_AIR] + p->capacity[PLANT_STONE] + p->capacity[PLANT_WALLS];
+    two->capacity[PLANT_BOTTOM_ELEMENT] = 1.0f;     // unused nodes, not linked to anything
+    two->capacity[PLANT_STONE] = 1.0f;
+    two->capacity[PLANT_WALLS] = 1.0f;
+    two->links[0] = (PlantLink_t){ PLANT_TOP_ELEMENT, PLANT_AIR, toChamber, 0.0f };
+    two->links[1] = (PlantLink_t){ PLANT_AIR, PLANT_AMBIENT, airLoss + airToWalls * wallsLoss / (airToWalls + wallsLoss), 0.0f };
+    two->linkCount = 2;
+    two->doorConductance = p->doorConductance;
+    two->topPower = p->topPower + p->bottomPower;
+    two->bottomPower = 0.0f;
+    two->sensorTau = p->sensorTau;
+}
+
+/* Runs */
+
+static void run(const PlantCase_t* pc, bool cascade, bool verbose, RunResult_t* r) {
+    const PlantParams_t* pp = pc->params;
+    CascadeConfig_t cfg = cascadeConfig;
+    cfg.maxElement = pc->maxElement;
+    PIDController_t pid;
+    CascadeController_t cc;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, ovenControlDefaultConfig.derivativeFilter);
+    cascadeInit(&cc, &cfg, AMBIENT_C);
+    heaterOutInit(&ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, ovenControlDefaultConfig.currentCap);
+    plantInit(&tp, pp, AMBIENT_C);
+    r->preheat = NAN;
+    r->settling = NAN;
+    r->overshoot = 0.0f;
+    r->peakElement = AMBIENT_C;
+    r->peakElementLimited = AMBIENT_C;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    float lastOutside = 0.0f;
+    for (uint32_t t = 0; t < END_S; t++) {
+        if (t == LIMIT_S)
+            cascadeSetMaxElement(&cc, pc->lowerElement);
+        float duty = cascade ? cascadeStep(&cc, TARGET_C, tp.sensor, tp.temperature[PLANT_TOP_ELEMENT]) : pidStep(&pid, TARGET_C, tp.sensor);
+        heaterOutSetDuty(&ho, duty, duty);
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = heaterOutNextHalfCycle(&ho);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+            float element = tp.temperature[PLANT_TOP_ELEMENT];
+            if (element > r->peakElement)
+                r->peakElement = element;
+            if (t >= LIMIT_S + LIMIT_COOL_S && element > r->peakElementLimited)
+                r->peakElementLimited = element;
+        }
+
+        float err = tp.temperature[PLANT_AIR] - TARGET_C;
+        if (fabsf(err) > BAND_C)
+            lastOutside = (float)(t + 1);
+        else if (isnan(r->preheat))
+            r->preheat = (float)(t + 1);
+        if (err > r->overshoot)
+            r->overshoot = err;
+        if (verbose && t % 30 == 0)
+            printf("%s,%s,%u,%.2f,%.2f,%.2f,%.3f\n", pc->name, cascade ? "cascade" : "single", t, tp.temperature[PLANT_AIR],
+                tp.temperature[PLANT_TOP_ELEMENT], cc.elementSetpoint, duty);
+    }
+    if (fabsf(tp.temperature[PLANT_AIR] - TARGET_C) <= BAND_C)
+        r->settling = lastOutside;
+}
+
+static void printSeconds(float s) {
+    if (isnan(s))
+        printf(" %11s", "-");
+    else
+        printf(" %11.0f", s);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    lumpTwoNodes(&plantDefaultParams, &twoNodeParams);
+    const PlantCase_t plants[] = {
+        { "two-node", &twoNodeParams, 580.0f, 550.0f },
+        { "default", &plantDefaultParams, 650.0f, 600.0f },
+    };
+
+    if (verbose)
+        printf("plant,loop,t,air,element,element setpoint,duty\n");
+    RunResult_t results[2][2];
+    for (uint8_t p = 0; p < 2; p++) {
+        run(&plants[p], false, verbose, &results[p][0]);
+        run(&plants[p], true, verbose, &results[p][1]);
+    }
+
+    printf("preheat to %.0f degC, band +-%.0f degC, element limit lowered at %u s\n", TARGET_C, BAND_C, LIMIT_S);
+    printf("%-9s %-8s %13s %11s %11s %13s %16s %16s\n", "plant", "loop", "limits[C]", "preheat[s]", "settled[s]", "overshoot[C]", "peak element[C]", "after limit[C]");
+    bool ok = true;
+    for (uint8_t p = 0; p < 2; p++) {
+        const PlantCase_t* pc = &plants[p];
+        for (uint8_t c = 0; c < 2; c++) {
+            const RunResult_t* r = &results[p][c];
+            printf("%-9s %-8s", c == 0 ? pc->name : "", c == 0 ? "single" : "cascade");
+            if (c == 0)
+                printf(" %13s", "-");
+            else
+                printf("     %3.0f / %3.0f", pc->maxElement, pc->lowerElement);
+            printSeconds(r->preheat);
+            printSeconds(r->settling);
+            printf(" %13.2f %16.1f %16.1f\n", r->overshoot, r->peakElement, r->peakElementLimited);
+        }
+        const RunResult_t* cr = &results[p][1];
+        ok &= !isnan(cr->settling) && cr->peakElement < results[p][0].peakElement && cr->peakElement <= pc->maxElement + ELEMENT_MARGIN_C
+            && cr->peakElementLimited <= pc->lowerElement + ELEMENT_MARGIN_C;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file dead_time.c
+ * @brief Adds a measurement dead time to the thermal plant and compares the firmware's PID with and without the Smith predictor, plus the cost of a step of each.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The plant's own thermocouple only lags by a few seconds. A sensor in a thick thermowell, or one read over a slow bus, adds a pure delay on top, modelled here as a delay line of whole control periods on the thermocouple reading. For every dead time the same schedule runs with the PID alone and with the PID inside the Smith predictor, both with the firmware's gains (ovenControlDefaultConfig) and driving the heaters through the power splitter and the joint modulator like oven_control:
+ * - preheat to SETPOINT_LOW_C (not scored)
+ * - setpoint steps between SETPOINT_LOW_C and SETPOINT_HIGH_C every STEP_PERIOD_S
+ * - the door open for DOOR_OPEN_S at DOOR_S
+ *
+ * The predictor's first-order model is identified on the plant at the operating point: the oven is held at the low setpoint by a constant demand, the demand is stepped up by ID_STEP and the gain and time constant come from the response within ID_WINDOW_S (the 28.3 % and 63.2 % times, two-point method). The predictor's dead time is the simulated one plus the apparent delay of the fit.
+ *
+ * Reported per run: the RMS error of the air over the steps, the worst overshoot and settling time (+-BAND_C) and the largest error after the door opening. The cost per step is timed on this host over the whole run, the cycles on the STM32F303 come from the smith.step case of oven_bench.
+ *
+ * Usage: dead_time [dead time s ...] (default: 0 10 30 60)
+ * Exit code: 0 - with the predictor every step settled at every dead time, and at the longest one the RMS error was below the PID's, 1 - it didn't, 2 - bad arguments
+ */
+
+#include "oven_control.h"
+#include "smith_predictor.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define BAND_C                  2.0f
+#define MAX_DEAD_TIMES          8
+#define MAX_DEAD_TIME_S         (SMITH_DELAY_LEN - 1)
+
+#define SETPOINT_LOW_C          230.0f
+#define SETPOINT_HIGH_C         260.0f
+#define STEP_PERIOD_S           1800
+#define STEPS                   4
+#define DOOR_S                  (STEP_PERIOD_S * (STEPS + 1) + 600)
+#define DOOR_OPEN_S             30
+#define END_S                   (STEP_PERIOD_S * (STEPS + 2))
+
+#define ID_SETTLE_S             7200    // constant demand before the step
+#define ID_STEP                 0.1f
+#define ID_WINDOW_S             600
+
+typedef struct RunResult_t {
+    double squares;
+    uint32_t ticks;
+    float overshoot;            // worst over the steps [degC]
+    float settling;             // worst over the steps that settled [s]
+    bool allSettled;
+    float doorError;            // [degC]
+    double stepNs;              // per control step
+} RunResult_t;
+
+typedef struct Delay_t {
+    float line[SMITH_DELAY_LEN];
+    uint16_t head;
+    uint16_t length;            // [control periods]
+} Delay_t;
+
+/* Helpers */
+
+static void heatersInit(PowerSplitter_t* split, HeaterOutput_t* ho) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    psplitInit(split, pp->topPower, pp->bottomPower, 0.5f);
+    heaterOutInit(ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, ovenControlDefaultConfig.currentCap);
+}
+
+static void applyDemand(const PowerSplitter_t* split, HeaterOutput_t* ho, float demand) {
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(split, (uint16_t)(demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutSetDutyQ15(ho, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+}
+
+static void tick(ThermalPlant_t* tp, HeaterOutput_t* ho, PlantInputs_t* in) {
+    for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+        in->heaters = heaterOutNextHalfCycle(ho);
+        plantStep(tp, in, HALF_CYCLE_S);
+    }
+}
+
+// Returns the reading from length periods ago, the line starts filled with the first reading
+static float delayed(Delay_t* d, float reading) {
+    d->line[d->head] = reading;
+    float out = d->line[(d->head - d->length) & (SMITH_DELAY_LEN - 1)];
+    d->head = (d->head + 1) & (SMITH_DELAY_LEN - 1);
+    return out;
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Identification */
+
+// Demand that holds the sensor at the low setpoint, found with a plain PID run
+static float holdingDemand(void) {
+    PIDController_t pid;
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    heatersInit(&split, &ho);
+    plantInit(&tp, &plantDefaultParams, AMBIENT_C);
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    double sum = 0.0;
+    for (uint32_t t = 0; t < ID_SETTLE_S; t++) {
+        float demand = pidStep(&pid, SETPOINT_LOW_C, tp.sensor);
+        if (t >= ID_SETTLE_S / 2)
+            sum += demand;
+        applyDemand(&split, &ho, demand);
+        tick(&tp, &ho, &in);
+    }
+    return (float)(sum / (ID_SETTLE_S - ID_SETTLE_S / 2));
+}
+
+static SmithModel_t identify(void) {
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    heatersInit(&split, &ho);
+    plantInit(&tp, &plantDefaultParams, AMBIENT_C);
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+
+    // settle the whole plant (walls included) at the holding demand, then step it
+    float hold = holdingDemand();
+    applyDemand(&split, &ho, hold);
+    for (uint32_t t = 0; t < 5 * ID_SETTLE_S; t++)
+        tick(&tp, &ho, &in);
+    float start = tp.sensor;
+    applyDemand(&split, &ho, hold + ID_STEP);
+    static float rise[ID_WINDOW_S];
+    for (uint32_t t = 0; t < ID_WINDOW_S; t++) {
+        tick(&tp, &ho, &in);
+        rise[t] = tp.sensor - start;
+    }
+
+    float final = rise[ID_WINDOW_S - 1];
+    float t28 = 0.0f, t63 = 0.0f;
+    for (uint32_t t = ID_WINDOW_S; t-- > 0;) {
+        if (rise[t] >= 0.283f * final)
+            t28 = (float)(t + 1);
+        if (rise[t] >= 0.632f * final)
+            t63 = (float)(t + 1);
+    }
+    SmithModel_t m;
+    m.gain = final / ID_STEP;
+    m.tau = 1.5f * (t63 - t28);
+    m.deadTime = t63 - m.tau;
+    if (m.deadTime < 0.0f)
+        m.deadTime = 0.0f;
+    return m;
+}
+
+/* Runs */
+
+static void run(uint16_t deadTime, const SmithModel_t* model, RunResult_t* r) {
+    PIDController_t pid;
+    SmithPredictor_t sp;
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    static Delay_t delay;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, ovenControlDefaultConfig.derivativeFilter);
+    if (model) {
+        SmithModel_t m = *model;
+        m.deadTime += deadTime;
+        smithInit(&sp, &pid, m);
+    }
+    heatersInit(&split, &ho);
+    plantInit(&tp, &plantDefaultParams, AMBIENT_C);
+    for (uint16_t i = 0; i < SMITH_DELAY_LEN; i++)
+        delay.line[i] = AMBIENT_C;
+    delay.head = 0;
+    delay.length = deadTime;
+    memset(r, 0, sizeof(*r));
+    r->allSettled = true;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    float setpoint = SETPOINT_LOW_C;
+    float from = AMBIENT_C;
+    uint32_t stepStart = 0;
+    float lastOutside = 0.0f;
+    float overshoot = 0.0f;
+    for (uint32_t t = 0; t < END_S; t++) {
+        if (t % STEP_PERIOD_S == 0 && t > 0 && t <= STEP_PERIOD_S * (STEPS + 1)) {
+            if (stepStart > 0) {
+                if (fabsf(tp.temperature[PLANT_AIR] - setpoint) > BAND_C)
+                    r->allSettled = false;
+                else if (lastOutside - stepStart > r->settling)
+                    r->settling = lastOutside - stepStart;
+                if (overshoot > r->overshoot)
+                    r->overshoot = overshoot;
+            }
+            if (t <= STEP_PERIOD_S * STEPS) {
+                from = setpoint;
+                setpoint = (setpoint == SETPOINT_LOW_C) ? SETPOINT_HIGH_C : SETPOINT_LOW_C;
+                stepStart = t;
+                lastOutside = (float)t;
+                overshoot = 0.0f;
+            } else {
+                stepStart = 0;
+            }
+        }
+        in.doorOpen = (t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S);
+
+        float measurement = delayed(&delay, tp.sensor);
+        double start = nowNs();
+        float demand = model ? smithStep(&sp, setpoint, measurement) : pidStep(&pid, setpoint, measurement);
+        r->stepNs += nowNs() - start;
+        applyDemand(&split, &ho, demand);
+        tick(&tp, &ho, &in);
+
+        float err = tp.temperature[PLANT_AIR] - setpoint;
+        if (stepStart > 0) {
+            if (fabsf(err) > BAND_C)
+                lastOutside = (float)(t + 1);
+            float beyond = (setpoint > from) ? err : -err;
+            if (beyond > overshoot)
+                overshoot = beyond;
+            r->squares += (double)(err * err);
+            r->ticks++;
+        }
+        if (t >= DOOR_S && fabsf(err) > r->doorError)
+            r->doorError = fabsf(err);
+    }
+    r->stepNs /= END_S;
+}
+
+static void printRun(const char* name, uint16_t deadTime, const RunResult_t* r) {
+    printf("%8u  %-6s %9.2f %13.2f", deadTime, name, r->ticks ? sqrt(r->squares / r->ticks) : 0.0, r->overshoot);
+    if (r->allSettled)
+        printf(" %11.0f", r->settling);
+    else
+        printf(" %11s", "-");
+    printf(" %14.2f %12.0f\n", r->doorError, r->stepNs);
+}
+
+int main(int argc, char** argv) {
+    uint16_t deadTimes[MAX_DEAD_TIMES] = { 0, 10, 30, 60 };
+    uint8_t count = 4;
+    if (argc > 1) {
+        count = 0;
+        for (int i = 1; i < argc && count < MAX_DEAD_TIMES; i++) {
+            char* end;
+            long d = strtol(argv[i], &end, 10);
+            if (*end != '\0' || d < 0 || d > MAX_DEAD_TIME_S) {
+                fprintf(stderr, "bad dead time: %s (0 - %d s)\n", argv[i], MAX_DEAD_TIME_S);
+                return 2;
+            }
+            deadTimes[count++] = (uint16_t)d;
+        }
+    }
+
+    SmithModel_t model = identify();
+    printf("identified at %.0f degC: gain %.1f degC, tau %.1f s, apparent dead time %.1f s\n", SETPOINT_LOW_C, model.gain, model.tau, model.deadTime);
+    printf("setpoint %.0f <-> %.0f degC every %u s, door open %u s at %u s, band +-%.0f degC\n", SETPOINT_LOW_C, SETPOINT_HIGH_C, STEP_PERIOD_S,
+        DOOR_OPEN_S, DOOR_S, BAND_C);
+    printf("%8s  %-6s %9s %13s %11s %14s %12s\n", "dead[s]", "loop", "RMS[C]", "overshoot[C]", "settled[s]", "door error[C]", "step[ns]");
+
+    bool ok = true;
+    RunResult_t pid, smith;
+    for (uint8_t i = 0; i < count; i++) {
+        run(deadTimes[i], NULL, &pid);
+        run(deadTimes[i], &model, &smith);
+        printRun("PID", deadTimes[i], &pid);
+        printRun("Smith", deadTimes[i], &smith);
+        ok &= smith.allSettled;
+    }
+    // the last pair is the longest dead time when run with the defaults
+    ok &= sqrt(smith.squares / smith.ticks) < sqrt(pid.squares / pid.ticks);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
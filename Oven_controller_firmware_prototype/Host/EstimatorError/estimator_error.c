@@ -0,0 +1,262 @@
+/**
+ * @file estimator_error.c
+ * @brief Runs the state estimator alongside a pizza bake on the thermal plant and reports its errors against the plant's true node temperatures.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The firmware's control loop (oven_control) runs the pizza program on the plant, with the door open for DOOR_OPEN_S seconds at DOOR_S. The estimator steps at its design rate of 10 Hz and gets what the firmware would have: the duties the heaters actually fired in the last period, the chamber thermocouple and a bottom sensor under the stone (a BOTTOM_SENSOR_TAU_S lag on the stone, which the plant doesn't model itself). Both readings carry SENSOR_NOISE_C of Gaussian noise from a fixed seed, so runs are repeatable.
+ *
+ * Estimator setups:
+ * - the firmware's default model (estDefaultModel), the lumping below with rounded numbers
+ * - a model lumped from the plant's parameters: the top element is the element node, the walls are folded into the chamber (their capacity added, the air-walls-ambient path as the chamber loss) and the bottom element into the stone (its link to the air counted as chamber to stone)
+ * - the lumped model with a direct stone measurement (estUpdateStone) every STONE_PERIOD_S seconds with STONE_NOISE_C of noise, like an IR thermometer
+ *
+ * Errors are split into the preheat (until the air first reaches the target), the door opening (while open and DOOR_RECOVERY_S after) and the rest of the bake. The stone rate is compared with the plant's stone change over the same 0.1 s. As a baseline, the bottom sensor itself (without its noise) is scored as a stone estimate. The host time of every estimator step is reported next to the errors; cycles on the STM32F303 come from the est.step case of oven_bench.
+ *
+ * While the door is open the air loses heat much faster than the model's chamber, which holds the walls' capacity too, so the element and chamber estimates are only judged outside the door opening.
+ *
+ * Usage: estimator_error [-v]
+ * Exit code: 0 - with both models (without the stone sensor) the stone estimate beat the bottom sensor in every part of the bake, the element and chamber RMS stayed within MAX_ELEMENT_RMS_C and MAX_CHAMBER_RMS_C outside the door opening and every step of every setup took under STEP_BUDGET_NS, 1 - something didn't
+ */
+
+#include "oven_control.h"
+#include "state_estimator.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define HALF_CYCLES_PER_EST     10      // 10 Hz estimator
+#define EST_DT_S                0.1f
+#define AMBIENT_C               22.0f
+#define BAKE_TIME_S             3600
+#define DOOR_S                  2400
+#define DOOR_OPEN_S             30
+#define DOOR_RECOVERY_S         120     // scored with the door opening after it closes
+#define BOTTOM_SENSOR_TAU_S     15.0f
+#define SENSOR_NOISE_C          0.5f
+#define STONE_PERIOD_S          5
+#define STONE_NOISE_C           2.0f
+#define NOISE_SEED              12345u
+#define MAX_ELEMENT_RMS_C       5.0f    // element estimate, preheat and rest
+#define MAX_CHAMBER_RMS_C       1.0f    // chamber estimate, preheat and rest
+#define STEP_BUDGET_NS          10e6    // a tenth of the 100 ms period for one step on this host
+
+#define PARTS                   3
+#define QUANTITIES              4       // stone, element, chamber, stone rate
+
+typedef struct ErrorStats_t {
+    double sumSquares;
+    float max;
+    uint32_t count;
+} ErrorStats_t;
+
+typedef struct RunResult_t {
+    const char* name;
+    ErrorStats_t error[PARTS][QUANTITIES];
+    ErrorStats_t sensorError[PARTS];    // bottom sensor as a stone estimate
+    double stepNs;                      // host time of estStep (and estUpdateStone when due), summed
+    double maxStepNs;
+    uint32_t steps;
+} RunResult_t;
+
+static const char* partNames[PARTS] = { "preheat", "rest", "door" };
+static const char* quantityNames[QUANTITIES] = { "stone[C]", "element[C]", "chamber[C]", "rate[C/s]" };
+static uint32_t noiseState;
+
+/* Helpers */
+
+// Standard normal numbers (Box-Muller over a 32-bit LCG)
+static float gaussian(void) {
+    noiseState = noiseState * 1664525u + 1013904223u;
+    float u1 = ((noiseState >> 8) + 1.0f) / 16777217.0f;
+    noiseState = noiseState * 1664525u + 1013904223u;
+    float u2 = (noiseState >> 8) / 16777216.0f;
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static void addError(ErrorStats_t* s, float error) {
+    float e = fabsf(error);
+    s->sumSquares += (double)(e * e);
+    s->count++;
+    if (e > s->max)
+        s->max = e;
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static float rms(const ErrorStats_t* s) {
+    return s->count ? (float)sqrt(s->sumSquares / s->count) : 0.0f;
+}
+
+static void lumpedModel(const PlantParams_t* p, EstModel_t* m) {
+    *m = estDefaultModel;
+    float airToWalls = 0.0f, wallsLoss = 0.0f, airLoss = 0.0f;
+    float topToAir = 0.0f, topToStone = 0.0f, airToStone = 0.0f, bottomToAir = 0.0f;
+    for (uint8_t l = 0; l < p->linkCount; l++) {
+        const PlantLink_t* link = &p->links[l];
+        if (link->a == PLANT_TOP_ELEMENT && link->b == PLANT_AIR)
+            topToAir = link->conductance;
+        else if (link->a == PLANT_TOP_ELEMENT && link->b == PLANT_STONE)
+            topToStone = link->conductance;
+        else if (link->a == PLANT_AIR && link->b == PLANT_STONE)
+            airToStone = link->conductance;
+        else if (link->a == PLANT_BOTTOM_ELEMENT && link->b == PLANT_AIR)
+            bottomToAir = link->conductance;
+        else if (link->a == PLANT_AIR && link->b == PLANT_WALLS)
+            airToWalls = link->conductance;
+        else if (link->a == PLANT_AIR && link->b == PLANT_AMBIENT)
+            airLoss = link->conductance;
+        else if (link->a == PLANT_WALLS && link->b == PLANT_AMBIENT)
+            wallsLoss = link->conductance;
+    }
+    m->topPower = p->topPower;
+    m->bottomPower = p->bottomPower;
+    m->elementCapacity = p->capacity[PLANT_TOP_ELEMENT];
+    m->chamberCapacity = p->capacity[PLANT_AIR] + p->capacity[PLANT_WALLS];
+    m->stoneCapacity = p->capacity[PLANT_STONE] + p->capacity[PLANT_BOTTOM_ELEMENT];
+    m->elementToChamber = topToAir;
+    m->elementToStone = topToStone;
+    m->chamberToStone = airToStone + bottomToAir;
+    m->chamberLoss = airLoss + airToWalls * wallsLoss / (airToWalls + wallsLoss);
+    m->stoneLoss = 0.0f;
+    m->topSensorTau = p->sensorTau;
+    m->bottomSensorTau = BOTTOM_SENSOR_TAU_S;
+}
+
+/* Runs */
+
+static void score(RunResult_t* r, uint8_t part, const EstState_t* e, const ThermalPlant_t* tp, float stoneRate, float bottomSensor) {
+    addError(&r->error[part][0], e->stone - tp->temperature[PLANT_STONE]);
+    addError(&r->error[part][1], e->element - tp->temperature[PLANT_TOP_ELEMENT]);
+    addError(&r->error[part][2], e->chamber - tp->temperature[PLANT_AIR]);
+    addError(&r->error[part][3], e->stoneRate - stoneRate);
+    addError(&r->sensorError[part], bottomSensor - tp->temperature[PLANT_STONE]);
+}
+
+static void run(const EstModel_t* model, bool stoneSensor, bool verbose, RunResult_t* r) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = ovenControlDefaultConfig;
+    occ.topPower = pp->topPower;
+    occ.bottomPower = pp->bottomPower;
+
+    static StateEstimator_t est;    // keeps CMSIS descriptors pointing into itself, so it's set up in place and never copied
+    OvenControl_t oc;
+    ThermalPlant_t tp;
+    ovenControlInit(&oc, &occ);
+    plantInit(&tp, pp, AMBIENT_C);
+    estInit(&est, model, EST_DT_S, AMBIENT_C);
+    ovenControlStart(&oc, &profilePizza, tp.sensor);
+    noiseState = NOISE_SEED;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    const float target = profilePizza.segments[0].target;
+    float bottomSensor = AMBIENT_C;
+    float lastStone = AMBIENT_C;
+    uint8_t part = 0;
+    uint32_t fired[HEATER_OUT_CHANNELS] = { 0 };
+    for (uint32_t t = 0; t < BAKE_TIME_S; t++) {
+        in.doorOpen = (t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S);
+        ovenControlStep(&oc, tp.sensor);
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = ovenControlHalfCycle(&oc);
+            fired[HEATER_TOP] += (in.heaters & HEATER_TOP_BIT) ? 1 : 0;
+            fired[HEATER_BOTTOM] += (in.heaters & HEATER_BOTTOM_BIT) ? 1 : 0;
+            plantStep(&tp, &in, HALF_CYCLE_S);
+            bottomSensor += (tp.temperature[PLANT_STONE] - bottomSensor) * HALF_CYCLE_S / BOTTOM_SENSOR_TAU_S;
+            if ((h + 1) % HALF_CYCLES_PER_EST != 0)
+                continue;
+
+            float duty[EST_NU] = { fired[HEATER_TOP] / (float)HALF_CYCLES_PER_EST, fired[HEATER_BOTTOM] / (float)HALF_CYCLES_PER_EST };
+            float measurement[EST_NY] = { tp.sensor + SENSOR_NOISE_C * gaussian(), bottomSensor + SENSOR_NOISE_C * gaussian() };
+            fired[HEATER_TOP] = 0;
+            fired[HEATER_BOTTOM] = 0;
+            bool stoneDue = stoneSensor && h + 1 == HALF_CYCLES_PER_TICK && t % STONE_PERIOD_S == 0;
+            float stone = stoneDue ? tp.temperature[PLANT_STONE] + STONE_NOISE_C * gaussian() : 0.0f;
+            double start = nowNs();
+            estStep(&est, duty, measurement);
+            if (stoneDue)
+                estUpdateStone(&est, stone);
+            double stepNs = nowNs() - start;
+            r->stepNs += stepNs;
+            r->steps++;
+            if (stepNs > r->maxStepNs)
+                r->maxStepNs = stepNs;
+
+            EstState_t e;
+            estGetState(&est, &e);
+            float stoneRate = (tp.temperature[PLANT_STONE] - lastStone) / EST_DT_S;
+            lastStone = tp.temperature[PLANT_STONE];
+            if (part == 0 && tp.temperature[PLANT_AIR] >= target)
+                part = 1;
+            bool door = t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S + DOOR_RECOVERY_S;
+            score(r, door ? 2 : part, &e, &tp, stoneRate, bottomSensor);
+            if (verbose && h + 1 == HALF_CYCLES_PER_TICK && t % 30 == 0)
+                printf("%s,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.4f,%.4f\n", r->name, t, tp.temperature[PLANT_STONE], e.stone, tp.temperature[PLANT_TOP_ELEMENT],
+                    e.element, tp.temperature[PLANT_AIR], e.chamber, stoneRate, e.stoneRate);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    EstModel_t lumped;
+    lumpedModel(&plantDefaultParams, &lumped);
+
+    RunResult_t results[] = {
+        { .name = "default model" },
+        { .name = "lumped plant model" },
+        { .name = "lumped + stone sensor" },
+    };
+    if (verbose)
+        printf("model,t,stone,est stone,element,est element,air,est chamber,stone rate,est stone rate\n");
+    run(&estDefaultModel, false, verbose, &results[0]);
+    run(&lumped, false, verbose, &results[1]);
+    run(&lumped, true, verbose, &results[2]);
+
+    printf("pizza bake, %u s, door open %u s at %u s, estimator at %.0f Hz\n", BAKE_TIME_S, DOOR_OPEN_S, DOOR_S, 1.0f / EST_DT_S);
+    printf("%-22s %-8s", "estimator", "part");
+    for (uint8_t q = 0; q < QUANTITIES; q++)
+        printf(" %20s", quantityNames[q]);
+    printf(" %20s", "step[us]");
+    printf("\n%-31s", "");
+    for (uint8_t q = 0; q < QUANTITIES; q++)
+        printf(" %10s %9s", "RMS", "max");
+    printf(" %10s %9s\n", "mean", "max");
+    for (uint8_t m = 0; m < sizeof(results) / sizeof(results[0]); m++) {
+        for (uint8_t p = 0; p < PARTS; p++) {
+            printf("%-22s %-8s", p == 0 ? results[m].name : "", partNames[p]);
+            for (uint8_t q = 0; q < QUANTITIES; q++)
+                printf(" %10.3f %9.3f", rms(&results[m].error[p][q]), results[m].error[p][q].max);
+            if (p == 0)
+                printf(" %10.2f %9.2f", results[m].stepNs / results[m].steps * 1e-3, results[m].maxStepNs * 1e-3);
+            printf("\n");
+        }
+    }
+    for (uint8_t p = 0; p < PARTS; p++)
+        printf("%-22s %-8s %10.3f %9.3f\n", p == 0 ? "bottom sensor" : "", partNames[p], rms(&results[0].sensorError[p]), results[0].sensorError[p].max);
+
+    // both models without the stone sensor: stone better than the bottom sensor throughout, element and chamber within their bounds outside the door opening
+    bool ok = true;
+    for (uint8_t m = 0; m < 2; m++) {
+        for (uint8_t p = 0; p < PARTS; p++) {
+            ok &= rms(&results[m].error[p][0]) < rms(&results[m].sensorError[p]);
+            if (p == 2)
+                continue;
+            ok &= rms(&results[m].error[p][1]) < MAX_ELEMENT_RMS_C;
+            ok &= rms(&results[m].error[p][2]) < MAX_CHAMBER_RMS_C;
+        }
+    }
+    // every step within the 10 Hz period, with the rest of the control loop still to run
+    for (uint8_t m = 0; m < sizeof(results) / sizeof(results[0]); m++)
+        ok &= results[m].maxStepNs < STEP_BUDGET_NS;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
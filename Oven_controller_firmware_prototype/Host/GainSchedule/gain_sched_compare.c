@@ -0,0 +1,290 @@
+/**
+ * @file gain_sched_compare.c
+ * @brief Checks the gain scheduler's table lookup and runs the scheduled PID across setpoint steps from 50 to 500 degC on the radiating plant, against the firmware's fixed gains.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Lookup checks, on gainDefaultTable and on a small table with distinct kp, ki and kd slopes:
+ * - at every breakpoint the lookup returns the breakpoint's gains
+ * - halfway between two breakpoints it returns their mean, and within a segment it stays between its ends
+ * - below the first and above the last breakpoint it returns the first and the last gains
+ * - sweeping the temperature in SWEEP_STEP_C steps, no step changes a gain by more than the steepest segment's slope allows (no jump at the breakpoints or at the clamps)
+ *
+ * Tracking: the plant is the radiating copy gain_sweep identified the table on (the elements radiate onto the stone, matched to the linear conductances at RADIATION_MATCH_C). The setpoint steps through the levels in setpoints[], each held for STEP_S, and every step is scored: the RMS error of the air, the overshoot beyond the new setpoint and the settling time (+-BAND_C). Loops:
+ * - the firmware's fixed gains (ovenControlDefaultConfig)
+ * - the scheduler on the setpoint
+ * - the scheduler on the measurement
+ *
+ * Output continuity: before every step of the scheduled runs, copies of the PID take one step on the previous setpoint, one with the previous gains and one with the new gains applied through pidSetGains (as gainSchedStep does). Their difference is what the gain change alone did to the output; a setpoint step moves the output by itself. It's reported next to the same difference for the new gains assigned without pidSetGains' compensation.
+ *
+ * Usage: gain_sched_compare [-v]
+ * Exit code: 0 - every lookup check held, the scheduled outputs never moved more than MAX_GAIN_JUMP through a gain change, and both scheduled loops settled every step with an RMS error, overshoot and settling time no worse than the fixed gains', 1 - something didn't
+ */
+
+#include "gain_scheduler.h"
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define KELVIN                  273.15f
+#define RADIATION_MATCH_C       450.0f  // as in gain_sweep
+
+#define STEP_S                  5400
+#define BAND_C                  2.0f
+
+#define SWEEP_FROM_C            0.0f
+#define SWEEP_TO_C              600.0f
+#define SWEEP_STEP_C            0.01f
+#define LOOKUP_TOLERANCE        1e-6f   // relative
+#define MAX_GAIN_JUMP           0.01f   // duty, one half-cycle of the 100 per control period
+
+#define LOOPS                   3
+
+typedef struct LoopResult_t {
+    const char* name;
+    double squares;
+    uint32_t ticks;
+    float overshoot;            // worst over the steps [degC]
+    float settling;             // worst over the steps that settled [s]
+    bool allSettled;
+    float gainJump;             // largest output change caused by a gain change (scheduled loops)
+    float directJump;           // the same without pidSetGains' compensation
+} LoopResult_t;
+
+// 50 - 500 degC up in uneven steps, then back down to where the oven still cools within a step
+static const float setpoints[] = { 50.0f, 150.0f, 200.0f, 300.0f, 350.0f, 450.0f, 500.0f, 400.0f, 250.0f };
+
+static const PIDGains_t smallGains[] = {
+    { .kp = 1.0f, .ki = 0.1f, .kd = 0.0f },
+    { .kp = 2.0f, .ki = 0.1f, .kd = 0.5f },
+    { .kp = 0.5f, .ki = 0.4f, .kd = 0.5f },
+};
+static const GainTable_t smallTable = GAIN_TABLE(100.0f, 25.0f, smallGains);
+
+static PlantParams_t radiatingParams;
+
+/* Lookup */
+
+static bool near(float a, float b) {
+    return fabsf(a - b) <= LOOKUP_TOLERANCE * fmaxf(fmaxf(fabsf(a), fabsf(b)), 1e-9f);
+}
+
+static bool sameGains(PIDGains_t a, PIDGains_t b) {
+    return near(a.kp, b.kp) && near(a.ki, b.ki) && near(a.kd, b.kd);
+}
+
+static bool between(float x, float a, float b) {
+    float slack = LOOKUP_TOLERANCE * fmaxf(fabsf(a), fabsf(b));
+    return x >= fminf(a, b) - slack && x <= fmaxf(a, b) + slack;
+}
+
+static uint32_t checkTable(const char* name, const GainTable_t* table) {
+    uint32_t failures = 0;
+    float spacing = 1.0f / table->invSpacing;
+    float last = table->x1 + spacing * (table->count - 1);
+
+    for (uint8_t i = 0; i < table->count; i++)
+        failures += !sameGains(gainSchedLookup(table, table->x1 + spacing * i), table->gains[i]);
+
+    for (uint8_t i = 0; i + 1 < table->count; i++) {
+        const PIDGains_t* g0 = &table->gains[i];
+        const PIDGains_t* g1 = &table->gains[i + 1];
+        PIDGains_t mid = { (g0->kp + g1->kp) / 2.0f, (g0->ki + g1->ki) / 2.0f, (g0->kd + g1->kd) / 2.0f };
+        failures += !sameGains(gainSchedLookup(table, table->x1 + spacing * (i + 0.5f)), mid);
+        for (float f = 0.1f; f < 1.0f; f += 0.2f) {
+            PIDGains_t g = gainSchedLookup(table, table->x1 + spacing * (i + f));
+            failures += !between(g.kp, g0->kp, g1->kp) || !between(g.ki, g0->ki, g1->ki) || !between(g.kd, g0->kd, g1->kd);
+        }
+    }
+
+    const float below[] = { table->x1 - 0.001f, table->x1 - spacing, -273.0f };
+    const float above[] = { last + 0.001f, last + spacing, 2000.0f };
+    for (uint8_t i = 0; i < 3; i++) {
+        failures += !sameGains(gainSchedLookup(table, below[i]), table->gains[0]);
+        failures += !sameGains(gainSchedLookup(table, above[i]), table->gains[table->count - 1]);
+    }
+
+    // continuity: no sweep step may change a gain more than the steepest segment allows over it
+    PIDGains_t maxSlope = { 0 };
+    for (uint8_t i = 0; i + 1 < table->count; i++) {
+        maxSlope.kp = fmaxf(maxSlope.kp, fabsf(table->gains[i + 1].kp - table->gains[i].kp) * table->invSpacing);
+        maxSlope.ki = fmaxf(maxSlope.ki, fabsf(table->gains[i + 1].ki - table->gains[i].ki) * table->invSpacing);
+        maxSlope.kd = fmaxf(maxSlope.kd, fabsf(table->gains[i + 1].kd - table->gains[i].kd) * table->invSpacing);
+    }
+    PIDGains_t prev = gainSchedLookup(table, SWEEP_FROM_C);
+    float worst = 0.0f;     // largest step relative to the allowed one
+    uint32_t steps = (uint32_t)((SWEEP_TO_C - SWEEP_FROM_C) / SWEEP_STEP_C);
+    for (uint32_t s = 1; s <= steps; s++) {
+        float x = SWEEP_FROM_C + SWEEP_STEP_C * s;
+        PIDGains_t g = gainSchedLookup(table, x);
+        // a float temperature step is SWEEP_STEP_C plus the rounding of x
+        float dx = SWEEP_STEP_C + 2.0f * x * 1.2e-7f;
+        const float d[3] = { fabsf(g.kp - prev.kp), fabsf(g.ki - prev.ki), fabsf(g.kd - prev.kd) };
+        const float allowed[3] = { maxSlope.kp * dx, maxSlope.ki * dx, maxSlope.kd * dx };
+        const float scale[3] = { fabsf(g.kp), fabsf(g.ki), fabsf(g.kd) };
+        for (uint8_t k = 0; k < 3; k++) {
+            float limit = allowed[k] + LOOKUP_TOLERANCE * scale[k];
+            if (d[k] > limit)
+                failures++;
+            if (limit > 0.0f && d[k] / limit > worst)
+                worst = d[k] / limit;
+        }
+        prev = g;
+    }
+    printf("lookup %-14s %2u breakpoints %5.0f - %5.0f degC: %s, largest sweep step %.2f of the allowed\n", name, table->count, table->x1, last, failures ? "FAIL" : "ok",
+        worst);
+    return failures;
+}
+
+/* Tracking */
+
+// Replaces the linearised element-stone conductances with radiation that has the same slope at RADIATION_MATCH_C
+static void makeRadiating(const PlantParams_t* p, PlantParams_t* r) {
+    *r = *p;
+    float k = RADIATION_MATCH_C + KELVIN;
+    for (uint8_t l = 0; l < r->linkCount; l++) {
+        PlantLink_t* link = &r->links[l];
+        bool element = (link->a == PLANT_TOP_ELEMENT || link->a == PLANT_BOTTOM_ELEMENT);
+        if (element && link->b == PLANT_STONE) {
+            link->radiation = link->conductance / (4.0f * k * k * k);
+            link->conductance = 0.0f;
+        }
+    }
+}
+
+static void heatersInit(PowerSplitter_t* split, HeaterOutput_t* ho) {
+    const PlantParams_t* pp = &radiatingParams;
+    psplitInit(split, pp->topPower, pp->bottomPower, 0.5f);
+    heaterOutInit(ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, ovenControlDefaultConfig.currentCap);
+}
+
+static void applyDemand(const PowerSplitter_t* split, HeaterOutput_t* ho, float demand) {
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(split, (uint16_t)(demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutSetDutyQ15(ho, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+}
+
+// gainSchedStep, plus how much the gain change alone moves the output: copies of the PID are stepped on the previous setpoint (a setpoint step moves the output anyway) with the old gains, with the new ones through pidSetGains like gainSchedStep applies them, and with the new ones assigned directly
+static float scheduledStep(GainScheduler_t* gs, float setpoint, float lastSetpoint, float measurement, LoopResult_t* r) {
+    float x = (gs->variable == GAIN_SCHED_ON_SETPOINT) ? setpoint : measurement;
+    PIDGains_t gains = gainSchedLookup(gs->table, x);
+    PIDController_t held = *gs->pid;
+    PIDController_t bumpless = *gs->pid;
+    PIDController_t direct = *gs->pid;
+    pidSetGains(&bumpless, gains);
+    direct.gains = gains;
+    float heldOut = pidStep(&held, lastSetpoint, measurement);
+    float jump = fabsf(pidStep(&bumpless, lastSetpoint, measurement) - heldOut);
+    float directJump = fabsf(pidStep(&direct, lastSetpoint, measurement) - heldOut);
+    if (jump > r->gainJump)
+        r->gainJump = jump;
+    if (directJump > r->directJump)
+        r->directJump = directJump;
+    return gainSchedStep(gs, setpoint, measurement);
+}
+
+static void run(int8_t variable, bool verbose, LoopResult_t* r) {
+    const OvenControlConfig_t* occ = &ovenControlDefaultConfig;
+    PIDController_t pid;
+    GainScheduler_t gs;
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    pidInit(&pid, occ->gains, occ->dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, occ->derivativeFilter);
+    if (variable >= 0)
+        gainSchedInit(&gs, &pid, &gainDefaultTable, (GainSchedVariable_t)variable, AMBIENT_C);
+    heatersInit(&split, &ho);
+    plantInit(&tp, &radiatingParams, AMBIENT_C);
+    r->allSettled = true;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    const uint8_t steps = sizeof(setpoints) / sizeof(setpoints[0]);
+    float from = AMBIENT_C;
+    float lastSetpoint = setpoints[0];
+    for (uint8_t s = 0; s < steps; s++) {
+        float setpoint = setpoints[s];
+        float lastOutside = 0.0f;
+        float overshoot = 0.0f;
+        for (uint32_t t = 0; t < STEP_S; t++) {
+            float demand = (variable >= 0) ? scheduledStep(&gs, setpoint, lastSetpoint, tp.sensor, r) : pidStep(&pid, setpoint, tp.sensor);
+            lastSetpoint = setpoint;
+            applyDemand(&split, &ho, demand);
+            for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+                in.heaters = heaterOutNextHalfCycle(&ho);
+                plantStep(&tp, &in, HALF_CYCLE_S);
+            }
+
+            float err = tp.temperature[PLANT_AIR] - setpoint;
+            if (fabsf(err) > BAND_C)
+                lastOutside = (float)(t + 1);
+            float beyond = (setpoint > from) ? err : -err;
+            if (beyond > overshoot)
+                overshoot = beyond;
+            r->squares += (double)(err * err);
+            r->ticks++;
+            if (verbose && t % 30 == 0)
+                printf("%s,%u,%.0f,%.2f,%.3f,%.4f,%.6f\n", r->name, s * STEP_S + t, setpoint, tp.temperature[PLANT_AIR], demand, pid.gains.kp, pid.gains.ki);
+        }
+        if (lastOutside >= STEP_S)
+            r->allSettled = false;
+        else if (lastOutside > r->settling)
+            r->settling = lastOutside;
+        if (overshoot > r->overshoot)
+            r->overshoot = overshoot;
+        from = setpoint;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    makeRadiating(&plantDefaultParams, &radiatingParams);
+
+    uint32_t failures = checkTable("default table", &gainDefaultTable);
+    failures += checkTable("small table", &smallTable);
+
+    LoopResult_t results[LOOPS] = {
+        { .name = "fixed gains" },
+        { .name = "on setpoint" },
+        { .name = "on measurement" },
+    };
+    if (verbose)
+        printf("loop,t,setpoint,air,demand,kp,ki\n");
+    run(-1, verbose, &results[0]);
+    run(GAIN_SCHED_ON_SETPOINT, verbose, &results[1]);
+    run(GAIN_SCHED_ON_MEASUREMENT, verbose, &results[2]);
+
+    printf("radiating plant matched at %.0f degC, setpoint", RADIATION_MATCH_C);
+    for (uint8_t s = 0; s < sizeof(setpoints) / sizeof(setpoints[0]); s++)
+        printf(" %.0f", setpoints[s]);
+    printf(" degC, %u s each, band +-%.0f degC\n", STEP_S, BAND_C);
+    printf("%-15s %9s %13s %11s %14s %14s\n", "loop", "RMS[C]", "overshoot[C]", "settled[s]", "gain jump", "direct jump");
+    for (uint8_t l = 0; l < LOOPS; l++) {
+        const LoopResult_t* r = &results[l];
+        printf("%-15s %9.2f %13.2f", r->name, sqrt(r->squares / r->ticks), r->overshoot);
+        if (r->allSettled)
+            printf(" %11.0f", r->settling);
+        else
+            printf(" %11s", "-");
+        if (l > 0)
+            printf(" %14.6f %14.6f\n", r->gainJump, r->directJump);
+        else
+            printf(" %14s %14s\n", "-", "-");
+    }
+
+    const LoopResult_t* fixed = &results[0];
+    bool ok = failures == 0;
+    for (uint8_t l = 1; l < LOOPS; l++) {
+        const LoopResult_t* r = &results[l];
+        ok &= r->allSettled && r->gainJump <= MAX_GAIN_JUMP;
+        ok &= r->squares / r->ticks <= fixed->squares / fixed->ticks && r->overshoot <= fixed->overshoot && r->settling <= fixed->settling;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
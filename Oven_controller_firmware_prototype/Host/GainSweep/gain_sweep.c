@@ -0,0 +1,168 @@
+/**
+ * @file gain_sweep.c
+ * @brief Sweeps the setpoint over the gain scheduler's breakpoints on the thermal plant, identifies a first-order model at each one and prints the PID gains for gain_scheduler.c's default table.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The default plant is linear, so it would give the same model at every temperature. The sweep runs a copy of it where the elements radiate onto the stone (T^4 in kelvin) instead of the linearised conductances, with the coefficients matching them at RADIATION_MATCH_C. At every breakpoint:
+ * - the firmware's PID (ovenControlDefaultConfig) holds the setpoint for HOLD_S, the demand is averaged over the last HOLD_AVERAGE_S
+ * - two copies of the plant continue open loop from there, one at the average demand and one ID_STEP above it. Their difference is the step response, without the drift of the slow nodes.
+ * - gain, time constant and apparent dead time come from the response within ID_WINDOW_S (the 28.3 % and 63.2 % times, two-point method)
+ * - kp and ki follow the SIMC rules for a closed-loop time constant of LAMBDA_S: kp = tau / (gain * (lambda + deadTime)), ki = kp / min(tau, 4 * (lambda + deadTime))
+ * - kd keeps the firmware's derivative time (kd / kp of ovenControlDefaultConfig), which damps the sensor lag the first-order model leaves out
+ *
+ * The heaters are driven through the power splitter and the joint modulator like oven_control. The last lines of the output are the table in gain_scheduler.c's format.
+ *
+ * Usage: gain_sweep
+ * Exit code: 0 - every breakpoint was identified (positive gain and time constant), 1 - one wasn't
+ */
+
+#include "gain_scheduler.h"
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define KELVIN                  273.15f
+
+#define FIRST_C                 50.0f   // gainDefaultTable's breakpoints
+#define SPACING_C               50.0f
+#define BREAKPOINTS             10
+
+#define RADIATION_MATCH_C       450.0f
+#define HOLD_S                  14400
+#define HOLD_AVERAGE_S          3600
+#define ID_STEP                 0.05f
+#define ID_WINDOW_S             600
+#define LAMBDA_S                15.0f
+
+typedef struct SweepPoint_t {
+    float setpoint;             // [degC]
+    float demand;               // holding demand (0.0 - 1.0)
+    float gain;                 // [degC / full demand]
+    float tau;                  // [s]
+    float deadTime;             // [s]
+    PIDGains_t gains;
+} SweepPoint_t;
+
+/* Plant */
+
+static PlantParams_t radiatingParams;
+
+// Replaces the linearised element-stone conductances with radiation that has the same slope at RADIATION_MATCH_C
+static void makeRadiating(const PlantParams_t* p, PlantParams_t* r) {
+    *r = *p;
+    float k = RADIATION_MATCH_C + KELVIN;
+    for (uint8_t l = 0; l < r->linkCount; l++) {
+        PlantLink_t* link = &r->links[l];
+        bool element = (link->a == PLANT_TOP_ELEMENT || link->a == PLANT_BOTTOM_ELEMENT);
+        if (element && link->b == PLANT_STONE) {
+            link->radiation = link->conductance / (4.0f * k * k * k);
+            link->conductance = 0.0f;
+        }
+    }
+}
+
+/* Helpers */
+
+static void heatersInit(PowerSplitter_t* split, HeaterOutput_t* ho) {
+    const PlantParams_t* pp = &radiatingParams;
+    psplitInit(split, pp->topPower, pp->bottomPower, 0.5f);
+    heaterOutInit(ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, ovenControlDefaultConfig.currentCap);
+}
+
+static void applyDemand(const PowerSplitter_t* split, HeaterOutput_t* ho, float demand) {
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(split, (uint16_t)(demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutSetDutyQ15(ho, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+}
+
+static void tick(ThermalPlant_t* tp, HeaterOutput_t* ho, PlantInputs_t* in) {
+    for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+        in->heaters = heaterOutNextHalfCycle(ho);
+        plantStep(tp, in, HALF_CYCLE_S);
+    }
+}
+
+/* Sweep */
+
+static bool identify(SweepPoint_t* sp) {
+    PIDController_t pid;
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    pidInit(&pid, ovenControlDefaultConfig.gains, ovenControlDefaultConfig.dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&pid, ovenControlDefaultConfig.derivativeFilter);
+    heatersInit(&split, &ho);
+    plantInit(&tp, &radiatingParams, AMBIENT_C);
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    double sum = 0.0;
+    for (uint32_t t = 0; t < HOLD_S; t++) {
+        float demand = pidStep(&pid, sp->setpoint, tp.sensor);
+        if (t >= HOLD_S - HOLD_AVERAGE_S)
+            sum += demand;
+        applyDemand(&split, &ho, demand);
+        tick(&tp, &ho, &in);
+    }
+    sp->demand = (float)(sum / HOLD_AVERAGE_S);
+
+    // the modulators continue from the same phase, so the difference is only the step
+    ThermalPlant_t stepped = tp;
+    HeaterOutput_t steppedHo = ho;
+    PlantInputs_t steppedIn = in;
+    applyDemand(&split, &ho, sp->demand);
+    applyDemand(&split, &steppedHo, sp->demand + ID_STEP);
+    static float rise[ID_WINDOW_S];
+    for (uint32_t t = 0; t < ID_WINDOW_S; t++) {
+        tick(&tp, &ho, &in);
+        tick(&stepped, &steppedHo, &steppedIn);
+        rise[t] = stepped.sensor - tp.sensor;
+    }
+
+    float final = rise[ID_WINDOW_S - 1];
+    float t28 = 0.0f, t63 = 0.0f;
+    for (uint32_t t = ID_WINDOW_S; t-- > 0;) {
+        if (rise[t] >= 0.283f * final)
+            t28 = (float)(t + 1);
+        if (rise[t] >= 0.632f * final)
+            t63 = (float)(t + 1);
+    }
+    sp->gain = final / ID_STEP;
+    sp->tau = 1.5f * (t63 - t28);
+    sp->deadTime = fmaxf(t63 - sp->tau, 0.0f);
+    if (sp->gain <= 0.0f || sp->tau <= 0.0f)
+        return false;
+
+    float closedLoop = LAMBDA_S + sp->deadTime;
+    sp->gains.kp = sp->tau / (sp->gain * closedLoop);
+    sp->gains.ki = sp->gains.kp / fminf(sp->tau, 4.0f * closedLoop);
+    sp->gains.kd = sp->gains.kp * ovenControlDefaultConfig.gains.kd / ovenControlDefaultConfig.gains.kp;
+    return true;
+}
+
+int main(void) {
+    makeRadiating(&plantDefaultParams, &radiatingParams);
+    SweepPoint_t points[BREAKPOINTS];
+    bool ok = true;
+    printf("radiating plant matched at %.0f degC, %.2f demand step, %u s window, lambda %.0f s\n", RADIATION_MATCH_C, ID_STEP, ID_WINDOW_S, LAMBDA_S);
+    printf("%11s %8s %14s %8s %12s %9s %10s\n", "setpoint[C]", "demand", "gain[C/duty]", "tau[s]", "dead time[s]", "kp", "ki");
+    for (uint8_t i = 0; i < BREAKPOINTS; i++) {
+        SweepPoint_t* sp = &points[i];
+        memset(sp, 0, sizeof(*sp));
+        sp->setpoint = FIRST_C + SPACING_C * i;
+        ok &= identify(sp);
+        printf("%11.0f %8.3f %14.1f %8.1f %12.1f %9.4f %10.6f\n", sp->setpoint, sp->demand, sp->gain, sp->tau, sp->deadTime, sp->gains.kp, sp->gains.ki);
+    }
+
+    printf("\nstatic const PIDGains_t defaultGains[] = {\n");
+    for (uint8_t i = 0; i < BREAKPOINTS; i++)
+        printf("    { .kp = %.4ff, .ki = %.6ff, .kd = %.3ff },  // %3.0f degC\n", points[i].gains.kp, points[i].gains.ki, points[i].gains.kd, points[i].setpoint);
+    printf("};\n");
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
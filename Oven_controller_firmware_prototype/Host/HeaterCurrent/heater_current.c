@@ -0,0 +1,269 @@
+/**
+ * @file heater_current.c
+ * @brief Compares the mains current of the joint heater modulator with naive independent scheduling of the two SSRs: a duty sweep and a complete bake on the thermal plant.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Naive scheduling runs one modulator per channel, each knowing nothing about the other, so both elements fire together whenever their patterns happen to line up. It uses heater_output itself with a single channel per instance, so the two schedulers differ only in the joint planning.
+ *
+ * The elements are resistive and the SSRs switch at zero crossings, so in every half-cycle the mains carries a whole half-sine with the summed RMS current of the elements that are on. That sum is the half-cycle's current below, the peak is its maximum and the RMS over a window is the root mean square of the half-cycle currents.
+ *
+ * - Sweep: every pair of duties from 0 to 1 in steps of 0.1, HALF_CYCLES half-cycles each from a fresh modulator. Checks that the joint modulator never exceeds the cap and that each channel gets the duty the modulator reports (heaterOutGetDuty), i.e. what was requested unless it had to be scaled down, and never fires at all with a zero duty.
+ * - Bakes: both programs on the thermal plant through the firmware's control loop with the cap, and the same loop with the naive scheduler and no cap. Reports the peak current, the highest RMS over one second, the RMS over the whole bake and the time it took to reach the first target. Under a cap that only lets one element on at a time the preheat gets slower, at 450 degC the capped oven may not get there at all.
+ *
+ * Usage: heater_current [-c cap A] [-v]
+ * Exit code: 0 - the joint modulator stayed under the cap and delivered the duties, 1 - it didn't, 2 - bad arguments
+ */
+
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#define MAINS_VOLTAGE           230.0f
+#define DEFAULT_CAP_A           10.0f   // a shared 10 A circuit: either element fits, both together (11.7 A) don't
+#define HALF_CYCLES             2000    // per duty pair (20 s of 50 Hz mains)
+#define SWEEP_STEPS             10
+#define DUTY_TOLERANCE          0.002f  // a few half-cycles in HALF_CYCLES
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define WINDOW                  100     // half-cycles in the RMS window (1 s)
+#define BAKE_TIME_S             3600
+#define AMBIENT_C               22.0f
+
+typedef struct CurrentStats_t {
+    float peak;                 // [A]
+    double sumSquares;          // [A^2], over all half-cycles
+    uint32_t halfCycles;
+    float windowSquares[WINDOW];
+    double windowSum;
+    float maxWindowRms;         // [A]
+} CurrentStats_t;
+
+static float elementCurrent[HEATER_OUT_CHANNELS];
+
+/* Schedulers */
+
+typedef struct NaiveScheduler_t {
+    HeaterOutput_t channel[HEATER_OUT_CHANNELS];    // one single-channel modulator per heater
+} NaiveScheduler_t;
+
+static void naiveInit(NaiveScheduler_t* ns) {
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+        heaterOutInit(&ns->channel[ch], elementCurrent[ch], 0.0f, elementCurrent[ch]);
+}
+
+static void naiveSetDuty(NaiveScheduler_t* ns, const uint16_t duty[HEATER_OUT_CHANNELS]) {
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+        heaterOutSetDutyQ15(&ns->channel[ch], duty[ch], 0);
+}
+
+static uint8_t naiveNextHalfCycle(NaiveScheduler_t* ns) {
+    uint8_t mask = 0;
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+        if (heaterOutNextHalfCycle(&ns->channel[ch]) & HEATER_TOP_BIT)
+            mask |= (uint8_t)(1 << ch);
+    return mask;
+}
+
+/* Current statistics */
+
+static void statsAdd(CurrentStats_t* s, uint8_t mask) {
+    float amps = 0.0f;
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+        if (mask & (1 << ch))
+            amps += elementCurrent[ch];
+    float squares = amps * amps;
+    if (amps > s->peak)
+        s->peak = amps;
+    s->sumSquares += squares;
+
+    uint32_t w = s->halfCycles % WINDOW;
+    s->windowSum += squares - s->windowSquares[w];
+    s->windowSquares[w] = squares;
+    s->halfCycles++;
+    if (s->halfCycles >= WINDOW) {
+        float rms = sqrtf((float)(s->windowSum / WINDOW));
+        if (rms > s->maxWindowRms)
+            s->maxWindowRms = rms;
+    }
+}
+
+static float statsRms(const CurrentStats_t* s) {
+    return s->halfCycles ? sqrtf((float)(s->sumSquares / s->halfCycles)) : 0.0f;
+}
+
+/* Duty sweep */
+
+static bool sweep(float cap, bool verbose) {
+    float worstPeak[2] = { 0.0f, 0.0f };   // joint, naive
+    float worstRms[2] = { 0.0f, 0.0f };
+    float worstDutyError = 0.0f;
+    float rmsGain = 0.0f;               // largest RMS reduction of the joint modulator
+    float rmsGainAt[HEATER_OUT_CHANNELS] = { 0.0f, 0.0f };
+    uint32_t overCap = 0, wrongDuty = 0;
+
+    if (verbose)
+        printf("  top bottom  delivered top/bottom  peak joint/naive [A]  RMS joint/naive [A]\n");
+    for (uint8_t i = 0; i <= SWEEP_STEPS; i++) {
+        for (uint8_t j = 0; j <= SWEEP_STEPS; j++) {
+            uint16_t duty[HEATER_OUT_CHANNELS] = {
+                (uint16_t)(i * HEATER_OUT_DUTY_ONE / SWEEP_STEPS),
+                (uint16_t)(j * HEATER_OUT_DUTY_ONE / SWEEP_STEPS),
+            };
+            HeaterOutput_t joint;
+            NaiveScheduler_t naive;
+            heaterOutInit(&joint, elementCurrent[HEATER_TOP], elementCurrent[HEATER_BOTTOM], cap);
+            heaterOutSetDutyQ15(&joint, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+            naiveInit(&naive);
+            naiveSetDuty(&naive, duty);
+
+            CurrentStats_t stats[2];
+            memset(stats, 0, sizeof(stats));
+            uint32_t fired[HEATER_OUT_CHANNELS] = { 0, 0 };
+            for (uint32_t h = 0; h < HALF_CYCLES; h++) {
+                uint8_t mask = heaterOutNextHalfCycle(&joint);
+                for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+                    fired[ch] += (mask >> ch) & 1;
+                statsAdd(&stats[0], mask);
+                statsAdd(&stats[1], naiveNextHalfCycle(&naive));
+            }
+
+            float delivered[HEATER_OUT_CHANNELS];
+            for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+                delivered[ch] = (float)fired[ch] / HALF_CYCLES;
+                float err = fabsf(delivered[ch] - heaterOutGetDuty(&joint, (HeaterChannel_t)ch));
+                if (err > worstDutyError)
+                    worstDutyError = err;
+                if (err > DUTY_TOLERANCE || (joint.duty[ch] == 0 && fired[ch] > 0))
+                    wrongDuty++;
+            }
+            if (stats[0].peak > cap)
+                overCap++;
+            for (uint8_t k = 0; k < 2; k++) {
+                if (stats[k].peak > worstPeak[k])
+                    worstPeak[k] = stats[k].peak;
+                if (statsRms(&stats[k]) > worstRms[k])
+                    worstRms[k] = statsRms(&stats[k]);
+            }
+            if (statsRms(&stats[1]) - statsRms(&stats[0]) > rmsGain) {
+                rmsGain = statsRms(&stats[1]) - statsRms(&stats[0]);
+                rmsGainAt[HEATER_TOP] = i * 0.1f;
+                rmsGainAt[HEATER_BOTTOM] = j * 0.1f;
+            }
+            if (verbose)
+                printf("  %3.1f  %3.1f   %9.3f / %-9.3f   %8.2f / %-8.2f     %7.2f / %-7.2f\n", i * 0.1f, j * 0.1f,
+                    delivered[HEATER_TOP], delivered[HEATER_BOTTOM], stats[0].peak, stats[1].peak, statsRms(&stats[0]), statsRms(&stats[1]));
+        }
+    }
+
+    uint32_t pairs = (SWEEP_STEPS + 1) * (SWEEP_STEPS + 1);
+    printf("sweep: %u duty pairs, %u half-cycles each\n", pairs, HALF_CYCLES);
+    printf("  highest peak current:    joint %5.2f A, naive %5.2f A\n", worstPeak[0], worstPeak[1]);
+    printf("  highest RMS current:     joint %5.2f A, naive %5.2f A\n", worstRms[0], worstRms[1]);
+    printf("  largest RMS reduction:   %5.2f A (top %.1f, bottom %.1f)\n", rmsGain, rmsGainAt[HEATER_TOP], rmsGainAt[HEATER_BOTTOM]);
+    printf("  pairs over the cap:      %u\n", overCap);
+    printf("  largest duty error:      %.4f (%u channels over %.3f)\n", worstDutyError, wrongDuty, DUTY_TOLERANCE);
+    return overCap == 0 && wrongDuty == 0;
+}
+
+/* Bake */
+
+typedef struct BakeResult_t {
+    CurrentStats_t current;
+    float preheatTime;          // [s], NAN if the first target wasn't reached
+    double energy;              // [kWh]
+} BakeResult_t;
+
+static void bake(const BakeProgram_t* program, float cap, bool naiveScheduling, BakeResult_t* r) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = ovenControlDefaultConfig;
+    occ.topPower = pp->topPower;
+    occ.bottomPower = pp->bottomPower;
+    occ.topCurrent = elementCurrent[HEATER_TOP];
+    occ.bottomCurrent = elementCurrent[HEATER_BOTTOM];
+    // the naive scheduler doesn't know about the cap, its loop must not scale the duties either
+    occ.currentCap = naiveScheduling ? elementCurrent[HEATER_TOP] + elementCurrent[HEATER_BOTTOM] : cap;
+
+    OvenControl_t oc;
+    ThermalPlant_t tp;
+    NaiveScheduler_t naive;
+    ovenControlInit(&oc, &occ);
+    plantInit(&tp, pp, AMBIENT_C);
+    naiveInit(&naive);
+    ovenControlStart(&oc, program, tp.sensor);
+    memset(r, 0, sizeof(*r));
+    r->preheatTime = NAN;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    const float target = program->segments[0].target;
+    for (uint32_t k = 0; k < BAKE_TIME_S; k++) {
+        ovenControlStep(&oc, tp.sensor);
+        if (naiveScheduling) {
+            uint16_t duty[HEATER_OUT_CHANNELS];
+            for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++)
+                duty[ch] = oc.heater.duty[ch];
+            naiveSetDuty(&naive, duty);
+        }
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            uint8_t joint = ovenControlHalfCycle(&oc);
+            in.heaters = naiveScheduling ? naiveNextHalfCycle(&naive) : joint;
+            statsAdd(&r->current, in.heaters);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+        if (isnan(r->preheatTime) && tp.temperature[PLANT_AIR] >= target)
+            r->preheatTime = (float)(k + 1);
+    }
+    r->energy = tp.energy / 3.6e6;
+}
+
+static void printBake(const char* name, const BakeResult_t* r) {
+    printf("  %-22s %8.2f %12.2f %10.2f ", name, r->current.peak, r->current.maxWindowRms, statsRms(&r->current));
+    if (isnan(r->preheatTime))
+        printf("%12s", "-");
+    else
+        printf("%12.0f", r->preheatTime);
+    printf(" %12.3f\n", r->energy);
+}
+
+int main(int argc, char** argv) {
+    float cap = DEFAULT_CAP_A;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cap = strtof(argv[++i], NULL);
+        } else {
+            fprintf(stderr, "usage: %s [-c cap A] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    elementCurrent[HEATER_TOP] = plantDefaultParams.topPower / MAINS_VOLTAGE;
+    elementCurrent[HEATER_BOTTOM] = plantDefaultParams.bottomPower / MAINS_VOLTAGE;
+    if (elementCurrent[HEATER_TOP] > cap || elementCurrent[HEATER_BOTTOM] > cap) {
+        fprintf(stderr, "an element alone draws more than %.1f A\n", cap);
+        return 2;
+    }
+    printf("elements: top %.2f A, bottom %.2f A, cap %.2f A\n", elementCurrent[HEATER_TOP], elementCurrent[HEATER_BOTTOM], cap);
+
+    bool ok = sweep(cap, verbose);
+
+    const BakeProgram_t* programs[] = { &profilePizza, &profileBread };
+    for (uint8_t p = 0; p < sizeof(programs) / sizeof(programs[0]); p++) {
+        BakeResult_t joint, naive;
+        bake(programs[p], cap, false, &joint);
+        bake(programs[p], cap, true, &naive);
+        printf("bake: %s, %u s\n", programs[p]->name, BAKE_TIME_S);
+        printf("  %-22s %8s %12s %10s %12s %12s\n", "scheduler", "peak[A]", "1 s RMS[A]", "RMS[A]", "preheat[s]", "energy[kWh]");
+        printBake("joint, capped", &joint);
+        printBake("naive, independent", &naive);
+        ok &= joint.current.peak <= cap;
+    }
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
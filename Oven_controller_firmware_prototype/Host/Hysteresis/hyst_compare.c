@@ -0,0 +1,190 @@
+/**
+ * @file hyst_compare.c
+ * @brief Runs the hysteresis mode on the thermal plant with a fixed band and with the adaptive band, reporting switch counts, cycle lengths and the temperature ripple.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The controller steps every mains half-cycle on the chamber thermocouple and switches both heaters together (their combined current is below the prototype's cap). The setpoint is SETPOINT_LOW_C from a cold start and SETPOINT_HIGH_C from STEP_S. Each hold is scored from SETTLE_S after its start to its end.
+ *
+ * Setups:
+ * - fixed band of FIXED_BAND_C (adaptation gain 0, no compensation)
+ * - adaptive band starting at FIXED_BAND_C, kept between MIN_BAND_C and MAX_BAND_C, cycles of at least MIN_CYCLE_S
+ * - adaptive band with cycles of at least SHORT_CYCLE_S and a tight minimum band (TIGHT_MIN_BAND_C), where the learned compensations would cross the thresholds without the joint limit
+ * - for each adaptive setup, the narrowest fixed band (in REFERENCE_STEP_C steps from FIXED_BAND_C) whose cycles all reach the same minimum
+ *
+ * Longer cycles cost ripple: the heaters' lag carries the air past both thresholds, and more so the longer they stay on. The fixed reference is what the same cycle floor costs without adaptation, where one band has to fit both setpoints.
+ *
+ * Reported per hold: the relay switchings per hour, the shortest and the mean on-off cycle, the peak-to-peak ripple and the mean of the air (the sensor lags it) and, over the whole run, the band at the end and the smallest distance between the compensated thresholds.
+ *
+ * Usage: hyst_compare [-v]
+ * Exit code: 0 - every adaptive setup ended with its band inside its limits, kept the thresholds at least the minimum band apart, had mean cycles of at least its minimum and no more ripple than its fixed reference in both holds, 1 - not
+ */
+
+#include "hysteresis_controller.h"
+#include "heater_output.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_S       100
+#define AMBIENT_C               22.0f
+
+#define SETPOINT_LOW_C          250.0f
+#define SETPOINT_HIGH_C         300.0f
+#define STEP_S                  7200
+#define END_S                   14400
+#define SETTLE_S                1800
+#define HOLDS                   2
+
+#define FIXED_BAND_C            4.0f
+#define MIN_BAND_C              2.0f
+#define TIGHT_MIN_BAND_C        0.5f
+#define MAX_BAND_C              40.0f   // 60 s cycles need a band of about 21 degC on this plant
+#define MIN_CYCLE_S             60.0f
+#define SHORT_CYCLE_S           40.0f
+#define ADAPT_GAIN              0.3f
+#define REFERENCE_STEP_C        0.5f
+
+typedef struct HoldResult_t {
+    uint32_t switches;
+    uint32_t cycles;
+    float shortestCycle;        // [s]
+    double cycleSum;            // [s]
+    float minAir;               // [degC]
+    float maxAir;               // [degC]
+    double airSum;
+    uint32_t samples;
+} HoldResult_t;
+
+typedef struct SetupResult_t {
+    char name[20];
+    HystConfig_t cfg;
+    int8_t reference;           // index of the fixed band an adaptive setup is judged against
+    HoldResult_t hold[HOLDS];
+    float minGap;               // smallest distance between the thresholds [degC]
+    float band;                 // at the end [degC]
+} SetupResult_t;
+
+/* Runs */
+
+static void run(SetupResult_t* r, bool verbose) {
+    HystController_t hc;
+    ThermalPlant_t tp;
+    hystInit(&hc, &r->cfg);
+    plantInit(&tp, &plantDefaultParams, AMBIENT_C);
+    for (uint8_t h = 0; h < HOLDS; h++) {
+        memset(&r->hold[h], 0, sizeof(r->hold[h]));
+        r->hold[h].shortestCycle = INFINITY;
+        r->hold[h].minAir = INFINITY;
+        r->hold[h].maxAir = -INFINITY;
+    }
+    r->minGap = INFINITY;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    uint32_t lastOn = 0;
+    bool on = false;
+    for (uint32_t k = 0; k < END_S * HALF_CYCLES_PER_S; k++) {
+        uint32_t t = k / HALF_CYCLES_PER_S;
+        uint8_t hold = (t < STEP_S) ? 0 : 1;
+        float setpoint = hold ? SETPOINT_HIGH_C : SETPOINT_LOW_C;
+        bool scored = (t - (hold ? STEP_S : 0)) >= SETTLE_S;
+        HoldResult_t* hr = &r->hold[hold];
+
+        bool next = hystStep(&hc, setpoint, tp.sensor);
+        if (next != on && scored)
+            hr->switches++;
+        if (next && !on) {
+            if (scored && lastOn > 0) {
+                float cycle = (float)(k - lastOn) * HALF_CYCLE_S;
+                hr->cycles++;
+                hr->cycleSum += cycle;
+                if (cycle < hr->shortestCycle)
+                    hr->shortestCycle = cycle;
+            }
+            lastOn = k;
+        }
+        on = next;
+        float gap = hc.band - hc.overshootComp - hc.undershootComp;
+        if (gap < r->minGap)
+            r->minGap = gap;
+
+        in.heaters = on ? (HEATER_TOP_BIT | HEATER_BOTTOM_BIT) : 0;
+        plantStep(&tp, &in, HALF_CYCLE_S);
+        if (scored) {
+            float air = tp.temperature[PLANT_AIR];
+            if (air < hr->minAir)
+                hr->minAir = air;
+            if (air > hr->maxAir)
+                hr->maxAir = air;
+            hr->airSum += air;
+            hr->samples++;
+        }
+        if (verbose && k % (10 * HALF_CYCLES_PER_S) == 0)
+            printf("%s,%u,%.2f,%.2f,%d,%.2f,%.2f,%.2f\n", r->name, t, tp.temperature[PLANT_AIR], tp.sensor, on, hc.band, hc.overshootComp, hc.undershootComp);
+    }
+    r->band = hc.band;
+}
+
+// Widens a fixed band until every scored cycle of both holds reaches minCycle
+static bool findReference(SetupResult_t* r, float minCycle) {
+    snprintf(r->name, sizeof(r->name), "fixed, %.0f s", minCycle);
+    for (float band = FIXED_BAND_C; band <= MAX_BAND_C; band += REFERENCE_STEP_C) {
+        r->cfg = (HystConfig_t){ HALF_CYCLE_S, band, band, band, minCycle, 0.0f };
+        run(r, false);
+        if (r->hold[0].shortestCycle >= minCycle && r->hold[1].shortestCycle >= minCycle)
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    SetupResult_t results[] = {
+        { .name = "fixed band", .cfg = { HALF_CYCLE_S, FIXED_BAND_C, FIXED_BAND_C, FIXED_BAND_C, MIN_CYCLE_S, 0.0f }, .reference = -1 },
+        { .name = "adaptive", .cfg = { HALF_CYCLE_S, FIXED_BAND_C, MIN_BAND_C, MAX_BAND_C, MIN_CYCLE_S, ADAPT_GAIN }, .reference = 2 },
+        { .reference = -1 },
+        { .name = "adaptive, tight", .cfg = { HALF_CYCLE_S, FIXED_BAND_C, TIGHT_MIN_BAND_C, MAX_BAND_C, SHORT_CYCLE_S, ADAPT_GAIN }, .reference = 4 },
+        { .reference = -1 },
+    };
+    const uint8_t count = sizeof(results) / sizeof(results[0]);
+    if (verbose)
+        printf("setup,t,air,sensor,on,band,overshoot comp,undershoot comp\n");
+    bool ok = true;
+    for (uint8_t i = 0; i < count; i++) {
+        if (results[i].reference >= 0)
+            ok &= findReference(&results[results[i].reference], results[i].cfg.minCyclePeriod);
+        run(&results[i], verbose);
+    }
+
+    printf("holds at %.0f and %.0f degC, scored from %u s into each\n", SETPOINT_LOW_C, SETPOINT_HIGH_C, SETTLE_S);
+    printf("%-16s %9s %9s %12s %14s %11s %13s %12s %10s %11s\n", "setup", "min cycle", "setpoint", "switches/h", "shortest[s]", "mean[s]", "ripple[C]", "mean air[C]", "band[C]", "min gap[C]");
+    for (uint8_t i = 0; i < count; i++) {
+        const SetupResult_t* r = &results[i];
+        bool adaptive = r->cfg.adaptGain > 0.0f;
+        for (uint8_t h = 0; h < HOLDS; h++) {
+            const HoldResult_t* hr = &r->hold[h];
+            float hours = hr->samples * HALF_CYCLE_S / 3600.0f;
+            float mean = hr->cycles ? (float)(hr->cycleSum / hr->cycles) : 0.0f;
+            float ripple = hr->maxAir - hr->minAir;
+            if (h == 0 && i > 0)
+                printf("%-16s %9.0f", r->name, r->cfg.minCyclePeriod);
+            else
+                printf("%-16s %9s", h == 0 ? r->name : "", h == 0 ? "-" : "");
+            printf(" %9.0f %12.1f %14.1f %11.1f %13.2f %12.2f", h ? SETPOINT_HIGH_C : SETPOINT_LOW_C, hr->switches / hours, hr->shortestCycle, mean, ripple, hr->airSum / hr->samples);
+            if (h == 0)
+                printf(" %10.2f %11.2f\n", r->band, r->minGap);
+            else
+                printf("\n");
+            if (adaptive) {
+                const HoldResult_t* ref = &results[r->reference].hold[h];
+                ok &= mean >= r->cfg.minCyclePeriod && ripple <= ref->maxAir - ref->minAir;
+            }
+        }
+        if (adaptive)
+            ok &= r->minGap >= r->cfg.minBand - 1e-4f && r->band > r->cfg.minBand && r->band < r->cfg.maxBand;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
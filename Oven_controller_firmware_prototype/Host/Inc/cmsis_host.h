@@ -0,0 +1,82 @@
+/**
+ * @file cmsis_host.h
+ * @brief Host (Linux) replacements for the CMSIS-Core intrinsics used by the firmware and CMSIS-DSP
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Interrupt masking (PRIMASK) is a flag of the fake HAL: simulated interrupts (DMA completions) aren't delivered while it's set
+- Saturation and bit intrinsics are plain C
+
+# Limitations
+- Only the intrinsics that are actually used are provided
+*/
+
+#ifndef CMSIS_HOST_H
+#define CMSIS_HOST_H
+
+#include "stdint.h"
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE         static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+#define __STATIC_FORCEINLINE    static inline __attribute__((always_inline))
+#endif
+#ifndef __INLINE
+#define __INLINE                inline
+#endif
+#ifndef __ASM
+#define __ASM                   __asm
+#endif
+#ifndef __PACKED
+#define __PACKED                __attribute__((packed))
+#endif
+#ifndef __ALIGNED
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#endif
+#ifndef __WEAK
+#define __WEAK                  __attribute__((weak))
+#endif
+#ifndef __NOP
+#define __NOP()                 ((void)0)
+#endif
+
+/* Interrupt masking (implemented in fake_hal.c) */
+
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+
+/* Intrinsics */
+
+__STATIC_INLINE uint8_t __CLZ(uint32_t value) {
+    return value ? (uint8_t)__builtin_clz(value) : 32U;
+}
+
+__STATIC_INLINE int32_t __SSAT(int32_t val, uint32_t sat) {
+    int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+    int32_t min = -1 - max;
+    return val > max ? max : (val < min ? min : val);
+}
+
+__STATIC_INLINE uint32_t __USAT(int32_t val, uint32_t sat) {
+    uint32_t max = (1U << sat) - 1U;
+    return val < 0 ? 0U : ((uint32_t)val > max ? max : (uint32_t)val);
+}
+
+__STATIC_INLINE uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < 32; i++) {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+__STATIC_INLINE uint32_t __REV(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file core_cm3.h
+ * @brief Host stand-in for the CMSIS-Core header that arm_math.h includes. The host build of CMSIS-DSP selects ARM_MATH_CM3, which uses the plain C code paths (no DSP extension) and only needs the intrinsics from cmsis_host.h.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ */
+
+#ifndef CORE_CM3_HOST_H
+#define CORE_CM3_HOST_H
+
+#include "cmsis_host.h"
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file fake_hal.h
+ * @brief Host-side control of the fake HAL: virtual time, simulated interrupts and simulated devices. See fake_hal.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Virtual time in microseconds. It only moves in HAL_Delay, HAL_GetTick (FAKE_HAL_POLL_US per call, so busy-wait loops end), blocking transfers and fakeHalAdvance.
+- Simulated interrupts are events scheduled at a virtual time. They are delivered while time moves, never while PRIMASK is set or another one is running, in time order (ties in scheduling order), so every run is repeatable.
+- DMA transfers finish after the time the bus needs for them, then the device is accessed and the HAL callback is called
+- I2C devices are attached by address, SPI devices by chip select pin. Unattached I2C addresses don't acknowledge, unattached SPI devices read as zeros.
+- I2C devices that care about timing (e.g. hd44780_model.h) can ask when each byte of a transfer was on the bus, at a settable bus speed
+
+# Limitations
+- One I2C bus, one SPI bus and one UART sink are modelled (the handles are still checked for being busy separately)
+- Environment variables read by HAL_Init: OVEN_HOST_RUN_MS - virtual run time before the program exits (default 60000, 0 = forever), OVEN_HOST_UART - file the UART output is written to (default: stdout)
+*/
+
+#ifndef FAKE_HAL_H
+#define FAKE_HAL_H
+
+#include "stm32f3xx_hal.h"
+#include "stdbool.h"
+
+#define FAKE_HAL_POLL_US            1       // virtual time spent by each HAL_GetTick call
+#define FAKE_HAL_MAX_EVENTS         16
+#define FAKE_HAL_DEFAULT_RUN_MS     60000
+#define FAKE_I2C_MAX_DEVICES        8
+#define FAKE_I2C_BYTE_US            90      // default, 100 kHz, 9 clocks per byte
+#define FAKE_I2C_MAX_XFER           1100
+#define FAKE_SPI_MAX_DEVICES        4
+
+typedef void (*FakeHalEvent_t)(void* arg);
+
+typedef struct FakeI2CDevice_t {
+    uint8_t address;                                    // 7-bit
+    bool (*write)(const uint8_t* data, uint16_t len);   // return false to not acknowledge
+    bool (*read)(uint8_t* data, uint16_t len);
+} FakeI2CDevice_t;
+
+typedef struct FakeSpiDevice_t {
+    GPIO_TypeDef* csPort;
+    uint16_t csPin;                                     // the device answers while this pin is low
+    void (*transfer)(const uint8_t* tx, uint8_t* rx, uint16_t len);  // rx is NULL for transmit-only transfers
+} FakeSpiDevice_t;
+
+typedef void (*FakeUartSink_t)(const uint8_t* data, uint16_t len);
+
+/* Virtual time */
+
+/**
+ * @brief Returns the virtual time [us]
+ */
+uint64_t fakeHalMicros(void);
+
+/**
+ * @brief Moves virtual time forward, delivering the simulated interrupts that fall within it
+ * @param us time step [us]
+ */
+void fakeHalAdvance(uint32_t us);
+
+/**
+ * @brief Schedules a simulated interrupt
+ * @param delayUs delay from now [us]
+ * @param event function to be called (in "interrupt context")
+ * @param arg its argument
+ * @return false if the event queue is full
+ */
+bool fakeHalSchedule(uint32_t delayUs, FakeHalEvent_t event, void* arg);
+
+/**
+ * @brief Sets the virtual time at which the program exits (0 = never)
+ * @param ms [ms]
+ */
+void fakeHalSetRunTime(uint32_t ms);
+
+/**
+ * @brief Board hook called from HAL_Init, for attaching simulated devices. The firmware executable gets the one in host_board.c, the default does nothing.
+ */
+void hostBoardInit(void);
+
+/* Simulated devices */
+
+/**
+ * @brief Attaches a device to the I2C bus
+ * @param device pointer to the device (must stay valid)
+ * @return false if FAKE_I2C_MAX_DEVICES are already attached
+ */
+bool fakeI2CAttach(const FakeI2CDevice_t* device);
+
+/**
+ * @brief Sets the time one byte takes on the I2C bus (FAKE_I2C_BYTE_US by default), e.g. 23 us for 400 kHz
+ * @param us [us]
+ */
+void fakeI2CSetByteTime(uint32_t us);
+
+/**
+ * @brief Returns when a device handled a byte of the transfer it's being called for. Devices are called at the end of the transfer, this lets them see when each byte actually arrived.
+ * @note Only valid inside a device's write or read function
+ * @param index byte of the data passed to the function
+ * @return [us] write: the byte's acknowledge (when an I/O expander's outputs change), read: the acknowledge before the byte (when an I/O expander samples its inputs)
+ */
+uint64_t fakeI2CByteTime(uint16_t index);
+
+/**
+ * @brief Attaches a device to the SPI bus
+ * @param device pointer to the device (must stay valid)
+ * @return false if FAKE_SPI_MAX_DEVICES are already attached
+ */
+bool fakeSpiAttach(const FakeSpiDevice_t* device);
+
+/**
+ * @brief Makes the next DMA transfers on the SPI bus end with an overrun error instead of completing. The device isn't accessed and HAL_SPI_ErrorCallback is called.
+ * @param count number of transfers
+ */
+void fakeSpiFailNext(uint8_t count);
+
+/**
+ * @brief Sets the level read from an input pin
+ */
+void fakeGpioSetInput(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+
+/**
+ * @brief Redirects everything transmitted by the UARTs (replaces the default file/stdout output)
+ * @param sink function receiving the bytes, at the end of each transfer
+ */
+void fakeUartSetSink(FakeUartSink_t sink);
+
+/**
+ * @brief Delivers bytes to a UART. They are stored if a reception is in progress and complete it once enough have arrived, otherwise they're dropped.
+ */
+void fakeUartFeed(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len);
+
+#endif
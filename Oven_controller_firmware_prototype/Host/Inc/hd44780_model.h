@@ -0,0 +1,59 @@
+/**
+ * @file hd44780_model.h
+ * @brief Timed model of an HD44780 LCD behind a PCF8574 I2C expander, for the host build. See hd44780_model.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- The usual module wiring: P0 = RS, P1 = R/W, P2 = EN, P3 = backlight, P4..P7 = D4..D7
+- 8-bit and 4-bit interface, nibbles latched on the falling edges of EN at the time their byte was on the bus
+- Enforces the controller's execution times: an instruction or data write that arrives while the busy flag is set is ignored and counted
+- Reads through the quasi-bidirectional port: with R/W high and EN high the controller pulls D7..D4 (busy flag and address counter) down wherever the expander's outputs are written high
+- DDRAM contents for checking what the display shows
+
+# Limitations
+- One display, only clear, return home, function set and DDRAM address/data instructions change the model's state (the others only take their execution time)
+- No power-on reset time and no CGRAM
+*/
+
+#ifndef HD44780_MODEL_H
+#define HD44780_MODEL_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#define HD44780_DDRAM_SIZE          0x80
+#define HD44780_EXEC_US             37      // datasheet execution times at 270 kHz
+#define HD44780_EXEC_CLEAR_US       1520    // clear display and return home
+
+typedef struct HD44780Stats_t {
+    uint32_t executed;              // instructions and data writes
+    uint32_t ignored;               // writes that arrived while the controller was busy
+    uint32_t flagReads;             // busy flag reads (first nibble in 4-bit mode)
+    uint32_t busyReads;             // of which found the controller busy
+} HD44780Stats_t;
+
+/**
+ * @brief Attaches the model to the fake I2C bus and resets it
+ * @param address expander's 7-bit I2C address
+ * @return false if the bus has no room for another device
+ */
+bool hd44780ModelAttach(uint8_t address);
+
+/**
+ * @brief Resets the model: 8-bit interface, DDRAM filled with spaces, not busy, statistics cleared
+ */
+void hd44780ModelReset(void);
+
+/**
+ * @brief Returns the DDRAM contents (HD44780_DDRAM_SIZE characters, row 1 starts at 0x40)
+ */
+const char* hd44780ModelDdram(void);
+
+/**
+ * @brief Copies the statistics
+ * @param stats output
+ */
+void hd44780ModelGetStats(HD44780Stats_t* stats);
+
+#endif
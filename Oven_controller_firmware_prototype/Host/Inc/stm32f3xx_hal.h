@@ -0,0 +1,616 @@
+/**
+ * @file stm32f3xx_hal.h
+ * @brief Fake STM32F3 HAL for the host (Linux) build. See fake_hal.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Same names, types and signatures as the real HAL for everything the firmware uses, so the application, the libraries and the CubeMX peripheral init files compile unchanged
+- Deterministic virtual time instead of SysTick
+- DMA/interrupt transfers complete from a simulated DMA engine, which calls the usual HAL callbacks at the right virtual time
+- Simulated devices can be attached to the I2C and SPI buses (see fake_hal.h)
+
+# Limitations
+- Only the parts of the HAL used by this firmware. Peripheral registers are plain memory (only the bits the firmware touches mean anything).
+- Init functions only store their configuration, nothing is validated
+*/
+
+#ifndef STM32F3XX_HAL_H
+#define STM32F3XX_HAL_H
+
+#include "stdint.h"
+#include "stddef.h"
+#include "cmsis_host.h"
+
+/* Common */
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U,
+} HAL_StatusTypeDef;
+
+typedef enum {
+    HAL_UNLOCKED = 0x00U,
+    HAL_LOCKED = 0x01U,
+} HAL_LockTypeDef;
+
+#define HAL_MAX_DELAY           0xFFFFFFFFU
+
+#define SET_BIT(REG, BIT)       ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)     ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)      ((REG) & (BIT))
+#define WRITE_REG(REG, VAL)     ((REG) = (VAL))
+#define READ_REG(REG)           ((REG))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)     WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+#define UNUSED(X)               (void)X
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do { \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__); \
+        (__DMA_HANDLE__).Parent = (__HANDLE__); \
+    } while (0U)
+
+extern uint32_t SystemCoreClock;
+
+typedef enum {
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel2_IRQn = 12,
+    DMA1_Channel3_IRQn = 13,
+    DMA1_Channel4_IRQn = 14,
+    DMA1_Channel5_IRQn = 15,
+    DMA1_Channel6_IRQn = 16,
+    DMA1_Channel7_IRQn = 17,
+    TIM1_UP_TIM16_IRQn = 25,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    I2C1_EV_IRQn = 31,
+    I2C1_ER_IRQn = 32,
+    SPI2_IRQn = 36,
+    USART2_IRQn = 38,
+    EXTI15_10_IRQn = 40,
+} IRQn_Type;
+
+void HAL_NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#define NVIC_PRIORITYGROUP_0    0x00000007U
+#define NVIC_PRIORITYGROUP_4    0x00000003U
+
+/* Clock enables (no-ops) */
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_PWR_CLK_ENABLE()      ((void)0)
+#define __HAL_RCC_I2C1_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_I2C1_CLK_DISABLE()    ((void)0)
+#define __HAL_RCC_SPI2_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_SPI2_CLK_DISABLE()    ((void)0)
+#define __HAL_RCC_USART2_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_USART2_CLK_DISABLE()  ((void)0)
+#define __HAL_RCC_CRC_CLK_ENABLE()      ((void)0)
+#define __HAL_RCC_CRC_CLK_DISABLE()     ((void)0)
+
+/* RCC */
+
+typedef struct {
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLMUL;
+    uint32_t PREDIV;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    uint32_t HSEPredivValue;
+    uint32_t LSEState;
+    uint32_t HSIState;
+    uint32_t HSICalibrationValue;
+    uint32_t LSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+typedef struct {
+    uint32_t PeriphClockSelection;
+    uint32_t RTCClockSelection;
+    uint32_t Usart1ClockSelection;
+    uint32_t Usart2ClockSelection;
+    uint32_t Usart3ClockSelection;
+    uint32_t I2c1ClockSelection;
+    uint32_t Tim1ClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSE      0x00000001U
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_HSE_ON                  0x00000001U
+#define RCC_HSE_BYPASS              0x00000005U
+#define RCC_HSI_ON                  0x00000001U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSI           0x00000000U
+#define RCC_PLLSOURCE_HSE           0x00010000U
+#define RCC_PLL_MUL9                0x001C0000U
+#define RCC_PREDIV_DIV1             0x00000000U
+#define RCC_CLOCKTYPE_SYSCLK        0x00000001U
+#define RCC_CLOCKTYPE_HCLK          0x00000002U
+#define RCC_CLOCKTYPE_PCLK1         0x00000004U
+#define RCC_CLOCKTYPE_PCLK2         0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK     0x00000002U
+#define RCC_SYSCLK_DIV1             0x00000000U
+#define RCC_HCLK_DIV1               0x00000000U
+#define RCC_HCLK_DIV2               0x00000400U
+#define RCC_PERIPHCLK_USART2        0x00000002U
+#define RCC_PERIPHCLK_I2C1          0x00000020U
+#define RCC_PERIPHCLK_TIM1          0x00001000U
+#define RCC_USART2CLKSOURCE_PCLK1   0x00000000U
+#define RCC_I2C1CLKSOURCE_SYSCLK    0x00000010U
+#define RCC_TIM1CLK_HCLK            0x00000000U
+#define FLASH_LATENCY_2             0x00000002U
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit);
+void HAL_RCC_EnableCSS(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+/* Tick */
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_MspInit(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_IncTick(void);
+
+/* GPIO */
+
+typedef struct {
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef fakeGpioPorts[6];
+
+#define GPIOA   (&fakeGpioPorts[0])
+#define GPIOB   (&fakeGpioPorts[1])
+#define GPIOC   (&fakeGpioPorts[2])
+#define GPIOD   (&fakeGpioPorts[3])
+#define GPIOE   (&fakeGpioPorts[4])
+#define GPIOF   (&fakeGpioPorts[5])
+
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET,
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+#define GPIO_PIN_All    ((uint16_t)0xFFFF)
+
+#define GPIO_MODE_INPUT         0x00000000U
+#define GPIO_MODE_OUTPUT_PP     0x00000001U
+#define GPIO_MODE_OUTPUT_OD     0x00000011U
+#define GPIO_MODE_AF_PP         0x00000002U
+#define GPIO_MODE_AF_OD         0x00000012U
+#define GPIO_MODE_ANALOG        0x00000003U
+#define GPIO_MODE_IT_RISING     0x10110000U
+#define GPIO_MODE_IT_FALLING    0x10210000U
+#define GPIO_NOPULL             0x00000000U
+#define GPIO_PULLUP             0x00000001U
+#define GPIO_PULLDOWN           0x00000002U
+#define GPIO_SPEED_FREQ_LOW     0x00000000U
+#define GPIO_SPEED_FREQ_MEDIUM  0x00000001U
+#define GPIO_SPEED_FREQ_HIGH    0x00000003U
+#define GPIO_AF4_I2C1           ((uint8_t)0x04)
+#define GPIO_AF5_SPI2           ((uint8_t)0x05)
+#define GPIO_AF7_USART2         ((uint8_t)0x07)
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/* DMA */
+
+typedef struct {
+    uint32_t CCR;
+    uint32_t CNDTR;
+    uint32_t CPAR;
+    uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+extern DMA_Channel_TypeDef fakeDmaChannels[7];
+
+#define DMA1_Channel1   (&fakeDmaChannels[0])
+#define DMA1_Channel2   (&fakeDmaChannels[1])
+#define DMA1_Channel3   (&fakeDmaChannels[2])
+#define DMA1_Channel4   (&fakeDmaChannels[3])
+#define DMA1_Channel5   (&fakeDmaChannels[4])
+#define DMA1_Channel6   (&fakeDmaChannels[5])
+#define DMA1_Channel7   (&fakeDmaChannels[6])
+
+typedef struct {
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+    DMA_Channel_TypeDef* Instance;
+    DMA_InitTypeDef Init;
+    void* Parent;
+} DMA_HandleTypeDef;
+
+#define DMA_PERIPH_TO_MEMORY    0x00000000U
+#define DMA_MEMORY_TO_PERIPH    0x00000010U
+#define DMA_PINC_ENABLE         0x00000040U
+#define DMA_PINC_DISABLE        0x00000000U
+#define DMA_MINC_ENABLE         0x00000080U
+#define DMA_MINC_DISABLE        0x00000000U
+#define DMA_PDATAALIGN_BYTE     0x00000000U
+#define DMA_PDATAALIGN_HALFWORD 0x00000100U
+#define DMA_PDATAALIGN_WORD     0x00000200U
+#define DMA_MDATAALIGN_BYTE     0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00000400U
+#define DMA_MDATAALIGN_WORD     0x00000800U
+#define DMA_NORMAL              0x00000000U
+#define DMA_CIRCULAR            0x00000020U
+#define DMA_PRIORITY_LOW        0x00000000U
+#define DMA_PRIORITY_MEDIUM     0x00001000U
+#define DMA_PRIORITY_HIGH       0x00002000U
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma);
+
+/* I2C */
+
+typedef struct {
+    uint32_t CR1;
+    uint32_t CR2;
+    uint32_t ISR;
+    uint32_t TXDR;
+    uint32_t RXDR;
+} I2C_TypeDef;
+
+extern I2C_TypeDef fakeI2C1;
+#define I2C1    (&fakeI2C1)
+
+typedef struct {
+    uint32_t Timing;
+    uint32_t OwnAddress1;
+    uint32_t AddressingMode;
+    uint32_t DualAddressMode;
+    uint32_t OwnAddress2;
+    uint32_t OwnAddress2Masks;
+    uint32_t GeneralCallMode;
+    uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef enum {
+    HAL_I2C_STATE_RESET = 0x00U,
+    HAL_I2C_STATE_READY = 0x20U,
+    HAL_I2C_STATE_BUSY = 0x24U,
+    HAL_I2C_STATE_BUSY_TX = 0x21U,
+    HAL_I2C_STATE_BUSY_RX = 0x22U,
+} HAL_I2C_StateTypeDef;
+
+typedef struct __I2C_HandleTypeDef {
+    I2C_TypeDef* Instance;
+    I2C_InitTypeDef Init;
+    uint8_t* pBuffPtr;
+    uint16_t XferSize;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+    HAL_LockTypeDef Lock;
+    volatile HAL_I2C_StateTypeDef State;
+    volatile uint32_t ErrorCode;
+    uint16_t Devaddress;
+    uint16_t Memaddress;
+    uint8_t fakeXfer;           // fake: kind of the pending transfer
+    uint8_t fakeMemSize;        // fake: register address size of the pending transfer
+} I2C_HandleTypeDef;
+
+#define HAL_I2C_ERROR_NONE      0x00000000U
+#define HAL_I2C_ERROR_BERR      0x00000001U
+#define HAL_I2C_ERROR_ARLO      0x00000002U
+#define HAL_I2C_ERROR_AF        0x00000004U
+#define HAL_I2C_ERROR_OVR       0x00000008U
+#define HAL_I2C_ERROR_DMA       0x00000010U
+#define HAL_I2C_ERROR_TIMEOUT   0x00000020U
+
+#define I2C_ADDRESSINGMODE_7BIT 0x00000001U
+#define I2C_DUALADDRESS_DISABLE 0x00000000U
+#define I2C_OA2_NOMASK          0x00U
+#define I2C_GENERALCALL_DISABLE 0x00000000U
+#define I2C_NOSTRETCH_DISABLE   0x00000000U
+#define I2C_ANALOGFILTER_ENABLE 0x00000000U
+#define I2C_MEMADD_SIZE_8BIT    0x00000001U
+#define I2C_MEMADD_SIZE_16BIT   0x00000002U
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef* hi2c);
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef* hi2c, uint32_t AnalogFilter);
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef* hi2c, uint32_t DigitalFilter);
+void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MspDeInit(I2C_HandleTypeDef* hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef* hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c);
+
+/* SPI */
+
+typedef struct {
+    uint32_t CR1;
+    uint32_t CR2;
+    uint32_t SR;
+    uint32_t DR;
+} SPI_TypeDef;
+
+extern SPI_TypeDef fakeSPI2;
+#define SPI2    (&fakeSPI2)
+
+#define SPI_CR1_CPHA    0x00000001U
+#define SPI_CR1_CPOL    0x00000002U
+#define SPI_CR1_SPE     0x00000040U
+
+typedef struct {
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+    uint32_t CRCLength;
+    uint32_t NSSPMode;
+} SPI_InitTypeDef;
+
+typedef enum {
+    HAL_SPI_STATE_RESET = 0x00U,
+    HAL_SPI_STATE_READY = 0x01U,
+    HAL_SPI_STATE_BUSY = 0x02U,
+    HAL_SPI_STATE_BUSY_TX_RX = 0x05U,
+} HAL_SPI_StateTypeDef;
+
+typedef struct __SPI_HandleTypeDef {
+    SPI_TypeDef* Instance;
+    SPI_InitTypeDef Init;
+    uint8_t* pTxBuffPtr;
+    uint8_t* pRxBuffPtr;
+    uint16_t TxXferSize;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+    HAL_LockTypeDef Lock;
+    volatile HAL_SPI_StateTypeDef State;
+    volatile uint32_t ErrorCode;
+} SPI_HandleTypeDef;
+
+#define HAL_SPI_ERROR_NONE          0x00000000U
+#define HAL_SPI_ERROR_OVR           0x00000004U
+#define SPI_MODE_MASTER             0x00000104U
+#define SPI_DIRECTION_2LINES        0x00000000U
+#define SPI_DATASIZE_8BIT           0x00000700U
+#define SPI_POLARITY_LOW            0x00000000U
+#define SPI_POLARITY_HIGH           SPI_CR1_CPOL
+#define SPI_PHASE_1EDGE             0x00000000U
+#define SPI_PHASE_2EDGE             SPI_CR1_CPHA
+#define SPI_NSS_SOFT                0x00000200U
+#define SPI_BAUDRATEPRESCALER_2     0x00000000U
+#define SPI_BAUDRATEPRESCALER_4     0x00000008U
+#define SPI_BAUDRATEPRESCALER_8     0x00000010U
+#define SPI_BAUDRATEPRESCALER_16    0x00000018U
+#define SPI_FIRSTBIT_MSB            0x00000000U
+#define SPI_TIMODE_DISABLE          0x00000000U
+#define SPI_CRCCALCULATION_DISABLE  0x00000000U
+#define SPI_CRC_LENGTH_DATASIZE     0x00000000U
+#define SPI_NSS_PULSE_DISABLE       0x00000000U
+
+#define __HAL_SPI_ENABLE(__HANDLE__)    SET_BIT((__HANDLE__)->Instance->CR1, SPI_CR1_SPE)
+#define __HAL_SPI_DISABLE(__HANDLE__)   CLEAR_BIT((__HANDLE__)->Instance->CR1, SPI_CR1_SPE)
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi);
+void HAL_SPI_MspDeInit(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef* hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi);
+
+/* UART */
+
+typedef struct {
+    uint32_t CR1;
+    uint32_t ISR;
+    uint32_t TDR;
+    uint32_t RDR;
+} USART_TypeDef;
+
+extern USART_TypeDef fakeUSART2;
+#define USART2  (&fakeUSART2)
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+    uint32_t OneBitSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+    uint32_t AdvFeatureInit;
+} UART_AdvFeatureInitTypeDef;
+
+typedef enum {
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U,
+    HAL_UART_STATE_BUSY = 0x24U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U,
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef* Instance;
+    UART_InitTypeDef Init;
+    UART_AdvFeatureInitTypeDef AdvancedInit;
+    uint8_t* pTxBuffPtr;
+    uint16_t TxXferSize;
+    uint8_t* pRxBuffPtr;
+    uint16_t RxXferSize;
+    volatile uint16_t RxXferCount;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+    HAL_LockTypeDef Lock;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+    uint8_t fakeRxDma;          // fake: the pending reception was started with HAL_UART_Receive_DMA or _IT (completes with a callback)
+} UART_HandleTypeDef;
+
+#define HAL_UART_ERROR_NONE             0x00000000U
+#define UART_WORDLENGTH_8B              0x00000000U
+#define UART_STOPBITS_1                 0x00000000U
+#define UART_PARITY_NONE                0x00000000U
+#define UART_MODE_TX_RX                 0x0000000CU
+#define UART_HWCONTROL_NONE             0x00000000U
+#define UART_OVERSAMPLING_16            0x00000000U
+#define UART_ONE_BIT_SAMPLE_DISABLE     0x00000000U
+#define UART_ADVFEATURE_NO_INIT         0x00000000U
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+void HAL_UART_MspInit(UART_HandleTypeDef* huart);
+void HAL_UART_MspDeInit(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef* huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+
+/* CRC */
+
+typedef struct {
+    uint32_t DR;
+    uint32_t CR;
+    uint32_t INIT;
+    uint32_t POL;
+} CRC_TypeDef;
+
+extern CRC_TypeDef fakeCRC;
+#define CRC     (&fakeCRC)
+
+typedef struct {
+    uint8_t DefaultPolynomialUse;
+    uint8_t DefaultInitValueUse;
+    uint32_t GeneratingPolynomial;
+    uint32_t CRCLength;
+    uint32_t InitValue;
+    uint32_t InputDataInversionMode;
+    uint32_t OutputDataInversionMode;
+} CRC_InitTypeDef;
+
+typedef enum {
+    HAL_CRC_STATE_RESET = 0x00U,
+    HAL_CRC_STATE_READY = 0x01U,
+} HAL_CRC_StateTypeDef;
+
+typedef struct {
+    CRC_TypeDef* Instance;
+    CRC_InitTypeDef Init;
+    HAL_LockTypeDef Lock;
+    volatile HAL_CRC_StateTypeDef State;
+    uint32_t InputDataFormat;
+} CRC_HandleTypeDef;
+
+#define DEFAULT_POLYNOMIAL_ENABLE           ((uint8_t)0x00U)
+#define DEFAULT_POLYNOMIAL_DISABLE          ((uint8_t)0x01U)
+#define DEFAULT_INIT_VALUE_ENABLE           ((uint8_t)0x00U)
+#define DEFAULT_INIT_VALUE_DISABLE          ((uint8_t)0x01U)
+#define CRC_POLYLENGTH_32B                  0x00000000U
+#define CRC_POLYLENGTH_16B                  0x00000008U
+#define CRC_POLYLENGTH_8B                   0x00000010U
+#define CRC_POLYLENGTH_7B                   0x00000018U
+#define CRC_INPUTDATA_INVERSION_NONE        0x00000000U
+#define CRC_OUTPUTDATA_INVERSION_DISABLE    0x00000000U
+#define CRC_INPUTDATA_FORMAT_BYTES          0x00000001U
+#define CRC_INPUTDATA_FORMAT_HALFWORDS      0x00000002U
+#define CRC_INPUTDATA_FORMAT_WORDS          0x00000003U
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef* hcrc);
+void HAL_CRC_MspInit(CRC_HandleTypeDef* hcrc);
+void HAL_CRC_MspDeInit(CRC_HandleTypeDef* hcrc);
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file lcd_bsrr_check.c
+ * @brief Decodes the BSRR word stream of the LCD's GPIO transport back into HD44780 instructions and checks it against the controller's timing.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The stream is built from the driver's own entry expansion (encodeEntry, entryExecUs) and lcdBsrrEncode, packed into transfers the way the transport packs them: the initialisation (polled writes and 5 ms delays, like lcdInit), the queue lcdInit leaves behind, then both lines of a 2x16 display and a return home. Every transfer starts right when the previous one ends, which is the tightest the interrupt can make it.
+ *
+ * A model of the controller's bus interface replays the words on a nanosecond time base: the port lines change when a word is written, the controller latches D4-D7 on each EN falling edge (8-bit mode after power-up, 4-bit after the function set) and is busy for the instruction's execution time after it. The datasheet's figures for 2.7-4.5 V supply are enforced:
+ * - enable pulse width PWEH >= 450 ns, enable cycle time tcycE >= 1000 ns
+ * - RS setup tAS >= 60 ns and data setup tDSW >= 195 ns before EN falls, RS and data hold tAH >= 20 ns, tH >= 10 ns after it
+ * - no EN pulse while the controller is busy: 37 us per instruction, 1.52 ms for clear display and return home at the nominal 270 kHz, 4.1 ms and 100 us after the first two function sets of the initialisation
+ *
+ * Usage: lcd_bsrr_check [-v]
+ * Exit code: 0 - the decoded instructions match the sent ones and no timing was violated, 1 otherwise
+ */
+
+#include "lcd_bsrr.h"
+#include "stdbool.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// driver internals (not static, but not in the public header)
+uint8_t encodeEntry(uint8_t rs, uint8_t data, uint8_t* seq);
+uint16_t entryExecUs(uint8_t rs, uint8_t data);
+
+#define WORD_NS         (LCD_BSRR_WORD_US * 1000ULL)
+#define MAX_ENTRIES     64
+
+#define PWEH_NS         450
+#define TCYCE_NS        1000
+#define TAS_NS          60
+#define TDSW_NS         195
+#define TAH_NS          20
+#define TH_NS           10
+#define EXEC_NS         37000ULL
+#define EXEC_CLEAR_NS   1520000ULL
+
+typedef struct Entry_t {
+    uint8_t rs;
+    uint8_t data;
+} Entry_t;
+
+/* stream */
+
+static uint32_t stream[8192];
+static uint64_t streamTime[8192];  // when each word is written [ns]
+static size_t streamLen = 0;
+static uint32_t transferCount = 0;
+
+static void putWord(uint32_t word, uint64_t t) {
+    if (streamLen >= sizeof(stream) / sizeof(stream[0])) {
+        fprintf(stderr, "stream too long\n");
+        exit(1);
+    }
+    stream[streamLen] = word;
+    streamTime[streamLen++] = t;
+}
+
+// lcdTransportWriteNow (the driver's usual execution time) followed by a delay, returns when the next write can start
+static uint64_t writeNow(const uint8_t* seq, uint8_t size, uint64_t t, uint32_t delayUs) {
+    uint32_t words[LCD_BSRR_WORDS_MAX];
+    uint16_t n = lcdBsrrEncode(seq, size, entryExecUs(0, seq[0] & LCD_STATE_DATA), words, LCD_BSRR_WORDS_MAX);
+    for (uint16_t i = 0; i < n; i++) {
+        t += WORD_NS;
+        putWord(words[i], t);
+    }
+    return t + delayUs * 1000ULL;
+}
+
+// packs the entries into transfers like lcdTransportAppend and lcdTransportStart, each transfer starting when the previous one ends
+static uint64_t sendEntries(const Entry_t* entries, size_t count, uint64_t t) {
+    static uint32_t words[LCD_BSRR_WORDS_MAX];
+    size_t next = 0;
+    while (next < count) {
+        uint16_t n = 0;
+        while (next < count) {
+            uint8_t seq[6];
+            uint8_t size = encodeEntry(entries[next].rs, entries[next].data, seq);
+            uint16_t added = lcdBsrrEncode(seq, size, entryExecUs(entries[next].rs, entries[next].data), &words[n], LCD_BSRR_WORDS_MAX - n);
+            if (added == 0)
+                break;
+            n += added;
+            next++;
+        }
+        if (n == 0) {
+            fprintf(stderr, "entry %zu doesn't fit into a transfer\n", next);
+            exit(1);
+        }
+        for (uint16_t i = 0; i < n; i++) {
+            t += WORD_NS;
+            putWord(words[i], t);
+        }
+        transferCount++;
+    }
+    return t;
+}
+
+/* controller model */
+
+static bool verbose = false;
+static uint32_t violations = 0;
+
+static void violation(uint64_t t, const char* what, uint64_t actual, uint64_t required) {
+    violations++;
+    printf("VIOLATION at %.3f us: %s %llu ns < %llu ns\n", t / 1000.0, what, (unsigned long long)actual, (unsigned long long)required);
+}
+
+static const char* describe(uint8_t rs, uint8_t data) {
+    static char text[32];
+    if (rs) {
+        snprintf(text, sizeof(text), "data '%c'", (data >= 0x20 && data < 0x7f) ? data : '?');
+        return text;
+    }
+    if (data & 0x80)
+        snprintf(text, sizeof(text), "set DDRAM address 0x%02X", data & 0x7f);
+    else if (data & 0x40)
+        snprintf(text, sizeof(text), "set CGRAM address");
+    else if (data & 0x20)
+        snprintf(text, sizeof(text), "function set (%s, %s)", (data & 0x10) ? "8-bit" : "4-bit", (data & 0x08) ? "2 lines" : "1 line");
+    else if (data & 0x10)
+        snprintf(text, sizeof(text), "cursor/display shift");
+    else if (data & 0x08)
+        snprintf(text, sizeof(text), "display control");
+    else if (data & 0x04)
+        snprintf(text, sizeof(text), "entry mode set");
+    else if (data & 0x02)
+        snprintf(text, sizeof(text), "return home");
+    else
+        snprintf(text, sizeof(text), "clear display");
+    return text;
+}
+
+// replays the stream, fills decoded with the instructions and characters the controller executed
+static size_t decode(Entry_t* decoded, size_t capacity) {
+    const uint32_t rsMask = 1UL << LCD_BSRR_RS_PIN;
+    const uint32_t enMask = 1UL << LCD_BSRR_EN_PIN;
+    const uint32_t dataMask = 0xFUL << LCD_BSRR_D4_PIN;
+
+    uint32_t lines = 0;
+    uint64_t rsChanged = 0, dataChanged = 0, enRise = 0, enFall = 0;
+    bool risen = false, fallen = false;
+    uint64_t busyFrom = 0, busyExec = 0;   // last instruction's latch time and execution time
+    bool fourBit = false, highHalf = true;
+    uint8_t high = 0;
+    uint8_t initSets = 0;
+    size_t count = 0;
+
+    for (size_t i = 0; i < streamLen; i++) {
+        uint64_t t = streamTime[i];
+        uint32_t next = (lines | (stream[i] & 0xFFFF)) & ~(stream[i] >> 16);
+        uint32_t changed = lines ^ next;
+
+        if (fallen && (changed & rsMask) && t - enFall < TAH_NS)
+            violation(t, "RS hold", t - enFall, TAH_NS);
+        if (fallen && (changed & dataMask) && t - enFall < TH_NS)
+            violation(t, "data hold", t - enFall, TH_NS);
+        if (changed & rsMask)
+            rsChanged = t;
+        if (changed & dataMask)
+            dataChanged = t;
+
+        if ((changed & enMask) && (next & enMask)) {     // rising edge
+            if (t - busyFrom < busyExec)
+                violation(t, "EN raised while busy", t - busyFrom, busyExec);
+            if (risen && t - enRise < TCYCE_NS)
+                violation(t, "tcycE", t - enRise, TCYCE_NS);
+            if (t - rsChanged < TAS_NS)
+                violation(t, "tAS", t - rsChanged, TAS_NS);
+            enRise = t;
+            risen = true;
+        }
+
+        if ((changed & enMask) && !(next & enMask)) {    // falling edge, the nibble is latched
+            if (t - enRise < PWEH_NS)
+                violation(t, "PWEH", t - enRise, PWEH_NS);
+            if (t - dataChanged < TDSW_NS)
+                violation(t, "tDSW", t - dataChanged, TDSW_NS);
+            enFall = t;
+            fallen = true;
+
+            uint8_t nibble = (uint8_t)((lines & dataMask) >> LCD_BSRR_D4_PIN);
+            uint8_t rs = (lines & rsMask) ? 1 : 0;
+            bool complete = false;
+            uint8_t data = 0;
+            if (!fourBit) {     // 8-bit mode, D0-D3 aren't connected and read as 0
+                data = (uint8_t)(nibble << 4);
+                complete = true;
+            } else if (highHalf) {
+                high = nibble;
+                highHalf = false;
+            } else {
+                data = (uint8_t)((high << 4) | nibble);
+                highHalf = true;
+                complete = true;
+            }
+
+            if (complete) {
+                uint64_t exec = EXEC_NS;
+                if (!rs && (data == 0x01 || (data & 0xfe) == 0x02))
+                    exec = EXEC_CLEAR_NS;
+                if (!fourBit && !rs && (data & 0xf0) == 0x30) {
+                    initSets++;
+                    if (initSets == 1)
+                        exec = 4100000ULL;
+                    else if (initSets == 2)
+                        exec = 100000ULL;
+                }
+                if (!rs && (data & 0xe0) == 0x20)
+                    fourBit = !(data & 0x10);
+                busyFrom = t;
+                busyExec = exec;
+
+                if (verbose)
+                    printf("%12.3f us  %s\n", t / 1000.0, describe(rs, data));
+                if (count < capacity)
+                    decoded[count] = (Entry_t){ rs, data };
+                count++;
+            }
+        }
+        lines = next;
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "-v") == 0)
+        verbose = true;
+
+    Entry_t sent[MAX_ENTRIES];
+    size_t sentCount = 0;
+
+    // initialisation, like lcdInit
+    uint64_t t = 0;
+    uint8_t init8[3] = { 0x30, 0x30 | LCD_STATE_EN, 0x30 };
+    uint8_t init4[3] = { 0x20, 0x20 | LCD_STATE_EN, 0x20 };
+    for (int i = 0; i < 3; i++) {
+        t = writeNow(init8, 3, t, 5000);
+        sent[sentCount++] = (Entry_t){ 0, 0x30 };
+    }
+    t = writeNow(init4, 3, t, 0);
+    sent[sentCount++] = (Entry_t){ 0, 0x20 };
+
+    // the queue lcdInit leaves behind (function set, entry mode set, display control, clear and two NOPs), then both lines and a return home
+    Entry_t queue[MAX_ENTRIES];
+    size_t queueCount = 0;
+    const Entry_t setup[] = { { 0, 0x28 }, { 0, 0x06 }, { 0, 0x0C }, { 0, 0x01 }, { 0, 0 }, { 0, 0 } };
+    for (size_t i = 0; i < sizeof(setup) / sizeof(setup[0]); i++)
+        queue[queueCount++] = setup[i];
+    const char* lines[2] = { "Oven  231/250 C ", "Bake 12:34 ON   " };
+    size_t lineStart = queueCount;
+    for (uint8_t row = 0; row < 2; row++) {
+        queue[queueCount++] = (Entry_t){ 0, (uint8_t)(0x80 | (row ? 0x40 : 0)) };
+        for (const char* c = lines[row]; *c; c++)
+            queue[queueCount++] = (Entry_t){ 1, (uint8_t)*c };
+    }
+    size_t lineEnd = queueCount;
+    queue[queueCount++] = (Entry_t){ 0, 0x02 };
+    queue[queueCount++] = (Entry_t){ 0, 0 };
+    queue[queueCount++] = (Entry_t){ 0, 0 };
+
+    for (size_t i = 0; i < queueCount; i++) {
+        if (queue[i].rs || queue[i].data != 0)     // NOPs don't reach the controller
+            sent[sentCount++] = queue[i];
+    }
+
+    t = sendEntries(queue, lineStart, t);
+    uint64_t linesStart = t;
+    size_t wordsBefore = streamLen;
+    t = sendEntries(&queue[lineStart], lineEnd - lineStart, t);
+    uint64_t linesTime = t - linesStart;
+    size_t linesWords = streamLen - wordsBefore;
+    sendEntries(&queue[lineEnd], queueCount - lineEnd, t);
+
+    Entry_t decoded[MAX_ENTRIES];
+    size_t decodedCount = decode(decoded, MAX_ENTRIES);
+
+    bool match = (decodedCount == sentCount);
+    for (size_t i = 0; match && i < sentCount; i++)
+        match = (decoded[i].rs == sent[i].rs && decoded[i].data == sent[i].data);
+    if (!match)
+        printf("MISMATCH: %zu instructions sent, %zu decoded\n", sentCount, decodedCount);
+
+    size_t chars = lineEnd - lineStart - 2;
+    printf("%zu words in %u transfers, %zu instructions decoded\n", streamLen, transferCount, decodedCount);
+    printf("2x16 screen: %zu words, %.1f us, %.0f chars/s (PCF8574 at 100 kHz: 7 bytes per entry, %.0f chars/s)\n",
+        linesWords, linesTime / 1000.0, chars * 1e9 / linesTime, 100000.0 / (7 * 9));
+    printf("%s: %u timing violations\n", (match && violations == 0) ? "PASS" : "FAIL", violations);
+    return (match && violations == 0) ? 0 : 1;
+}
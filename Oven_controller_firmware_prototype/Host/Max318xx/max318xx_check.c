@@ -0,0 +1,396 @@
+/**
+ * @file max318xx_check.c
+ * @brief Checks the MAX31855/MAX31856 driver's decoding, fault bits and error handling on the fake HAL against simulated converters, and measures the acquisition latency of a round.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Four simulated converters (MAX31855, MAX31856, MAX31855, MAX31856) hang on the fake SPI bus. They encode their raw codes as in the datasheets, and a converter read in the wrong clock phase answers one bit late. The MAX31856 keeps the registers written to it.
+ *
+ * Checks:
+ * - configuration: each MAX31856 got CR0 = 0x91 and CR1 = 0x03, a fifth sensor is refused
+ * - decode: the extremes of both chips' codes, then RANDOM_ROUNDS rounds of random codes and fault bits on all four converters. Every reading has to match the code exactly, with the round's number and a timestamp within the round.
+ * - faults: every fault bit of both chips alone, mapped to MAX318XX_FAULT_*
+ * - errors: a round started during another one is refused, an SPI error in the first or a later transfer aborts the round with every chip select released and the unread sensors untouched, the next round succeeds
+ * - latency: from max318xxStartRound to the last reading published, for two and four converters at each SPI prescaler. max318xxStartRound may not take any virtual time and the transfers may not leave the bus idle. The fake HAL adds per transfer up to a microsecond of rounding and FAKE_HAL_POLL_US for the timestamp's HAL_GetTick, the wait loop another microsecond.
+ *
+ * The fake HAL doesn't model the interrupt entry or the HAL's own code, so the latency is the bus-bound part. On the board each transfer adds the completion interrupt's time.
+ *
+ * Usage: max318xx_check
+ * Exit code: 0 - every check passed, 1 - one didn't
+ */
+
+#include "fake_hal.h"
+#include "max318xx_driver.h"
+#include "stdio.h"
+#include "string.h"
+
+#define SENSORS                 MAX318XX_MAX_SENSORS
+#define RANDOM_ROUNDS           20000
+#define PCLK_MHZ                36
+#define ROUND_TIMEOUT_US        10000
+
+#define MAX31855_FRAME_LEN      4
+#define MAX31856_READ_LEN       7
+#define MAX31856_CR0_EXPECTED   0x91
+#define MAX31856_CR1_EXPECTED   0x03
+
+typedef struct SimConverter_t {
+    MAX318xxType_t type;
+    uint16_t csPin;
+    int32_t tc;                 // raw code, MAX31855: 14 bits, MAX31856: 19 bits
+    int32_t cj;                 // raw code, MAX31855: 12 bits, MAX31856: 14 bits
+    uint8_t faults;             // MAX31855: SCV, SCG, OC bits, MAX31856: fault status register
+    uint8_t regs[16];           // MAX31856
+    uint32_t phaseErrors;
+} SimConverter_t;
+
+static SPI_HandleTypeDef hspi;
+static SimConverter_t sims[SENSORS] = {
+    { .type = MAX318XX_TYPE_MAX31855, .csPin = GPIO_PIN_12 },
+    { .type = MAX318XX_TYPE_MAX31856, .csPin = GPIO_PIN_13 },
+    { .type = MAX318XX_TYPE_MAX31855, .csPin = GPIO_PIN_14 },
+    { .type = MAX318XX_TYPE_MAX31856, .csPin = GPIO_PIN_15 },
+};
+static uint8_t indices[SENSORS];
+static uint32_t failures = 0;
+
+static void fail(const char* what, uint8_t sensor) {
+    if (failures++ < 10)
+        printf("  %s (sensor %u)\n", what, sensor);
+}
+
+/* Simulated converters */
+
+static void simTransfer(SimConverter_t* s, const uint8_t* tx, uint8_t* rx, uint16_t len) {
+    uint8_t out[MAX31856_READ_LEN] = { 0 };
+    bool mode1 = (hspi.Instance->CR1 & SPI_CR1_CPHA) != 0;
+    if (s->type == MAX318XX_TYPE_MAX31855) {
+        // D31..D18 thermocouple, D16 any fault, D15..D4 cold junction, D2..D0 SCV, SCG, OC
+        uint32_t frame = ((uint32_t)s->tc & 0x3FFFU) << 18 | ((uint32_t)s->cj & 0xFFFU) << 4 | (s->faults & 0x07U);
+        if (s->faults)
+            frame |= 1UL << 16;
+        for (uint8_t i = 0; i < MAX31855_FRAME_LEN; i++)
+            out[i] = (uint8_t)(frame >> (24 - 8 * i));
+        if (mode1) {
+            s->phaseErrors++;
+            frame >>= 1;
+            for (uint8_t i = 0; i < MAX31855_FRAME_LEN; i++)
+                out[i] = (uint8_t)(frame >> (24 - 8 * i));
+        }
+    } else {
+        if (!mode1)
+            s->phaseErrors++;
+        uint8_t address = tx[0] & 0x0F;
+        if (tx[0] & 0x80) {
+            for (uint16_t i = 1; i < len; i++)
+                s->regs[(address + i - 1) & 0x0F] = tx[i];
+            return;
+        }
+        // CJTH, CJTL: bits 15..2, LTCBH, LTCBM, LTCBL: bits 23..5, SR
+        uint16_t cj = (uint16_t)(((uint32_t)s->cj & 0x3FFFU) << 2);
+        uint32_t tc = ((uint32_t)s->tc & 0x7FFFFU) << 5;
+        s->regs[0x0A] = (uint8_t)(cj >> 8);
+        s->regs[0x0B] = (uint8_t)cj;
+        s->regs[0x0C] = (uint8_t)(tc >> 16);
+        s->regs[0x0D] = (uint8_t)(tc >> 8);
+        s->regs[0x0E] = (uint8_t)tc;
+        s->regs[0x0F] = s->faults;
+        for (uint16_t i = 1; i < len && i < MAX31856_READ_LEN; i++)
+            out[i] = s->regs[(address + i - 1) & 0x0F];
+        if (!mode1)
+            for (uint16_t i = MAX31856_READ_LEN - 1; i > 0; i--)
+                out[i] = (uint8_t)(out[i] >> 1 | out[i - 1] << 7);
+    }
+    if (rx)
+        for (uint16_t i = 0; i < len; i++)
+            rx[i] = (i < MAX31856_READ_LEN) ? out[i] : 0;
+}
+
+static void transfer0(const uint8_t* tx, uint8_t* rx, uint16_t len) { simTransfer(&sims[0], tx, rx, len); }
+static void transfer1(const uint8_t* tx, uint8_t* rx, uint16_t len) { simTransfer(&sims[1], tx, rx, len); }
+static void transfer2(const uint8_t* tx, uint8_t* rx, uint16_t len) { simTransfer(&sims[2], tx, rx, len); }
+static void transfer3(const uint8_t* tx, uint8_t* rx, uint16_t len) { simTransfer(&sims[3], tx, rx, len); }
+
+static const FakeSpiDevice_t devices[SENSORS] = {
+    { GPIOB, GPIO_PIN_12, transfer0 },
+    { GPIOB, GPIO_PIN_13, transfer1 },
+    { GPIOB, GPIO_PIN_14, transfer2 },
+    { GPIOB, GPIO_PIN_15, transfer3 },
+};
+
+/* HAL callbacks, routed like in main.c */
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi_) {
+    (void)hspi_;
+    max318xxTransferCompleteHandler();
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi_) {
+    (void)hspi_;
+    max318xxSpiErrorHandler();
+}
+
+/* Helpers */
+
+static uint32_t rngState = 0x12345678U;
+
+static uint32_t rng(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+// Sign-extends the low bits of a random number
+static int32_t randomCode(uint8_t bits) {
+    return (int32_t)(rng() << (32 - bits)) >> (32 - bits);
+}
+
+static bool setup(uint8_t count, uint32_t prescaler) {
+    hspi.Instance = SPI2;
+    hspi.Init.Mode = SPI_MODE_MASTER;
+    hspi.Init.CLKPhase = SPI_PHASE_1EDGE;
+    hspi.Init.CLKPolarity = SPI_POLARITY_LOW;
+    hspi.Init.BaudRatePrescaler = prescaler;
+    HAL_SPI_Init(&hspi);
+    max318xxInit(&hspi);
+    for (uint8_t i = 0; i < count; i++) {
+        memset(sims[i].regs, 0, sizeof(sims[i].regs));
+        if (max318xxAddSensor(sims[i].type, GPIOB, sims[i].csPin, &indices[i]) != MAX318XX_OK || indices[i] != i)
+            return false;
+    }
+    return true;
+}
+
+static bool csReleased(void) {
+    for (uint8_t i = 0; i < SENSORS; i++)
+        if (!(GPIOB->ODR & sims[i].csPin))
+            return false;
+    return true;
+}
+
+// Runs a round to its end, returns its duration [us] or 0 if it didn't finish
+static uint64_t runRound(MAX318xxStatus_t* status) {
+    uint64_t start = fakeHalMicros();
+    *status = max318xxStartRound();
+    if (fakeHalMicros() != start)
+        fail("max318xxStartRound took virtual time", 0);
+    while (max318xxIsBusy()) {
+        if (fakeHalMicros() - start > ROUND_TIMEOUT_US)
+            return 0;
+        fakeHalAdvance(1);
+    }
+    return fakeHalMicros() - start;
+}
+
+static void expected(const SimConverter_t* s, MAX318xxReading_t* r) {
+    if (s->type == MAX318XX_TYPE_MAX31855) {
+        r->temperature = s->tc * 16384;     // 0.25 degC
+        r->coldJunction = s->cj * 4096;     // 0.0625 degC
+        r->faults = s->faults & 0x07;       // same order as MAX318XX_FAULT_*
+        return;
+    }
+    r->temperature = s->tc * 512;           // 2^-7 degC
+    r->coldJunction = s->cj * 1024;         // 2^-6 degC
+    static const uint8_t map[8] = {
+        MAX318XX_FAULT_OPEN, MAX318XX_FAULT_OVUV, MAX318XX_FAULT_TC_LIMIT, MAX318XX_FAULT_TC_LIMIT,
+        MAX318XX_FAULT_CJ_LIMIT, MAX318XX_FAULT_CJ_LIMIT, MAX318XX_FAULT_TC_RANGE, MAX318XX_FAULT_CJ_RANGE,
+    };
+    r->faults = 0;
+    for (uint8_t b = 0; b < 8; b++)
+        if (s->faults & (1U << b))
+            r->faults |= map[b];
+}
+
+// Runs a round and compares every reading with its converter
+static void checkRound(uint8_t count) {
+    uint32_t tickBefore = (uint32_t)(fakeHalMicros() / 1000U);
+    MAX318xxStatus_t status;
+    if (runRound(&status) == 0 || status != MAX318XX_OK || max318xxGetStatus() != MAX318XX_OK) {
+        fail("round failed", 0);
+        return;
+    }
+    uint32_t tickAfter = (uint32_t)(fakeHalMicros() / 1000U);
+    for (uint8_t i = 0; i < count; i++) {
+        MAX318xxReading_t r, e;
+        expected(&sims[i], &e);
+        if (max318xxGetReading(indices[i], &r) != MAX318XX_OK) {
+            fail("no reading", i);
+            continue;
+        }
+        if (r.temperature != e.temperature || r.coldJunction != e.coldJunction)
+            fail("temperature decoded wrong", i);
+        if (r.faults != e.faults)
+            fail("fault bits decoded wrong", i);
+        if (r.round != max318xxGetRoundCount())
+            fail("reading from the wrong round", i);
+        if (r.timestamp < tickBefore || r.timestamp > tickAfter)
+            fail("timestamp outside the round", i);
+    }
+}
+
+/* Checks */
+
+static void checkConfiguration(void) {
+    setup(SENSORS, SPI_BAUDRATEPRESCALER_8);
+    for (uint8_t i = 0; i < SENSORS; i++)
+        if (sims[i].type == MAX318XX_TYPE_MAX31856 && (sims[i].regs[0] != MAX31856_CR0_EXPECTED || sims[i].regs[1] != MAX31856_CR1_EXPECTED))
+            fail("MAX31856 not configured", i);
+    uint8_t index;
+    if (max318xxAddSensor(MAX318XX_TYPE_MAX31855, GPIOB, GPIO_PIN_11, &index) != MAX318XX_TOO_MANY_SENSORS)
+        fail("fifth sensor accepted", SENSORS);
+    MAX318xxReading_t r;
+    if (max318xxGetReading(indices[0], &r) != MAX318XX_NO_READING)
+        fail("reading before the first round", 0);
+}
+
+static void checkExtremes(void) {
+    static const int32_t codes55[][2] = { { 0, 0 }, { 8191, 2047 }, { -8192, -2048 }, { 1, 1 }, { -1, -1 }, { 5488, 400 }, { -1080, -640 } };
+    static const int32_t codes56[][2] = { { 0, 0 }, { 262143, 8191 }, { -262144, -8192 }, { 1, 1 }, { -1, -1 }, { 175616, 1600 }, { -34560, -2560 } };
+    setup(SENSORS, SPI_BAUDRATEPRESCALER_8);
+    for (uint8_t k = 0; k < sizeof(codes55) / sizeof(codes55[0]); k++) {
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            const int32_t* c = (sims[i].type == MAX318XX_TYPE_MAX31855) ? codes55[k] : codes56[k];
+            sims[i].tc = c[0];
+            sims[i].cj = c[1];
+            sims[i].faults = 0;
+        }
+        checkRound(SENSORS);
+    }
+}
+
+static void checkRandom(void) {
+    setup(SENSORS, SPI_BAUDRATEPRESCALER_8);
+    for (uint32_t n = 0; n < RANDOM_ROUNDS; n++) {
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            bool is55 = (sims[i].type == MAX318XX_TYPE_MAX31855);
+            sims[i].tc = randomCode(is55 ? 14 : 19);
+            sims[i].cj = randomCode(is55 ? 12 : 14);
+            sims[i].faults = (rng() & 3U) ? 0 : (uint8_t)(rng() & (is55 ? 0x07U : 0xFFU));
+        }
+        checkRound(SENSORS);
+    }
+}
+
+static void checkFaults(void) {
+    setup(SENSORS, SPI_BAUDRATEPRESCALER_8);
+    for (uint8_t b = 0; b < 8; b++) {
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            sims[i].tc = 100 + i;
+            sims[i].cj = 20 + i;
+            sims[i].faults = (sims[i].type == MAX318XX_TYPE_MAX31855 && b >= 3) ? 0 : (uint8_t)(1U << b);
+        }
+        checkRound(SENSORS);
+    }
+}
+
+static void checkErrors(void) {
+    setup(SENSORS, SPI_BAUDRATEPRESCALER_8);
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        sims[i].tc = 400;
+        sims[i].cj = 100;
+        sims[i].faults = 0;
+    }
+    checkRound(SENSORS);
+    uint32_t rounds = max318xxGetRoundCount();
+
+    if (max318xxStartRound() != MAX318XX_OK || max318xxStartRound() != MAX318XX_BUSY)
+        fail("second round started during the first", 0);
+    MAX318xxStatus_t status;
+    while (max318xxIsBusy())
+        fakeHalAdvance(1);
+    rounds = max318xxGetRoundCount();
+
+    // the first transfer fails
+    fakeSpiFailNext(1);
+    runRound(&status);
+    if (status != MAX318XX_OK || max318xxGetStatus() != MAX318XX_SPI_ERROR || !csReleased() || max318xxGetRoundCount() != rounds)
+        fail("SPI error in the first transfer not handled", 0);
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        MAX318xxReading_t r;
+        if (max318xxGetReading(indices[i], &r) != MAX318XX_OK || r.round != rounds)
+            fail("reading changed by a failed round", i);
+    }
+
+    // the second transfer fails, the first sensor's reading is already published
+    uint64_t start = fakeHalMicros();
+    if (max318xxStartRound() != MAX318XX_OK)
+        fail("round not started after an error", 0);
+    MAX318xxReading_t r;
+    while (max318xxGetReading(indices[0], &r) == MAX318XX_OK && r.round == rounds && fakeHalMicros() - start < ROUND_TIMEOUT_US)
+        fakeHalAdvance(1);
+    fakeSpiFailNext(1);
+    while (max318xxIsBusy())
+        fakeHalAdvance(1);
+    if (max318xxGetStatus() != MAX318XX_SPI_ERROR || !csReleased() || max318xxGetRoundCount() != rounds)
+        fail("SPI error in a later transfer not handled", 1);
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        max318xxGetReading(indices[i], &r);
+        if (r.round != ((i == 0) ? rounds + 1 : rounds))
+            fail("wrong readings after a failed round", i);
+    }
+
+    // and the next round recovers
+    checkRound(SENSORS);
+    if (max318xxGetRoundCount() != rounds + 1)
+        fail("round count wrong after recovering", 0);
+}
+
+static void checkPhase(void) {
+    for (uint8_t i = 0; i < SENSORS; i++)
+        if (sims[i].phaseErrors > 0)
+            fail("read in the wrong SPI mode", i);
+}
+
+/* Latency */
+
+static uint32_t busTimeNs(MAX318xxType_t type, uint32_t divider) {
+    uint32_t bytes = (type == MAX318XX_TYPE_MAX31855) ? MAX31855_FRAME_LEN : MAX31856_READ_LEN;
+    return bytes * 8U * divider * 1000U / PCLK_MHZ;
+}
+
+static bool latency(void) {
+    static const uint32_t prescalers[] = { SPI_BAUDRATEPRESCALER_4, SPI_BAUDRATEPRESCALER_8, SPI_BAUDRATEPRESCALER_16 };
+    bool ok = true;
+    printf("\n%9s %9s %8s %12s %12s\n", "prescaler", "SCK[MHz]", "sensors", "bus[us]", "round[us]");
+    for (uint8_t p = 0; p < sizeof(prescalers) / sizeof(prescalers[0]); p++) {
+        uint32_t divider = 2U << (prescalers[p] >> 3);
+        for (uint8_t count = 2; count <= SENSORS; count += 2) {
+            setup(count, prescalers[p]);
+            uint32_t busNs = 0;
+            for (uint8_t i = 0; i < count; i++)
+                busNs += busTimeNs(sims[i].type, divider);
+            MAX318xxStatus_t status;
+            uint64_t us = runRound(&status);
+            printf("%9u %9.2f %8u %12.2f %12llu\n", divider, (double)PCLK_MHZ / divider, count, busNs / 1000.0, (unsigned long long)us);
+            ok &= us > 0 && status == MAX318XX_OK && us * 1000U <= busNs + count * (1000U + FAKE_HAL_POLL_US * 1000U) + 1000U;
+        }
+    }
+    return ok;
+}
+
+int main(void) {
+    HAL_Init();
+    fakeHalSetRunTime(0);
+    for (uint8_t i = 0; i < SENSORS; i++)
+        fakeSpiAttach(&devices[i]);
+
+    checkConfiguration();
+    printf("configuration           %s\n", failures ? "FAIL" : "ok");
+    uint32_t before = failures;
+    checkExtremes();
+    checkRandom();
+    printf("decode (%5u rounds)    %s\n", RANDOM_ROUNDS, failures > before ? "FAIL" : "ok");
+    before = failures;
+    checkFaults();
+    printf("fault bits              %s\n", failures > before ? "FAIL" : "ok");
+    before = failures;
+    checkErrors();
+    printf("SPI errors              %s\n", failures > before ? "FAIL" : "ok");
+    before = failures;
+    checkPhase();
+    printf("SPI modes               %s\n", failures > before ? "FAIL" : "ok");
+    bool ok = latency() && failures == 0;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file mcp9600_check.c
+ * @brief Runs the MCP9600 driver on the fake HAL against simulated converters sharing the I2C bus with the LCD, checking the readings and measuring the reads per second with and without LCD traffic.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Two simulated MCP9600s (SENSOR_ADDRESS_A and _B) have a register map: the register pointer, the configuration registers, the device ID and the temperature registers. Once the device configuration is written, each converts continuously at the time its ADC resolution takes, with its oscillator off by OSCILLATOR_ERROR (one slow, one fast). Conversion n reads HOT_BASE + n in the hot-junction register, so every reading tells which conversion it came from. The LCD is the timed HD44780 model, fed by the main loop with full-screen refreshes as fast as its queue takes them. Above 100 kHz the LCD driver checks the busy flag, its fixed timing is only long enough at 100 kHz (see LcdRefresh/lcd_refresh.c).
+ *
+ * The main loop runs every millisecond for RUN_S of virtual time: mcp9600Process, then the LCD queue is topped up. Runs at 100 and 400 kHz, each with and without the LCD traffic (and one of the LCD alone for its rate).
+ *
+ * Reported per run: completed rounds and register reads per second, conversions read twice or skipped, the age of the conversion at its read, and LCD writes per second.
+ *
+ * Usage: mcp9600_check
+ * Exit code: 0 - every run decoded every reading exactly, never read a conversion twice, never polled the status register, kept up one round per MCP9600_READ_PERIOD_MS and left the LCD showing the last refresh without ignored writes, 1 - not, 2 - the driver failed
+ */
+
+#include "fake_hal.h"
+#include "hd44780_model.h"
+#include "i2c_bus.h"
+#include "lcd_hd44780_pcf8574_driver.h"
+#include "mcp9600_driver.h"
+#include "stdio.h"
+#include "string.h"
+
+#define LCD_ADDRESS             0x27
+#define SENSOR_ADDRESS_A        0x60
+#define SENSOR_ADDRESS_B        0x67
+#define SENSORS                 2
+#define COLUMNS                 16
+
+#define RUN_S                   10
+#define LOOP_US                 1000
+#define IDLE_TIMEOUT_US         1000000U
+#define OSCILLATOR_ERROR        0.04    // converters up to 4 % slower or faster, within the driver's 5 % margin
+#define HOT_BASE                1600    // 100 degC in 0.0625 degC
+#define COLD_CODE               400     // 25 degC
+
+#define REG_HOT_JUNCTION        0x00
+#define REG_COLD_JUNCTION       0x02
+#define REG_STATUS              0x04
+#define REG_SENSOR_CONFIG       0x05
+#define REG_DEVICE_CONFIG       0x06
+#define REG_DEVICE_ID           0x20
+#define DEVICE_ID               0x4011
+#define DC_ADC_RES_SHIFT        5
+#define DC_MODE_MASK            0x03
+
+typedef struct SimMcp9600_t {
+    uint8_t address;
+    double oscillator;          // conversion time factor
+    uint8_t pointer;
+    uint8_t sensorConfig;
+    uint8_t deviceConfig;
+    bool converting;
+    uint64_t convStart;         // [us]
+    uint32_t convUs;
+    uint32_t reads;             // temperature register reads
+    uint32_t statusReads;
+    uint64_t ageSum;            // [us]
+    uint64_t ageMax;            // [us]
+} SimMcp9600_t;
+
+typedef struct RunResult_t {
+    double rounds;              // per second
+    double reads;               // temperature registers per second
+    uint32_t statusReads;
+    uint32_t twice;             // rounds that returned the previous round's conversion
+    uint32_t skipped;           // conversions no round read
+    uint32_t wrong;             // readings that don't decode to a conversion
+    double ageMean;             // [ms]
+    double ageMax;              // [ms]
+    double lcdWrites;           // per second
+    bool lcdIntact;
+    uint32_t ignored;
+} RunResult_t;
+
+static I2C_HandleTypeDef hi2c;
+static SimMcp9600_t sims[SENSORS] = {
+    { .address = SENSOR_ADDRESS_A, .oscillator = 1.0 + OSCILLATOR_ERROR },
+    { .address = SENSOR_ADDRESS_B, .oscillator = 1.0 - OSCILLATOR_ERROR },
+};
+
+/* Simulated MCP9600 */
+
+// ADC resolution 18, 16, 14 and 12 bits
+static const uint32_t conversionUs[4] = { 320000, 80000, 20000, 5000 };
+
+// The last finished conversion at a time, -1 before the first one
+static int32_t conversionAt(const SimMcp9600_t* s, uint64_t t) {
+    if (!s->converting || t < s->convStart + s->convUs)
+        return -1;
+    return (int32_t)((t - s->convStart) / s->convUs) - 1;
+}
+
+static bool simWrite(SimMcp9600_t* s, const uint8_t* data, uint16_t len) {
+    if (len == 0)
+        return true;
+    s->pointer = data[0];
+    if (len < 2)
+        return true;
+    if (s->pointer == REG_SENSOR_CONFIG) {
+        s->sensorConfig = data[1];
+    } else if (s->pointer == REG_DEVICE_CONFIG) {
+        s->deviceConfig = data[1];
+        s->converting = (data[1] & DC_MODE_MASK) == 0;
+        s->convStart = fakeI2CByteTime(1);
+        s->convUs = (uint32_t)(conversionUs[(data[1] >> DC_ADC_RES_SHIFT) & 0x03] * s->oscillator);
+    }
+    return true;
+}
+
+static bool simRead(SimMcp9600_t* s, uint8_t* data, uint16_t len) {
+    uint64_t t = fakeI2CByteTime(0);
+    int32_t n = conversionAt(s, t);
+    uint16_t word = 0;
+    switch (s->pointer) {
+        case REG_HOT_JUNCTION:
+            s->reads++;
+            if (n >= 0) {
+                word = (uint16_t)(HOT_BASE + n);
+                uint64_t age = t - (s->convStart + (uint64_t)(n + 1) * s->convUs);
+                s->ageSum += age;
+                if (age > s->ageMax)
+                    s->ageMax = age;
+            }
+            break;
+        case REG_COLD_JUNCTION:
+            s->reads++;
+            word = (n >= 0) ? COLD_CODE : 0;
+            break;
+        case REG_STATUS:
+            s->statusReads++;
+            break;
+        case REG_SENSOR_CONFIG:
+            word = (uint16_t)(s->sensorConfig << 8);
+            break;
+        case REG_DEVICE_CONFIG:
+            word = (uint16_t)(s->deviceConfig << 8);
+            break;
+        case REG_DEVICE_ID:
+            word = DEVICE_ID;
+            break;
+    }
+    for (uint16_t i = 0; i < len; i++)
+        data[i] = (i == 0) ? (uint8_t)(word >> 8) : (i == 1) ? (uint8_t)word : 0;
+    return true;
+}
+
+static bool writeA(const uint8_t* data, uint16_t len) { return simWrite(&sims[0], data, len); }
+static bool readA(uint8_t* data, uint16_t len) { return simRead(&sims[0], data, len); }
+static bool writeB(const uint8_t* data, uint16_t len) { return simWrite(&sims[1], data, len); }
+static bool readB(uint8_t* data, uint16_t len) { return simRead(&sims[1], data, len); }
+
+static const FakeI2CDevice_t devices[SENSORS] = {
+    { SENSOR_ADDRESS_A, writeA, readA },
+    { SENSOR_ADDRESS_B, writeB, readB },
+};
+
+/* HAL callbacks, routed like in main.c */
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c_) {
+    (void)hi2c_;
+    i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c_) {
+    (void)hi2c_;
+    i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c_) {
+    (void)hi2c_;
+    i2cBusErrorHandler();
+}
+
+/* LCD traffic: cursor to line 0, its text, cursor to line 1, its text, over and over */
+
+static char lines[2][COLUMNS + 1];
+static uint32_t pass = 0;
+static uint8_t step = 0;
+
+static void nextText(void) {
+    snprintf(lines[0], sizeof(lines[0]), "Refresh %8u", pass);
+    snprintf(lines[1], sizeof(lines[1]), "Stone %6u C  ", pass % 1000);
+}
+
+// Tops up the LCD queue, returns true at the end of a refresh
+static bool feedLcd(void) {
+    while (!lcdQueueIsFull()) {
+        uint8_t line = step / (COLUMNS + 1);
+        uint8_t col = step % (COLUMNS + 1);
+        if (col == 0)
+            lcdSetCursorPos(line, 0);
+        else
+            lcdPrintChar((uint8_t)lines[line][col - 1]);
+        if (++step == 2 * (COLUMNS + 1)) {
+            step = 0;
+            pass++;
+            nextText();
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool waitIdle(void) {
+    uint64_t start = fakeHalMicros();
+    while (!i2cBusIsIdle()) {
+        if (fakeHalMicros() - start > IDLE_TIMEOUT_US)
+            return false;
+        fakeHalAdvance(1);
+    }
+    return true;
+}
+
+/* Runs */
+
+static bool run(uint32_t byteUs, bool sensors, bool lcd, RunResult_t* r) {
+    memset(r, 0, sizeof(*r));
+    fakeI2CSetByteTime(byteUs);
+    hd44780ModelReset();
+    i2cBusInit(&hi2c);
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        SimMcp9600_t* s = &sims[i];
+        s->converting = false;
+        s->reads = s->statusReads = 0;
+        s->ageSum = s->ageMax = 0;
+    }
+    uint8_t index[SENSORS];
+    if (mcp9600Init() != MCP9600_OK)
+        return false;
+    if (sensors)
+        for (uint8_t i = 0; i < SENSORS; i++)
+            if (mcp9600AddSensor(sims[i].address, &index[i]) != MCP9600_OK)
+                return false;
+    if (lcd) {
+        pass = 0;
+        step = 0;
+        nextText();
+        if (lcdSetBusyFlagCheck(byteUs < FAKE_I2C_BYTE_US) != LCD_OK || lcdInit(&hi2c, LCD_ADDRESS, 2, 8, true) != LCD_OK || !waitIdle())
+            return false;
+    }
+    HD44780Stats_t before;
+    hd44780ModelGetStats(&before);
+
+    uint64_t start = fakeHalMicros();
+    uint32_t lastRound = 0;
+    int32_t lastConversion[SENSORS] = { -1, -1 };
+    while (fakeHalMicros() - start < (uint64_t)RUN_S * 1000000U) {
+        mcp9600Process();
+        if (lcd)
+            feedLcd();
+        fakeHalAdvance(LOOP_US);
+
+        uint32_t rounds = mcp9600GetRoundCount();
+        if (!sensors || rounds == lastRound)
+            continue;
+        lastRound = rounds;
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            MCP9600Reading_t reading;
+            if (mcp9600GetReading(index[i], &reading) != MCP9600_OK) {
+                r->wrong++;
+                continue;
+            }
+            int32_t n = reading.temperature / (1 << 12) - HOT_BASE;
+            if (reading.temperature % (1 << 12) != 0 || reading.coldJunction != COLD_CODE * (1 << 12) || n < 0) {
+                r->wrong++;
+                continue;
+            }
+            if (n <= lastConversion[i])
+                r->twice++;
+            else if (lastConversion[i] >= 0)
+                r->skipped += (uint32_t)(n - lastConversion[i] - 1);
+            lastConversion[i] = n;
+        }
+    }
+    double seconds = (fakeHalMicros() - start) / 1e6;
+    if (lcd) {
+        while (!feedLcd())
+            fakeHalAdvance(LOOP_US);
+        if (!waitIdle() || lcdGetStatus() != LCD_OK)
+            return false;
+        const char* ddram = hd44780ModelDdram();
+        char shown[2][COLUMNS + 1];
+        pass--;
+        nextText();
+        memcpy(shown, lines, sizeof(shown));
+        r->lcdIntact = memcmp(ddram, shown[0], COLUMNS) == 0 && memcmp(&ddram[0x40], shown[1], COLUMNS) == 0;
+    } else {
+        r->lcdIntact = true;
+    }
+    if (sensors && mcp9600GetStatus() != MCP9600_OK)
+        return false;
+
+    HD44780Stats_t after;
+    hd44780ModelGetStats(&after);
+    r->lcdWrites = (after.executed - before.executed) / seconds;
+    r->ignored = after.ignored;
+    r->rounds = mcp9600GetRoundCount() / seconds;
+    uint32_t reads = 0;
+    uint64_t ageSum = 0;
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        reads += sims[i].reads;
+        r->statusReads += sims[i].statusReads;
+        ageSum += sims[i].ageSum;
+        if (sims[i].ageMax / 1000.0 > r->ageMax)
+            r->ageMax = sims[i].ageMax / 1000.0;
+    }
+    r->ageMean = reads ? ageSum / 1000.0 / (reads / 2.0) : 0.0;     // hot-junction reads only
+    r->reads = reads / seconds;
+    return true;
+}
+
+int main(void) {
+    static const uint32_t speeds[] = { 90, 23 };
+    static const struct { const char* name; bool sensors; bool lcd; } setups[] = {
+        { "MCP9600 only", true, false },
+        { "LCD only", false, true },
+        { "both", true, true },
+    };
+
+    HAL_Init();
+    fakeHalSetRunTime(0);
+    hd44780ModelAttach(LCD_ADDRESS);
+    for (uint8_t i = 0; i < SENSORS; i++)
+        fakeI2CAttach(&devices[i]);
+    HAL_I2C_Init(&hi2c);
+
+    bool ok = true;
+    printf("%u converters, oscillators %+.0f %%, read period %u ms, %u s per run\n", SENSORS, 100.0 * OSCILLATOR_ERROR, MCP9600_READ_PERIOD_MS, RUN_S);
+    printf("%7s %-13s %9s %8s %6s %8s %6s %13s %12s %13s %8s  %s\n", "bus", "setup", "rounds/s", "reads/s", "twice", "skipped", "wrong",
+        "mean age[ms]", "max age[ms]", "status reads", "LCD w/s", "display");
+    for (uint8_t s = 0; s < sizeof(speeds) / sizeof(speeds[0]); s++) {
+        for (uint8_t k = 0; k < sizeof(setups) / sizeof(setups[0]); k++) {
+            RunResult_t r;
+            if (!run(speeds[s], setups[k].sensors, setups[k].lcd, &r)) {
+                fprintf(stderr, "driver failed (MCP9600 status %d, LCD status %d)\n", (int)mcp9600GetStatus(), (int)lcdGetStatus());
+                return 2;
+            }
+            printf("%3u kHz %-13s %9.2f %8.1f %6u %8u %6u %13.1f %12.1f %13u %8.0f  %s\n", (unsigned)((9000 + speeds[s] / 2) / speeds[s]), setups[k].name,
+                r.rounds, r.reads, r.twice, r.skipped, r.wrong, r.ageMean, r.ageMax, r.statusReads, r.lcdWrites,
+                (r.lcdIntact && r.ignored == 0) ? "ok" : "WRONG");
+            ok &= r.lcdIntact && r.ignored == 0;
+            if (setups[k].sensors)
+                ok &= r.wrong == 0 && r.twice == 0 && r.statusReads == 0 && r.rounds >= 0.98 * 1000.0 / MCP9600_READ_PERIOD_MS;
+        }
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file mimo_zones.c
+ * @brief Runs the independent top/bottom mode on the thermal plant: the 2x2 controller with and without its decoupler, reporting settling times and how much a step or a disturbance in one zone moves the other.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The top zone is the chamber air (its thermocouple), the bottom zone the stone. Both heaters warm both zones through the plant's links, which is the coupling the decoupler has to undo. Every mode gets the same PID gains and the same scenario:
+ * - preheat from ambient to both setpoints
+ * - a top setpoint step at STEP_TOP_S, the bottom zone should stay where it is
+ * - a bottom setpoint step at STEP_BOTTOM_S, the top zone should stay where it is
+ * - the door open for DOOR_OPEN_S seconds at DOOR_S
+ *
+ * The coupling matrix for the static and dynamic decoupler is identified the way mimo_controller.h describes it: the zones' rise after COUPLING_HORIZON_S at full power of each heater, measured on the plant from ambient. The horizon is a few of the loops' time constants. The plant's steady-state gain ([621 497; 712 635] degC) is too close to singular to invert usefully: det(G) is ~10% of g00*g11, and a decoupler built from it compensates cross effects that take hours to arrive. With the 900 s rise the static decoupler already recovered from the door slower than two plain PIDs (77 s against 62 s). The heater duties go through the joint modulator with the prototype's current cap, so the plant sees real half-cycle patterns.
+ *
+ * Settling time: from the start of a phase until the zone last entered +-BAND_C around its setpoint, "both" is the later of the two (the oven is ready). Cross deviation: the largest distance of the other zone from its setpoint in the same phase.
+ *
+ * The static decoupler settles faster, but it cuts the other heater before that heater's cross effect arrives, so after the bottom step and the door the other zone dips further than with two PIDs. The dynamic decoupler's lagged cross terms keep the other zone closer to its setpoint during both steps, but during the preheat they let the stone overshoot like the two PIDs do, and it takes longer to come back.
+ *
+ * Usage: mimo_zones [-v]
+ * Exit code: 0 - every mode settled in every phase, the static decoupler had both zones settled no later than the two PIDs in every phase, and the dynamic decoupler settled both setpoint steps no later with smaller cross deviations, 1 - not
+ */
+
+#include "heater_output.h"
+#include "mimo_controller.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100
+#define CONTROL_PERIOD_S        1.0f
+#define MAINS_VOLTAGE           230.0f
+#define CURRENT_CAP_A           16.0f
+#define AMBIENT_C               22.0f
+#define BAND_C                  2.0f
+
+#define TOP_SETPOINT_C          260.0f
+#define BOTTOM_SETPOINT_C       310.0f
+#define STEP_C                  10.0f
+#define STEP_TOP_S              7200
+#define STEP_BOTTOM_S           10800
+#define DOOR_S                  14400
+#define DOOR_OPEN_S             20
+#define END_S                   18000
+
+#define COUPLING_HORIZON_S      240.0f
+#define CROSS_TAU_S             30.0f
+#define PHASES                  4
+
+typedef struct PhaseResult_t {
+    float settling[MIMO_ZONES];     // [s], NAN if the zone didn't settle within the phase
+    float deviation[MIMO_ZONES];    // largest distance from the setpoint [degC]
+} PhaseResult_t;
+
+typedef struct ModeResult_t {
+    const char* name;
+    MIMODecoupler_t mode;
+    PhaseResult_t phase[PHASES];
+} ModeResult_t;
+
+static const PIDGains_t gains[MIMO_ZONES] = {
+    { .kp = 0.05f, .ki = 0.0004f, .kd = 0.0f },     // chamber air
+    { .kp = 0.08f, .ki = 0.0002f, .kd = 0.0f },     // stone
+};
+
+static const char* phaseNames[PHASES] = { "preheat", "top step", "bottom step", "door" };
+static const uint32_t phaseStart[PHASES + 1] = { 0, STEP_TOP_S, STEP_BOTTOM_S, DOOR_S, END_S };
+
+/* Plant coupling */
+
+// Rise of both zones after horizon seconds at full power of one heater, starting from ambient
+static void plantCoupling(const PlantParams_t* p, float horizon, float g[MIMO_ZONES * MIMO_ZONES]) {
+    const uint8_t bit[MIMO_ZONES] = { HEATER_TOP_BIT, HEATER_BOTTOM_BIT };
+    for (uint8_t j = 0; j < MIMO_ZONES; j++) {
+        ThermalPlant_t tp;
+        plantInit(&tp, p, AMBIENT_C);
+        PlantInputs_t in = { bit[j], false, AMBIENT_C };
+        for (uint32_t k = 0; k < (uint32_t)(horizon / HALF_CYCLE_S); k++)
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        g[MIMO_TOP * MIMO_ZONES + j] = tp.sensor - AMBIENT_C;
+        g[MIMO_BOTTOM * MIMO_ZONES + j] = tp.temperature[PLANT_STONE] - AMBIENT_C;
+    }
+}
+
+/* Runs */
+
+static void zones(const ThermalPlant_t* tp, float measurement[MIMO_ZONES]) {
+    measurement[MIMO_TOP] = tp->sensor;
+    measurement[MIMO_BOTTOM] = tp->temperature[PLANT_STONE];
+}
+
+static void run(ModeResult_t* r, const float g[MIMO_ZONES * MIMO_ZONES], bool verbose) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    MIMOController_t mc;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    mimoInit(&mc, gains, CONTROL_PERIOD_S, r->mode);
+    if (r->mode != MIMO_DECOUPLER_OFF) {
+        mimoSetCoupling(&mc, g);
+        mimoSetCrossLag(&mc, CROSS_TAU_S);
+    }
+    heaterOutInit(&ho, pp->topPower / MAINS_VOLTAGE, pp->bottomPower / MAINS_VOLTAGE, CURRENT_CAP_A);
+    plantInit(&tp, pp, AMBIENT_C);
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    float setpoint[MIMO_ZONES] = { TOP_SETPOINT_C, BOTTOM_SETPOINT_C };
+    float measurement[MIMO_ZONES];
+    float lastOutside[MIMO_ZONES];
+    uint8_t phase = 0;
+    for (uint8_t p = 0; p < PHASES; p++) {
+        for (uint8_t z = 0; z < MIMO_ZONES; z++) {
+            r->phase[p].settling[z] = NAN;
+            r->phase[p].deviation[z] = 0.0f;
+        }
+    }
+
+    for (uint32_t t = 0; t < END_S; t++) {
+        if (t == phaseStart[phase + 1]) {
+            phase++;
+            if (t == STEP_TOP_S)
+                setpoint[MIMO_TOP] += STEP_C;
+            else if (t == STEP_BOTTOM_S)
+                setpoint[MIMO_BOTTOM] += STEP_C;
+        }
+        if (t == phaseStart[phase])
+            for (uint8_t z = 0; z < MIMO_ZONES; z++)
+                lastOutside[z] = (float)t;
+        in.doorOpen = (t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S);
+
+        float duty[MIMO_ZONES];
+        zones(&tp, measurement);
+        mimoStep(&mc, setpoint, measurement, duty);
+        heaterOutSetDuty(&ho, duty[MIMO_TOP], duty[MIMO_BOTTOM]);
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = heaterOutNextHalfCycle(&ho);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+
+        zones(&tp, measurement);
+        PhaseResult_t* pr = &r->phase[phase];
+        for (uint8_t z = 0; z < MIMO_ZONES; z++) {
+            float err = fabsf(measurement[z] - setpoint[z]);
+            if (err > BAND_C)
+                lastOutside[z] = (float)(t + 1);
+            if (phase > 0 && err > pr->deviation[z])
+                pr->deviation[z] = err;
+        }
+        if (t + 1 == phaseStart[phase + 1]) {
+            for (uint8_t z = 0; z < MIMO_ZONES; z++) {
+                float err = fabsf(measurement[z] - setpoint[z]);
+                pr->settling[z] = (err <= BAND_C) ? lastOutside[z] - (float)phaseStart[phase] : NAN;
+            }
+        }
+        if (verbose && t % 60 == 0)
+            printf("%s,%u,%.2f,%.2f,%.3f,%.3f\n", r->name, t, measurement[MIMO_TOP], measurement[MIMO_BOTTOM], duty[MIMO_TOP], duty[MIMO_BOTTOM]);
+    }
+}
+
+// both zones settled [s], NAN if one didn't
+static float ready(const PhaseResult_t* pr) {
+    if (isnan(pr->settling[MIMO_TOP]) || isnan(pr->settling[MIMO_BOTTOM]))
+        return NAN;
+    return fmaxf(pr->settling[MIMO_TOP], pr->settling[MIMO_BOTTOM]);
+}
+
+static void printSeconds(float s) {
+    if (isnan(s))
+        printf(" %9s", "-");
+    else
+        printf(" %9.0f", s);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    float g[MIMO_ZONES * MIMO_ZONES];
+    plantCoupling(&plantDefaultParams, COUPLING_HORIZON_S, g);
+    printf("identified coupling [degC after %.0f s at full power]: air %.0f %.0f, stone %.0f %.0f (top heater, bottom heater)\n", COUPLING_HORIZON_S, g[0], g[1], g[2], g[3]);
+
+    ModeResult_t results[] = {
+        { .name = "two PIDs", .mode = MIMO_DECOUPLER_OFF },
+        { .name = "static decoupler", .mode = MIMO_DECOUPLER_STATIC },
+        { .name = "dynamic decoupler", .mode = MIMO_DECOUPLER_DYNAMIC },
+    };
+    const uint8_t count = sizeof(results) / sizeof(results[0]);
+    if (verbose)
+        printf("mode,t,top,bottom,top duty,bottom duty\n");
+    for (uint8_t m = 0; m < count; m++)
+        run(&results[m], g, verbose);
+
+    printf("setpoints: air %.0f, stone %.0f degC, +%.0f degC steps, band +-%.0f degC\n", TOP_SETPOINT_C, BOTTOM_SETPOINT_C, STEP_C, BAND_C);
+    printf("%-20s %-12s %9s %9s %9s %14s %14s\n", "mode", "phase", "air[s]", "stone[s]", "both[s]", "air dev[C]", "stone dev[C]");
+    bool ok = true;
+    for (uint8_t m = 0; m < count; m++) {
+        for (uint8_t p = 0; p < PHASES; p++) {
+            const PhaseResult_t* pr = &results[m].phase[p];
+            printf("%-20s %-12s", p == 0 ? results[m].name : "", phaseNames[p]);
+            printSeconds(pr->settling[MIMO_TOP]);
+            printSeconds(pr->settling[MIMO_BOTTOM]);
+            printSeconds(ready(pr));
+            printf(" %14.2f %14.2f\n", pr->deviation[MIMO_TOP], pr->deviation[MIMO_BOTTOM]);
+            ok &= !isnan(ready(pr));
+        }
+    }
+
+    // settling against the two PIDs, cross deviations: the stone during the top step, the air during the bottom step
+    const PhaseResult_t* pids = results[0].phase;
+    const PhaseResult_t* stat = results[1].phase;
+    const PhaseResult_t* dyn = results[2].phase;
+    for (uint8_t p = 0; p < PHASES; p++)
+        ok &= ready(&stat[p]) <= ready(&pids[p]);
+    for (uint8_t p = 1; p <= 2; p++)
+        ok &= ready(&dyn[p]) <= ready(&pids[p]);
+    ok &= dyn[1].deviation[MIMO_BOTTOM] < pids[1].deviation[MIMO_BOTTOM] && dyn[2].deviation[MIMO_TOP] < pids[2].deviation[MIMO_TOP];
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+/**
+ * @file mlx90614_check.c
+ * @brief Runs the MLX90614 driver on the fake HAL against a simulated sensor that corrupts words on purpose, checking the PEC handling, the decoding and the achieved sample rate.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The simulated sensor answers SMBus "read word" for its Ta and Tobj1 RAM registers with a fresh word on every read and the PEC of the whole transaction, computed bit by bit here (independent of the CRC unit the driver uses). Each read can be spoiled in one of these ways:
+ * - PEC: the PEC byte is wrong
+ * - bit flip: one bit of the data or the PEC flipped on the wire
+ * - error flag: bit 15 set, with a valid PEC
+ * - NACK: the sensor doesn't acknowledge
+ *
+ * Checks:
+ * - decode: DECODE_WORDS words over the sensor's range, each a full round. Object and ambient have to match word * 0.02 K - 273.15 within a Q16 LSB (the driver's offset is 273.15 * 65536 truncated).
+ * - failures: every way of spoiling the object and the ambient word, alone. The round has to end with the matching status, publish nothing and count only PEC mismatches, the next round has to succeed.
+ * - rate: RATE_S of virtual time with the main loop calling mlx90614Process every millisecond, without and with FAILURE_RATE of the reads spoiled at random. Every published reading has to be the pair of words the sensor sent in that round and every spoiled word has to be caught. The sensor also checks that the bus never runs faster than its 100 kHz.
+ *
+ * Usage: mlx90614_check
+ * Exit code: 0 - every check passed, 1 - one didn't
+ */
+
+#include "fake_hal.h"
+#include "i2c_bus.h"
+#include "mlx90614_driver.h"
+#include "math.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#define SENSOR_ADDRESS          MLX90614_DEFAULT_ADDRESS
+#define RAM_TA                  0x06
+#define RAM_TOBJ1               0x07
+#define WORD_ERROR_FLAG         0x8000
+#define WORD_MIN                0x2DE4  // -70.01 degC
+#define WORD_MAX                0x4DC4  // 382.19 degC
+
+#define DECODE_WORDS            4000
+#define RATE_S                  60
+#define LOOP_US                 1000
+#define FAILURE_RATE            0.05
+#define MIN_BYTE_US             90      // 100 kHz
+#define ROUND_TIMEOUT_US        100000U
+
+typedef enum Spoil_t {
+    SPOIL_NONE,
+    SPOIL_PEC,
+    SPOIL_BIT_FLIP,
+    SPOIL_ERROR_FLAG,
+    SPOIL_NACK,
+    SPOIL_COUNT,
+} Spoil_t;
+
+static const char* spoilNames[SPOIL_COUNT] = { "none", "PEC", "bit flip", "error flag", "NACK" };
+
+typedef struct SimSensor_t {
+    uint8_t command;
+    uint16_t next[2];           // words to send next, [0] object, [1] ambient
+    uint16_t sent[2];           // last words sent without spoiling
+    Spoil_t spoil[2];           // spoiling of the next read
+    double failureRate;         // random spoiling
+    uint32_t spoiled[SPOIL_COUNT];
+    uint32_t reads;
+    uint32_t tooFast;
+} SimSensor_t;
+
+static SimSensor_t sim;
+static I2C_HandleTypeDef hi2c;
+static CRC_HandleTypeDef hcrc;
+static uint32_t failures = 0;
+
+static void fail(const char* what) {
+    if (failures++ < 10)
+        printf("  %s\n", what);
+}
+
+/* Helpers */
+
+static uint32_t rngState = 0x9E3779B9U;
+
+static uint32_t rng(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint8_t crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static int32_t expectedQ16(uint16_t word) {
+    return (int32_t)lround((word * 0.02 - 273.15) * 65536.0);
+}
+
+/* Simulated MLX90614 */
+
+static bool simWrite(const uint8_t* data, uint16_t len) {
+    if (len > 0)
+        sim.command = data[0];
+    return true;
+}
+
+static bool simRead(uint8_t* data, uint16_t len) {
+    if (fakeI2CByteTime(1) - fakeI2CByteTime(0) < MIN_BYTE_US)
+        sim.tooFast++;
+    uint8_t w = (sim.command == RAM_TOBJ1) ? 0 : 1;
+    Spoil_t spoil = sim.spoil[w];
+    sim.spoil[w] = SPOIL_NONE;
+    if (spoil == SPOIL_NONE && sim.failureRate > 0.0 && rng() < sim.failureRate * 4294967296.0)
+        spoil = (Spoil_t)(SPOIL_PEC + rng() % (SPOIL_COUNT - SPOIL_PEC));
+    sim.spoiled[spoil]++;
+    sim.reads++;
+    if (spoil == SPOIL_NACK)
+        return false;
+
+    uint16_t word = sim.next[w];
+    if (spoil == SPOIL_ERROR_FLAG)
+        word |= WORD_ERROR_FLAG;
+    uint8_t frame[5] = { SENSOR_ADDRESS << 1, sim.command, (SENSOR_ADDRESS << 1) | 1U, (uint8_t)word, (uint8_t)(word >> 8) };
+    uint8_t reply[3] = { frame[3], frame[4], crc8(frame, sizeof(frame)) };
+    if (spoil == SPOIL_PEC)
+        reply[2] ^= (uint8_t)(1U + rng() % 255U);
+    else if (spoil == SPOIL_BIT_FLIP)
+        reply[rng() % 3U] ^= (uint8_t)(1U << (rng() % 8U));
+    else if (spoil == SPOIL_NONE)
+        sim.sent[w] = word;
+    for (uint16_t i = 0; i < len; i++)
+        data[i] = (i < sizeof(reply)) ? reply[i] : 0xFF;
+
+    // a fresh word for the next read
+    sim.next[w] = (uint16_t)(WORD_MIN + rng() % (WORD_MAX - WORD_MIN + 1U));
+    return true;
+}
+
+static const FakeI2CDevice_t device = { SENSOR_ADDRESS, simWrite, simRead };
+
+/* HAL callbacks, routed like in main.c */
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c_) {
+    (void)hi2c_;
+    i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c_) {
+    (void)hi2c_;
+    i2cBusErrorHandler();
+}
+
+/* Runs */
+
+static void setup(void) {
+    memset(&sim, 0, sizeof(sim));
+    sim.next[0] = WORD_MIN;
+    sim.next[1] = WORD_MIN;
+    i2cBusInit(&hi2c);
+    if (mlx90614Init(&hcrc, SENSOR_ADDRESS) != MLX90614_OK)
+        fail("mlx90614Init failed");
+}
+
+// Lets the driver start a round and waits for its end
+static bool runRound(void) {
+    HAL_Delay(MLX90614_READ_PERIOD_MS);
+    uint64_t start = fakeHalMicros();
+    mlx90614Process();
+    while (!i2cBusIsIdle()) {
+        if (fakeHalMicros() - start > ROUND_TIMEOUT_US)
+            return false;
+        fakeHalAdvance(1);
+    }
+    return true;
+}
+
+static bool readingIs(const MLX90614Reading_t* r, uint16_t object, uint16_t ambient) {
+    return labs(r->object - expectedQ16(object)) <= 1 && labs(r->ambient - expectedQ16(ambient)) <= 1;
+}
+
+/* Checks */
+
+static void checkDecode(void) {
+    setup();
+    for (uint32_t i = 0; i < DECODE_WORDS; i++) {
+        sim.next[0] = (uint16_t)(WORD_MIN + (uint32_t)(WORD_MAX - WORD_MIN) * i / (DECODE_WORDS - 1));
+        sim.next[1] = (uint16_t)(WORD_MIN + rng() % (WORD_MAX - WORD_MIN + 1U));
+        uint16_t object = sim.next[0], ambient = sim.next[1];
+        MLX90614Reading_t r;
+        if (!runRound() || mlx90614GetStatus() != MLX90614_OK || mlx90614GetReading(&r) != MLX90614_OK) {
+            fail("round failed");
+            continue;
+        }
+        if (!readingIs(&r, object, ambient) || r.round != mlx90614GetRoundCount())
+            fail("reading decoded wrong");
+    }
+}
+
+static void checkFailures(void) {
+    static const MLX90614Status_t expectedStatus[SPOIL_COUNT] = {
+        MLX90614_OK, MLX90614_PEC_ERROR, MLX90614_PEC_ERROR, MLX90614_DATA_ERROR, MLX90614_I2C_ERROR,
+    };
+    setup();
+    runRound();
+    for (uint8_t w = 0; w < 2; w++) {
+        for (uint8_t s = SPOIL_PEC; s < SPOIL_COUNT; s++) {
+            MLX90614Reading_t before, after;
+            mlx90614GetReading(&before);
+            uint32_t pecErrors = mlx90614GetPecErrorCount();
+            uint32_t rounds = mlx90614GetRoundCount();
+            sim.spoil[w] = (Spoil_t)s;
+            if (!runRound())
+                fail("spoiled round didn't end");
+            mlx90614GetReading(&after);
+            bool pec = expectedStatus[s] == MLX90614_PEC_ERROR;
+            if (mlx90614GetStatus() != expectedStatus[s])
+                printf("  %s in the %s word: status %d\n", spoilNames[s], w ? "ambient" : "object", (int)mlx90614GetStatus()), failures++;
+            if (mlx90614GetRoundCount() != rounds || after.round != before.round || after.object != before.object || after.ambient != before.ambient)
+                fail("spoiled round published a reading");
+            if (mlx90614GetPecErrorCount() != pecErrors + (pec ? 1U : 0U))
+                fail("PEC errors miscounted");
+
+            uint16_t object = sim.next[0], ambient = sim.next[1];
+            if (!runRound() || mlx90614GetStatus() != MLX90614_OK || mlx90614GetReading(&after) != MLX90614_OK || !readingIs(&after, object, ambient))
+                fail("no recovery after a spoiled round");
+        }
+    }
+}
+
+typedef struct RateResult_t {
+    double rounds;              // per second
+    uint32_t published;
+    uint32_t spoiledReads;
+    uint32_t reads;
+    uint32_t pecErrors;
+    uint32_t wrongPublished;
+} RateResult_t;
+
+static void rate(double failureRate, RateResult_t* rr) {
+    setup();
+    sim.failureRate = failureRate;
+    memset(rr, 0, sizeof(*rr));
+    uint64_t start = fakeHalMicros();
+    uint32_t lastRound = 0;
+    while (fakeHalMicros() - start < (uint64_t)RATE_S * 1000000U) {
+        mlx90614Process();
+        fakeHalAdvance(LOOP_US);
+        uint32_t rounds = mlx90614GetRoundCount();
+        if (rounds == lastRound)
+            continue;
+        lastRound = rounds;
+        MLX90614Reading_t r;
+        rr->published++;
+        if (mlx90614GetReading(&r) != MLX90614_OK || !readingIs(&r, sim.sent[0], sim.sent[1]))
+            rr->wrongPublished++;
+    }
+    rr->rounds = mlx90614GetRoundCount() / ((fakeHalMicros() - start) / 1e6);
+    rr->reads = sim.reads;
+    rr->spoiledReads = sim.reads - sim.spoiled[SPOIL_NONE];
+    rr->pecErrors = mlx90614GetPecErrorCount();
+    if (rr->pecErrors != sim.spoiled[SPOIL_PEC] + sim.spoiled[SPOIL_BIT_FLIP])
+        fail("PEC errors don't match the corrupted words");
+}
+
+int main(void) {
+    HAL_Init();
+    fakeHalSetRunTime(0);
+    fakeI2CAttach(&device);
+    HAL_I2C_Init(&hi2c);
+    hcrc.Instance = CRC;
+    hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+    hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+    hcrc.Init.GeneratingPolynomial = 7;
+    hcrc.Init.CRCLength = CRC_POLYLENGTH_8B;
+    hcrc.Init.InitValue = 0;
+    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    HAL_CRC_Init(&hcrc);
+
+    checkDecode();
+    printf("decode (%u words)       %s\n", DECODE_WORDS, failures ? "FAIL" : "ok");
+    uint32_t before = failures;
+    checkFailures();
+    printf("spoiled words           %s\n", failures > before ? "FAIL" : "ok");
+
+    printf("\n%13s %9s %7s %13s %11s %16s\n", "spoiled reads", "rounds/s", "reads", "spoiled", "PEC errors", "wrong published");
+    for (uint8_t k = 0; k < 2; k++) {
+        RateResult_t rr;
+        double failureRate = k ? FAILURE_RATE : 0.0;
+        rate(failureRate, &rr);
+        printf("%12.0f%% %9.2f %7u %13u %11u %16u\n", 100.0 * failureRate, rr.rounds, rr.reads, rr.spoiledReads, rr.pecErrors, rr.wrongPublished);
+        if (rr.wrongPublished > 0)
+            fail("a reading that wasn't sent was published");
+        // each spoiled read costs its round, the next one starts a read period later
+        if (rr.rounds < (1.0 - 2.0 * failureRate) * 0.98 * 1000.0 / MLX90614_READ_PERIOD_MS)
+            fail("sample rate too low");
+    }
+    if (sim.tooFast > 0)
+        fail("bus faster than 100 kHz");
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/**
+ * @file mpc_compare.c
+ * @brief Compares the MPC heating mode with the firmware's PID loop on the thermal plant: a pizza bake with a door opening, plus the QP's iterations and time per solve.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Both loops are the firmware's oven_control: profile engine, power splitter and the joint heater modulator. In the MPC run its PID is replaced by mpcStep, solved every MPC period and held in between. The default current cap is above both elements together, so the modulator never scales the MPC's duties down (the MPC has no output tracking).
+ *
+ * The MPC's two-lag model is identified on the plant first, from an open-loop step of the combined demand: the gain is the final rise of the chamber thermocouple and the element time constant the top element's capacity over its conductances. The direct share (how much of the element rise the air follows within seconds) is the least-squares fit of the normalised step response, searched in steps of 0.01; for each share the chamber time constant follows from the response's area (elementTau + (1 - share) * chamberTau for this model).
+ *
+ * Reported per loop: when the air first settled within +-BAND_C of the first target, the overshoot over it, the largest heating rate of the air over one minute, the RMS and largest error while the stone soaks (both without the door opening and its recovery, when the air reheats from the walls and the stone whatever the heaters do), the largest error after the door opening and the energy. For the MPC also the QP iterations per solve (mean, maximum, how many solves hit MPC_MAX_ITERATIONS) and the host time per mpcStep. Cycles on the STM32F303 come from the mpc.step case of oven_bench.
+ *
+ *
+ * Usage: mpc_compare [-p MPC period s] [-v]
+ * Exit code: 0 - the MPC settled on the first target, overshot it no more than the PID, kept the air's rate within MPC_MAX_RATE, held the soak within the program's soak band and hit the iteration limit in at most MAX_NOT_CONVERGED of its solves, 1 - it didn't, 2 - bad arguments or the model couldn't be identified
+ */
+
+#include "mpc_controller.h"
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+
+#define HALF_CYCLE_S            0.01f
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define MAINS_VOLTAGE           230.0f
+#define AMBIENT_C               22.0f
+#define BAND_C                  5.0f
+#define BAKE_TIME_S             3600
+#define DOOR_S                  2400
+#define DOOR_OPEN_S             30
+#define DOOR_RECOVERY_S         60      // the air reheats from the walls and the stone within seconds of the door closing, on top of the rate window
+#define RATE_WINDOW_S           60
+#define SOAK_SEGMENT            1
+
+#define ID_DEMAND               0.5f    // open-loop step for the identification
+#define ID_TIME_S               36000   // long enough for the walls to settle
+#define ID_SHARE_STEPS          100     // direct share searched in steps of 0.01
+
+#define DEFAULT_MPC_PERIOD_S    1       // the PID's tick
+#define MPC_MAX_RATE            1.0f    // [degC/s]
+#define MPC_MOVE_WEIGHT         1000.0f
+#define MAX_NOT_CONVERGED       0.01f   // share of the solves allowed to hit MPC_MAX_ITERATIONS
+
+typedef struct LoopResult_t {
+    float settlingTime;         // [s], NAN if the air never settled on the first target
+    float overshoot;            // [degC]
+    float maxRate;              // [degC/s]
+    float holdError;            // largest error while the stone soaks [degC]
+    double holdSquares;
+    uint32_t holdTicks;
+    float doorError;            // [degC]
+    double energy;              // [kWh]
+    // MPC only
+    uint32_t solves;
+    uint32_t iterations;
+    uint8_t maxIterations;
+    uint32_t notConverged;
+    double solveNs;
+} LoopResult_t;
+
+static OvenControlConfig_t loopConfig(void) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = ovenControlDefaultConfig;
+    occ.topPower = pp->topPower;
+    occ.bottomPower = pp->bottomPower;
+    occ.topCurrent = pp->topPower / MAINS_VOLTAGE;
+    occ.bottomCurrent = pp->bottomPower / MAINS_VOLTAGE;
+    return occ;
+}
+
+/* Identification */
+
+static bool identify(MPCModel_t* model) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = loopConfig();
+    PowerSplitter_t split;
+    HeaterOutput_t ho;
+    ThermalPlant_t tp;
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitInit(&split, pp->topPower, pp->bottomPower, 0.5f);
+    psplitApply(&split, (uint16_t)(ID_DEMAND * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutInit(&ho, occ.topCurrent, occ.bottomCurrent, occ.currentCap);
+    heaterOutSetDutyQ15(&ho, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+    plantInit(&tp, pp, AMBIENT_C);
+
+    static float rise[ID_TIME_S];
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    for (uint32_t t = 0; t < ID_TIME_S; t++) {
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = heaterOutNextHalfCycle(&ho);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+        rise[t] = tp.sensor - AMBIENT_C;
+    }
+    float final = rise[ID_TIME_S - 1];
+    double area = 0.0;
+    for (uint32_t t = 0; t < ID_TIME_S; t++)
+        area += 1.0 - rise[t] / final;
+
+    float conductance = 0.0f;
+    for (uint8_t l = 0; l < pp->linkCount; l++)
+        if (pp->links[l].a == PLANT_TOP_ELEMENT)
+            conductance += pp->links[l].conductance;
+    model->gain = final / ID_DEMAND;
+    model->elementTau = pp->capacity[PLANT_TOP_ELEMENT] / conductance;
+
+    // direct share by least squares over the normalised step response, the chamber time constant following from the area for each share
+    float te = model->elementTau;
+    double bestSquares = INFINITY;
+    for (uint32_t s = 0; s < ID_SHARE_STEPS; s++) {
+        float share = (float)s / ID_SHARE_STEPS;
+        float tc = ((float)area - te) / (1.0f - share);
+        if (tc <= 0.0f)
+            break;
+        float a11 = expf(-1.0f / te), a22 = expf(-1.0f / tc);
+        float a21 = te * (a11 - a22) / (te - tc);
+        float x1 = 0.0f, x2 = 0.0f;
+        double squares = 0.0;
+        for (uint32_t t = 0; t < ID_TIME_S; t++) {
+            float x1Next = a11 * x1 + (1.0f - a11);
+            x2 = a21 * x1 + a22 * x2 + (1.0f - a21 - a22);
+            x1 = x1Next;
+            float e = share * x1 + (1.0f - share) * x2 - rise[t] / final;
+            squares += (double)(e * e);
+        }
+        if (squares < bestSquares) {
+            bestSquares = squares;
+            model->directShare = share;
+            model->chamberTau = tc;
+        }
+    }
+    return final > 0.0f && bestSquares < INFINITY;
+}
+
+/* Bakes */
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ovenControlStep with the PID replaced by the MPC, solved every period ticks
+static void mpcControlStep(OvenControl_t* oc, MPCController_t* mpc, float chamber, bool solve, float* demand, LoopResult_t* r) {
+    oc->chamber = chamber;
+    ProfileOutput_t out = { oc->setpoint, oc->split.ratio };
+    ProfilePhase_t phase = profileTick(&oc->profile, chamber, &out);
+    if (phase == PROFILE_IDLE || phase == PROFILE_DONE) {
+        heaterOutSetDutyQ15(&oc->heater, 0, 0);
+        return;
+    }
+    if (out.topShare != oc->split.ratio)
+        psplitSetRatio(&oc->split, out.topShare);
+    oc->setpoint = out.setpoint;
+
+    if (solve) {
+        double start = nowNs();
+        *demand = mpcStep(mpc, out.setpoint, chamber);
+        r->solveNs += nowNs() - start;
+        uint8_t it = mpcGetIterations(mpc);
+        r->solves++;
+        r->iterations += it;
+        if (it > r->maxIterations)
+            r->maxIterations = it;
+        if (mpcGetStatus(mpc) == MPC_NOT_CONVERGED)
+            r->notConverged++;
+    }
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(&oc->split, (uint16_t)(*demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+    heaterOutSetDutyQ15(&oc->heater, duty[HEATER_TOP], duty[HEATER_BOTTOM]);
+}
+
+static void bake(const MPCModel_t* model, uint32_t mpcPeriod, bool verbose, LoopResult_t* r) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = loopConfig();
+    static MPCController_t mpc;     // keeps CMSIS descriptors pointing into itself, set up in place
+    OvenControl_t oc;
+    ThermalPlant_t tp;
+    ovenControlInit(&oc, &occ);
+    plantInit(&tp, pp, AMBIENT_C);
+    ovenControlStart(&oc, &profilePizza, tp.sensor);
+    if (model) {
+        MPCConfig_t cfg = { .dt = (float)mpcPeriod, .maxDuty = 1.0f, .maxRate = MPC_MAX_RATE, .moveWeight = MPC_MOVE_WEIGHT };
+        mpcInit(&mpc, model, &cfg, AMBIENT_C);
+    }
+    memset(r, 0, sizeof(*r));
+    r->settlingTime = NAN;
+
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    const float target = profilePizza.segments[0].target;
+    static float air[RATE_WINDOW_S];
+    bool firstTarget = true;
+    float lastOutside = 0.0f;
+    float demand = 0.0f;
+    for (uint32_t t = 0; t < BAKE_TIME_S; t++) {
+        in.doorOpen = (t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S);
+        if (model)
+            mpcControlStep(&oc, &mpc, tp.sensor, t % mpcPeriod == 0, &demand, r);
+        else
+            ovenControlStep(&oc, tp.sensor);
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = ovenControlHalfCycle(&oc);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+
+        float a = tp.temperature[PLANT_AIR];
+        bool door = t >= DOOR_S && t < DOOR_S + DOOR_OPEN_S + RATE_WINDOW_S + DOOR_RECOVERY_S;
+        if (t >= RATE_WINDOW_S && !door) {
+            float rate = (a - air[t % RATE_WINDOW_S]) / RATE_WINDOW_S;
+            if (rate > r->maxRate)
+                r->maxRate = rate;
+        }
+        air[t % RATE_WINDOW_S] = a;
+        if (firstTarget && oc.setpoint != target && t > 0)
+            firstTarget = false;
+        if (firstTarget) {
+            if (fabsf(a - target) > BAND_C)
+                lastOutside = (float)(t + 1);
+            else if (isnan(r->settlingTime) || r->settlingTime < lastOutside)
+                r->settlingTime = lastOutside;
+            if (a - target > r->overshoot)
+                r->overshoot = a - target;
+        }
+        if (profileGetSegment(&oc.profile) == SOAK_SEGMENT && profileGetPhase(&oc.profile) == PROFILE_HOLD && !door) {
+            float e = fabsf(a - oc.setpoint);
+            r->holdSquares += (double)(e * e);
+            r->holdTicks++;
+            if (e > r->holdError)
+                r->holdError = e;
+        }
+        if (t >= DOOR_S && fabsf(a - oc.setpoint) > r->doorError)
+            r->doorError = fabsf(a - oc.setpoint);
+        if (verbose && t % 10 == 0)
+            printf("%s,%u,%.2f,%.2f,%.3f\n", model ? "mpc" : "pid", t, oc.setpoint, a, (heaterOutGetDuty(&oc.heater, HEATER_TOP) + heaterOutGetDuty(&oc.heater, HEATER_BOTTOM)) / 2.0f);
+    }
+    r->energy = tp.energy / 3.6e6;
+}
+
+static void printLoop(const char* name, const LoopResult_t* r) {
+    printf("%-6s", name);
+    if (isnan(r->settlingTime))
+        printf(" %11s", "-");
+    else
+        printf(" %11.0f", r->settlingTime);
+    float holdRms = r->holdTicks ? (float)sqrt(r->holdSquares / r->holdTicks) : 0.0f;
+    printf(" %13.2f %14.3f %9.2f %9.2f %14.2f %12.3f\n", r->overshoot, r->maxRate, holdRms, r->holdError, r->doorError, r->energy);
+}
+
+int main(int argc, char** argv) {
+    uint32_t mpcPeriod = DEFAULT_MPC_PERIOD_S;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            mpcPeriod = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (mpcPeriod == 0) {
+                fprintf(stderr, "bad MPC period: %s\n", argv[i]);
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [-p MPC period s] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    MPCModel_t model;
+    if (!identify(&model)) {
+        fprintf(stderr, "identification failed\n");
+        return 2;
+    }
+    printf("identified model: gain %.1f degC, element tau %.1f s, chamber tau %.1f s, direct share %.2f\n", model.gain, model.elementTau, model.chamberTau, model.directShare);
+    printf("MPC: period %u s, horizon %u s, rate limit %.1f degC/s, move weight %.0f\n", mpcPeriod, mpcPeriod * MPC_HORIZON, MPC_MAX_RATE, MPC_MOVE_WEIGHT);
+
+    if (verbose)
+        printf("loop,t,setpoint,air,demand\n");
+    LoopResult_t pid, mpc;
+    bake(NULL, 1, verbose, &pid);
+    bake(&model, mpcPeriod, verbose, &mpc);
+
+    printf("pizza bake, %u s, door open %u s at %u s, band +-%.0f degC\n", BAKE_TIME_S, DOOR_OPEN_S, DOOR_S, BAND_C);
+    printf("%-6s %11s %13s %14s %19s %14s %12s\n", "loop", "settled[s]", "overshoot[C]", "max rate[C/s]", "soak RMS/max[C]", "door error[C]", "energy[kWh]");
+    printLoop("PID", &pid);
+    printLoop("MPC", &mpc);
+    printf("QP: %u solves, %.2f iterations per solve (max %u, %u hit the limit of %u), %.0f ns per mpcStep on this host\n", mpc.solves,
+        mpc.solves ? (double)mpc.iterations / mpc.solves : 0.0, mpc.maxIterations, mpc.notConverged, MPC_MAX_ITERATIONS,
+        mpc.solves ? mpc.solveNs / mpc.solves : 0.0);
+
+    bool ok = !isnan(mpc.settlingTime) && mpc.holdTicks > 0 && mpc.holdError <= profilePizza.soakBand;
+    ok &= mpc.overshoot <= pid.overshoot && mpc.maxRate <= MPC_MAX_RATE;
+    ok &= mpc.notConverged <= MAX_NOT_CONVERGED * mpc.solves;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file oled_render.c
+ * @brief Renders a sequence of oven status screens through the OLED driver on the fake HAL, dumps each frame the display shows to a PGM file and reports the bus traffic of every update.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The driver talks to a model of the display attached to the fake I2C bus. The model interprets the control bytes, the addressing commands (the SSD1306's column/page windows in horizontal mode or the SH1106's page addressing) and the data stream into its own display RAM, which is what gets dumped, so the pictures show what the transfers produced rather than the framebuffer. After every update the model's RAM is compared with the framebuffer.
+ *
+ * The screen has both zones' temperatures and setpoints, their heater duties as bars and a trend graph that gains a point per frame. One frame redraws the same values, so its update sends nothing.
+ *
+ * Usage: oled_render [-c ssd1306|sh1106] [-s scale] [output directory]
+ * Exit code: 0 - every update reached the display intact, 1 - the display differs from the framebuffer, 2 - bad arguments or the driver failed
+ */
+
+#include "fake_hal.h"
+#include "i2c_bus.h"
+#include "oled_gfx.h"
+#include "oled_ssd1306_driver.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#define OLED_ADDRESS    0x3C
+#define FRAMES          24
+#define RAM_COLUMNS     132
+
+/* display model */
+
+static OLEDController_t panelController = OLED_SSD1306;
+static uint8_t panelRam[OLED_PAGES][RAM_COLUMNS];
+static uint8_t panelPage = 0, panelColumn = 0;
+static uint8_t panelColStart = 0, panelColEnd = OLED_WIDTH - 1;
+static uint8_t panelPageStart = 0, panelPageEnd = OLED_PAGES - 1;
+static bool panelHorizontal = false;    // SSD1306 addressing mode, page addressing after reset
+static bool panelOn = false;
+static uint8_t panelCmd = 0;
+static uint8_t panelArgs[2];
+static uint8_t panelArgCount = 0, panelArgsLeft = 0;
+static uint32_t panelBytes = 0;         // bytes on the bus, address bytes included
+static uint32_t panelTransfers = 0;
+
+static uint8_t argCount(uint8_t cmd) {
+    switch (cmd) {
+        case 0x21:
+        case 0x22:
+            return (panelController == OLED_SSD1306) ? 2 : 0;
+        case 0x20:
+            return (panelController == OLED_SSD1306) ? 1 : 0;
+        case 0x81:
+        case 0xD5:
+        case 0xA8:
+        case 0xD3:
+        case 0x8D:
+        case 0xDA:
+        case 0xD9:
+        case 0xDB:
+        case 0xAD:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void panelCommand(uint8_t byte) {
+    if (panelArgsLeft > 0) {
+        panelArgs[panelArgCount++] = byte;
+        if (--panelArgsLeft > 0)
+            return;
+    } else {
+        panelCmd = byte;
+        panelArgCount = 0;
+        panelArgsLeft = argCount(byte);
+        if (panelArgsLeft > 0)
+            return;
+    }
+
+    uint8_t c = panelCmd;
+    if (c == 0x20) {
+        panelHorizontal = (panelArgs[0] & 0x03) == 0;
+    } else if (c == 0x21) {
+        panelColStart = panelArgs[0] & 0x7F;
+        panelColEnd = panelArgs[1] & 0x7F;
+        panelColumn = panelColStart;
+    } else if (c == 0x22) {
+        panelPageStart = panelArgs[0] & 0x07;
+        panelPageEnd = panelArgs[1] & 0x07;
+        panelPage = panelPageStart;
+    } else if (c == 0xAE || c == 0xAF) {
+        panelOn = (c == 0xAF);
+    } else if ((c & 0xF8) == 0xB0) {
+        panelPage = c & 0x07;
+    } else if ((c & 0xF0) == 0x00) {
+        panelColumn = (uint8_t)((panelColumn & 0xF0) | (c & 0x0F));
+    } else if ((c & 0xF0) == 0x10) {
+        panelColumn = (uint8_t)((panelColumn & 0x0F) | ((c & 0x0F) << 4));
+    }
+}
+
+static void panelData(uint8_t byte) {
+    if (panelColumn < RAM_COLUMNS)
+        panelRam[panelPage][panelColumn] = byte;
+    if (panelController == OLED_SSD1306 && panelHorizontal) {
+        if (++panelColumn > panelColEnd) {
+            panelColumn = panelColStart;
+            if (++panelPage > panelPageEnd)
+                panelPage = panelPageStart;
+        }
+    } else if (panelColumn < RAM_COLUMNS - 1) {
+        panelColumn++;
+    }
+}
+
+static bool panelWrite(const uint8_t* data, uint16_t len) {
+    panelBytes += 1U + len;
+    panelTransfers++;
+    uint16_t i = 0;
+    while (i < len) {
+        uint8_t control = data[i++];
+        bool isData = (control & 0x40) != 0;
+        if (control & 0x80) {   // continuation: one byte, then another control byte
+            if (i < len)
+                isData ? panelData(data[i++]) : panelCommand(data[i++]);
+            continue;
+        }
+        while (i < len)
+            isData ? panelData(data[i++]) : panelCommand(data[i++]);
+    }
+    return true;
+}
+
+static const FakeI2CDevice_t panelDevice = { OLED_ADDRESS, panelWrite, NULL };
+
+static uint8_t panelPixel(uint8_t x, uint8_t y) {
+    uint8_t column = x + ((panelController == OLED_SH1106) ? 2 : 0);
+    return (panelRam[y / 8][column] >> (y % 8)) & 1;
+}
+
+static bool panelMatchesFramebuffer(void) {
+    uint8_t offset = (panelController == OLED_SH1106) ? 2 : 0;
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t x = 0; x < OLED_WIDTH; x++) {
+            if (panelRam[page][x + offset] != oledGetByte(page, x))
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool writePgm(const char* dir, unsigned frame, unsigned scale) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/oled_%03u.pgm", dir, frame);
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "P5\n%u %u\n255\n", OLED_WIDTH * scale, OLED_HEIGHT * scale);
+    for (unsigned y = 0; y < OLED_HEIGHT * scale; y++) {
+        for (unsigned x = 0; x < OLED_WIDTH * scale; x++)
+            fputc((panelOn && panelPixel((uint8_t)(x / scale), (uint8_t)(y / scale))) ? 255 : 0, f);
+    }
+    fclose(f);
+    return true;
+}
+
+/* HAL callbacks, routed like in main.c */
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    (void)hi2c;
+    i2cBusTransferCompleteHandler();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    (void)hi2c;
+    i2cBusErrorHandler();
+}
+
+/* oven status screen */
+
+#define GRAPH_X     0
+#define GRAPH_Y     34
+#define GRAPH_W     OLED_WIDTH
+#define GRAPH_H     30
+#define GRAPH_MAX_C 300
+#define ZONE_TEXT   32      // 3-letter name, two int32 values at up to 11 characters, separators, degree sign, 'C' and NUL
+
+static int16_t graphY(int32_t celsius) {
+    return (int16_t)(GRAPH_Y + GRAPH_H - 2 - celsius * (GRAPH_H - 3) / GRAPH_MAX_C);
+}
+
+static void drawZone(int16_t y, const char* name, int32_t celsius, int32_t setpoint, int32_t dutyPercent) {
+    char text[ZONE_TEXT];
+    snprintf(text, sizeof(text), "%.3s %3d/%3d" OLED_GFX_DEGREE "C", name, (int)celsius, (int)setpoint);
+    oledGfxStr(0, y, text);
+    // duty bar right below the text
+    int16_t width = (int16_t)(dutyPercent * (OLED_WIDTH - 2) / 100);
+    oledGfxRect(0, y + 9, OLED_WIDTH, 6, true);
+    oledGfxFillRect(1, y + 10, width, 4, true);
+    oledGfxFillRect(1 + width, y + 10, OLED_WIDTH - 2 - width, 4, false);
+}
+
+int main(int argc, char** argv) {
+    const char* dir = ".";
+    unsigned scale = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "ssd1306") == 0)
+                panelController = OLED_SSD1306;
+            else if (strcmp(name, "sh1106") == 0)
+                panelController = OLED_SH1106;
+            else {
+                fprintf(stderr, "unknown controller: %s\n", name);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            scale = (unsigned)strtoul(argv[++i], NULL, 10);
+            if (scale == 0 || scale > 8)
+                scale = 1;
+        } else {
+            dir = argv[i];
+        }
+    }
+
+    HAL_Init();
+    fakeHalSetRunTime(0);
+    fakeI2CAttach(&panelDevice);
+    static I2C_HandleTypeDef hi2c;
+    HAL_I2C_Init(&hi2c);
+    i2cBusInit(&hi2c);
+
+    if (oledInit(panelController, OLED_ADDRESS) != OLED_OK) {
+        fprintf(stderr, "oledInit failed\n");
+        return 2;
+    }
+    printf("controller: %s, initialisation: %u bytes\n", (panelController == OLED_SSD1306) ? "SSD1306" : "SH1106", (unsigned)panelBytes);
+
+    int32_t zone1 = 25, zone2 = 25;
+    int16_t lastX = -1, lastY1 = 0, lastY2 = 0;
+    uint32_t totalBytes = 0, totalUpdates = 0;
+    bool intact = true;
+
+    for (unsigned frame = 0; frame < FRAMES; frame++) {
+        // frame 12 shows the same values as frame 11
+        if (frame != 12) {
+            zone1 += (250 - zone1) / 6;
+            zone2 += (250 - zone2) / 10;
+        }
+        int32_t duty1 = (250 - zone1) * 100 / 225;
+        int32_t duty2 = (250 - zone2) * 100 / 225;
+
+        drawZone(0, "Top", zone1, 250, duty1);
+        drawZone(16, "Bot", zone2, 250, duty2);
+        if (frame == 0) {
+            oledGfxRect(GRAPH_X, GRAPH_Y, GRAPH_W, GRAPH_H, true);
+            oledGfxLine(GRAPH_X + 1, graphY(250), GRAPH_X + GRAPH_W - 2, graphY(250), true);    // setpoint
+        }
+        if (frame != 12) {
+            int16_t x = (int16_t)(GRAPH_X + 2 + frame * 5);
+            int16_t y1 = graphY(zone1), y2 = graphY(zone2);
+            if (lastX >= 0) {
+                oledGfxLine(lastX, lastY1, x, y1, true);
+                oledGfxLine(lastX, lastY2, x, y2, true);
+            }
+            lastX = x;
+            lastY1 = y1;
+            lastY2 = y2;
+        }
+
+        OLEDStats_t before, after;
+        oledGetStats(&before);
+        uint64_t start = fakeHalMicros();
+        oledUpdate();
+        while (oledIsBusy())
+            fakeHalAdvance(50);
+        uint64_t duration = fakeHalMicros() - start;
+        oledGetStats(&after);
+
+        unsigned bytes = (after.updates != before.updates) ? after.lastBytes : 0;
+        unsigned transfers = (after.updates != before.updates) ? after.lastTransfers : 0;
+        bool match = panelMatchesFramebuffer() && oledGetStatus() == OLED_OK;
+        intact &= match;
+        totalBytes += bytes;
+        totalUpdates++;
+        printf("frame %2u: %4u bytes in %2u transfers, %6.2f ms%s\n", frame, bytes, transfers, duration / 1000.0, match ? "" : "  DISPLAY DIFFERS FROM FRAMEBUFFER");
+        if (!writePgm(dir, frame, scale))
+            return 2;
+    }
+
+    unsigned full = OLED_PAGES * OLED_WIDTH + 1 + 1;    // one data stream with its address and control byte
+    printf("average: %u bytes per update, a full refresh is at least %u bytes\n", (unsigned)(totalBytes / totalUpdates), full);
+    printf("%s\n", intact ? "PASS" : "FAIL");
+    return intact ? 0 : 1;
+}
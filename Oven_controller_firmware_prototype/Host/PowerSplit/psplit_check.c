@@ -0,0 +1,147 @@
+/**
+ * @file psplit_check.c
+ * @brief Checks the power splitter's table against a float reference for every demand: power conservation, saturation redistribution and the set ratio.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Every Q15 demand from 0 to HEATER_OUT_DUTY_ONE is split at every ratio from 0 to 1 in RATIO_STEP steps, for a few heater pairs: the prototype's, the same swapped, equal heaters, a strongly unequal pair and a single heater. The reference splits the demand in float and redistributes what a saturated heater can't take, like psplitSetRatio does at its table points.
+ *
+ * Checks:
+ * - conservation: the power of both duties matches the demand within CONSERVATION_LSB of the combined power
+ * - saturation: no duty above HEATER_OUT_DUTY_ONE, both duties non-decreasing in the demand and both heaters full at full demand
+ * - split: each duty matches the reference within SPLIT_LSB, except in a table segment containing a saturation point, where the heater's power has to stay within the documented 1/PSPLIT_TABLE_SEGMENTS of the combined power
+ *
+ * Usage: psplit_check
+ * Exit code: 0 - every check passed for every pair, 1 - one didn't
+ */
+
+#include "power_splitter.h"
+#include "math.h"
+#include "stdio.h"
+
+#define RATIO_STEP              0.05f
+#define CONSERVATION_LSB        2.0f
+#define SPLIT_LSB               2.0f
+
+typedef struct HeaterPair_t {
+    const char* name;
+    float topPower;             // [W]
+    float bottomPower;          // [W]
+} HeaterPair_t;
+
+typedef struct PairResult_t {
+    float conservation;         // worst power error [LSB of the combined power]
+    float split;                // worst duty error outside the saturation segments [LSB]
+    float splitSaturation;      // worst heater power error in the saturation segments [share of the combined power]
+    uint32_t overDuty;
+    uint32_t decreasing;
+    bool fullAtFull;
+} PairResult_t;
+
+static const HeaterPair_t pairs[] = {
+    { "prototype", 1500.0f, 1200.0f },
+    { "swapped", 1200.0f, 1500.0f },
+    { "equal", 1500.0f, 1500.0f },
+    { "unequal", 2000.0f, 300.0f },
+    { "top only", 1500.0f, 0.0f },
+};
+
+/* Reference */
+
+static void referenceSplit(float pTop, float pBottom, float ratio, float demand, float duty[HEATER_OUT_CHANNELS]) {
+    float total = (pTop + pBottom) * demand;
+    float top = total * ratio;
+    float bottom = total - top;
+    if (top > pTop) {
+        bottom += top - pTop;
+        top = pTop;
+    }
+    if (bottom > pBottom) {
+        top += bottom - pBottom;
+        bottom = pBottom;
+    }
+    duty[HEATER_TOP] = (pTop > 0.0f) ? top / pTop : 0.0f;
+    duty[HEATER_BOTTOM] = (pBottom > 0.0f) ? bottom / pBottom : 0.0f;
+}
+
+// Whether the table segment of the demand contains the demand at which one heater saturates
+static bool saturationSegment(float pTop, float pBottom, float ratio, uint16_t demand) {
+    uint16_t segment = demand / (HEATER_OUT_DUTY_ONE / PSPLIT_TABLE_SEGMENTS);
+    float lo = (float)segment / PSPLIT_TABLE_SEGMENTS;
+    float hi = (float)(segment + 1) / PSPLIT_TABLE_SEGMENTS;
+    float total = pTop + pBottom;
+    float points[2] = {
+        (ratio > 0.0f) ? pTop / (total * ratio) : INFINITY,
+        (ratio < 1.0f) ? pBottom / (total * (1.0f - ratio)) : INFINITY,
+    };
+    for (uint8_t i = 0; i < 2; i++)
+        if (points[i] > lo && points[i] < hi)
+            return true;
+    return false;
+}
+
+/* Checks */
+
+static void check(const HeaterPair_t* hp, PairResult_t* r) {
+    float total = hp->topPower + hp->bottomPower;
+    float lsb = 1.0f / HEATER_OUT_DUTY_ONE;
+    *r = (PairResult_t){ 0.0f, 0.0f, 0.0f, 0, 0, true };
+    uint32_t steps = (uint32_t)(1.0f / RATIO_STEP + 0.5f);
+    for (uint32_t k = 0; k <= steps; k++) {
+        float ratio = (float)k * RATIO_STEP;
+        PowerSplitter_t ps;
+        psplitInit(&ps, hp->topPower, hp->bottomPower, ratio);
+        uint16_t last[HEATER_OUT_CHANNELS] = { 0, 0 };
+        for (uint32_t d = 0; d <= HEATER_OUT_DUTY_ONE; d++) {
+            uint16_t duty[HEATER_OUT_CHANNELS];
+            psplitApply(&ps, (uint16_t)d, duty);
+            float demand = (float)d * lsb;
+            float ref[HEATER_OUT_CHANNELS];
+            referenceSplit(hp->topPower, hp->bottomPower, ratio, demand, ref);
+
+            float power = (duty[HEATER_TOP] * hp->topPower + duty[HEATER_BOTTOM] * hp->bottomPower) * lsb;
+            float conservation = fabsf(power - demand * total) / (total * lsb);
+            if (conservation > r->conservation)
+                r->conservation = conservation;
+
+            bool saturating = saturationSegment(hp->topPower, hp->bottomPower, ratio, (uint16_t)d);
+            for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+                if (duty[ch] > HEATER_OUT_DUTY_ONE)
+                    r->overDuty++;
+                if (duty[ch] < last[ch])
+                    r->decreasing++;
+                last[ch] = duty[ch];
+                float err = fabsf((float)duty[ch] * lsb - ref[ch]);
+                if (saturating) {
+                    // the duty error scaled by the heater's power, as a share of the combined power
+                    float p = (ch == HEATER_TOP) ? hp->topPower : hp->bottomPower;
+                    float share = err * p / total;
+                    if (share > r->splitSaturation)
+                        r->splitSaturation = share;
+                } else if (err / lsb > r->split) {
+                    r->split = err / lsb;
+                }
+            }
+            if (d == HEATER_OUT_DUTY_ONE) {
+                r->fullAtFull &= (hp->topPower == 0.0f || duty[HEATER_TOP] == HEATER_OUT_DUTY_ONE);
+                r->fullAtFull &= (hp->bottomPower == 0.0f || duty[HEATER_BOTTOM] == HEATER_OUT_DUTY_ONE);
+            }
+        }
+    }
+}
+
+int main(void) {
+    printf("%u demands x %u ratios per pair, %u table segments\n", HEATER_OUT_DUTY_ONE + 1, (unsigned)(1.0f / RATIO_STEP + 1.5f), PSPLIT_TABLE_SEGMENTS);
+    printf("%-10s %9s %9s %14s %11s %17s %10s %10s\n", "pair", "top[W]", "bottom[W]", "power err[LSB]", "split[LSB]", "at saturation[%]", "over 1.0", "decreases");
+    bool ok = true;
+    for (uint8_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++) {
+        PairResult_t r;
+        check(&pairs[i], &r);
+        printf("%-10s %9.0f %9.0f %14.2f %11.2f %17.2f %10u %10u%s\n", pairs[i].name, pairs[i].topPower, pairs[i].bottomPower, r.conservation, r.split,
+            100.0f * r.splitSaturation, r.overDuty, r.decreasing, r.fullAtFull ? "" : "  not full at full demand");
+        ok &= r.conservation <= CONSERVATION_LSB && r.split <= SPLIT_LSB && r.splitSaturation <= 1.0f / PSPLIT_TABLE_SEGMENTS
+            && r.overDuty == 0 && r.decreasing == 0 && r.fullAtFull;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file profile_run.c
+ * @brief Plays the pizza and bread programs through the firmware's control loop on the thermal plant and checks every segment.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The loop (oven_control with ovenControlDefaultConfig) runs each program from ambient like the firmware, the chamber thermocouple is the measurement. A program ends when its last segment (held forever) has been holding for KEEP_S, or after MAX_S.
+ *
+ * Checks per segment:
+ * - target reached: the segment got into its hold, which with a soak band needs the thermocouple within the band around the target
+ * - hold elapsed: the hold ran for the segment's hold time (rounded down to ticks) before the next segment started, a segment held forever is still holding at the end
+ * - soak band respected: the thermocouple stayed within the program's soak band around the target for the whole hold
+ * - top heater share switched: the splitter ran at the segment's share from the segment's first tick to its last. The share of the power the heaters actually delivered is reported alongside, it only matches when neither heater is saturated.
+ *
+ * Usage: profile_run [-v]
+ * Exit code: 0 - every check of every segment passed, 1 - one didn't
+ */
+
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "stdio.h"
+#include "string.h"
+
+#define HALF_CYCLES_PER_TICK    100     // 1 s control period
+#define HALF_CYCLE_S            0.01f
+#define AMBIENT_C               22.0f
+#define KEEP_S                  600
+#define MAX_S                   (8 * 3600)
+#define MAX_SEGMENTS            8
+
+typedef struct SegmentResult_t {
+    bool entered;
+    bool reached;
+    float reachedAt;            // start of the hold [s]
+    uint32_t holdTicks;
+    float maxDeviation;         // in the hold [degC]
+    bool shareKept;
+    double energy[HEATER_OUT_CHANNELS];   // [J]
+} SegmentResult_t;
+
+/* Runs */
+
+static bool run(const BakeProgram_t* program, bool verbose) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = ovenControlDefaultConfig;
+    occ.topPower = pp->topPower;
+    occ.bottomPower = pp->bottomPower;
+    OvenControl_t oc;
+    ThermalPlant_t tp;
+    ovenControlInit(&oc, &occ);
+    plantInit(&tp, pp, AMBIENT_C);
+    ovenControlStart(&oc, program, tp.sensor);
+
+    SegmentResult_t seg[MAX_SEGMENTS];
+    memset(seg, 0, sizeof(seg));
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+    uint32_t keep = 0;
+    uint32_t t = 0;
+    for (; t < MAX_S && keep < KEEP_S; t++) {
+        ProfilePhase_t phase = ovenControlStep(&oc, tp.sensor);
+        if (phase == PROFILE_IDLE || phase == PROFILE_DONE)
+            break;
+        uint8_t s = profileGetSegment(&oc.profile);
+        const ProfileSegment_t* ps = &program->segments[s];
+        SegmentResult_t* r = &seg[s];
+        if (!r->entered) {
+            r->entered = true;
+            r->shareKept = true;
+        }
+        if (oc.split.ratio != ps->topShare)
+            r->shareKept = false;
+        if (phase == PROFILE_HOLD) {
+            if (!r->reached) {
+                r->reached = true;
+                r->reachedAt = (float)t;
+            }
+            r->holdTicks++;
+            float dev = fabsf(tp.sensor - ps->target);
+            if (dev > r->maxDeviation)
+                r->maxDeviation = dev;
+            if (ps->holdTime < 0.0f)
+                keep++;
+        }
+
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = ovenControlHalfCycle(&oc);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+            if (in.heaters & HEATER_TOP_BIT)
+                r->energy[HEATER_TOP] += pp->topPower * HALF_CYCLE_S;
+            if (in.heaters & HEATER_BOTTOM_BIT)
+                r->energy[HEATER_BOTTOM] += pp->bottomPower * HALF_CYCLE_S;
+        }
+        if (verbose && t % 30 == 0)
+            printf("%s,%u,%u,%u,%.2f,%.2f,%.2f,%.3f\n", program->name, t, s, phase, oc.setpoint, tp.sensor, tp.temperature[PLANT_STONE], oc.demand);
+    }
+
+    printf("%s: soak band +-%.0f degC, %u s\n", program->name, program->soakBand, t);
+    printf("%3s %9s %6s %11s %14s %10s %8s %15s  %s\n", "seg", "target[C]", "share", "reached[s]", "hold[s]", "dev[C]", "ratio", "delivered share", "checks");
+    bool ok = true;
+    for (uint8_t i = 0; i < program->count; i++) {
+        const ProfileSegment_t* ps = &program->segments[i];
+        const SegmentResult_t* r = &seg[i];
+        bool forever = (ps->holdTime < 0.0f);
+        uint32_t required = forever ? KEEP_S : (uint32_t)ps->holdTime;
+        bool held = forever ? (r->holdTicks >= KEEP_S) : (r->holdTicks >= required && (i + 1 >= program->count || seg[i + 1].entered));
+        bool inBand = r->reached && r->maxDeviation <= program->soakBand;
+        double total = r->energy[HEATER_TOP] + r->energy[HEATER_BOTTOM];
+        float delivered = (total > 0.0) ? (float)(r->energy[HEATER_TOP] / total) : 0.0f;
+        bool segOk = r->reached && held && inBand && r->shareKept;
+        ok &= segOk;
+
+        printf("%3u %9.0f %6.2f", i, ps->target, ps->topShare);
+        if (r->reached)
+            printf(" %11.0f", r->reachedAt);
+        else
+            printf(" %11s", "-");
+        printf(" %6u / %5u%s %10.2f %8s %15.2f ", r->holdTicks, required, forever ? "+" : " ", r->maxDeviation, r->shareKept ? "kept" : "changed", delivered);
+        if (segOk)
+            printf(" OK\n");
+        else
+            printf("%s%s%s%s\n", r->reached ? "" : " target", held ? "" : " hold", inBand ? "" : " band", r->shareKept ? "" : " share");
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+    if (verbose)
+        printf("program,t,segment,phase,setpoint,sensor,stone,demand\n");
+    bool ok = run(&profilePizza, verbose);
+    ok &= run(&profileBread, verbose);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
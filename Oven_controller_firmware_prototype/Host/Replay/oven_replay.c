@@ -0,0 +1,123 @@
+/**
+ * @file oven_replay.c
+ * @brief Replays a recorded bake log through the current control code and reports where its outputs differ from the recording.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The loop is initialised exactly like in main.c (ovenControlDefaultConfig) and every recorded tick goes through bakeLogRunTick, the same function the firmware used while recording. With unchanged control code the phase and both Q15 duties match the recording in every tick; any difference is a behaviour change between the firmware that recorded the log and this build.
+ *
+ * Usage: oven_replay [-v] log.bin
+ * Exit code: 0 - identical, 1 - divergence or gaps in the log, 2 - the log couldn't be read
+ */
+
+#include "bake_log.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+
+#define MAX_REPORTED    10      // divergent ticks printed without -v
+
+static uint8_t* readFile(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+    uint8_t* data = NULL;
+    size_t cap = 0;
+    *size = 0;
+    for (;;) {
+        if (*size == cap) {
+            cap = cap ? cap * 2 : 65536;
+            uint8_t* grown = realloc(data, cap);
+            if (!grown) {
+                free(data);
+                fclose(f);
+                return NULL;
+            }
+            data = grown;
+        }
+        size_t n = fread(&data[*size], 1, cap - *size, f);
+        if (n == 0)
+            break;
+        *size += n;
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v"))
+            verbose = true;
+        else if (!path)
+            path = argv[i];
+        else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [-v] log.bin\n", argv[0]);
+        return 2;
+    }
+
+    size_t size;
+    uint8_t* data = readFile(path, &size);
+    if (!data) {
+        perror(path);
+        return 2;
+    }
+    BakeLogReader_t reader;
+    if (!bakeLogReaderInit(&reader, data, size)) {
+        fprintf(stderr, "%s: not a bake log (version %u)\n", path, BLOG_VERSION);
+        free(data);
+        return 2;
+    }
+    if (reader.controlPeriod != (uint16_t)(ovenControlDefaultConfig.dt * 1000.0f + 0.5f))
+        fprintf(stderr, "warning: recorded with a %u ms control period, this build uses %.0f ms\n",
+            reader.controlPeriod, ovenControlDefaultConfig.dt * 1000.0f);
+
+    OvenControl_t oc;
+    ovenControlInit(&oc, &ovenControlDefaultConfig);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint32_t ticks = 0, divergent = 0, gaps = 0;
+    uint32_t firstTime = 0, lastTime = 0;
+    BakeLogTick_t tick;
+    BakeLogReadStatus_t status;
+    while ((status = bakeLogRead(&reader, &tick)) != BLOG_READ_END) {
+        if (status == BLOG_READ_RESYNC) {
+            gaps++;
+            fprintf(stderr, "gap before t=%u ms: damaged or missing records skipped, the loop state no longer follows the recording\n", tick.time);
+        }
+        if (ticks == 0)
+            firstTime = tick.time;
+        lastTime = tick.time;
+
+        BakeLogTick_t replayed = tick;
+        bakeLogRunTick(&oc, &replayed);
+        bool same = replayed.phase == tick.phase
+                 && replayed.duty[HEATER_TOP] == tick.duty[HEATER_TOP]
+                 && replayed.duty[HEATER_BOTTOM] == tick.duty[HEATER_BOTTOM];
+        if (!same) {
+            if (verbose || divergent < MAX_REPORTED)
+                printf("tick %u t=%u ms: recorded phase %u duty %u/%u, replayed phase %u duty %u/%u\n",
+                    ticks, tick.time, tick.phase, tick.duty[HEATER_TOP], tick.duty[HEATER_BOTTOM],
+                    replayed.phase, replayed.duty[HEATER_TOP], replayed.duty[HEATER_BOTTOM]);
+            divergent++;
+        }
+        ticks++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wall = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    double span = (double)(lastTime - firstTime) / 1000.0;
+    fprintf(stderr, "%u ticks (%.0f s recorded) replayed in %.3f s (%.0fx real time): %u divergent, %u gaps, %zu trailing bytes\n",
+        ticks, span, wall, (wall > 0.0) ? span / wall : 0.0, divergent, gaps, size - reader.pos);
+    free(data);
+    return (divergent || gaps) ? 1 : 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file oven_sim.c
+ * @brief Faster-than-real-time bake simulator with parallel PID gain sweeps.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Every parameter set is one complete bake: the firmware's control loop (oven_control) runs against the thermal plant, with the controller ticking every CONTROL_PERIOD_S and the plant stepped once per mains half-cycle with the SSR mask the loop returns. Bakes share nothing, so a fixed pool of worker threads takes them from a common counter, each running one simulation at a time, until the grid is done.
+ *
+ * Usage: oven_sim [-j threads] [--program pizza|bread] [--time s] [--kp min:max:n] [--ki min:max:n] [--kd min:max:n] [--door segment:s | --door off] [--band degC] [--csv]
+ *
+ * Reported per parameter set, all on the true chamber air temperature:
+ * - settling time: when the air last entered the +-band around the program's first target, before the target first changes
+ * - overshoot: highest excursion above that target in the same window
+ * - energy: electricity used by both elements over the whole run
+ */
+
+#include "oven_control.h"
+#include "thermal_plant.h"
+#include "math.h"
+#include "pthread.h"
+#include "stdatomic.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+
+#define HALF_CYCLE_S            0.01f   // 50 Hz mains
+#define CONTROL_PERIOD_S        1.0f
+#define HALF_CYCLES_PER_TICK    100
+#define MAINS_VOLTAGE           230.0f
+#define CURRENT_CAP_A           16.0f
+#define AMBIENT_C               22.0f
+
+#define DEFAULT_RUN_TIME_S      3600.0f
+#define DEFAULT_BAND_C          5.0f
+#define DEFAULT_DOOR_SEGMENT    2       // loading the pizza/bread
+#define DEFAULT_DOOR_TIME_S     15.0f
+
+typedef struct Range_t {
+    float min;
+    float max;
+    uint32_t n;
+} Range_t;
+
+typedef struct SimConfig_t {
+    const BakeProgram_t* program;
+    float runTime;          // [s]
+    float band;             // settling band [degC]
+    int doorSegment;        // -1 = door stays closed
+    float doorTime;         // [s]
+    Range_t kp, ki, kd;
+} SimConfig_t;
+
+typedef struct RunResult_t {
+    PIDGains_t gains;
+    float settlingTime;     // [s], NAN if never settled
+    float overshoot;        // [degC]
+    float energy;           // [kWh]
+} RunResult_t;
+
+typedef struct Pool_t {
+    const SimConfig_t* cfg;
+    RunResult_t* results;
+    uint32_t count;
+    atomic_uint next;
+} Pool_t;
+
+/* One bake */
+
+static float rangeValue(const Range_t* r, uint32_t i) {
+    return (r->n <= 1) ? r->min : r->min + (r->max - r->min) * (float)i / (float)(r->n - 1);
+}
+
+static PIDGains_t gridGains(const SimConfig_t* cfg, uint32_t index) {
+    PIDGains_t g;
+    g.kd = rangeValue(&cfg->kd, index % cfg->kd.n);
+    index /= cfg->kd.n;
+    g.ki = rangeValue(&cfg->ki, index % cfg->ki.n);
+    index /= cfg->ki.n;
+    g.kp = rangeValue(&cfg->kp, index);
+    return g;
+}
+
+static void runBake(const SimConfig_t* cfg, PIDGains_t gains, RunResult_t* r) {
+    const PlantParams_t* pp = &plantDefaultParams;
+    OvenControlConfig_t occ = {
+        .gains = gains,
+        .derivativeFilter = 5.0f,
+        .dt = CONTROL_PERIOD_S,
+        .topPower = pp->topPower,
+        .bottomPower = pp->bottomPower,
+        .topCurrent = pp->topPower / MAINS_VOLTAGE,
+        .bottomCurrent = pp->bottomPower / MAINS_VOLTAGE,
+        .currentCap = CURRENT_CAP_A,
+    };
+    OvenControl_t oc;
+    ThermalPlant_t tp;
+    ovenControlInit(&oc, &occ);
+    plantInit(&tp, pp, AMBIENT_C);
+    ovenControlStart(&oc, cfg->program, tp.sensor);
+
+    const float target = cfg->program->segments[0].target;
+    bool window = true;         // setpoint still on the first target
+    float lastOutside = 0.0f;
+    bool settled = false;
+    float overshoot = 0.0f;
+    float doorUntil = -1.0f;
+    int segment = -1;
+    PlantInputs_t in = { 0, false, AMBIENT_C };
+
+    uint32_t ticks = (uint32_t)(cfg->runTime / CONTROL_PERIOD_S);
+    for (uint32_t k = 0; k < ticks; k++) {
+        float t = (float)k * CONTROL_PERIOD_S;
+        ovenControlStep(&oc, tp.sensor);
+
+        int s = profileGetSegment(&oc.profile);
+        if (s != segment) {
+            segment = s;
+            if (s == cfg->doorSegment)
+                doorUntil = t + cfg->doorTime;
+        }
+        in.doorOpen = (t < doorUntil);
+        if (window && ovenControlGetSetpoint(&oc) != target)
+            window = false;
+
+        for (uint32_t h = 0; h < HALF_CYCLES_PER_TICK; h++) {
+            in.heaters = ovenControlHalfCycle(&oc);
+            plantStep(&tp, &in, HALF_CYCLE_S);
+        }
+
+        if (window) {
+            float err = tp.temperature[PLANT_AIR] - target;
+            if (err > overshoot)
+                overshoot = err;
+            if (fabsf(err) > cfg->band) {
+                lastOutside = t + CONTROL_PERIOD_S;
+                settled = false;
+            } else {
+                settled = true;
+            }
+        }
+    }
+
+    r->gains = gains;
+    r->settlingTime = settled ? lastOutside : NAN;
+    r->overshoot = overshoot;
+    r->energy = (float)(tp.energy / 3.6e6);
+}
+
+/* Thread pool */
+
+static void* worker(void* arg) {
+    Pool_t* pool = arg;
+    for (;;) {
+        uint32_t i = atomic_fetch_add(&pool->next, 1);
+        if (i >= pool->count)
+            return NULL;
+        runBake(pool->cfg, gridGains(pool->cfg, i), &pool->results[i]);
+    }
+}
+
+static void runPool(Pool_t* pool, uint32_t threads) {
+    pthread_t* ids = malloc(threads * sizeof(pthread_t));
+    uint32_t started = 0;
+    for (; started < threads; started++)
+        if (pthread_create(&ids[started], NULL, worker, pool) != 0)
+            break;
+    if (started == 0)
+        worker(pool);
+    for (uint32_t i = 0; i < started; i++)
+        pthread_join(ids[i], NULL);
+    free(ids);
+}
+
+/* Command line and output */
+
+static bool parseRange(const char* s, Range_t* r) {
+    char* end;
+    r->min = strtof(s, &end);
+    if (*end != ':')
+        return false;
+    r->max = strtof(end + 1, &end);
+    if (*end != ':')
+        return false;
+    long n = strtol(end + 1, &end, 10);
+    if (*end != '\0' || n < 1)
+        return false;
+    r->n = (uint32_t)n;
+    return true;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "usage: %s [-j threads] [--program pizza|bread] [--time s] [--kp min:max:n] [--ki min:max:n] [--kd min:max:n] [--door segment:s | --door off] [--band degC] [--csv]\n", name);
+    exit(2);
+}
+
+static void printResult(const RunResult_t* r, bool csv) {
+    if (csv) {
+        printf("%g,%g,%g,", r->gains.kp, r->gains.ki, r->gains.kd);
+        if (isnan(r->settlingTime))
+            printf(",");
+        else
+            printf("%.0f,", r->settlingTime);
+        printf("%.2f,%.3f\n", r->overshoot, r->energy);
+        return;
+    }
+    printf("%10.5f %10.6f %10.4f ", r->gains.kp, r->gains.ki, r->gains.kd);
+    if (isnan(r->settlingTime))
+        printf("%12s ", "-");
+    else
+        printf("%12.0f ", r->settlingTime);
+    printf("%14.2f %12.3f\n", r->overshoot, r->energy);
+}
+
+int main(int argc, char** argv) {
+    SimConfig_t cfg = {
+        .program = &profilePizza,
+        .runTime = DEFAULT_RUN_TIME_S,
+        .band = DEFAULT_BAND_C,
+        .doorSegment = DEFAULT_DOOR_SEGMENT,
+        .doorTime = DEFAULT_DOOR_TIME_S,
+        .kp = { 0.01f, 0.1f, 16 },
+        .ki = { 0.0001f, 0.002f, 16 },
+        .kd = { 0.0f, 0.4f, 8 },
+    };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = (cpus > 0) ? (uint32_t)cpus : 1;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--csv")) {
+            csv = true;
+            continue;
+        }
+        if (!v)
+            usage(argv[0]);
+        i++;
+        if (!strcmp(a, "-j")) {
+            threads = (uint32_t)strtoul(v, NULL, 10);
+            if (threads == 0)
+                usage(argv[0]);
+        } else if (!strcmp(a, "--program")) {
+            if (!strcmp(v, "pizza"))
+                cfg.program = &profilePizza;
+            else if (!strcmp(v, "bread"))
+                cfg.program = &profileBread;
+            else
+                usage(argv[0]);
+        } else if (!strcmp(a, "--time")) {
+            cfg.runTime = strtof(v, NULL);
+        } else if (!strcmp(a, "--band")) {
+            cfg.band = strtof(v, NULL);
+        } else if (!strcmp(a, "--door")) {
+            if (!strcmp(v, "off"))
+                cfg.doorSegment = -1;
+            else if (sscanf(v, "%d:%f", &cfg.doorSegment, &cfg.doorTime) != 2)
+                usage(argv[0]);
+        } else if (!strcmp(a, "--kp") || !strcmp(a, "--ki") || !strcmp(a, "--kd")) {
+            Range_t* r = (a[3] == 'p') ? &cfg.kp : (a[3] == 'i') ? &cfg.ki : &cfg.kd;
+            if (!parseRange(v, r))
+                usage(argv[0]);
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    Pool_t pool = { .cfg = &cfg, .count = cfg.kp.n * cfg.ki.n * cfg.kd.n };
+    atomic_init(&pool.next, 0);
+    pool.results = calloc(pool.count, sizeof(RunResult_t));
+    if (!pool.results) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    runPool(&pool, threads);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wall = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    if (csv)
+        printf("kp,ki,kd,settling_s,overshoot_C,energy_kWh\n");
+    else
+        printf("%10s %10s %10s %12s %14s %12s\n", "kp", "ki", "kd", "settling[s]", "overshoot[C]", "energy[kWh]");
+    for (uint32_t i = 0; i < pool.count; i++)
+        printResult(&pool.results[i], csv);
+
+    double simulated = (double)pool.count * cfg.runTime;
+    fprintf(stderr, "%s: %u bakes of %.0f s on %u threads in %.2f s (%.0fx real time)\n",
+        cfg.program->name, pool.count, cfg.runTime, threads, wall, simulated / wall);
+    free(pool.results);
+    return 0;
+}
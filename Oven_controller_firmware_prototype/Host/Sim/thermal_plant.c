@@ -0,0 +1,79 @@
+/**
+ * @file thermal_plant.c
+ * @brief Thermal plant implementation. See thermal_plant.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Each step sums the heat flows through all links and the heater powers into every node, then updates the temperatures with C dT/dt = sum(P). The default parameters are rough numbers for the prototype: about 30 minutes of full-power preheat to 450 degC and roughly half of the power needed to hold it.
+ */
+
+#include "thermal_plant.h"
+#include "heater_output.h"
+
+#define KELVIN  273.15f
+
+const PlantParams_t plantDefaultParams = {
+    .capacity = {
+        [PLANT_TOP_ELEMENT] = 150.0f,
+        [PLANT_BOTTOM_ELEMENT] = 150.0f,
+        [PLANT_AIR] = 80.0f,
+        [PLANT_STONE] = 2500.0f,
+        [PLANT_WALLS] = 8000.0f,
+    },
+    .links = {
+        { PLANT_TOP_ELEMENT, PLANT_AIR, 4.0f },
+        { PLANT_TOP_ELEMENT, PLANT_STONE, 3.5f },     // radiation onto the stone surface
+        { PLANT_BOTTOM_ELEMENT, PLANT_STONE, 8.0f },  // element right under the stone
+        { PLANT_BOTTOM_ELEMENT, PLANT_AIR, 1.0f },
+        { PLANT_AIR, PLANT_STONE, 5.0f },
+        { PLANT_AIR, PLANT_WALLS, 6.0f },
+        { PLANT_AIR, PLANT_AMBIENT, 0.6f },           // leakage around the door
+        { PLANT_WALLS, PLANT_AMBIENT, 2.6f },         // through the insulation
+    },
+    .linkCount = 8,
+    .doorConductance = 15.0f,
+    .topPower = 1500.0f,
+    .bottomPower = 1200.0f,
+    .sensorTau = 3.0f,
+};
+
+void plantInit(ThermalPlant_t* tp, const PlantParams_t* params, float ambient) {
+    tp->params = params;
+    for (uint8_t i = 0; i < PLANT_NODES; i++)
+        tp->temperature[i] = ambient;
+    tp->sensor = ambient;
+    tp->energy = 0.0;
+}
+
+void plantStep(ThermalPlant_t* tp, const PlantInputs_t* in, float dt) {
+    const PlantParams_t* p = tp->params;
+    float power[PLANT_NODES] = { 0.0f };
+    float t[PLANT_NODES + 1];
+    for (uint8_t i = 0; i < PLANT_NODES; i++)
+        t[i] = tp->temperature[i];
+    t[PLANT_AMBIENT] = in->ambient;
+
+    if (in->heaters & HEATER_TOP_BIT)
+        power[PLANT_TOP_ELEMENT] += p->topPower;
+    if (in->heaters & HEATER_BOTTOM_BIT)
+        power[PLANT_BOTTOM_ELEMENT] += p->bottomPower;
+    tp->energy += (double)((power[PLANT_TOP_ELEMENT] + power[PLANT_BOTTOM_ELEMENT]) * dt);
+
+    for (uint8_t k = 0; k < p->linkCount; k++) {
+        const PlantLink_t* l = &p->links[k];
+        float flow = l->conductance * (t[l->a] - t[l->b]);
+        if (l->radiation != 0.0f) {
+            float ka = t[l->a] + KELVIN, kb = t[l->b] + KELVIN;
+            flow += l->radiation * (ka * ka * ka * ka - kb * kb * kb * kb);
+        }
+        power[l->a] -= flow;
+        if (l->b != PLANT_AMBIENT)
+            power[l->b] += flow;
+    }
+    if (in->doorOpen)
+        power[PLANT_AIR] -= p->doorConductance * (t[PLANT_AIR] - in->ambient);
+
+    for (uint8_t i = 0; i < PLANT_NODES; i++)
+        tp->temperature[i] += power[i] * dt / p->capacity[i];
+    tp->sensor += (tp->temperature[PLANT_AIR] - tp->sensor) * dt / p->sensorTau;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file thermal_plant.h
+ * @brief Lumped thermal model of the oven for the host simulator. See thermal_plant.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Five nodes (top element, bottom element, chamber air, stone, walls) joined by thermal conductances and optional radiation terms, ambient as a fixed-temperature boundary
+- Inputs per step: the SSR mask of the half-cycle, door open/closed and the ambient temperature
+- Chamber thermocouple modelled as a first-order lag on the air temperature
+- Instance based with no global state, any number of plants can be stepped in parallel
+
+# Limitations
+- The default parameters linearise the radiation between the elements and the stone around baking temperatures, links with a radiation term make the model nonlinear
+- Explicit Euler integration, the step has to stay well below the fastest time constant (the chamber air, a few seconds with the default parameters)
+*/
+
+#ifndef THERMAL_PLANT_H
+#define THERMAL_PLANT_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+typedef enum PlantNode_t {
+    PLANT_TOP_ELEMENT,
+    PLANT_BOTTOM_ELEMENT,
+    PLANT_AIR,
+    PLANT_STONE,
+    PLANT_WALLS,
+    PLANT_NODES,
+    PLANT_AMBIENT = PLANT_NODES,    // boundary, only valid in links
+} PlantNode_t;
+
+#define PLANT_MAX_LINKS     12
+
+typedef struct PlantLink_t {
+    uint8_t a;
+    uint8_t b;                      // PlantNode_t, may be PLANT_AMBIENT
+    float conductance;              // [W/K]
+    float radiation;                // emissivity * sigma * area of a radiating link [W/K^4], 0 for a linear one
+} PlantLink_t;
+
+typedef struct PlantParams_t {
+    float capacity[PLANT_NODES];    // [J/K]
+    PlantLink_t links[PLANT_MAX_LINKS];
+    uint8_t linkCount;
+    float doorConductance;          // extra air-ambient conductance while the door is open [W/K]
+    float topPower;                 // [W]
+    float bottomPower;              // [W]
+    float sensorTau;                // chamber thermocouple time constant [s]
+} PlantParams_t;
+
+typedef struct PlantInputs_t {
+    uint8_t heaters;                // HEATER_TOP_BIT, HEATER_BOTTOM_BIT
+    bool doorOpen;
+    float ambient;                  // [degC]
+} PlantInputs_t;
+
+typedef struct ThermalPlant_t {
+    const PlantParams_t* params;
+    float temperature[PLANT_NODES]; // [degC]
+    float sensor;                   // chamber thermocouple reading [degC]
+    double energy;                  // electrical energy delivered to the elements [J]
+} ThermalPlant_t;
+
+extern const PlantParams_t plantDefaultParams;
+
+/**
+ * @brief Initialises the plant with every node at the ambient temperature
+ * @param tp pointer to the plant instance
+ * @param params model parameters (must stay valid)
+ * @param ambient [degC]
+ */
+void plantInit(ThermalPlant_t* tp, const PlantParams_t* params, float ambient);
+
+/**
+ * @brief Advances the model by one step
+ * @param tp pointer to the plant instance
+ * @param in inputs held for the whole step
+ * @param dt step [s]
+ */
+void plantStep(ThermalPlant_t* tp, const PlantInputs_t* in, float dt);
+
+#endif
@@ -0,0 +1,783 @@
+/**
+ * @file fake_hal.c
+ * @brief Fake STM32F3 HAL implementation for the host build. See stm32f3xx_hal.h and fake_hal.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Everything runs on one thread. Interrupts are modelled as events in a small queue, sorted by virtual time when they are delivered. An event is only delivered while virtual time moves forward, with PRIMASK clear and outside of other events, which gives the same ordering guarantees as equal-priority interrupts on the target. Clearing PRIMASK delivers whatever became due while it was set, like a pending interrupt would be taken.
+ *
+ * A DMA transfer is started by scheduling its completion after the time it would take on the bus. The simulated device is accessed when the event is delivered, so the firmware sees the data appear at the end of the transfer, as with the real DMA.
+ */
+
+#include "fake_hal.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+/* Peripheral instances */
+
+uint32_t SystemCoreClock = 72000000U;
+GPIO_TypeDef fakeGpioPorts[6];
+DMA_Channel_TypeDef fakeDmaChannels[7];
+I2C_TypeDef fakeI2C1;
+SPI_TypeDef fakeSPI2;
+USART_TypeDef fakeUSART2;
+CRC_TypeDef fakeCRC;
+
+#define HCLK_HZ     72000000U
+#define PCLK1_HZ    36000000U
+#define PCLK2_HZ    72000000U
+
+/* VIRTUAL TIME AND SIMULATED INTERRUPTS */
+
+typedef struct Event_t {
+    uint64_t time;
+    uint32_t seq;
+    FakeHalEvent_t handler;
+    void* arg;
+} Event_t;
+
+static Event_t events[FAKE_HAL_MAX_EVENTS];
+static uint8_t eventCount = 0;
+static uint32_t eventSeq = 0;
+static uint64_t now = 0;
+static uint64_t runLimit = 0;
+static uint32_t primask = 0;
+static bool inInterrupt = false;
+
+static int8_t nextEvent(void) {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < eventCount; i++) {
+        if (best < 0 || events[i].time < events[best].time
+            || (events[i].time == events[best].time && events[i].seq < events[best].seq))
+            best = (int8_t)i;
+    }
+    return best;
+}
+
+static void deliver(uint64_t until) {
+    while (!primask && !inInterrupt) {
+        int8_t i = nextEvent();
+        if (i < 0 || events[i].time > until)
+            return;
+        Event_t e = events[i];
+        events[i] = events[--eventCount];
+        if (e.time > now)
+            now = e.time;
+        inInterrupt = true;
+        e.handler(e.arg);
+        inInterrupt = false;
+    }
+}
+
+static void printSummary(void) {
+    fprintf(stderr, "virtual time: %.3f s\n", (double)now / 1e6);
+}
+
+uint64_t fakeHalMicros(void) {
+    return now;
+}
+
+void fakeHalAdvance(uint32_t us) {
+    uint64_t target = now + us;
+    deliver(target);
+    if (target > now)
+        now = target;
+    if (runLimit != 0 && now >= runLimit && !inInterrupt)
+        exit(0);
+}
+
+bool fakeHalSchedule(uint32_t delayUs, FakeHalEvent_t event, void* arg) {
+    if (eventCount >= FAKE_HAL_MAX_EVENTS)
+        return false;
+    events[eventCount].time = now + delayUs;
+    events[eventCount].seq = eventSeq++;
+    events[eventCount].handler = event;
+    events[eventCount].arg = arg;
+    eventCount++;
+    return true;
+}
+
+void fakeHalSetRunTime(uint32_t ms) {
+    runLimit = (uint64_t)ms * 1000U;
+}
+
+void __enable_irq(void) {
+    primask = 0;
+    deliver(now);
+}
+
+void __disable_irq(void) {
+    primask = 1;
+}
+
+uint32_t __get_PRIMASK(void) {
+    return primask;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+    primask = priMask & 1U;
+    deliver(now);
+}
+
+/* Weak defaults, overridden by the firmware or the host board */
+
+__WEAK void hostBoardInit(void) {}
+__WEAK void HAL_MspInit(void) {}
+__WEAK void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) { UNUSED(GPIO_Pin); }
+__WEAK void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_MspDeInit(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) { UNUSED(hi2c); }
+__WEAK void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi) { UNUSED(hspi); }
+__WEAK void HAL_SPI_MspDeInit(SPI_HandleTypeDef* hspi) { UNUSED(hspi); }
+__WEAK void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) { UNUSED(hspi); }
+__WEAK void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) { UNUSED(hspi); }
+__WEAK void HAL_UART_MspInit(UART_HandleTypeDef* huart) { UNUSED(huart); }
+__WEAK void HAL_UART_MspDeInit(UART_HandleTypeDef* huart) { UNUSED(huart); }
+__WEAK void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { UNUSED(huart); }
+__WEAK void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) { UNUSED(huart); }
+__WEAK void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) { UNUSED(huart); }
+__WEAK void HAL_CRC_MspInit(CRC_HandleTypeDef* hcrc) { UNUSED(hcrc); }
+__WEAK void HAL_CRC_MspDeInit(CRC_HandleTypeDef* hcrc) { UNUSED(hcrc); }
+
+/* Tick */
+
+static FILE* uartFile = NULL;
+
+HAL_StatusTypeDef HAL_Init(void) {
+    now = 0;
+    eventCount = 0;
+    primask = 0;
+
+    const char* runMs = getenv("OVEN_HOST_RUN_MS");
+    fakeHalSetRunTime(runMs ? (uint32_t)strtoul(runMs, NULL, 10) : FAKE_HAL_DEFAULT_RUN_MS);
+    const char* uartPath = getenv("OVEN_HOST_UART");
+    if (uartPath) {
+        uartFile = fopen(uartPath, "wb");
+        if (!uartFile)
+            perror(uartPath);
+    }
+    atexit(printSummary);
+
+    HAL_MspInit();
+    hostBoardInit();
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void) {
+    fakeHalAdvance(FAKE_HAL_POLL_US);
+    return (uint32_t)(now / 1000U);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    fakeHalAdvance(Delay * 1000U);
+}
+
+void HAL_IncTick(void) {
+    fakeHalAdvance(1000U);
+}
+
+/* RCC and NVIC (configuration is ignored) */
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct) {
+    UNUSED(RCC_OscInitStruct);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency) {
+    UNUSED(RCC_ClkInitStruct);
+    UNUSED(FLatency);
+    SystemCoreClock = HCLK_HZ;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit) {
+    UNUSED(PeriphClkInit);
+    return HAL_OK;
+}
+
+void HAL_RCC_EnableCSS(void) {}
+
+uint32_t HAL_RCC_GetHCLKFreq(void) {
+    return HCLK_HZ;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return PCLK1_HZ;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return PCLK2_HZ;
+}
+
+void HAL_NVIC_SetPriorityGrouping(uint32_t PriorityGroup) { UNUSED(PriorityGroup); }
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) { UNUSED(IRQn); UNUSED(PreemptPriority); UNUSED(SubPriority); }
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { UNUSED(IRQn); }
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { UNUSED(IRQn); }
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma) {
+    UNUSED(hdma);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma) {
+    UNUSED(hdma);
+    return HAL_OK;
+}
+
+/* GPIO */
+
+static uint32_t pinModes[6][16];
+
+static uint8_t portIndex(GPIO_TypeDef* GPIOx) {
+    return (uint8_t)(GPIOx - fakeGpioPorts);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init) {
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        if (!(GPIO_Init->Pin & (1U << pin)))
+            continue;
+        pinModes[portIndex(GPIOx)][pin] = GPIO_Init->Mode;
+        // inputs idle at their pull level, falling edge interrupt inputs idle high (external pull-up)
+        if (GPIO_Init->Pull == GPIO_PULLUP || GPIO_Init->Mode == GPIO_MODE_IT_FALLING)
+            GPIOx->IDR |= 1U << pin;
+        else if (GPIO_Init->Mode == GPIO_MODE_INPUT || GPIO_Init->Mode == GPIO_MODE_IT_RISING)
+            GPIOx->IDR &= ~(1U << pin);
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin) {
+    for (uint8_t pin = 0; pin < 16; pin++)
+        if (GPIO_Pin & (1U << pin))
+            pinModes[portIndex(GPIOx)][pin] = GPIO_MODE_INPUT;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+        GPIOx->IDR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+        GPIOx->IDR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    GPIOx->ODR ^= GPIO_Pin;
+    GPIOx->IDR = (GPIOx->IDR & ~(uint32_t)GPIO_Pin) | (GPIOx->ODR & GPIO_Pin);
+}
+
+static void extiEvent(void* arg) {
+    HAL_GPIO_EXTI_Callback((uint16_t)(uintptr_t)arg);
+}
+
+void fakeGpioSetInput(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+    bool was = (port->IDR & pin) != 0;
+    bool is = (state != GPIO_PIN_RESET);
+    if (is)
+        port->IDR |= pin;
+    else
+        port->IDR &= ~(uint32_t)pin;
+
+    for (uint8_t p = 0; p < 16; p++) {
+        if (!(pin & (1U << p)))
+            continue;
+        uint32_t mode = pinModes[portIndex(port)][p];
+        if ((mode == GPIO_MODE_IT_FALLING && was && !is) || (mode == GPIO_MODE_IT_RISING && !was && is))
+            fakeHalSchedule(0, extiEvent, (void*)(uintptr_t)(1U << p));
+    }
+}
+
+/* I2C */
+
+typedef enum I2CXfer_t {
+    XFER_TX,
+    XFER_RX,
+    XFER_MEM_TX,
+    XFER_MEM_RX,
+} I2CXfer_t;
+
+static const FakeI2CDevice_t* i2cDevices[FAKE_I2C_MAX_DEVICES];
+static uint8_t i2cDeviceCount = 0;
+static uint8_t i2cScratch[FAKE_I2C_MAX_XFER + 2];
+static uint32_t i2cByteUs = FAKE_I2C_BYTE_US;
+static uint64_t i2cByteBase = 0;        // fakeI2CByteTime(0) of the device call in progress
+
+bool fakeI2CAttach(const FakeI2CDevice_t* device) {
+    if (i2cDeviceCount >= FAKE_I2C_MAX_DEVICES)
+        return false;
+    i2cDevices[i2cDeviceCount++] = device;
+    return true;
+}
+
+static const FakeI2CDevice_t* findI2C(uint16_t devAddress) {
+    for (uint8_t i = 0; i < i2cDeviceCount; i++)
+        if (i2cDevices[i]->address == (devAddress >> 1))
+            return i2cDevices[i];
+    return NULL;
+}
+
+void fakeI2CSetByteTime(uint32_t us) {
+    i2cByteUs = us;
+}
+
+uint64_t fakeI2CByteTime(uint16_t index) {
+    return i2cByteBase + (uint64_t)index * i2cByteUs;
+}
+
+static uint32_t i2cDuration(I2CXfer_t kind, uint8_t memSize, uint16_t size) {
+    uint32_t bytes = 1U + size;             // address byte + data
+    if (kind == XFER_MEM_TX || kind == XFER_MEM_RX)
+        bytes += memSize;
+    if (kind == XFER_MEM_RX)
+        bytes += 1U;                        // address byte after the repeated start
+    return bytes * i2cByteUs;
+}
+
+// performs the transfer on the device, returns false if it wasn't acknowledged. Called at the end of the transfer.
+static bool i2cAccess(I2CXfer_t kind, uint16_t devAddress, uint16_t memAddress, uint8_t memSize, uint8_t* data, uint16_t size) {
+    const FakeI2CDevice_t* d = findI2C(devAddress);
+    if (!d)
+        return false;
+
+    uint8_t n = 0;
+    if (memSize == 2)
+        i2cScratch[n++] = (uint8_t)(memAddress >> 8);
+    i2cScratch[n++] = (uint8_t)memAddress;
+
+    // written bytes count from the acknowledge of the first one, read bytes from the acknowledge of the address before them
+    uint64_t start = now - i2cDuration(kind, memSize, size);
+    i2cByteBase = start + 2U * i2cByteUs;
+    switch (kind) {
+        case XFER_TX:
+            return d->write && d->write(data, size);
+        case XFER_RX:
+            i2cByteBase = start + i2cByteUs;
+            return d->read && d->read(data, size);
+        case XFER_MEM_TX:
+            if (size > FAKE_I2C_MAX_XFER || !d->write)
+                return false;
+            memcpy(&i2cScratch[n], data, size);
+            return d->write(i2cScratch, (uint16_t)(n + size));
+        case XFER_MEM_RX:
+            if (!d->write || !d->read || !d->write(i2cScratch, n))
+                return false;
+            i2cByteBase = start + (uint64_t)(n + 2U) * i2cByteUs;
+            return d->read(data, size);
+    }
+    return false;
+}
+
+static HAL_StatusTypeDef i2cBlocking(I2C_HandleTypeDef* hi2c, I2CXfer_t kind, uint16_t devAddress, uint16_t memAddress, uint8_t memSize, uint8_t* data, uint16_t size) {
+    if (hi2c->State != HAL_I2C_STATE_READY)
+        return HAL_BUSY;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = HAL_I2C_STATE_BUSY;
+    fakeHalAdvance(i2cDuration(kind, memSize, size));
+    bool ack = i2cAccess(kind, devAddress, memAddress, memSize, data, size);
+    hi2c->State = HAL_I2C_STATE_READY;
+    if (!ack) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+static void i2cDmaComplete(void* arg) {
+    I2C_HandleTypeDef* hi2c = arg;
+    I2CXfer_t kind = (I2CXfer_t)hi2c->fakeXfer;
+    bool ack = i2cAccess(kind, hi2c->Devaddress, hi2c->Memaddress, hi2c->fakeMemSize, hi2c->pBuffPtr, hi2c->XferSize);
+    hi2c->State = HAL_I2C_STATE_READY;
+    if (!ack) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+        return;
+    }
+    switch (kind) {
+        case XFER_TX:
+            HAL_I2C_MasterTxCpltCallback(hi2c);
+            break;
+        case XFER_RX:
+            HAL_I2C_MasterRxCpltCallback(hi2c);
+            break;
+        case XFER_MEM_TX:
+            HAL_I2C_MemTxCpltCallback(hi2c);
+            break;
+        case XFER_MEM_RX:
+            HAL_I2C_MemRxCpltCallback(hi2c);
+            break;
+    }
+}
+
+static HAL_StatusTypeDef i2cStartDma(I2C_HandleTypeDef* hi2c, I2CXfer_t kind, uint16_t devAddress, uint16_t memAddress, uint8_t memSize, uint8_t* data, uint16_t size) {
+    if (hi2c->State != HAL_I2C_STATE_READY)
+        return HAL_BUSY;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = (kind == XFER_TX || kind == XFER_MEM_TX) ? HAL_I2C_STATE_BUSY_TX : HAL_I2C_STATE_BUSY_RX;
+    hi2c->fakeXfer = (uint8_t)kind;
+    hi2c->fakeMemSize = memSize;
+    hi2c->Devaddress = devAddress;
+    hi2c->Memaddress = memAddress;
+    hi2c->pBuffPtr = data;
+    hi2c->XferSize = size;
+    if (!fakeHalSchedule(i2cDuration(kind, memSize, size), i2cDmaComplete, hi2c)) {
+        hi2c->State = HAL_I2C_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef* hi2c) {
+    if (hi2c->State == HAL_I2C_STATE_RESET)
+        HAL_I2C_MspInit(hi2c);
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = HAL_I2C_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef* hi2c, uint32_t AnalogFilter) {
+    UNUSED(hi2c);
+    UNUSED(AnalogFilter);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigDigitalFilter(I2C_HandleTypeDef* hi2c, uint32_t DigitalFilter) {
+    UNUSED(hi2c);
+    UNUSED(DigitalFilter);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    return i2cBlocking(hi2c, XFER_TX, DevAddress, 0, 0, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    return i2cBlocking(hi2c, XFER_RX, DevAddress, 0, 0, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    return i2cBlocking(hi2c, XFER_MEM_TX, DevAddress, MemAddress, (uint8_t)MemAddSize, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    return i2cBlocking(hi2c, XFER_MEM_RX, DevAddress, MemAddress, (uint8_t)MemAddSize, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout) {
+    UNUSED(Trials);
+    UNUSED(Timeout);
+    if (hi2c->State != HAL_I2C_STATE_READY)
+        return HAL_BUSY;
+    fakeHalAdvance(i2cByteUs);
+    return findI2C(DevAddress) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size) {
+    return i2cStartDma(hi2c, XFER_TX, DevAddress, 0, 0, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size) {
+    return i2cStartDma(hi2c, XFER_RX, DevAddress, 0, 0, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size) {
+    return i2cStartDma(hi2c, XFER_MEM_TX, DevAddress, MemAddress, (uint8_t)MemAddSize, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size) {
+    return i2cStartDma(hi2c, XFER_MEM_RX, DevAddress, MemAddress, (uint8_t)MemAddSize, pData, Size);
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef* hi2c) {
+    return hi2c->State;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c) {
+    return hi2c->ErrorCode;
+}
+
+/* SPI */
+
+static const FakeSpiDevice_t* spiDevices[FAKE_SPI_MAX_DEVICES];
+static uint8_t spiDeviceCount = 0;
+static uint8_t spiFailures = 0;
+
+bool fakeSpiAttach(const FakeSpiDevice_t* device) {
+    if (spiDeviceCount >= FAKE_SPI_MAX_DEVICES)
+        return false;
+    spiDevices[spiDeviceCount++] = device;
+    return true;
+}
+
+void fakeSpiFailNext(uint8_t count) {
+    spiFailures = count;
+}
+
+static void spiAccess(const uint8_t* tx, uint8_t* rx, uint16_t size) {
+    for (uint8_t i = 0; i < spiDeviceCount; i++) {
+        const FakeSpiDevice_t* d = spiDevices[i];
+        if (!(d->csPort->ODR & d->csPin)) {
+            d->transfer(tx, rx, size);
+            return;
+        }
+    }
+    if (rx)
+        memset(rx, 0, size);
+}
+
+static uint32_t spiDuration(SPI_HandleTypeDef* hspi, uint16_t size) {
+    uint32_t divider = 2U << (hspi->Init.BaudRatePrescaler >> 3);
+    return ((uint32_t)size * 8U * divider + PCLK1_HZ / 1000000U - 1U) / (PCLK1_HZ / 1000000U);
+}
+
+static void spiDmaComplete(void* arg) {
+    SPI_HandleTypeDef* hspi = arg;
+    if (spiFailures > 0) {
+        spiFailures--;
+        hspi->ErrorCode = HAL_SPI_ERROR_OVR;
+        hspi->State = HAL_SPI_STATE_READY;
+        HAL_SPI_ErrorCallback(hspi);
+        return;
+    }
+    spiAccess(hspi->pTxBuffPtr, hspi->pRxBuffPtr, hspi->TxXferSize);
+    hspi->State = HAL_SPI_STATE_READY;
+    HAL_SPI_TxRxCpltCallback(hspi);
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi) {
+    if (hspi->State == HAL_SPI_STATE_RESET)
+        HAL_SPI_MspInit(hspi);
+    hspi->Instance->CR1 = hspi->Init.CLKPhase | hspi->Init.CLKPolarity;
+    hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+    hspi->State = HAL_SPI_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hspi->State != HAL_SPI_STATE_READY)
+        return HAL_BUSY;
+    fakeHalAdvance(spiDuration(hspi, Size));
+    spiAccess(pData, NULL, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (hspi->State != HAL_SPI_STATE_READY)
+        return HAL_BUSY;
+    fakeHalAdvance(spiDuration(hspi, Size));
+    spiAccess(pTxData, pRxData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size) {
+    if (hspi->State != HAL_SPI_STATE_READY)
+        return HAL_BUSY;
+    hspi->pTxBuffPtr = pTxData;
+    hspi->pRxBuffPtr = pRxData;
+    hspi->TxXferSize = Size;
+    hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+    hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+    __HAL_SPI_ENABLE(hspi);
+    if (!fakeHalSchedule(spiDuration(hspi, Size), spiDmaComplete, hspi)) {
+        hspi->State = HAL_SPI_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef* hspi) {
+    return hspi->State;
+}
+
+/* UART */
+
+static FakeUartSink_t uartSink = NULL;
+
+void fakeUartSetSink(FakeUartSink_t sink) {
+    uartSink = sink;
+}
+
+static void uartOutput(const uint8_t* data, uint16_t size) {
+    if (uartSink) {
+        uartSink(data, size);
+        return;
+    }
+    FILE* f = uartFile ? uartFile : stdout;
+    fwrite(data, 1, size, f);
+    fflush(f);
+}
+
+static uint32_t uartDuration(UART_HandleTypeDef* huart, uint16_t size) {
+    uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 115200U;
+    return (uint32_t)(((uint64_t)size * 10U * 1000000U + baud - 1U) / baud);   // start + 8 data + stop bits
+}
+
+static void uartTxComplete(void* arg) {
+    UART_HandleTypeDef* huart = arg;
+    uartOutput(huart->pTxBuffPtr, huart->TxXferSize);
+    huart->gState = HAL_UART_STATE_READY;
+    HAL_UART_TxCpltCallback(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart) {
+    if (huart->gState == HAL_UART_STATE_RESET)
+        HAL_UART_MspInit(huart);
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (huart->gState != HAL_UART_STATE_READY)
+        return HAL_BUSY;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    fakeHalAdvance(uartDuration(huart, Size));
+    uartOutput(pData, Size);
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    if (huart->gState != HAL_UART_STATE_READY)
+        return HAL_BUSY;
+    huart->pTxBuffPtr = (uint8_t*)pData;
+    huart->TxXferSize = Size;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    if (!fakeHalSchedule(uartDuration(huart, Size), uartTxComplete, huart)) {
+        huart->gState = HAL_UART_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef uartStartRx(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, bool dma) {
+    if (huart->RxState != HAL_UART_STATE_READY)
+        return HAL_BUSY;
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxXferCount = 0;
+    huart->fakeRxDma = dma;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    HAL_StatusTypeDef status = uartStartRx(huart, pData, Size, false);
+    if (status != HAL_OK)
+        return status;
+    for (uint32_t t = 0; huart->RxState == HAL_UART_STATE_BUSY_RX; t++) {
+        if (t >= Timeout) {
+            huart->RxState = HAL_UART_STATE_READY;
+            return HAL_TIMEOUT;
+        }
+        fakeHalAdvance(1000U);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+    return uartStartRx(huart, pData, Size, true);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    return HAL_UART_Transmit_DMA(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+    return uartStartRx(huart, pData, Size, true);
+}
+
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef* huart) {
+    return (HAL_UART_StateTypeDef)(huart->gState | huart->RxState);
+}
+
+void fakeUartFeed(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len) {
+    for (uint16_t i = 0; i < len && huart->RxState == HAL_UART_STATE_BUSY_RX; i++) {
+        huart->pRxBuffPtr[huart->RxXferCount++] = data[i];
+        if (huart->RxXferCount >= huart->RxXferSize) {
+            huart->RxState = HAL_UART_STATE_READY;
+            if (huart->fakeRxDma)
+                HAL_UART_RxCpltCallback(huart);
+        }
+    }
+}
+
+/* CRC */
+
+static uint8_t crcWidth(CRC_HandleTypeDef* hcrc) {
+    switch (hcrc->Init.CRCLength) {
+        case CRC_POLYLENGTH_16B:
+            return 16;
+        case CRC_POLYLENGTH_8B:
+            return 8;
+        case CRC_POLYLENGTH_7B:
+            return 7;
+        default:
+            return 32;
+    }
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef* hcrc) {
+    if (hcrc->State == HAL_CRC_STATE_RESET)
+        HAL_CRC_MspInit(hcrc);
+    hcrc->Instance->POL = (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) ? 0x04C11DB7U : hcrc->Init.GeneratingPolynomial;
+    hcrc->Instance->CR = (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) ? CRC_POLYLENGTH_32B : hcrc->Init.CRCLength;
+    hcrc->Instance->INIT = (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE) ? 0xFFFFFFFFU : hcrc->Init.InitValue;
+    hcrc->Instance->DR = hcrc->Instance->INIT;
+    hcrc->State = HAL_CRC_STATE_READY;
+    return HAL_OK;
+}
+
+// MSB first, no reflection (the only configuration the firmware uses)
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef* hcrc, uint32_t pBuffer[], uint32_t BufferLength) {
+    CRC_TypeDef* c = hcrc->Instance;
+    uint8_t width = (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) ? 32 : crcWidth(hcrc);
+    uint32_t mask = (width == 32) ? 0xFFFFFFFFU : ((1U << width) - 1U);
+    uint32_t crc = c->DR & mask;
+
+    uint8_t bits = 8;
+    if (hcrc->InputDataFormat == CRC_INPUTDATA_FORMAT_HALFWORDS)
+        bits = 16;
+    else if (hcrc->InputDataFormat == CRC_INPUTDATA_FORMAT_WORDS)
+        bits = 32;
+
+    for (uint32_t i = 0; i < BufferLength; i++) {
+        uint32_t word;
+        if (bits == 8)
+            word = ((const uint8_t*)pBuffer)[i];
+        else if (bits == 16)
+            word = ((const uint16_t*)pBuffer)[i];
+        else
+            word = pBuffer[i];
+        for (int8_t b = (int8_t)(bits - 1); b >= 0; b--) {
+            uint32_t in = (word >> b) & 1U;
+            uint32_t top = (crc >> (width - 1)) & 1U;
+            crc = (crc << 1) & mask;
+            if (top ^ in)
+                crc ^= c->POL & mask;
+        }
+    }
+    c->DR = crc;
+    return crc;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef* hcrc, uint32_t pBuffer[], uint32_t BufferLength) {
+    hcrc->Instance->DR = hcrc->Instance->INIT;
+    return HAL_CRC_Accumulate(hcrc, pBuffer, BufferLength);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file hd44780_model.c
+ * @brief Timed HD44780 + PCF8574 model implementation. See hd44780_model.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The fake HAL hands the model whole transfers at their end, fakeI2CByteTime tells when each byte changed the expander's outputs. A falling edge of EN latches a nibble at that time, with the RS and data lines of the state before the edge. The second nibble of a 4-bit transfer (or the only one in 8-bit mode) executes the instruction and keeps the controller busy for its execution time. A write with any of its nibbles latched while busy is dropped, which is roughly what the real controller does with it: the datasheet leaves it undefined, in practice characters go missing.
+ *
+ * Reading works like on the real module. The expander's pins are quasi-bidirectional, a pin written high is only a weak pull-up that the controller can pull down, so a read returns the output latch ANDed with whatever the controller drives. It drives D7..D4 while R/W and EN are high: the busy flag and the upper address bits for the first nibble, the lower address bits for the second one. The busy flag is evaluated when the expander samples its inputs. A falling edge of EN with R/W high ends a read nibble, so reads take part in the nibble pairing of the 4-bit interface.
+ */
+
+#include "hd44780_model.h"
+#include "fake_hal.h"
+#include "string.h"
+
+#define PORT_RS     0x01
+#define PORT_RW     0x02
+#define PORT_EN     0x04
+
+static FakeI2CDevice_t device;
+static uint8_t port = 0;                // expander's output latch
+static bool eightBit = true;
+static bool highNibble = true;          // the next nibble transferred is the high one
+static uint8_t nibble = 0;
+static bool nibbleIgnored = false;      // the high nibble was latched while busy
+static uint8_t addressCounter = 0;
+static uint64_t busyUntil = 0;
+static char ddram[HD44780_DDRAM_SIZE];
+static HD44780Stats_t modelStats;
+
+static void execute(bool rs, uint8_t value, uint64_t time) {
+    uint32_t execUs = HD44780_EXEC_US;
+    if (rs) {
+        ddram[addressCounter] = (char)value;
+        addressCounter = (addressCounter + 1) & (HD44780_DDRAM_SIZE - 1);
+    } else if (value & 0x80) {
+        addressCounter = value & 0x7F;
+    } else if (value & 0x20) {
+        eightBit = (value & 0x10) != 0;
+    } else if (value & 0x02) {
+        addressCounter = 0;
+        execUs = HD44780_EXEC_CLEAR_US;
+    } else if (value == 0x01) {
+        memset(ddram, ' ', sizeof(ddram));
+        addressCounter = 0;
+        execUs = HD44780_EXEC_CLEAR_US;
+    }
+    modelStats.executed++;
+    busyUntil = time + execUs;
+}
+
+// state: the port before the edge
+static void fallingEdge(uint8_t state, uint64_t time) {
+    if (state & PORT_RW) {  // end of a read nibble
+        if (!eightBit)
+            highNibble = !highNibble;
+        return;
+    }
+
+    bool busy = time < busyUntil;
+    bool rs = (state & PORT_RS) != 0;
+    uint8_t bits = state >> 4;
+    if (eightBit) {
+        // only D7..D4 are wired, the low data bits read as 0
+        if (busy)
+            modelStats.ignored++;
+        else
+            execute(rs, (uint8_t)(bits << 4), time);
+        highNibble = true;
+    } else if (highNibble) {
+        nibble = bits;
+        nibbleIgnored = busy;
+        highNibble = false;
+    } else {
+        highNibble = true;
+        if (busy || nibbleIgnored)
+            modelStats.ignored++;
+        else
+            execute(rs, (uint8_t)((nibble << 4) | bits), time);
+    }
+}
+
+static bool modelWrite(const uint8_t* data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        if ((port & PORT_EN) && !(data[i] & PORT_EN))
+            fallingEdge(port, fakeI2CByteTime(i));
+        port = data[i];
+    }
+    return true;
+}
+
+static bool modelRead(uint8_t* data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t pins = port;
+        if ((port & PORT_RW) && (port & PORT_EN)) {
+            uint64_t time = fakeI2CByteTime(i);
+            bool busy = time < busyUntil;
+            uint8_t value = (uint8_t)((busy ? 0x80 : 0) | addressCounter);
+            bool first = eightBit || highNibble;
+            uint8_t driven = first ? (value >> 4) : (value & 0x0F);
+            pins &= (uint8_t)((driven << 4) | 0x0F);
+            if (first) {
+                modelStats.flagReads++;
+                if (busy)
+                    modelStats.busyReads++;
+            }
+        }
+        data[i] = pins;
+    }
+    return true;
+}
+
+/* API functions */
+
+bool hd44780ModelAttach(uint8_t address) {
+    device.address = address;
+    device.write = modelWrite;
+    device.read = modelRead;
+    hd44780ModelReset();
+    return fakeI2CAttach(&device);
+}
+
+void hd44780ModelReset(void) {
+    port = 0;
+    eightBit = true;
+    highNibble = true;
+    nibble = 0;
+    nibbleIgnored = false;
+    addressCounter = 0;
+    busyUntil = 0;
+    memset(ddram, ' ', sizeof(ddram));
+    memset(&modelStats, 0, sizeof(modelStats));
+}
+
+const char* hd44780ModelDdram(void) {
+    return ddram;
+}
+
+void hd44780ModelGetStats(HD44780Stats_t* stats) {
+    *stats = modelStats;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file host_board.c
+ * @brief Simulated devices of the prototype board for the host build.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Attaches the devices main.c talks to: the HD44780 LCD behind its PCF8574 expander, the MCP9600 and MLX90614 on I2C, and the MAX31855/MAX31856 on SPI. The sensors read a fixed room temperature. The LCD is the timed model of hd44780_model.h. Its DDRAM contents are printed to stderr when the program exits, with the number of writes it ignored for arriving while it was busy, if any.
+ *
+ * OVEN_HOST_COMMANDS scripts the user: its characters are sent to USART2 one per second, starting at 1 s, with '!' pressing the button instead.
+ */
+
+#include "fake_hal.h"
+#include "hd44780_model.h"
+#include "main.h"
+#include "usart.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#define ROOM_TEMPERATURE_C          25
+
+/* HD44780 behind a PCF8574 */
+
+#define LCD_ADDRESS                 0x27
+
+static void lcdPrint(void) {
+    static const uint8_t rowStart[2] = { 0x00, 0x40 };
+    const char* ddram = hd44780ModelDdram();
+    for (uint8_t r = 0; r < 2; r++)
+        fprintf(stderr, "LCD %u: |%.16s|\n", r, &ddram[rowStart[r]]);
+    HD44780Stats_t stats;
+    hd44780ModelGetStats(&stats);
+    if (stats.ignored > 0)
+        fprintf(stderr, "LCD: %lu writes ignored, the controller was busy\n", (unsigned long)stats.ignored);
+}
+
+/* MCP9600 */
+
+#define MCP9600_ADDRESS             0x60
+
+static uint8_t mcpPointer = 0;
+
+static bool mcpWrite(const uint8_t* data, uint16_t len) {
+    if (len > 0)
+        mcpPointer = data[0];
+    return true;
+}
+
+static bool mcpRead(uint8_t* data, uint16_t len) {
+    uint16_t word = 0;
+    switch (mcpPointer) {
+        case 0x00:  // hot junction
+        case 0x02:  // cold junction
+            word = (uint16_t)(ROOM_TEMPERATURE_C * 16);
+            break;
+        case 0x20:  // device ID, revision
+            word = 0x4011;
+            break;
+    }
+    for (uint16_t i = 0; i < len; i++)
+        data[i] = (i == 0) ? (uint8_t)(word >> 8) : (i == 1) ? (uint8_t)word : 0;
+    return true;
+}
+
+static const FakeI2CDevice_t mcpDevice = { MCP9600_ADDRESS, mcpWrite, mcpRead };
+
+/* MLX90614 */
+
+#define MLX90614_ADDRESS            0x5A
+
+static uint8_t mlxCommand = 0;
+
+static uint8_t crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static bool mlxWrite(const uint8_t* data, uint16_t len) {
+    if (len > 0)
+        mlxCommand = data[0];
+    return true;
+}
+
+static bool mlxRead(uint8_t* data, uint16_t len) {
+    uint16_t word = (uint16_t)((ROOM_TEMPERATURE_C * 100 + 27315) / 2);   // 0.02 K per LSB
+    uint8_t frame[5] = { MLX90614_ADDRESS << 1, mlxCommand, (MLX90614_ADDRESS << 1) | 1U, (uint8_t)word, (uint8_t)(word >> 8) };
+    uint8_t reply[3] = { frame[3], frame[4], crc8(frame, sizeof(frame)) };
+    for (uint16_t i = 0; i < len; i++)
+        data[i] = (i < sizeof(reply)) ? reply[i] : 0xFF;
+    return true;
+}
+
+static const FakeI2CDevice_t mlxDevice = { MLX90614_ADDRESS, mlxWrite, mlxRead };
+
+/* MAX31855 (TC1) and MAX31856 (TC2) */
+
+static void max31855Transfer(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+    (void)tx;
+    if (!rx)
+        return;
+    uint32_t frame = ((uint32_t)(ROOM_TEMPERATURE_C * 4) << 18) | ((uint32_t)(ROOM_TEMPERATURE_C * 16) << 4);
+    for (uint16_t i = 0; i < len; i++)
+        rx[i] = (i < 4) ? (uint8_t)(frame >> (24 - 8 * i)) : 0;
+}
+
+static void max31856Transfer(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+    if (!rx || len == 0 || (tx[0] & 0x80))     // register writes are ignored
+        return;
+    // registers from 0x0A: CJTH, CJTL (2^-6 degC in bits 15..2), LTCBH, LTCBM, LTCBL (2^-7 degC in bits 23..5), SR
+    uint16_t cj = (uint16_t)(ROOM_TEMPERATURE_C * 64) << 2;
+    uint32_t tc = (uint32_t)(ROOM_TEMPERATURE_C * 128) << 5;
+    uint8_t regs[16] = { 0 };
+    regs[0x0A] = (uint8_t)(cj >> 8);
+    regs[0x0B] = (uint8_t)cj;
+    regs[0x0C] = (uint8_t)(tc >> 16);
+    regs[0x0D] = (uint8_t)(tc >> 8);
+    regs[0x0E] = (uint8_t)tc;
+    rx[0] = 0;
+    for (uint16_t i = 1; i < len; i++)
+        rx[i] = regs[(tx[0] + i - 1) & 0x0F];
+}
+
+static const FakeSpiDevice_t tc1Device = { TC1_CS_GPIO_Port, TC1_CS_Pin, max31855Transfer };
+static const FakeSpiDevice_t tc2Device = { TC2_CS_GPIO_Port, TC2_CS_Pin, max31856Transfer };
+
+/* Scripted user input */
+
+#define COMMAND_INTERVAL_US         1000000U
+#define COMMAND_BUTTON              '!'
+
+static const char* commands = NULL;
+
+static void releaseButton(void* arg) {
+    (void)arg;
+    fakeGpioSetInput(BTN_GPIO_Port, BTN_Pin, GPIO_PIN_SET);
+}
+
+static void nextCommand(void* arg) {
+    (void)arg;
+    uint8_t c = (uint8_t)*commands++;
+    if (c == COMMAND_BUTTON) {
+        fakeGpioSetInput(BTN_GPIO_Port, BTN_Pin, GPIO_PIN_RESET);
+        fakeHalSchedule(100000U, releaseButton, NULL);
+    } else {
+        fakeUartFeed(&huart2, &c, 1);
+    }
+    if (*commands)
+        fakeHalSchedule(COMMAND_INTERVAL_US, nextCommand, NULL);
+}
+
+void hostBoardInit(void) {
+    atexit(lcdPrint);
+
+    hd44780ModelAttach(LCD_ADDRESS);
+    fakeI2CAttach(&mcpDevice);
+    fakeI2CAttach(&mlxDevice);
+    fakeSpiAttach(&tc1Device);
+    fakeSpiAttach(&tc2Device);
+
+    commands = getenv("OVEN_HOST_COMMANDS");
+    if (commands && *commands)
+        fakeHalSchedule(COMMAND_INTERVAL_US, nextCommand, NULL);
+}
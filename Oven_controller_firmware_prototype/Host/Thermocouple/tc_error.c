@@ -0,0 +1,141 @@
+/**
+ * @file tc_error.c
+ * @brief Measures the thermocouple conversion's worst error against the NIST ITS-90 type K reference function, with and without cold-junction compensation.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The reference is the NIST forward polynomial E(T) in double, inverted by bisection. It is kept here on its own rather than taken from the generator, so a mistake in gen_type_k_table.py's coefficients shows up as an error here.
+ *
+ * Checks:
+ * - tcTypeKToCelsius at every microvolt of the table range, against the inverted reference (the library promises +-MAX_ERROR_C)
+ * - tcTypeKToMicrovolts over the cold-junction range every 1/64 degC, against E(T) (+-MAX_CJ_ERROR_UV)
+ * - tcConvert for hot junctions from 0 degC to the top of the range every HOT_STEP_C and cold junctions over the cold-junction range every CJ_STEP_C. The measured emf is E(hot) - E(cold) rounded to a microvolt, like an ideal front end would read it. The errors of both tables and both roundings add up here, the budget is MAX_CJC_ERROR_C.
+ *
+ * Usage: tc_error
+ * Exit code: 0 - every error within its budget, 1 - not
+ */
+
+#include "thermocouple.h"
+#include "type_k_table.h"
+#include "math.h"
+#include "stdbool.h"
+#include "stdio.h"
+
+#define T_MIN_C                 -200.0
+#define T_MAX_C                 1372.0
+#define CJ_MIN_C                TC_K_FWD_MIN
+#define CJ_MAX_C                (TC_K_FWD_MIN + ((TC_K_FWD_POINTS - 1) << TC_K_FWD_SHIFT))
+#define HOT_STEP_C              0.5
+#define CJ_STEP_C               0.25
+
+#define MAX_ERROR_C             0.1
+#define MAX_CJ_ERROR_UV         1.0     // 0.5 uV interpolation and the rounding of the breakpoints and the result
+#define MAX_CJC_ERROR_C         0.1     // the library promises +-0.1 degC end to end
+
+/* NIST ITS-90 type K reference function */
+
+static const double negative[] = {
+    0.0, 0.394501280250e-1, 0.236223735980e-4, -0.328589067840e-6, -0.499048287770e-8, -0.675090591730e-10,
+    -0.574103274280e-12, -0.310888728940e-14, -0.104516093650e-16, -0.198892668780e-19, -0.163226974860e-22,
+};
+static const double positive[] = {
+    -0.176004136860e-1, 0.389212049750e-1, 0.185587700320e-4, -0.994575928740e-7, 0.318409457190e-9,
+    -0.560728448890e-12, 0.560750590590e-15, -0.320207200030e-18, 0.971511471520e-22, -0.121047212750e-25,
+};
+static const double a0 = 0.118597600000e0, a1 = -0.118343200000e-3, a2 = 0.126968600000e3;
+
+// [uV]
+static double emf(double t) {
+    const double* c = (t < 0.0) ? negative : positive;
+    uint8_t n = (t < 0.0) ? sizeof(negative) / sizeof(negative[0]) : sizeof(positive) / sizeof(positive[0]);
+    double e = 0.0;
+    for (uint8_t i = n; i-- > 0;)
+        e = e * t + c[i];
+    if (t >= 0.0)
+        e += a0 * exp(a1 * (t - a2) * (t - a2));
+    return e * 1000.0;
+}
+
+static double temperature(double uv) {
+    double lo = T_MIN_C - 1.0, hi = T_MAX_C + 1.0;
+    for (uint8_t i = 0; i < 60; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (emf(mid) < uv)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+static double q16ToDouble(int32_t q16) {
+    return (double)q16 / TC_Q16_ONE;
+}
+
+/* Checks */
+
+int main(void) {
+    bool ok = true;
+    if (fabs(emf(500.0) - 20644.0) > 1.0) {
+        printf("reference function is off: E(500 degC) = %.1f uV\n", emf(500.0));
+        return 1;
+    }
+
+    double worst = 0.0, worstAt = 0.0;
+    uint32_t failures = 0;
+    for (int32_t uv = TC_K_UV_MIN; uv <= TC_K_UV_MAX; uv++) {
+        int32_t q16;
+        failures += (tcTypeKToCelsius(uv, &q16) != TC_OK);
+        double err = fabs(q16ToDouble(q16) - temperature(uv));
+        if (err > worst) {
+            worst = err;
+            worstAt = uv;
+        }
+    }
+    printf("tcTypeKToCelsius     %7d - %5d uV every 1 uV         worst %.4f degC at %.0f uV (budget %.2f)\n", TC_K_UV_MIN, TC_K_UV_MAX, worst, worstAt, MAX_ERROR_C);
+    ok &= worst <= MAX_ERROR_C && failures == 0;
+
+    double worstUv = 0.0;
+    worstAt = 0.0;
+    for (int32_t q16 = CJ_MIN_C * TC_Q16_ONE; q16 <= CJ_MAX_C * TC_Q16_ONE; q16 += TC_Q16_ONE / 64) {
+        int32_t uv;
+        failures += (tcTypeKToMicrovolts(q16, &uv) != TC_OK);
+        double err = fabs(uv - emf(q16ToDouble(q16)));
+        if (err > worstUv) {
+            worstUv = err;
+            worstAt = q16ToDouble(q16);
+        }
+    }
+    printf("tcTypeKToMicrovolts  %7d - %5d degC every 1/64 degC   worst %.2f uV at %.2f degC (budget %.2f)\n", CJ_MIN_C, CJ_MAX_C, worstUv, worstAt, MAX_CJ_ERROR_UV);
+    ok &= worstUv <= MAX_CJ_ERROR_UV && failures == 0;
+
+    worst = 0.0;
+    double worstHot = 0.0, worstCold = 0.0;
+    uint32_t cases = 0, outside = 0;
+    for (double cold = CJ_MIN_C; cold <= CJ_MAX_C; cold += CJ_STEP_C) {
+        double coldEmf = emf(cold);
+        int32_t coldQ16 = (int32_t)lround(cold * TC_Q16_ONE);
+        for (double hot = 0.0; hot <= T_MAX_C; hot += HOT_STEP_C) {
+            int32_t measured = (int32_t)lround(emf(hot) - coldEmf);
+            int32_t q16;
+            TCStatus_t status = tcConvert(measured, coldQ16, &q16);
+            if (status != TC_OK) {
+                outside++;      // at the top of the range the rounded emfs can add up to a microvolt past the table
+                continue;
+            }
+            cases++;
+            double err = fabs(q16ToDouble(q16) - hot);
+            if (err > worst) {
+                worst = err;
+                worstHot = hot;
+                worstCold = cold;
+            }
+        }
+    }
+    printf("tcConvert            hot 0 - %.0f degC, cold %d - %d degC   worst %.4f degC at %.1f / %.2f degC, %u cases, %u out of range (budget %.2f)\n", T_MAX_C, CJ_MIN_C, CJ_MAX_C,
+        worst, worstHot, worstCold, cases, outside, MAX_CJC_ERROR_C);
+    ok &= worst <= MAX_CJC_ERROR_C && outside <= (uint32_t)((CJ_MAX_C - CJ_MIN_C) / CJ_STEP_C) + 1;
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
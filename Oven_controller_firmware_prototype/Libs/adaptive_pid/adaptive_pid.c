@@ -0,0 +1,90 @@
+/**
+ * @file adaptive_pid.c
+ * @brief Self-tuning PID wrapper implementation. See adaptive_pid.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * SIMC rules (Skogestad) for a first-order model with dead time theta: kp = tau / (K * (tauC + theta)), Ti = min(tau, 4 * (tauC + theta)). The closed-loop time constant is never allowed below the dead time.
+ */
+
+#include "adaptive_pid.h"
+#include "math.h"
+
+#define DEFAULT_RETUNE_THRESHOLD    0.15f
+#define DEFAULT_MAX_UNCERTAINTY     1.0f
+#define AMBIENT_MIN                 -20.0f  // [degC] models outside of the plausible ambient range are poorly conditioned fits, not the oven
+#define AMBIENT_MAX                 80.0f
+
+static bool changedBy(float now, float ref, float threshold) {
+    return fabsf(now - ref) > threshold * fabsf(ref);
+}
+
+void adaptiveInit(AdaptivePID_t* ap, PIDController_t* pid, uint16_t decimation, float forgetting, uint8_t delay, float closedLoopTau) {
+    if (decimation == 0) decimation = 1;
+    ap->pid = pid;
+    ap->decimation = decimation;
+    ap->invDecimation = 1.0f / decimation;
+    ap->decCount = 0;
+    ap->dutySum = 0.0f;
+    ap->closedLoopTau = closedLoopTau;
+    ap->retuneThreshold = DEFAULT_RETUNE_THRESHOLD;
+    ap->maxUncertainty = DEFAULT_MAX_UNCERTAINTY;
+    ap->tunedValid = false;
+    ap->retunes = 0;
+
+    float rlsDt = pid->dt * decimation;
+    ap->deadTime = rlsDt * delay;
+    rlsInit(&ap->rls, rlsDt, forgetting, delay);
+}
+
+void adaptiveSetCriteria(AdaptivePID_t* ap, float threshold, float maxUncertainty) {
+    ap->retuneThreshold = threshold;
+    ap->maxUncertainty = maxUncertainty;
+}
+
+void adaptiveSetAmbient(AdaptivePID_t* ap, float ambient) {
+    rlsSetAmbient(&ap->rls, ambient);
+}
+
+PIDGains_t adaptiveTuneSIMC(const RLSModel_t* model, float deadTime, float closedLoopTau) {
+    float tauC = (closedLoopTau > deadTime) ? closedLoopTau : deadTime;
+    float ti = 4.0f * (tauC + deadTime);
+    if (model->tau < ti)
+        ti = model->tau;
+    PIDGains_t g;
+    g.kp = model->tau / (model->gain * (tauC + deadTime));
+    g.ki = g.kp / ti;
+    g.kd = 0.0f;
+    return g;
+}
+
+static void retuneIfNeeded(AdaptivePID_t* ap) {
+    RLSModel_t m;
+    if (!rlsGetModel(&ap->rls, &m) || rlsGetUncertainty(&ap->rls) > ap->maxUncertainty)
+        return;
+    if (m.ambient < AMBIENT_MIN || m.ambient > AMBIENT_MAX)
+        return;
+    if (ap->tunedValid && !changedBy(m.gain, ap->tuned.gain, ap->retuneThreshold) && !changedBy(m.tau, ap->tuned.tau, ap->retuneThreshold))
+        return;
+    pidSetGains(ap->pid, adaptiveTuneSIMC(&m, ap->deadTime, ap->closedLoopTau));
+    ap->tuned = m;
+    ap->tunedValid = true;
+    ap->retunes++;
+}
+
+float adaptiveStep(AdaptivePID_t* ap, float setpoint, float measurement) {
+    if (++ap->decCount >= ap->decimation) {
+        // the measurement is the response to the duty averaged over the last identifier period
+        rlsUpdate(&ap->rls, ap->dutySum * ap->invDecimation, measurement);
+        ap->decCount = 0;
+        ap->dutySum = 0.0f;
+        retuneIfNeeded(ap);
+    }
+    float out = pidStep(ap->pid, setpoint, measurement);
+    ap->dutySum += out;
+    return out;
+}
+
+uint16_t adaptiveGetRetuneCount(const AdaptivePID_t* ap) {
+    return ap->retunes;
+}
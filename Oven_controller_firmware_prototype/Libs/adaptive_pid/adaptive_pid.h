@@ -0,0 +1,92 @@
+/**
+ * @file adaptive_pid.h
+ * @brief Public API for the self-tuning PID wrapper. See adaptive_pid.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Wraps an existing PID controller and identifies the oven online (RLS, see rls_identifier.h) from its own output and the measured temperature, optionally with a known ambient (adaptiveSetAmbient)
+- Recomputes the gains with the SIMC rules whenever the identified gain or time constant drifts by more than a threshold from the model the current gains came from
+- Gain changes are bumpless (pidSetGains)
+- Allocation-free; the identifier runs at a decimated rate on the averaged duty
+
+# Limitations
+- Gains are only updated once the identifier is confident, so there's no adaptation while the oven just holds a setpoint without any excitation
+*/
+
+#ifndef ADAPTIVE_PID_H
+#define ADAPTIVE_PID_H
+
+#include "pid_controller.h"
+#include "rls_identifier.h"
+#include "stdint.h"
+#include "stdbool.h"
+
+typedef struct AdaptivePID_t {
+    PIDController_t* pid;
+    RLSIdentifier_t rls;
+    RLSModel_t tuned;           // model the current gains were computed from
+    bool tunedValid;
+    float closedLoopTau;        // [s]
+    float deadTime;             // [s]
+    float retuneThreshold;      // relative change of gain or tau that triggers retuning
+    float maxUncertainty;       // identifier covariance trace required for retuning
+    uint16_t decimation;
+    uint16_t decCount;
+    float invDecimation;
+    float dutySum;
+    uint16_t retunes;
+} AdaptivePID_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the wrapper. The PID has to be initialised beforehand, its gains are used until the first retune.
+ * @param ap pointer to the wrapper instance
+ * @param pid pointer to an initialised PID controller
+ * @param decimation number of PID steps per identifier sample (the identifier sample period should be around 1% - 10% of the oven's time constant)
+ * @param forgetting identifier forgetting factor
+ * @param delay dead time in identifier samples
+ * @param closedLoopTau desired closed-loop time constant [s] (SIMC tuning parameter, larger is more conservative)
+ */
+void adaptiveInit(AdaptivePID_t* ap, PIDController_t* pid, uint16_t decimation, float forgetting, uint8_t delay, float closedLoopTau);
+
+/**
+ * @brief Sets the retuning criteria
+ * @param ap pointer to the wrapper instance
+ * @param threshold relative model change that triggers retuning (e.g. 0.15)
+ * @param maxUncertainty identifier covariance trace below which the model is trusted
+ */
+void adaptiveSetCriteria(AdaptivePID_t* ap, float threshold, float maxUncertainty);
+
+/**
+ * @brief Fixes the identifier's ambient temperature (see rlsSetAmbient)
+ * @param ap pointer to the wrapper instance
+ * @param ambient [degC]
+ */
+void adaptiveSetAmbient(AdaptivePID_t* ap, float ambient);
+
+/**
+ * @brief Runs the identifier (every decimation-th call), retunes if needed, then runs the PID
+ * @param ap pointer to the wrapper instance
+ * @param setpoint [degC]
+ * @param measurement [degC]
+ * @return PID output
+ */
+float adaptiveStep(AdaptivePID_t* ap, float setpoint, float measurement);
+
+/**
+ * @brief Computes PI gains for a first-order-plus-dead-time model with the SIMC rules
+ * @param model identified model
+ * @param deadTime [s]
+ * @param closedLoopTau desired closed-loop time constant [s]
+ * @return gains (kd = 0)
+ */
+PIDGains_t adaptiveTuneSIMC(const RLSModel_t* model, float deadTime, float closedLoopTau);
+
+/**
+ * @brief Returns how many times the gains were recomputed
+ */
+uint16_t adaptiveGetRetuneCount(const AdaptivePID_t* ap);
+
+#endif
@@ -0,0 +1,323 @@
+/**
+ * @file bake_log.c
+ * @brief Bake log recorder, encoder and decoder implementation. See bake_log.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Log layout: a header ("OVLG", version, control period in ms as little-endian uint16) followed by one record per tick:
+ *
+ * mark | time | sample mask | (age, value) per sample | event count | events | phase | top duty | bottom duty | CRC-8
+ *
+ * The mark tells key records from delta records. Times, ages and duties are unsigned LEB128 varints. Values are zigzag varints of the difference from the sensor's previous value, which is reset to 0 by key records (so their values, like their time, are absolute). The CRC (polynomial 0x07) covers the record from the mark on.
+ *
+ * The recorder encodes each record into a scratch buffer against a copy of the encoder state and only commits both when the record fits in the ring buffer, so a dropped record doesn't break the deltas of the following ones. The ring is sent with interrupt-driven UART transfers, one contiguous part at a time, each completion starting the next.
+ */
+
+#include "bake_log.h"
+#include "string.h"
+
+#define MARK_DELTA      (uint8_t)0xD5
+#define MARK_KEY        (uint8_t)0xDA
+
+static const uint8_t headerMagic[4] = { 'O', 'V', 'L', 'G' };
+
+/* ENCODING */
+
+static uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+size_t bakeLogEncode(BakeLogCodec_t* codec, const BakeLogTick_t* tick, bool key, uint8_t* out) {
+    size_t n = 0;
+    if (key) {
+        memset(codec->sample, 0, sizeof(codec->sample));
+        codec->sinceKey = 0;
+        out[n++] = MARK_KEY;
+        n += putVarint(&out[n], tick->time);
+    } else {
+        codec->sinceKey++;
+        out[n++] = MARK_DELTA;
+        n += putVarint(&out[n], tick->time - codec->time);
+    }
+    codec->time = tick->time;
+
+    out[n++] = tick->sampleMask;
+    for (uint8_t i = 0; i < BLOG_SENSORS; i++) {
+        if (!(tick->sampleMask & (1U << i)))
+            continue;
+        n += putVarint(&out[n], tick->sampleAge[i]);
+        n += putVarint(&out[n], zigzag((int32_t)((uint32_t)tick->sample[i] - (uint32_t)codec->sample[i])));
+        codec->sample[i] = tick->sample[i];
+    }
+
+    uint8_t events = (tick->eventCount > BLOG_MAX_EVENTS) ? BLOG_MAX_EVENTS : tick->eventCount;
+    out[n++] = events;
+    for (uint8_t i = 0; i < events; i++)
+        out[n++] = tick->event[i];
+
+    out[n++] = tick->phase;
+    n += putVarint(&out[n], tick->duty[HEATER_TOP]);
+    n += putVarint(&out[n], tick->duty[HEATER_BOTTOM]);
+    out[n] = crc8(out, n);
+    return n + 1;
+}
+
+/* DECODING */
+
+typedef struct Cursor_t {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;            // false once a read ran past the end
+} Cursor_t;
+
+static uint8_t getByte(Cursor_t* c) {
+    if (c->pos >= c->size) {
+        c->ok = false;
+        return 0;
+    }
+    return c->data[c->pos++];
+}
+
+static uint32_t getVarint(Cursor_t* c) {
+    uint32_t v = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        uint8_t b = getByte(c);
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+    c->ok = false;      // too long, not a varint
+    return v;
+}
+
+typedef enum Decode_t {
+    DECODE_OK,
+    DECODE_TRUNCATED,
+    DECODE_INVALID,
+} Decode_t;
+
+static Decode_t decodeRecord(const uint8_t* data, size_t size, BakeLogCodec_t* codec, BakeLogTick_t* tick, size_t* len) {
+    Cursor_t c = { data, size, 0, true };
+    uint8_t mark = getByte(&c);
+    if (mark != MARK_KEY && mark != MARK_DELTA)
+        return c.ok ? DECODE_INVALID : DECODE_TRUNCATED;
+
+    BakeLogCodec_t next = *codec;
+    if (mark == MARK_KEY) {
+        memset(next.sample, 0, sizeof(next.sample));
+        next.sinceKey = 0;
+        next.time = getVarint(&c);
+    } else {
+        next.sinceKey++;
+        next.time += getVarint(&c);
+    }
+    tick->time = next.time;
+
+    tick->sampleMask = getByte(&c);
+    if (tick->sampleMask >> BLOG_SENSORS)
+        return c.ok ? DECODE_INVALID : DECODE_TRUNCATED;
+    for (uint8_t i = 0; i < BLOG_SENSORS; i++) {
+        if (!(tick->sampleMask & (1U << i)))
+            continue;
+        tick->sampleAge[i] = getVarint(&c);
+        next.sample[i] = (int32_t)((uint32_t)next.sample[i] + (uint32_t)unzigzag(getVarint(&c)));
+        tick->sample[i] = next.sample[i];
+    }
+
+    tick->eventCount = getByte(&c);
+    if (tick->eventCount > BLOG_MAX_EVENTS)
+        return c.ok ? DECODE_INVALID : DECODE_TRUNCATED;
+    for (uint8_t i = 0; i < tick->eventCount; i++)
+        tick->event[i] = getByte(&c);
+
+    tick->phase = getByte(&c);
+    tick->duty[HEATER_TOP] = (uint16_t)getVarint(&c);
+    tick->duty[HEATER_BOTTOM] = (uint16_t)getVarint(&c);
+    size_t crcPos = c.pos;
+    uint8_t crc = getByte(&c);
+    if (!c.ok)
+        return DECODE_TRUNCATED;
+    if (crc != crc8(data, crcPos))
+        return DECODE_INVALID;
+
+    *codec = next;
+    *len = c.pos;
+    return DECODE_OK;
+}
+
+bool bakeLogReaderInit(BakeLogReader_t* r, const uint8_t* data, size_t size) {
+    memset(r, 0, sizeof(*r));
+    if (size < BLOG_HEADER_LEN || memcmp(data, headerMagic, sizeof(headerMagic)) != 0 || data[4] != BLOG_VERSION)
+        return false;
+    r->data = data;
+    r->size = size;
+    r->pos = BLOG_HEADER_LEN;
+    r->controlPeriod = (uint16_t)(data[5] | (data[6] << 8));
+    return true;
+}
+
+BakeLogReadStatus_t bakeLogRead(BakeLogReader_t* r, BakeLogTick_t* tick) {
+    bool skipped = false;
+    while (r->pos < r->size) {
+        const uint8_t* p = &r->data[r->pos];
+        size_t len = 0;
+        if (!r->synced && *p != MARK_KEY) {
+            r->pos++;
+            skipped = true;
+            continue;
+        }
+        switch (decodeRecord(p, r->size - r->pos, &r->codec, tick, &len)) {
+            case DECODE_OK:
+                r->pos += len;
+                r->synced = true;
+                return skipped ? BLOG_READ_RESYNC : BLOG_READ_OK;
+            case DECODE_TRUNCATED:
+                return BLOG_READ_END;
+            case DECODE_INVALID:
+                r->synced = false;
+                r->pos++;
+                skipped = true;
+                break;
+        }
+    }
+    return BLOG_READ_END;
+}
+
+/* SHARED CONTROL STEP */
+
+void bakeLogRunTick(OvenControl_t* oc, BakeLogTick_t* tick) {
+    for (uint8_t i = 0; i < tick->eventCount; i++)
+        ovenControlCommand(oc, (tick->event[i] == BLOG_EVENT_BUTTON) ? OVEN_CMD_TOGGLE : tick->event[i]);
+
+    float chamber = oc->chamber;
+    if (tick->sampleMask & (1U << BLOG_SENSOR_CHAMBER))
+        chamber = (float)tick->sample[BLOG_SENSOR_CHAMBER] * (1.0f / 65536.0f);
+
+    tick->phase = (uint8_t)ovenControlStep(oc, chamber);
+    tick->duty[HEATER_TOP] = oc->heater.duty[HEATER_TOP];
+    tick->duty[HEATER_BOTTOM] = oc->heater.duty[HEATER_BOTTOM];
+}
+
+/* RECORDING */
+
+static UART_HandleTypeDef* bloghuart;
+static uint8_t ring[BLOG_BUFFER_SIZE];
+static volatile uint16_t head = 0;          // written by the main loop
+static volatile uint16_t tail = 0;          // written by the completion interrupt
+static volatile uint16_t txLen = 0;         // length of the transfer in progress (0 = idle)
+static BakeLogCodec_t encoder;
+static bool forceKey = true;
+static uint32_t dropCount = 0;
+static volatile BakeLogStatus_t blogStatus = BLOG_OK;
+
+// call with interrupts disabled or from the completion interrupt
+static void startTransfer(void) {
+    if (txLen != 0 || head == tail)
+        return;
+    uint16_t end = (head > tail) ? head : BLOG_BUFFER_SIZE;
+    uint16_t len = end - tail;
+    if (HAL_UART_Transmit_IT(bloghuart, &ring[tail], len) != HAL_OK) {
+        blogStatus = BLOG_UART_ERROR;
+        return;
+    }
+    txLen = len;
+}
+
+static void kick(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    startTransfer();
+    __set_PRIMASK(primask);
+}
+
+static bool enqueue(const uint8_t* data, uint16_t len) {
+    uint16_t used = (uint16_t)((head + BLOG_BUFFER_SIZE - tail) % BLOG_BUFFER_SIZE);
+    if (len > BLOG_BUFFER_SIZE - 1 - used)
+        return false;
+    uint16_t h = head;
+    for (uint16_t i = 0; i < len; i++) {
+        ring[h] = data[i];
+        h = (h + 1) % BLOG_BUFFER_SIZE;
+    }
+    head = h;
+    return true;
+}
+
+/* API functions */
+
+void bakeLogInit(UART_HandleTypeDef* huart, uint16_t controlPeriod) {
+    bloghuart = huart;
+    head = tail = txLen = 0;
+    memset(&encoder, 0, sizeof(encoder));
+    forceKey = true;
+    dropCount = 0;
+    blogStatus = BLOG_OK;
+
+    uint8_t header[BLOG_HEADER_LEN] = { 0 };
+    memcpy(header, headerMagic, sizeof(headerMagic));
+    header[4] = BLOG_VERSION;
+    header[5] = (uint8_t)controlPeriod;
+    header[6] = (uint8_t)(controlPeriod >> 8);
+    enqueue(header, sizeof(header));
+    kick();
+}
+
+BakeLogStatus_t bakeLogRecord(const BakeLogTick_t* tick) {
+    uint8_t record[BLOG_MAX_RECORD_LEN];
+    BakeLogCodec_t next = encoder;
+    bool key = forceKey || encoder.sinceKey + 1 >= BLOG_KEY_INTERVAL;
+    uint16_t len = (uint16_t)bakeLogEncode(&next, tick, key, record);
+
+    if (!enqueue(record, len)) {
+        dropCount++;
+        forceKey = true;
+        return BLOG_DROPPED;
+    }
+    encoder = next;
+    forceKey = false;
+    if (blogStatus == BLOG_UART_ERROR)
+        blogStatus = BLOG_OK;   // retried below
+    kick();
+    return BLOG_OK;
+}
+
+void bakeLogTxCompleteHandler(void) {
+    tail = (uint16_t)((tail + txLen) % BLOG_BUFFER_SIZE);
+    txLen = 0;
+    startTransfer();
+}
+
+/* Status info */
+
+uint32_t bakeLogGetDropCount(void) {
+    return dropCount;
+}
+
+BakeLogStatus_t bakeLogGetStatus(void) {
+    return blogStatus;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file bake_log.h
+ * @brief Public API for recording the control loop's inputs and outputs and replaying them. See bake_log.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Everything that reaches the control loop goes through bakeLogRunTick: raw sensor samples, button presses and UART commands in, heater duties and program phase out. The firmware and the host replay call the same function, so a replay of the same log with the same control code gives bit-identical outputs.
+- One compact binary record per control tick: varint timestamps and sample ages, zigzag deltas of the raw Q16 samples, CRC-8 per record (typically around 20 bytes per tick)
+- Streamed out over UART with interrupt-driven transfers from a ring buffer, nothing blocks the main loop
+- A key record (absolute time and values) every BLOG_KEY_INTERVAL ticks and after every dropped record, so a reader can start mid-stream and resynchronise after errors
+- Decoder for the host side
+
+# Limitations
+- Records that don't fit in the ring buffer are dropped (counted, and the next record is a key record)
+- Bit-exact replay needs the control code compiled without floating-point contraction on both sides (see the CMakeLists.txt), since the Cortex-M4 FPU has fused multiply-adds and the host build doesn't use them
+
+# Requirements:
+- Route the UART transmit complete callback to the log:
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    if (huart == &huart2)
+        bakeLogTxCompleteHandler();
+}
+
+- The UART's global interrupt has to be enabled
+*/
+
+#ifndef BAKE_LOG_H
+#define BAKE_LOG_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "oven_control.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#define BLOG_VERSION            (uint8_t)1
+#define BLOG_MAX_EVENTS         8
+#define BLOG_EVENT_BUTTON       (uint8_t)0xFF   // every other event value is a UART command byte
+#define BLOG_KEY_INTERVAL       60              // ticks between key records
+#define BLOG_BUFFER_SIZE        1024            // transmit ring buffer [B]
+#define BLOG_HEADER_LEN         7
+#define BLOG_MAX_RECORD_LEN     (1 + 5 + 1 + BLOG_SENSORS * (5 + 5) + 1 + BLOG_MAX_EVENTS + 1 + 3 + 3 + 1)
+
+typedef enum BakeLogSensor_t {
+    BLOG_SENSOR_CHAMBER,        // the controlled temperature
+    BLOG_SENSOR_TOP,
+    BLOG_SENSOR_BOTTOM,
+    BLOG_SENSOR_STONE,
+    BLOG_SENSORS,
+} BakeLogSensor_t;
+
+typedef struct BakeLogTick_t {
+    uint32_t time;                              // [ms]
+    uint8_t sampleMask;                         // sensors with a new sample in this tick (1 << BakeLogSensor_t)
+    int32_t sample[BLOG_SENSORS];               // raw readings [degC, Q16]
+    uint32_t sampleAge[BLOG_SENSORS];           // time from the reading to the tick [ms]
+    uint8_t eventCount;
+    uint8_t event[BLOG_MAX_EVENTS];             // in arrival order
+    uint8_t phase;                              // output: ProfilePhase_t after the tick
+    uint16_t duty[HEATER_OUT_CHANNELS];         // output: heater duties (Q15)
+} BakeLogTick_t;
+
+typedef struct BakeLogCodec_t {
+    uint32_t time;                              // time of the previous record [ms]
+    int32_t sample[BLOG_SENSORS];               // base of the sample deltas
+    uint32_t sinceKey;                          // records since the latest key record
+} BakeLogCodec_t;
+
+typedef struct BakeLogReader_t {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint16_t controlPeriod;                     // from the header [ms]
+    bool synced;                                // a key record has been read since the start or the latest error
+    BakeLogCodec_t codec;
+} BakeLogReader_t;
+
+/* Status info */
+
+typedef enum BakeLogStatus_t {
+    BLOG_OK,
+    BLOG_DROPPED,               // The ring buffer was full, the record was dropped.
+    BLOG_UART_ERROR,            // The UART refused a transfer, the pending data will be retried with the next record.
+} BakeLogStatus_t;
+
+typedef enum BakeLogReadStatus_t {
+    BLOG_READ_OK,
+    BLOG_READ_END,
+    BLOG_READ_RESYNC,           // Damaged or unsynchronised data was skipped up to the next key record, the returned tick is valid.
+} BakeLogReadStatus_t;
+
+/* API functions */
+
+/**
+ * @brief Applies a tick's inputs to the loop and runs the control step, filling in the tick's outputs
+ * @note Called by the firmware when recording and by the replay, with the same inputs
+ * @param oc pointer to the loop instance
+ * @param tick tick with its inputs filled in
+ */
+void bakeLogRunTick(OvenControl_t* oc, BakeLogTick_t* tick);
+
+/**
+ * @brief Initialises the recorder and queues the log header
+ * @param huart pointer to HAL's UART handle struct
+ * @param controlPeriod control tick period [ms]
+ */
+void bakeLogInit(UART_HandleTypeDef* huart, uint16_t controlPeriod);
+
+/**
+ * @brief Encodes a tick and starts sending it
+ * @param tick tick after bakeLogRunTick
+ * @return BLOG_OK or BLOG_DROPPED
+ */
+BakeLogStatus_t bakeLogRecord(const BakeLogTick_t* tick);
+
+/**
+ * @brief Sends the next part of the ring buffer. Call from HAL_UART_TxCpltCallback.
+ */
+void bakeLogTxCompleteHandler(void);
+
+/**
+ * @brief Returns the number of dropped records
+ */
+uint32_t bakeLogGetDropCount(void);
+
+/**
+ * @brief Returns the recorder's status
+ */
+BakeLogStatus_t bakeLogGetStatus(void);
+
+/**
+ * @brief Encodes a tick
+ * @param codec encoder state, updated
+ * @param tick tick to encode
+ * @param key true to force a key record
+ * @param out output buffer, at least BLOG_MAX_RECORD_LEN bytes
+ * @return record length [B]
+ */
+size_t bakeLogEncode(BakeLogCodec_t* codec, const BakeLogTick_t* tick, bool key, uint8_t* out);
+
+/**
+ * @brief Checks the log header and prepares for reading the records
+ * @param r pointer to the reader instance
+ * @param data the whole log
+ * @param size [B]
+ * @return false if the header is missing or has a different version
+ */
+bool bakeLogReaderInit(BakeLogReader_t* r, const uint8_t* data, size_t size);
+
+/**
+ * @brief Decodes the next record
+ * @param r pointer to the reader instance
+ * @param tick decoded tick (inputs and recorded outputs)
+ * @return BLOG_READ_END when there are no more complete records
+ */
+BakeLogReadStatus_t bakeLogRead(BakeLogReader_t* r, BakeLogTick_t* tick);
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file bake_profile.c
+ * @brief Ramp/soak bake-profile engine implementation. See bake_profile.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Each segment is converted to tick units once, when it's entered: the ramp rate to a setpoint step per tick and the hold time to a tick count (both by multiplying with the tick period or its reciprocal from profileInit). A tick then only adds the step or increments the counter.
+ */
+
+#include "bake_profile.h"
+#include "ccmram.h"
+#include "stddef.h"
+#include "math.h"
+
+#define HOLD_FOREVER_TICKS  UINT32_MAX
+
+/* Example programs */
+
+static const ProfileSegment_t pizzaSegments[] = {
+    { .target = 450.0f, .rampRate = 0.0f,  .holdTime = 0.0f,                 .topShare = 0.5f },  // preheat at full power
+    { .target = 450.0f, .rampRate = 0.0f,  .holdTime = 20.0f * 60.0f,        .topShare = 0.3f },  // soak the stone
+    { .target = 430.0f, .rampRate = 0.0f,  .holdTime = 90.0f,                .topShare = 0.7f },  // bake, top heater for the cheese
+    { .target = 450.0f, .rampRate = 0.0f,  .holdTime = PROFILE_HOLD_FOREVER, .topShare = 0.4f },  // recover for the next pizza
+};
+
+static const ProfileSegment_t breadSegments[] = {
+    { .target = 250.0f, .rampRate = 0.0f,  .holdTime = 0.0f,                 .topShare = 0.5f },  // preheat
+    { .target = 250.0f, .rampRate = 0.0f,  .holdTime = 30.0f * 60.0f,        .topShare = 0.4f },  // soak the stone
+    { .target = 230.0f, .rampRate = 0.0f,  .holdTime = 15.0f * 60.0f,        .topShare = 0.2f },  // oven spring, top heater dropped
+    { .target = 200.0f, .rampRate = 0.05f, .holdTime = 20.0f * 60.0f,        .topShare = 0.4f },  // slow ramp down, finish the crust
+    { .target = 60.0f,  .rampRate = 0.0f,  .holdTime = PROFILE_HOLD_FOREVER, .topShare = 0.5f },  // keep warm
+};
+
+const BakeProgram_t profilePizza = BAKE_PROGRAM("Pizza", pizzaSegments, 10.0f);
+const BakeProgram_t profileBread = BAKE_PROGRAM("Bread", breadSegments, 5.0f);
+
+/* Static functions */
+
+static void startHold(ProfileEngine_t* pe) {
+    pe->ticks = 0;
+    pe->phase = (pe->program->soakBand > 0.0f) ? PROFILE_WAIT : PROFILE_HOLD;
+}
+
+static void enterSegment(ProfileEngine_t* pe, uint8_t index) {
+    const ProfileSegment_t* seg = &pe->program->segments[index];
+    pe->segment = index;
+    pe->holdTicks = (seg->holdTime < 0.0f) ? HOLD_FOREVER_TICKS : (uint32_t)(seg->holdTime * pe->invDt);
+
+    float step = seg->rampRate * pe->dt;
+    if (step <= 0.0f || pe->setpoint == seg->target) {
+        pe->setpoint = seg->target;
+        startHold(pe);
+        return;
+    }
+    pe->rampStep = (seg->target > pe->setpoint) ? step : -step;
+    pe->phase = PROFILE_RAMP;
+}
+
+/* API functions */
+
+void profileInit(ProfileEngine_t* pe, float dt) {
+    pe->program = NULL;
+    pe->dt = dt;
+    pe->invDt = 1.0f / dt;
+    pe->segment = 0;
+    pe->phase = PROFILE_IDLE;
+    pe->setpoint = 0.0f;
+    pe->rampStep = 0.0f;
+    pe->holdTicks = 0;
+    pe->ticks = 0;
+}
+
+void profileStart(ProfileEngine_t* pe, const BakeProgram_t* program, float currentTemp) {
+    pe->program = program;
+    pe->setpoint = currentTemp;
+    if (program->count == 0) {
+        pe->phase = PROFILE_DONE;
+        return;
+    }
+    enterSegment(pe, 0);
+}
+
+void profileStop(ProfileEngine_t* pe) {
+    pe->phase = PROFILE_IDLE;
+}
+
+CCMRAM_FUNC ProfilePhase_t profileTick(ProfileEngine_t* pe, float measurement, ProfileOutput_t* out) {
+    if (pe->phase == PROFILE_IDLE || pe->phase == PROFILE_DONE)
+        return pe->phase;
+
+    const ProfileSegment_t* seg = &pe->program->segments[pe->segment];
+    switch (pe->phase) {
+    case PROFILE_RAMP:
+        pe->setpoint += pe->rampStep;
+        if ((pe->rampStep > 0.0f) ? (pe->setpoint >= seg->target) : (pe->setpoint <= seg->target)) {
+            pe->setpoint = seg->target;
+            startHold(pe);
+        }
+        break;
+    case PROFILE_WAIT:
+        if (fabsf(measurement - seg->target) <= pe->program->soakBand)
+            pe->phase = PROFILE_HOLD;
+        break;
+    case PROFILE_HOLD:
+        if (pe->holdTicks != HOLD_FOREVER_TICKS && ++pe->ticks >= pe->holdTicks) {
+            if (pe->segment + 1 < pe->program->count) {
+                enterSegment(pe, pe->segment + 1);
+                seg = &pe->program->segments[pe->segment];
+            } else {
+                pe->phase = PROFILE_DONE;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    out->setpoint = pe->setpoint;
+    out->topShare = seg->topShare;
+    return pe->phase;
+}
+
+uint8_t profileGetSegment(const ProfileEngine_t* pe) {
+    return pe->segment;
+}
+
+ProfilePhase_t profileGetPhase(const ProfileEngine_t* pe) {
+    return pe->phase;
+}
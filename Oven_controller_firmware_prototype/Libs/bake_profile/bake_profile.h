@@ -0,0 +1,119 @@
+/**
+ * @file bake_profile.h
+ * @brief Public API for the ramp/soak bake-profile engine. See bake_profile.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- A program is a const table of segments (kept in flash): target temperature, ramp rate, hold time and the top heater's share of the power
+- Evaluated incrementally in every control tick in O(1), no floating-point divisions per tick
+- Optional guaranteed soak: the hold timer starts only once the measured temperature is within a band around the target
+- Example programs for pizza and bread
+
+# Limitations
+- Ramps are linear in time, the setpoint may run ahead of the oven if the ramp rate is higher than the oven can follow
+- Hold times are rounded down to whole ticks
+*/
+
+#ifndef BAKE_PROFILE_H
+#define BAKE_PROFILE_H
+
+#include "stdint.h"
+
+#define PROFILE_HOLD_FOREVER    (-1.0f)     // hold time of a segment that never ends (keep warm)
+
+typedef struct ProfileSegment_t {
+    float target;           // [degC]
+    float rampRate;         // [degC/s] (0 = jump to the target)
+    float holdTime;         // [s] (PROFILE_HOLD_FOREVER = until stopped)
+    float topShare;         // top heater's share of the total power (0.0 - 1.0)
+} ProfileSegment_t;
+
+typedef struct BakeProgram_t {
+    const char* name;
+    const ProfileSegment_t* segments;
+    uint8_t count;
+    float soakBand;         // the hold timer starts when the measurement is within +-soakBand of the target [degC] (0 = right after the ramp)
+} BakeProgram_t;
+
+typedef enum ProfilePhase_t {
+    PROFILE_IDLE,
+    PROFILE_RAMP,           // setpoint moving towards the segment target
+    PROFILE_WAIT,           // setpoint at the target, waiting for the oven to get within the soak band
+    PROFILE_HOLD,           // hold timer running
+    PROFILE_DONE,
+} ProfilePhase_t;
+
+typedef struct ProfileOutput_t {
+    float setpoint;         // [degC]
+    float topShare;         // (0.0 - 1.0)
+} ProfileOutput_t;
+
+typedef struct ProfileEngine_t {
+    const BakeProgram_t* program;
+    float dt;               // tick period [s]
+    float invDt;
+    uint8_t segment;
+    ProfilePhase_t phase;
+    float setpoint;         // [degC]
+    float rampStep;         // setpoint change per tick [degC]
+    uint32_t holdTicks;     // hold length of the current segment (UINT32_MAX = forever)
+    uint32_t ticks;         // ticks spent in the current hold
+} ProfileEngine_t;
+
+/**
+ * @brief Helper for defining a program from a segment array
+ */
+#define BAKE_PROGRAM(programName, segmentArray, band) { \
+    .name = (programName), \
+    .segments = (segmentArray), \
+    .count = (uint8_t)(sizeof(segmentArray) / sizeof((segmentArray)[0])), \
+    .soakBand = (band), \
+}
+
+extern const BakeProgram_t profilePizza;
+extern const BakeProgram_t profileBread;
+
+/* API functions */
+
+/**
+ * @brief Initialises the engine
+ * @param pe pointer to the engine instance
+ * @param dt tick period [s]
+ */
+void profileInit(ProfileEngine_t* pe, float dt);
+
+/**
+ * @brief Starts a program, the first ramp starts from the current temperature
+ * @param pe pointer to the engine instance
+ * @param program program to run
+ * @param currentTemp [degC]
+ */
+void profileStart(ProfileEngine_t* pe, const BakeProgram_t* program, float currentTemp);
+
+/**
+ * @brief Stops the running program
+ * @param pe pointer to the engine instance
+ */
+void profileStop(ProfileEngine_t* pe);
+
+/**
+ * @brief Advances the program by one tick
+ * @param pe pointer to the engine instance
+ * @param measurement controlled temperature [degC]
+ * @param out setpoint and heater share for this tick (unchanged when the engine is idle or done)
+ * @return phase after the tick
+ */
+ProfilePhase_t profileTick(ProfileEngine_t* pe, float measurement, ProfileOutput_t* out);
+
+/**
+ * @brief Returns the index of the current segment
+ */
+uint8_t profileGetSegment(const ProfileEngine_t* pe);
+
+/**
+ * @brief Returns the current phase
+ */
+ProfilePhase_t profileGetPhase(const ProfileEngine_t* pe);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file cascade_controller.c
+ * @brief Cascade controller implementation. See cascade_controller.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The outer PID calculates how far above the chamber setpoint the element has to be, rather than the absolute element temperature. The setpoint acts as a feedforward term, so the outer integral only has to hold the element-to-chamber difference at steady state and isn't left far behind after a preheat with a saturated output. When the element setpoint is clamped to maxElement, the outer PID is told the offset it actually got, so it doesn't wind up against the limit.
+ */
+
+#include "cascade_controller.h"
+#include "math.h"
+
+void cascadeInit(CascadeController_t* cc, const CascadeConfig_t* cfg, float ambient) {
+    pidInit(&cc->outer, cfg->outerGains, cfg->outerDt, 0.0f, cfg->maxElement);
+    cc->maxElement = cfg->maxElement;
+    pidInit(&cc->inner, cfg->innerGains, cfg->innerDt, 0.0f, cfg->maxDuty);
+    cc->elementSetpoint = ambient;
+    float divider = roundf(cfg->outerDt / cfg->innerDt);
+    cc->outerDivider = (divider >= 1.0f) ? (uint16_t)divider : 1;
+    cc->counter = 0;
+}
+
+float cascadeOuterStep(CascadeController_t* cc, float setpoint, float chamber) {
+    float offset = pidStep(&cc->outer, setpoint, chamber);
+    if (setpoint + offset > cc->maxElement) {
+        offset = cc->maxElement - setpoint;
+        pidTrackOutput(&cc->outer, (offset > 0.0f) ? offset : 0.0f);
+    }
+    cc->elementSetpoint = setpoint + offset;
+    return cc->elementSetpoint;
+}
+
+float cascadeInnerStep(CascadeController_t* cc, float element) {
+    return pidStep(&cc->inner, cc->elementSetpoint, element);
+}
+
+float cascadeStep(CascadeController_t* cc, float setpoint, float chamber, float element) {
+    if (cc->counter == 0)
+        cascadeOuterStep(cc, setpoint, chamber);
+    if (++cc->counter >= cc->outerDivider)
+        cc->counter = 0;
+    return cascadeInnerStep(cc, element);
+}
+
+void cascadeSetMaxElement(CascadeController_t* cc, float maxElement) {
+    cc->maxElement = maxElement;
+    // the offset can't exceed the limit either, as set in cascadeInit
+    cc->outer.outMax = maxElement;
+    if (cc->outer.integral > maxElement)
+        cc->outer.integral = maxElement;
+    if (cc->outer.output > maxElement)
+        cc->outer.output = maxElement;
+    if (cc->elementSetpoint > maxElement)
+        cc->elementSetpoint = maxElement;
+}
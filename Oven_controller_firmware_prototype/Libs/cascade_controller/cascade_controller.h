@@ -0,0 +1,85 @@
+/**
+ * @file cascade_controller.h
+ * @brief Public API for the cascade heating mode. See cascade_controller.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Fast inner loop regulating the heating element temperature, slow outer loop regulating the chamber (or stone) temperature
+- The outer loop output is the element setpoint (chamber setpoint plus a PID-controlled offset), clamped to a configurable maximum, which doubles as the element protection limit
+- Each loop has its own sample time. The loops can be stepped separately or together with cascadeStep, which runs the outer loop every n-th inner step.
+
+# Limitations
+- The outer sample time has to be a multiple of the inner one when cascadeStep is used
+- The element limit only holds as well as the inner loop tracks its setpoint, it's not a replacement for a hardware thermal cutoff
+*/
+
+#ifndef CASCADE_CONTROLLER_H
+#define CASCADE_CONTROLLER_H
+
+#include "pid_controller.h"
+#include "stdint.h"
+
+typedef struct CascadeConfig_t {
+    PIDGains_t outerGains;      // chamber temperature error -> element setpoint
+    PIDGains_t innerGains;      // element temperature error -> duty
+    float outerDt;              // [s]
+    float innerDt;              // [s]
+    float maxElement;           // element setpoint limit [degC]
+    float maxDuty;              // SSR duty limit (0.0 - 1.0)
+} CascadeConfig_t;
+
+typedef struct CascadeController_t {
+    PIDController_t outer;
+    PIDController_t inner;
+    float maxElement;           // [degC]
+    float elementSetpoint;      // [degC]
+    uint16_t outerDivider;      // inner steps per outer step
+    uint16_t counter;
+} CascadeController_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises both loops
+ * @param cc pointer to the controller instance
+ * @param cfg configuration
+ * @param ambient initial element setpoint [degC]
+ */
+void cascadeInit(CascadeController_t* cc, const CascadeConfig_t* cfg, float ambient);
+
+/**
+ * @brief Runs the outer loop, call every outerDt
+ * @param cc pointer to the controller instance
+ * @param setpoint chamber setpoint [degC]
+ * @param chamber chamber temperature [degC]
+ * @return new element setpoint [degC]
+ */
+float cascadeOuterStep(CascadeController_t* cc, float setpoint, float chamber);
+
+/**
+ * @brief Runs the inner loop, call every innerDt
+ * @param cc pointer to the controller instance
+ * @param element element temperature [degC]
+ * @return duty (0.0 - maxDuty)
+ */
+float cascadeInnerStep(CascadeController_t* cc, float element);
+
+/**
+ * @brief Runs the inner loop, and the outer loop before it every outerDt / innerDt calls. Call every innerDt.
+ * @param cc pointer to the controller instance
+ * @param setpoint chamber setpoint [degC]
+ * @param chamber chamber temperature [degC]
+ * @param element element temperature [degC]
+ * @return duty (0.0 - maxDuty)
+ */
+float cascadeStep(CascadeController_t* cc, float setpoint, float chamber, float element);
+
+/**
+ * @brief Changes the element setpoint limit
+ * @param cc pointer to the controller instance
+ * @param maxElement [degC]
+ */
+void cascadeSetMaxElement(CascadeController_t* cc, float maxElement);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file ccmram.h
+ * @brief Placement of hot code and data in the STM32F303's CCM RAM.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- CCM RAM (16 KB at 0x10000000) runs code with no wait states, while flash needs 2 at 72 MHz. It sits on its own bus, so code fetched from it doesn't compete with the DMA for the SRAM.
+- CCMRAM_FUNC places a function there, CCMRAM_DATA an initialised variable and CCMRAM_BSS a zero-initialised one. The startup code copies .ccmram from flash and zeroes .ccmbss before main().
+- Vendor and CubeMX-generated functions (the I2C/DMA interrupt handlers and the HAL functions they call) can't be annotated, they're placed by cmake/ccmram/ccmram_text.ld instead
+- A table of what landed in CCM is printed after each ARM build (cmake/ccmram_report.cmake)
+- Configuring with -DOVEN_CCMRAM=OFF keeps everything in flash and SRAM. Comparing the benchmark firmware (Bench/) of both builds gives the gain, e.g. with Bench/bench_compare.cmake.
+
+# Limitations
+- The DMA controllers can't reach CCM RAM. DMA buffers (e.g. the LCD driver's transmit buffer) must stay in SRAM.
+- A CCMRAM_BSS variable with an initialiser silently loses it, use CCMRAM_DATA for those
+- Calls between CCM and flash are out of the direct branch range, the linker adds a veneer (a few cycles) to each of them. Move callees along with their callers.
+- On the host build and with -DOVEN_CCMRAM=OFF the macros expand to nothing
+*/
+
+#ifndef CCMRAM_H
+#define CCMRAM_H
+
+#ifdef OVEN_CCMRAM   // set by the ccmram library for ARM builds with the OVEN_CCMRAM option on
+#define CCMRAM_FUNC     __attribute__((section(".ccmram.text")))
+#define CCMRAM_DATA     __attribute__((section(".ccmram.data")))
+#define CCMRAM_BSS      __attribute__((section(".ccmbss")))
+#else
+#define CCMRAM_FUNC
+#define CCMRAM_DATA
+#define CCMRAM_BSS
+#endif
+
+#endif /* CCMRAM_H */
@@ -0,0 +1,58 @@
+/**
+ * @file gain_scheduler.c
+ * @brief Gain scheduler implementation. See gain_scheduler.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The lookup follows arm_linear_interp_f32 from CMSIS-DSP, but multiplies by the stored reciprocal spacing instead of dividing, and takes the fraction straight from the scaled position instead of dividing by the breakpoint distance. The range check also covers the last segment correctly (the CMSIS version reads one entry past the table for inputs in it).
+ */
+
+#include "gain_scheduler.h"
+
+// PID gains from Host/GainSweep/gain_sweep on the simulated oven (SIMC rules for a 15 s closed loop on a first-order model identified at every breakpoint, the firmware's derivative time), to be tuned on the real one. Hotter elements radiate more into the stone, which lowers the oven's gain, but the time constant falls with it, so the gains stay nearly flat above 250 degC.
+static const PIDGains_t defaultGains[] = {
+    { .kp = 0.0561f, .ki = 0.000934f, .kd = 0.187f },  //  50 degC
+    { .kp = 0.0638f, .ki = 0.001063f, .kd = 0.213f },  // 100 degC
+    { .kp = 0.0709f, .ki = 0.001181f, .kd = 0.236f },  // 150 degC
+    { .kp = 0.0767f, .ki = 0.001279f, .kd = 0.256f },  // 200 degC
+    { .kp = 0.0820f, .ki = 0.001367f, .kd = 0.273f },  // 250 degC
+    { .kp = 0.0844f, .ki = 0.001406f, .kd = 0.281f },  // 300 degC
+    { .kp = 0.0860f, .ki = 0.001433f, .kd = 0.287f },  // 350 degC
+    { .kp = 0.0835f, .ki = 0.001392f, .kd = 0.278f },  // 400 degC
+    { .kp = 0.0855f, .ki = 0.001425f, .kd = 0.285f },  // 450 degC
+    { .kp = 0.0852f, .ki = 0.001420f, .kd = 0.284f },  // 500 degC
+};
+
+const GainTable_t gainDefaultTable = GAIN_TABLE(50.0f, 50.0f, defaultGains);
+
+PIDGains_t gainSchedLookup(const GainTable_t* table, float temp) {
+    float pos = (temp - table->x1) * table->invSpacing;
+    if (pos <= 0.0f)
+        return table->gains[0];
+    if (pos >= (float)(table->count - 1))
+        return table->gains[table->count - 1];
+
+    int32_t i = (int32_t)pos;
+    float f = pos - (float)i;
+    const PIDGains_t* g0 = &table->gains[i];
+    const PIDGains_t* g1 = &table->gains[i + 1];
+    PIDGains_t g = {
+        .kp = g0->kp + f * (g1->kp - g0->kp),
+        .ki = g0->ki + f * (g1->ki - g0->ki),
+        .kd = g0->kd + f * (g1->kd - g0->kd),
+    };
+    return g;
+}
+
+void gainSchedInit(GainScheduler_t* gs, PIDController_t* pid, const GainTable_t* table, GainSchedVariable_t variable, float initialTemp) {
+    gs->pid = pid;
+    gs->table = table;
+    gs->variable = variable;
+    pidSetGains(pid, gainSchedLookup(table, initialTemp));
+}
+
+float gainSchedStep(GainScheduler_t* gs, float setpoint, float measurement) {
+    float x = (gs->variable == GAIN_SCHED_ON_SETPOINT) ? setpoint : measurement;
+    pidSetGains(gs->pid, gainSchedLookup(gs->table, x));
+    return pidStep(gs->pid, setpoint, measurement);
+}
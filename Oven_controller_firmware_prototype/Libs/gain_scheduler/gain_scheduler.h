@@ -0,0 +1,82 @@
+/**
+ * @file gain_scheduler.h
+ * @brief Public API for the gain-scheduled PID heating mode. See gain_scheduler.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- PID gains interpolated from a const breakpoint table (kept in flash) in every control step
+- Uniformly spaced breakpoints with a precomputed reciprocal spacing, so the lookup is constant time and division-free
+- Bumpless gain changes (pidSetGains)
+- Scheduling on the setpoint or on the measured temperature
+
+# Limitations
+- Outside the table range the first or the last gain set is used
+*/
+
+#ifndef GAIN_SCHEDULER_H
+#define GAIN_SCHEDULER_H
+
+#include "pid_controller.h"
+#include "stdint.h"
+
+typedef enum GainSchedVariable_t {
+    GAIN_SCHED_ON_SETPOINT,     // gains follow the operating point the oven is heading to
+    GAIN_SCHED_ON_MEASUREMENT,  // gains follow the current operating point
+} GainSchedVariable_t;
+
+typedef struct GainTable_t {
+    float x1;                   // temperature of the first breakpoint [degC]
+    float invSpacing;           // 1 / breakpoint spacing [1/degC]
+    uint8_t count;              // number of breakpoints (at least 2)
+    const PIDGains_t* gains;
+} GainTable_t;
+
+typedef struct GainScheduler_t {
+    PIDController_t* pid;
+    const GainTable_t* table;
+    GainSchedVariable_t variable;
+} GainScheduler_t;
+
+/**
+ * @brief Helper for defining a table with a constant reciprocal spacing
+ */
+#define GAIN_TABLE(first, spacing, gainArray) { \
+    .x1 = (first), \
+    .invSpacing = 1.0f / (spacing), \
+    .count = (uint8_t)(sizeof(gainArray) / sizeof((gainArray)[0])), \
+    .gains = (gainArray), \
+}
+
+extern const GainTable_t gainDefaultTable;  // 50 - 500 degC in 50 degC steps
+
+/* API functions */
+
+/**
+ * @brief Initialises the scheduler and applies the gains for the initial temperature. The PID has to be initialised beforehand.
+ * @param gs pointer to the scheduler instance
+ * @param pid pointer to an initialised PID controller
+ * @param table breakpoint table
+ * @param variable scheduling variable
+ * @param initialTemp temperature to take the initial gains from [degC]
+ */
+void gainSchedInit(GainScheduler_t* gs, PIDController_t* pid, const GainTable_t* table, GainSchedVariable_t variable, float initialTemp);
+
+/**
+ * @brief Interpolates the gains for the current operating point, applies them and runs the PID
+ * @param gs pointer to the scheduler instance
+ * @param setpoint [degC]
+ * @param measurement [degC]
+ * @return PID output
+ */
+float gainSchedStep(GainScheduler_t* gs, float setpoint, float measurement);
+
+/**
+ * @brief Interpolates the gains from a table
+ * @param table breakpoint table
+ * @param temp [degC]
+ * @return interpolated gains
+ */
+PIDGains_t gainSchedLookup(const GainTable_t* table, float temp);
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file heater_output.c
+ * @brief Half-cycle SSR output modulator implementation. See heater_output.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * This file implements a joint first-order sigma-delta modulator for the top and bottom heater SSRs. Each channel accumulates its duty every half-cycle and is switched on once it is owed at least half of a half-cycle of energy; firing subtracts a whole half-cycle. A channel may only fire if that keeps its positive and negative half-cycle counts within one of each other. When both channels are due in the same half-cycle and their summed current would exceed the cap, the channel that is owed more energy goes first and the other one keeps its debt for the following half-cycles, so the average power of both channels is preserved while the peak current stays under the cap.
+ */
+
+#include "heater_output.h"
+#include "ccmram.h"
+
+#define FIRE_THRESHOLD  (int32_t)(HEATER_OUT_DUTY_ONE / 2)  // rounding quantiser: a channel is due once it's owed at least half of a half-cycle
+#define ACC_LIMIT       (int32_t)(4 * HEATER_OUT_DUTY_ONE)  // bounds the debt of a channel that can't be served (e.g. while the other one is saturated)
+
+/* Helpers */
+
+static uint16_t dutyToQ15(float d) {
+    if (d <= 0.0f) return 0;
+    if (d >= 1.0f) return HEATER_OUT_DUTY_ONE;
+    return (uint16_t)(d * (float)HEATER_OUT_DUTY_ONE + 0.5f);
+}
+
+static uint32_t ampsToMilliamps(float a) {
+    if (a <= 0.0f) return 0;
+    return (uint32_t)(a * 1000.0f + 0.5f);
+}
+
+/* API functions */
+
+HeaterOutStatus_t heaterOutInit(HeaterOutput_t* ho, float topCurrent, float bottomCurrent, float currentCap) {
+    ho->current[HEATER_TOP] = ampsToMilliamps(topCurrent);
+    ho->current[HEATER_BOTTOM] = ampsToMilliamps(bottomCurrent);
+    ho->currentCap = ampsToMilliamps(currentCap);
+    ho->positiveHalf = true;
+
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+        ho->duty[ch] = 0;
+        // stagger the channels so that equal duties interleave from the very first half-cycle, just below the threshold so a channel with no duty never fires
+        ho->acc[ch] = (int32_t)ch * (FIRE_THRESHOLD - 1);
+        ho->polarity[ch] = 0;
+    }
+
+    return heaterOutSetDuty(ho, 0.0f, 0.0f);
+}
+
+HeaterOutStatus_t heaterOutSetDuty(HeaterOutput_t* ho, float top, float bottom) {
+    return heaterOutSetDutyQ15(ho, dutyToQ15(top), dutyToQ15(bottom));
+}
+
+CCMRAM_FUNC HeaterOutStatus_t heaterOutSetDutyQ15(HeaterOutput_t* ho, uint16_t top, uint16_t bottom) {
+    uint16_t d[HEATER_OUT_CHANNELS];
+    d[HEATER_TOP] = (top < HEATER_OUT_DUTY_ONE) ? top : HEATER_OUT_DUTY_ONE;
+    d[HEATER_BOTTOM] = (bottom < HEATER_OUT_DUTY_ONE) ? bottom : HEATER_OUT_DUTY_ONE;
+    ho->status = HEATER_OUT_OK;
+
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+        if (ho->current[ch] > ho->currentCap) {
+            d[ch] = 0;
+            ho->status = HEATER_OUT_CAP_TOO_LOW;
+        }
+    }
+
+    // if both elements can't be on at the same time, the sum of the duties can't exceed one
+    uint32_t sum = (uint32_t)d[HEATER_TOP] + d[HEATER_BOTTOM];
+    if (ho->current[HEATER_TOP] + ho->current[HEATER_BOTTOM] > ho->currentCap && sum > HEATER_OUT_DUTY_ONE) {
+        d[HEATER_TOP] = (uint16_t)((uint32_t)d[HEATER_TOP] * HEATER_OUT_DUTY_ONE / sum);
+        d[HEATER_BOTTOM] = (uint16_t)(HEATER_OUT_DUTY_ONE - d[HEATER_TOP]);
+        if (ho->status == HEATER_OUT_OK)
+            ho->status = HEATER_OUT_DUTY_SCALED;
+    }
+
+    ho->duty[HEATER_TOP] = d[HEATER_TOP];
+    ho->duty[HEATER_BOTTOM] = d[HEATER_BOTTOM];
+    return ho->status;
+}
+
+CCMRAM_FUNC uint8_t heaterOutNextHalfCycle(HeaterOutput_t* ho) {
+    int8_t sign = ho->positiveHalf ? 1 : -1;
+    ho->positiveHalf = !ho->positiveHalf;
+
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+        ho->acc[ch] += ho->duty[ch];
+        if (ho->acc[ch] > ACC_LIMIT)
+            ho->acc[ch] = ACC_LIMIT;
+    }
+
+    // serve the channel that is owed more energy first
+    uint8_t order[HEATER_OUT_CHANNELS] = { HEATER_TOP, HEATER_BOTTOM };
+    if (ho->acc[HEATER_BOTTOM] > ho->acc[HEATER_TOP]) {
+        order[0] = HEATER_BOTTOM;
+        order[1] = HEATER_TOP;
+    }
+
+    uint32_t load = 0;
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < HEATER_OUT_CHANNELS; i++) {
+        uint8_t ch = order[i];
+        if (ho->acc[ch] < FIRE_THRESHOLD)
+            continue;
+        if (ho->polarity[ch] + sign > 1 || ho->polarity[ch] + sign < -1)   // firing would leave a DC component, wait for the opposite half-cycle
+            continue;
+        if (load + ho->current[ch] > ho->currentCap)
+            continue;
+        load += ho->current[ch];
+        ho->acc[ch] -= HEATER_OUT_DUTY_ONE;
+        ho->polarity[ch] += sign;
+        mask |= (uint8_t)(1 << ch);
+    }
+    return mask;
+}
+
+float heaterOutGetDuty(const HeaterOutput_t* ho, HeaterChannel_t ch) {
+    return (float)ho->duty[ch] / (float)HEATER_OUT_DUTY_ONE;
+}
+
+HeaterOutStatus_t heaterOutGetStatus(const HeaterOutput_t* ho) {
+    return ho->status;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file heater_output.h
+ * @brief Public API for the half-cycle SSR output modulator driving the top and bottom heaters. See heater_output.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Both heater channels are planned jointly, one mains half-cycle at a time
+- The summed current of the elements switched on in a half-cycle never exceeds a configurable cap
+- Each channel still gets its requested average power, as long as the request is feasible under the cap
+- Per-channel polarity balancing (no DC component on the mains)
+- Integer-only half-cycle step, cheap enough for a zero-cross interrupt
+
+# Limitations
+- Intended for zero-crossing SSRs (the output can only change on whole half-cycles)
+- If both requested duties can't be delivered under the cap, they are scaled down proportionally
+
+# Requirements:
+- Call heaterOutNextHalfCycle once per mains half-cycle (from a zero-cross interrupt or a 100 Hz timer) and drive the SSR pins according to the returned mask
+*/
+
+#ifndef HEATER_OUTPUT_H
+#define HEATER_OUTPUT_H
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#define HEATER_OUT_CHANNELS     2
+
+#define HEATER_OUT_DUTY_ONE     (uint16_t)32768 // duty of 1.0 in Q15
+
+typedef enum HeaterChannel_t {
+    HEATER_TOP,
+    HEATER_BOTTOM,
+} HeaterChannel_t;
+
+#define HEATER_TOP_BIT          (uint8_t)(1 << HEATER_TOP)
+#define HEATER_BOTTOM_BIT       (uint8_t)(1 << HEATER_BOTTOM)
+
+/* Status info */
+
+typedef enum HeaterOutStatus_t {
+    HEATER_OUT_OK,
+    HEATER_OUT_DUTY_SCALED,     // The requested duties can't be delivered without exceeding the current cap. Both were scaled down by the same factor.
+    HEATER_OUT_CAP_TOO_LOW,     // A single element draws more than the cap. That channel is kept off.
+} HeaterOutStatus_t;
+
+typedef struct HeaterOutput_t {
+    uint32_t current[HEATER_OUT_CHANNELS];          // element currents [mA]
+    uint32_t currentCap;                            // [mA]
+    volatile uint16_t duty[HEATER_OUT_CHANNELS];    // effective duties (Q15), written by the main loop, read by the half-cycle step
+    int32_t acc[HEATER_OUT_CHANNELS];               // error accumulators (Q15), positive when a channel is owed energy
+    int8_t polarity[HEATER_OUT_CHANNELS];           // balance of fired positive and negative half-cycles
+    bool positiveHalf;
+    HeaterOutStatus_t status;
+} HeaterOutput_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the modulator with both channels off
+ * @param ho pointer to the modulator instance
+ * @param topCurrent top element current [A RMS]
+ * @param bottomCurrent bottom element current [A RMS]
+ * @param currentCap maximum total current allowed in any half-cycle [A RMS]
+ * @return HEATER_OUT_CAP_TOO_LOW if any of the elements alone exceeds the cap
+ */
+HeaterOutStatus_t heaterOutInit(HeaterOutput_t* ho, float topCurrent, float bottomCurrent, float currentCap);
+
+/**
+ * @brief Sets the requested average power of both channels
+ * @note The duties are checked against the cap together, so always set both of them at once
+ * @param ho pointer to the modulator instance
+ * @param top top heater duty (0.0 - 1.0)
+ * @param bottom bottom heater duty (0.0 - 1.0)
+ */
+HeaterOutStatus_t heaterOutSetDuty(HeaterOutput_t* ho, float top, float bottom);
+
+/**
+ * @brief Same as heaterOutSetDuty, with the duties already in Q15
+ * @param ho pointer to the modulator instance
+ * @param top top heater duty (0 - HEATER_OUT_DUTY_ONE)
+ * @param bottom bottom heater duty (0 - HEATER_OUT_DUTY_ONE)
+ */
+HeaterOutStatus_t heaterOutSetDutyQ15(HeaterOutput_t* ho, uint16_t top, uint16_t bottom);
+
+/**
+ * @brief Plans the next mains half-cycle
+ * @note Call exactly once per half-cycle. Integer-only, safe to call from an interrupt.
+ * @param ho pointer to the modulator instance
+ * @return mask of the channels to switch on (HEATER_TOP_BIT, HEATER_BOTTOM_BIT)
+ */
+uint8_t heaterOutNextHalfCycle(HeaterOutput_t* ho);
+
+/**
+ * @brief Returns the effective duty of a channel, after scaling
+ * @param ho pointer to the modulator instance
+ * @param ch channel
+ * @return duty (0.0 - 1.0)
+ */
+float heaterOutGetDuty(const HeaterOutput_t* ho, HeaterChannel_t ch);
+
+/**
+ * @brief Returns the modulator's status from the latest heaterOutInit or heaterOutSetDuty call
+ * @return HeaterOutStatus_t
+ */
+HeaterOutStatus_t heaterOutGetStatus(const HeaterOutput_t* ho);
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file hysteresis_controller.c
+ * @brief Adaptive-band hysteresis controller implementation. See hysteresis_controller.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The heater switches off at setpoint + band/2 - overshootComp and on at setpoint - band/2 + undershootComp. When the heater switches off, the trough of the on phase updates undershootComp. When it switches on, the peak of the off phase updates overshootComp, and the length of the finished cycle updates the band: it grows when the cycle was shorter than minCyclePeriod and shrinks only when it was more than CYCLE_MARGIN longer, so the cycles settle at or just above the minimum rather than on both sides of it. All updates are proportional to the error, scaled by adaptGain. The compensations are limited together, so the off threshold always stays at least minBand above the on threshold.
+ */
+
+#include "hysteresis_controller.h"
+#include "math.h"
+
+#define CYCLE_MARGIN    0.01f   // of minCyclePeriod
+
+static float clamp(float x, float lo, float hi) {
+    if (x < lo) return lo;
+    if (x > hi) return hi;
+    return x;
+}
+
+static void limitComp(HystController_t* hc) {
+    // each compensation moves its threshold by at most half the band, and together they have to leave minBand between the thresholds
+    float half = 0.5f * hc->band;
+    hc->overshootComp = clamp(hc->overshootComp, -half, half);
+    hc->undershootComp = clamp(hc->undershootComp, -half, half);
+    float excess = hc->overshootComp + hc->undershootComp - (hc->band - hc->cfg.minBand);
+    if (excess > 0.0f) {
+        hc->overshootComp -= 0.5f * excess;
+        hc->undershootComp -= 0.5f * excess;
+    }
+}
+
+void hystInit(HystController_t* hc, const HystConfig_t* cfg) {
+    hc->cfg = *cfg;
+    hc->invMinCycleTicks = cfg->dt / cfg->minCyclePeriod;
+    hc->on = false;
+    hc->band = clamp(cfg->initialBand, cfg->minBand, cfg->maxBand);
+    hc->overshootComp = 0.0f;
+    hc->undershootComp = 0.0f;
+    hc->peak = -INFINITY;
+    hc->trough = INFINITY;
+    hc->lastSetpoint = NAN;
+    hc->skipCycle = true;
+    hc->ticks = 0;
+    hc->lastOnTick = 0;
+    hc->switches = 0;
+}
+
+bool hystStep(HystController_t* hc, float setpoint, float measurement) {
+    hc->ticks++;
+    float gain = hc->cfg.adaptGain;
+    float half = 0.5f * hc->band;
+    if (!(fabsf(setpoint - hc->lastSetpoint) <= hc->band))   // also true for the first step (NaN)
+        hc->skipCycle = true;
+    hc->lastSetpoint = setpoint;
+
+    if (hc->on) {
+        if (measurement < hc->trough)
+            hc->trough = measurement;
+        if (measurement >= setpoint + half - hc->overshootComp) {
+            if (!hc->skipCycle && gain > 0.0f)
+                hc->undershootComp += gain * ((setpoint - half) - hc->trough);
+            limitComp(hc);
+            hc->on = false;
+            hc->peak = measurement;
+            hc->switches++;
+        }
+    } else {
+        if (measurement > hc->peak)
+            hc->peak = measurement;
+        if (measurement <= setpoint - half + hc->undershootComp) {
+            if (!hc->skipCycle && gain > 0.0f) {
+                hc->overshootComp += gain * (hc->peak - (setpoint + half));
+                float period = (float)(hc->ticks - hc->lastOnTick) * hc->invMinCycleTicks;   // in units of minCyclePeriod
+                float error = 1.0f - period;
+                if (error < 0.0f)
+                    error = fminf(error + CYCLE_MARGIN, 0.0f);
+                float scale = clamp(1.0f + gain * error, 0.5f, 2.0f);
+                hc->band = clamp(hc->band * scale, hc->cfg.minBand, hc->cfg.maxBand);
+            }
+            limitComp(hc);
+            hc->skipCycle = false;
+            hc->on = true;
+            hc->trough = measurement;
+            hc->lastOnTick = hc->ticks;
+            hc->switches++;
+        }
+    }
+    return hc->on;
+}
+
+float hystGetBand(const HystController_t* hc) {
+    return hc->band;
+}
+
+uint32_t hystGetSwitchCount(const HystController_t* hc) {
+    return hc->switches;
+}
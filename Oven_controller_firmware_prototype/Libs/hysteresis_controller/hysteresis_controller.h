@@ -0,0 +1,78 @@
+/**
+ * @file hysteresis_controller.h
+ * @brief Public API for the adaptive-band hysteresis heating mode. See hysteresis_controller.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- On/off control with a band that adapts once per relay cycle to keep the cycle period at a configured minimum (limits SSR wear)
+- Overshoot and undershoot caused by the heater lag are learned and compensated by switching early, so the temperature swings around the setpoint instead of beyond the band
+- A few comparisons per step, adaptation math runs only on switching, suitable for a 100 Hz loop
+- Can be used with a fixed band (adaptation gain 0)
+
+# Limitations
+- Adaptation is suspended for the cycle following a setpoint change larger than the band
+- The learned compensation depends on the operating temperature and needs a few cycles to settle after a big change
+*/
+
+#ifndef HYSTERESIS_CONTROLLER_H
+#define HYSTERESIS_CONTROLLER_H
+
+#include "stdint.h"
+#include "stdbool.h"
+
+typedef struct HystConfig_t {
+    float dt;                   // step period [s]
+    float initialBand;          // full band width [degC]
+    float minBand;              // [degC]
+    float maxBand;              // [degC]
+    float minCyclePeriod;       // shortest allowed on-off cycle [s]
+    float adaptGain;            // adaptation speed per cycle (0.0 - 1.0, 0 = fixed band, no compensation)
+} HystConfig_t;
+
+typedef struct HystController_t {
+    HystConfig_t cfg;
+    float invMinCycleTicks;
+    bool on;
+    float band;                 // [degC]
+    float overshootComp;        // learned overshoot past the upper threshold [degC]
+    float undershootComp;       // learned undershoot past the lower threshold [degC]
+    float peak;                 // highest temperature since switching off
+    float trough;               // lowest temperature since switching on
+    float lastSetpoint;
+    bool skipCycle;             // don't adapt on the current cycle
+    uint32_t ticks;
+    uint32_t lastOnTick;
+    uint32_t switches;
+} HystController_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the controller, heater off
+ * @param hc pointer to the controller instance
+ * @param cfg configuration
+ */
+void hystInit(HystController_t* hc, const HystConfig_t* cfg);
+
+/**
+ * @brief Runs one control step
+ * @param hc pointer to the controller instance
+ * @param setpoint [degC]
+ * @param measurement [degC]
+ * @return true if the heater should be on
+ */
+bool hystStep(HystController_t* hc, float setpoint, float measurement);
+
+/**
+ * @brief Returns the current band width
+ * @return [degC]
+ */
+float hystGetBand(const HystController_t* hc);
+
+/**
+ * @brief Returns the number of relay switchings since hystInit
+ */
+uint32_t hystGetSwitchCount(const HystController_t* hc);
+
+#endif
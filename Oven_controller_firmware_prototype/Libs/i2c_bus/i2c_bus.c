@@ -0,0 +1,122 @@
+/**
+ * @file i2c_bus.c
+ * @brief Shared I2C bus arbiter implementation. See i2c_bus.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Pending requests are kept in a bit mask. Whenever the bus is released (after every transfer), the next pending client after the previous owner is granted it, so clients are served round-robin. A client that wants the bus again after its transfer goes back to the pending mask like any other request.
+ *
+ * The pending mask and the owner are changed with interrupts disabled, because requests come from the main loop as well as from completion interrupts. The client callbacks themselves run with interrupts enabled.
+ */
+
+#include "i2c_bus.h"
+#include "ccmram.h"
+
+#define NO_OWNER        (uint8_t)0xFF
+#define ARBITRATING     (uint8_t)0xFE   // the bus is being granted, requests only set their pending bit
+
+static I2C_HandleTypeDef* busHi2c;
+static const I2CBusClient_t* clients[I2C_BUS_MAX_CLIENTS];
+static uint8_t clientCount = 0;
+
+static volatile uint8_t owner = NO_OWNER;
+static volatile uint8_t lastOwner = I2C_BUS_MAX_CLIENTS - 1;
+static volatile uint32_t pending = 0;
+
+// picks the next pending client after the previous owner and clears its request, returns NO_OWNER if there's none
+CCMRAM_FUNC static uint8_t pickNext(void) {
+    for (uint8_t k = 1; k <= clientCount; k++) {
+        uint8_t id = (uint8_t)((lastOwner + k) % clientCount);
+        if (pending & (1UL << id)) {
+            pending &= ~(1UL << id);
+            return id;
+        }
+    }
+    return NO_OWNER;
+}
+
+// grants the bus to pending clients until one of them starts a transfer, must be called with owner == ARBITRATING
+CCMRAM_FUNC static void grantNext(void) {
+    while (1) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uint8_t id = pickNext();
+        owner = id;
+        if (id != NO_OWNER)
+            lastOwner = id;
+        __set_PRIMASK(primask);
+
+        if (id == NO_OWNER || clients[id]->start())
+            return;
+
+        // nothing started, the bus is still ours
+        owner = ARBITRATING;
+    }
+}
+
+CCMRAM_FUNC static void release(bool again) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (again)
+        pending |= 1UL << owner;
+    owner = ARBITRATING;
+    __set_PRIMASK(primask);
+    grantNext();
+}
+
+/* API functions */
+
+void i2cBusInit(I2C_HandleTypeDef* hi2c) {
+    busHi2c = hi2c;
+    clientCount = 0;
+    owner = NO_OWNER;
+    lastOwner = I2C_BUS_MAX_CLIENTS - 1;
+    pending = 0;
+}
+
+I2C_HandleTypeDef* i2cBusGetHandle(void) {
+    return busHi2c;
+}
+
+I2CBusStatus_t i2cBusRegister(const I2CBusClient_t* client, uint8_t* id) {
+    if (clientCount >= I2C_BUS_MAX_CLIENTS)
+        return I2C_BUS_TOO_MANY_CLIENTS;
+    clients[clientCount] = client;
+    *id = clientCount++;
+    return I2C_BUS_OK;
+}
+
+I2CBusStatus_t i2cBusRequest(uint8_t id) {
+    if (id >= clientCount)
+        return I2C_BUS_INVALID_CLIENT;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pending |= 1UL << id;
+    bool idle = (owner == NO_OWNER);
+    if (idle)
+        owner = ARBITRATING;
+    __set_PRIMASK(primask);
+
+    if (idle)
+        grantNext();
+    return I2C_BUS_OK;
+}
+
+bool i2cBusIsIdle(void) {
+    return owner == NO_OWNER && pending == 0;
+}
+
+CCMRAM_FUNC void i2cBusTransferCompleteHandler(void) {
+    uint8_t id = owner;
+    if (id >= clientCount)
+        return;
+    release(clients[id]->onComplete());
+}
+
+void i2cBusErrorHandler(void) {
+    uint8_t id = owner;
+    if (id >= clientCount)
+        return;
+    release(clients[id]->onError());
+}
@@ -0,0 +1,97 @@
+/**
+ * @file i2c_bus.h
+ * @brief Public API for the shared I2C bus arbiter. See i2c_bus.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Lets several asynchronous (DMA/interrupt) drivers share one I2C bus without pausing each other
+- Drivers register as clients and request the bus when they have work. The bus is granted round-robin, one transfer at a time, so a busy client (e.g. a long LCD queue) can't starve the others.
+- All HAL completion and error callbacks of the bus are routed to the arbiter, which forwards them to the current owner
+
+# Limitations
+- Blocking transfers (e.g. during a driver's initialisation) must not overlap with asynchronous ones, do them before other clients start requesting the bus
+- Up to I2C_BUS_MAX_CLIENTS clients
+
+# Requirements:
+- In your main program file, implement the HAL I2C callbacks according to these minimal examples:
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
+    if (hi2c == &hi2c1)
+        i2cBusTransferCompleteHandler();
+}
+
+(same for HAL_I2C_MasterRxCpltCallback, HAL_I2C_MemTxCpltCallback and HAL_I2C_MemRxCpltCallback)
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    if (hi2c == &hi2c1)
+        i2cBusErrorHandler();
+}
+*/
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+
+#define I2C_BUS_MAX_CLIENTS     8
+
+/* Status info */
+
+typedef enum I2CBusStatus_t {
+    I2C_BUS_OK,
+    I2C_BUS_TOO_MANY_CLIENTS,   // I2C_BUS_MAX_CLIENTS are already registered.
+    I2C_BUS_INVALID_CLIENT,
+} I2CBusStatus_t;
+
+typedef struct I2CBusClient_t {
+    bool (*start)(void);        // The bus was granted, start one asynchronous transfer. Return false if there was nothing to do (or the transfer couldn't be started), the bus is released then.
+    bool (*onComplete)(void);   // The transfer finished. Return true if the client has more work and wants the bus again.
+    bool (*onError)(void);      // The transfer failed. Return true if the client wants the bus again (e.g. to retry).
+} I2CBusClient_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the arbiter
+ * @param hi2c pointer to HAL's I2C handle struct of the shared bus
+ */
+void i2cBusInit(I2C_HandleTypeDef* hi2c);
+
+/**
+ * @brief Returns the I2C handle of the shared bus, for the clients' transfers
+ */
+I2C_HandleTypeDef* i2cBusGetHandle(void);
+
+/**
+ * @brief Registers a client
+ * @param client pointer to the client's callbacks (must stay valid)
+ * @param id returns the client's id for i2cBusRequest
+ */
+I2CBusStatus_t i2cBusRegister(const I2CBusClient_t* client, uint8_t* id);
+
+/**
+ * @brief Requests the bus. The client's start callback is called as soon as the bus is granted (possibly right away, from this call).
+ * @note Safe to call from interrupts
+ * @param id client id
+ */
+I2CBusStatus_t i2cBusRequest(uint8_t id);
+
+/**
+ * @brief Checks whether no client owns the bus and none is waiting for it
+ * @return bool
+ */
+bool i2cBusIsIdle(void);
+
+/**
+ * @brief Function to be called inside all HAL I2C completion callbacks of the bus
+ */
+void i2cBusTransferCompleteHandler(void);
+
+/**
+ * @brief Function to be called inside HAL_I2C_ErrorCallback (and HAL_I2C_AbortCpltCallback, if used)
+ */
+void i2cBusErrorHandler(void);
+
+#endif
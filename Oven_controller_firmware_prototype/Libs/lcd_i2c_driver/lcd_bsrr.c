@@ -0,0 +1,49 @@
+/**
+ * @file lcd_bsrr.c
+ * @brief BSRR word expansion for the LCD's GPIO transport. See lcd_bsrr.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The driver's sequences change the data lines one state before raising EN and keep them one state after dropping it, so at one word per state the lines settle a whole word period before each edge. The controller latches a nibble on EN's falling edge and is busy for the instruction's execution time after the second one. The padding counts from the word that drops EN: with W words of execution time, the next sequence's first word comes W word periods after the edge.
+ */
+
+#include "lcd_bsrr.h"
+
+#define PIN_MASK(pin)       (1UL << (pin))
+#define LINES_MASK          (PIN_MASK(LCD_BSRR_RS_PIN) | PIN_MASK(LCD_BSRR_EN_PIN) | (0xFUL << LCD_BSRR_D4_PIN))
+
+/* API functions */
+
+uint32_t lcdBsrrWord(uint8_t state) {
+    uint32_t high = (uint32_t)(state >> 4) << LCD_BSRR_D4_PIN;
+    if (state & LCD_STATE_RS)
+        high |= PIN_MASK(LCD_BSRR_RS_PIN);
+    if (state & LCD_STATE_EN)
+        high |= PIN_MASK(LCD_BSRR_EN_PIN);
+    uint32_t low = LINES_MASK & ~high;
+    return high | (low << 16);
+}
+
+uint16_t lcdBsrrEncode(const uint8_t* seq, uint8_t size, uint16_t execUs, uint32_t* words, uint16_t capacity) {
+    if (size == 0)
+        return 0;
+
+    uint16_t lastFall = 0;      // index of the word that drops EN the last time, 0 = no falling edge
+    for (uint8_t i = 1; i < size; i++) {
+        if ((seq[i - 1] & LCD_STATE_EN) && !(seq[i] & LCD_STATE_EN))
+            lastFall = i;
+    }
+
+    uint16_t count = size;
+    if (lastFall > 0) {
+        uint16_t busyWords = (uint16_t)((execUs + LCD_BSRR_WORD_US - 1) / LCD_BSRR_WORD_US);
+        if (lastFall + busyWords > count)
+            count = lastFall + busyWords;
+    }
+    if (count > capacity)
+        return 0;
+
+    for (uint16_t i = 0; i < count; i++)
+        words[i] = lcdBsrrWord(seq[(i < size) ? i : size - 1]);
+    return count;
+}
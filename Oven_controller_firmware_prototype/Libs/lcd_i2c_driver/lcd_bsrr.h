@@ -0,0 +1,53 @@
+/**
+ * @file lcd_bsrr.h
+ * @brief Expansion of the LCD driver's pin sequences into GPIO BSRR words for the GPIO transport. See lcd_bsrr.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- One 32-bit word per pin state: the set half drives the high lines, the reset half the low ones, so every word fully defines RS, EN and D4-D7 and leaves the port's other pins alone
+- The words are written one per LCD_BSRR_WORD_US. Each state lasts one word, which covers the HD44780's setup, hold and enable pulse times with a wide margin.
+- After the last EN falling edge of a sequence the words repeat its final state until the controller's execution time has passed
+- Hardware-independent, the host tool Host/LcdBsrr checks the stream against the HD44780's timing
+
+# Limitations
+- RS, EN and D4-D7 on one port, D4-D7 on consecutive pins
+- RW tied low (writes only), the backlight bit of the states isn't used
+*/
+
+#ifndef LCD_BSRR_H
+#define LCD_BSRR_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#define LCD_BSRR_WORD_US    10      // time between words [us]
+#define LCD_BSRR_WORDS_MAX  256     // words of one transfer, about 28 characters or a clear display
+#define LCD_BSRR_RS_PIN     0       // pin numbers on the port
+#define LCD_BSRR_EN_PIN     1
+#define LCD_BSRR_D4_PIN     2       // D4-D7 on this pin and the next three
+
+// pin states in the PCF8574's bit layout, as the driver builds them
+#define LCD_STATE_RS        (uint8_t)0x01
+#define LCD_STATE_EN        (uint8_t)0x04
+#define LCD_STATE_DATA      (uint8_t)0xF0
+
+/**
+ * @brief Converts a pin state into its BSRR word
+ * @param state pin state (PCF8574 bit layout)
+ * @return BSRR word
+ */
+uint32_t lcdBsrrWord(uint8_t state);
+
+/**
+ * @brief Appends the words of one sequence, followed by the words that wait out the controller's execution time
+ * @param seq pin states
+ * @param size state count
+ * @param execUs execution time after the sequence's last EN falling edge [us]
+ * @param words where the words go
+ * @param capacity room left in words
+ * @return number of words appended, 0 if they don't fit
+ */
+uint16_t lcdBsrrEncode(const uint8_t* seq, uint8_t size, uint16_t execUs, uint32_t* words, uint16_t capacity);
+
+#endif
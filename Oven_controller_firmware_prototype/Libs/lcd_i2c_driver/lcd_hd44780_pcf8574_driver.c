@@ -4,10 +4,14 @@
  * @author Mateusz Stelmaszyński
  * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
  *
- * This file implements a non-blocking, DMA-based driver for character LCDs using the HD44780 controller and PCF8574 I/O expander module. The driver uses a circular queue to buffer instructions. DMA and I2C are handled using the STM's HAL.
+ * This file implements a non-blocking, DMA-based driver for character LCDs using the HD44780 controller and PCF8574 I/O expander module. The driver uses a circular queue to buffer instructions. DMA and I2C are handled by the transport selected at compile time (lcd_transport.h), the STM's HAL by default. The bus is shared with other devices through the i2c_bus arbiter - each time the driver is granted the bus it sends as many queue entries as the transport takes in one transfer (one for the I2C transports).
+ *
+ * By default the controller's execution times are covered by the bus itself: an entry takes several expander bytes, longer than the usual 37 us, and clear/return home are followed by dummy entries. With busy flag checking on, an entry with a longer execution time is followed by busy flag reads instead, one per bus grant, and the next entry goes out as soon as a read finds the controller ready. Once the longest execution time has certainly passed (the queue was empty for a while), the reads are skipped. A read raises R/W with the data lines written high (the expander's pins are quasi-bidirectional, the controller can pull them down) and EN, and samples D7 in the same transfer. Only the first nibble of a 4-bit read holds the busy flag, so after a busy result the next read clocks the second nibble and the one after that checks the flag again. After a ready result, the second nibble is clocked at the start of the next entry's transfer.
  */
 
 #include "lcd_hd44780_pcf8574_driver.h"
+#include "lcd_transport.h"
+#include "ccmram.h"
 
  /* HARDWARE ABSTRACTION */
 
@@ -15,6 +19,7 @@
 
 #define RS_DATA_REG                 (uint8_t)0x01
 #define RS_INSTR_REG                (uint8_t)0
+#define RW_READ                     (uint8_t)0x02
 #define EN_BIT                      (uint8_t)0x04
 #define BL_ON                       (uint8_t)0x08   // backlight
 #define BL_OFF                      (uint8_t)0
@@ -95,20 +100,23 @@ Build an appropriate queue entry (data byte along with the RS bit)
 Enqueue that entry (unless the queue is full)
     |
     V
-Begin flushing the queue (unless it's already flushing or paused)
+Request the I2C bus (unless the queue is paused)
+    |
+    |  <-- Request it again after each transmission (unless the queue is paused or empty)
+    V
+The bus is granted (busStart called by the arbiter)
     |
-    |  <-- Continue flushing from HAL_I2C_MasterTxCpltCallback (unless the queue is paused)
     V
-Read the queue entry under qReadIdx without dequeueing it (unless the queue is empty)
+Read the queue entries from qReadIdx on without dequeueing them (unless the queue is empty)
     |
     V
-Prepare the read entry to be transmitted (by splitting in half and adding EN bit pulses, filling a 6-byte buffer)
+Prepare each read entry to be transmitted (by splitting in half and adding EN bit pulses, 6 pin states) and append it to the transport's buffer, until it's full
     |
     V
 Initialise the transmission of that buffer via DMA (unless there are persisting I2C errors)
     |
     V
-Dequeue the entry (unless the initialisation failed)
+Dequeue the appended entries (unless the initialisation failed)
     |
     V
 End
@@ -122,7 +130,7 @@ typedef struct QueueEntry_t {
     uint8_t data;
 } QueueEntry_t;
 
-QueueEntry_t queue[QUEUE_SIZE];
+QueueEntry_t queue[QUEUE_SIZE] CCMRAM_BSS;
 volatile uint8_t qWriteIdx = 0;
 volatile uint8_t qReadIdx = 0;
 volatile uint8_t qEntryCount = 0;
@@ -144,13 +152,7 @@ LCDStatus_t enq(QueueEntry_t* e) {
     return LCD_OK;
 }
 
-LCDStatus_t qPeek(QueueEntry_t* e) {
-    if (qEntryCount == 0) return LCD_QUEUE_EMPTY;
-    *e = queue[qReadIdx];
-    return LCD_OK;
-}
-
-LCDStatus_t deq(void) {
+CCMRAM_FUNC LCDStatus_t deq(void) {
     if (qEntryCount == 0) return LCD_QUEUE_EMPTY;
     qReadIdx = (qReadIdx + 1) % QUEUE_SIZE;
     qEntryCount--;
@@ -159,30 +161,69 @@ LCDStatus_t deq(void) {
 
 /* HANDLING AND SENDING DATA */
 
-volatile bool flushInProgress = false;
+volatile bool flushInProgress = false;  // an entry is being transmitted
 volatile bool i2cErrorPending = false;
 volatile LCDStatus_t lcdStatus = LCD_OK;
 
-LCDStatus_t txByte(uint8_t rs, uint8_t data) {
-    static uint8_t buffer[6] = { 0 };
+// controller's execution times, with some margin over the datasheet's 37 us and 1.52 ms
+#define EXEC_US         40
+#define EXEC_CLEAR_US   1640    // clear display and return home
+
+/* busy flag checking */
 
+#define BUSY_FLAG                   (uint8_t)0x80   // D7 of the first nibble read
+#define READ_RELEASED               (uint8_t)(0xf0 | RW_READ)  // data lines written high, EN low
+#define BF_EXPIRE_MS                2   // ticks after which the longest execution time has certainly passed
+
+volatile bool bfCheck = false;
+volatile bool bfWaiting = false;    // the last entry sent may still be executing, read the busy flag before the next one
+volatile bool bfReading = false;    // a busy flag read is on the bus
+volatile bool bfReadOpen = false;   // a read's first nibble was clocked, its second one wasn't
+volatile uint32_t bfWaitTick = 0;   // when the entry that's waited for was sent
+
+// expands an entry into pin states: the upper and the lower half, each with an EN pulse
+CCMRAM_FUNC uint8_t encodeEntry(uint8_t rs, uint8_t data, uint8_t* seq) {
     if (rs == RS_INSTR_REG && data == NOP) { // dummy entries from lcdClear() and lcdReturnHome()
-        buffer[0] = data | rs | bl;
-        for (uint8_t i = 1; i < sizeof(buffer); i++) {
-            buffer[i] = buffer[0];
+        seq[0] = data | rs | bl;
+        for (uint8_t i = 1; i < 6; i++) {
+            seq[i] = seq[0];
         }
     } else {
         // upper half
-        buffer[0] = (data & 0xf0) | rs | bl;
-        buffer[1] = buffer[0] | EN_BIT;
-        buffer[2] = buffer[0];
+        seq[0] = (data & 0xf0) | rs | bl;
+        seq[1] = seq[0] | EN_BIT;
+        seq[2] = seq[0];
         // lower half
-        buffer[3] = (data << 4) | rs | bl;
-        buffer[4] = buffer[3] | EN_BIT;
-        buffer[5] = buffer[3];
+        seq[3] = (data << 4) | rs | bl;
+        seq[4] = seq[3] | EN_BIT;
+        seq[5] = seq[3];
+    }
+    return 6;
+}
+
+// time the controller needs for an entry, NOPs take no time (the transport's idle time after them is just a delay)
+CCMRAM_FUNC uint16_t entryExecUs(uint8_t rs, uint8_t data) {
+    if (rs == RS_INSTR_REG && (data == CLEAR_DISPLAY_INSTR || (data & 0xfe) == RETURN_HOME_INSTR))
+        return EXEC_CLEAR_US;
+    return EXEC_US;
+}
+
+// endRead: clock the second nibble of the last busy flag read out first
+CCMRAM_FUNC static bool appendEntry(uint8_t rs, uint8_t data, bool endRead) {
+    uint8_t seq[LCD_TRANSPORT_MAX_SEQ];
+    uint8_t size = 0;
+    if (endRead) {
+        seq[0] = READ_RELEASED | bl;
+        seq[1] = seq[0] | EN_BIT;
+        seq[2] = seq[0];
+        size = 3;
     }
+    size += encodeEntry(rs, data, &seq[size]);
+    return lcdTransportAppend(seq, size, entryExecUs(rs, data));
+}
 
-    if (HAL_I2C_GetError(lcdhi2c) != HAL_I2C_ERROR_NONE) {  // if an error persists over 2 transmissions, pause the queue
+CCMRAM_FUNC static LCDStatus_t checkTransportError(void) {
+    if (lcdTransportHasError()) {   // if an error persists over 2 transmissions, pause the queue
         if (i2cErrorPending) {
             qPaused = true;
             i2cErrorPending = false;
@@ -191,20 +232,38 @@ LCDStatus_t txByte(uint8_t rs, uint8_t data) {
         i2cErrorPending = true;
     } else
         i2cErrorPending = false;
-
-    if (HAL_I2C_Master_Transmit_DMA(lcdhi2c, lcdAddress, buffer, sizeof(buffer)) != HAL_OK) {
-        return LCD_I2C_TX_INIT_FAIL;
-    }
     return LCD_OK;
 }
 
-LCDStatus_t flush(void) {
-    QueueEntry_t e;
-    LCDStatus_t status = qPeek(&e);
+CCMRAM_FUNC LCDStatus_t txByte(uint8_t rs, uint8_t data) {
+    LCDStatus_t status = checkTransportError();
+    if (status != LCD_OK)
+        return status;
+    appendEntry(rs, data, false);
+    return lcdTransportStart();
+}
+
+// sends as many entries from the queue as the transport takes in one transfer
+CCMRAM_FUNC LCDStatus_t flush(void) {
+    LCDStatus_t status = (qEntryCount == 0) ? LCD_QUEUE_EMPTY : checkTransportError();
     if (status == LCD_OK) {
-        status = txByte(e.rs, e.data);
+        uint8_t count = 0;
+        bool wait = false;
+        while (count < qEntryCount && !wait) {
+            QueueEntry_t* e = &queue[(qReadIdx + count) % QUEUE_SIZE];
+            if (!appendEntry(e->rs, e->data, bfReadOpen && count == 0))
+                break;
+            count++;
+            // the short instructions end before the next entry's first EN pulse, a read (5 expander bytes and a second nibble) would only add bus time
+            wait = bfCheck && entryExecUs(e->rs, e->data) > EXEC_US;
+        }
+        status = lcdTransportStart();
         if (status == LCD_OK) {
-            deq();
+            bfReadOpen = false;
+            bfWaiting = wait;
+            bfWaitTick = HAL_GetTick();
+            while (count--)
+                deq();
             return status;
         }
     }
@@ -212,34 +271,62 @@ LCDStatus_t flush(void) {
     return status;
 }
 
-LCDStatus_t enqAndBeginFlushing(QueueEntry_t* e) {
-    LCDStatus_t status = enq(e);
-    if (status != LCD_OK) {
-        lcdStatus = status;
-        return status;
-    }
-    if (flushInProgress || qPaused) {
-        lcdStatus = LCD_OK;
-        return LCD_OK;
+// reads the busy flag, or clocks the second nibble of the previous read
+CCMRAM_FUNC static LCDStatus_t readBusyFlag(void) {
+    LCDStatus_t status = checkTransportError();
+    if (status == LCD_OK) {
+        uint8_t released = READ_RELEASED | bl;
+        status = lcdTransportStartRead(released, released | EN_BIT);
+        if (status == LCD_OK) {
+            bfReading = true;
+            return status;
+        }
     }
-    flushInProgress = true;
-    lcdStatus = flush();
-    return lcdStatus;
+    flushInProgress = false;
+    return status;
 }
 
-/* Functions for HAL callbacks */
+/* I2C bus client (or the GPIO transport's client) */
+
+CCMRAM_FUNC static bool busStart(void) {
+    if (qPaused || qEntryCount == 0)
+        return false;
+    if (bfWaiting && HAL_GetTick() - bfWaitTick > BF_EXPIRE_MS)    // e.g. the queue was empty for a while
+        bfWaiting = false;
+    flushInProgress = true;
+    lcdStatus = bfWaiting ? readBusyFlag() : flush();
+    return flushInProgress;
+}
 
-void lcdFlushQueue(void) {
-    if (qPaused) {
-        flushInProgress = false;
-        lcdStatus = LCD_OK;
-        return;
+CCMRAM_FUNC static bool busComplete(void) { // wants the bus again if there's anything left to send
+    flushInProgress = false;
+    if (bfReading) {
+        bfReading = false;
+        bfReadOpen = !bfReadOpen;
+        if (bfReadOpen && !(lcdTransportGetRead() & BUSY_FLAG))
+            bfWaiting = false;
     }
-    lcdStatus = flush();
+    return !qPaused && qEntryCount > 0;
 }
 
-void lcdi2cErrorHandler(void) { // prevents queue stalling if HAL_I2C_MasterTxCpltCallback doesn't get called
+static bool busError(void) {    // a failed entry is dropped, a failed read is repeated, persisting errors pause the queue in flush
     flushInProgress = false;
+    bfReading = false;
+    return !qPaused && qEntryCount > 0;
+}
+
+static const I2CBusClient_t busClient = { busStart, busComplete, busError };
+
+LCDStatus_t enqAndBeginFlushing(QueueEntry_t* e) {
+    LCDStatus_t status = enq(e);
+    if (status != LCD_OK) {
+        lcdStatus = status;
+        return status;
+    }
+    lcdStatus = LCD_OK;
+    if (!qPaused)
+        lcdTransportRequest();
+    return lcdStatus;
 }
 
 /* API - queue control and status */
@@ -250,13 +337,14 @@ void lcdQueuePause(void) {
 
 LCDStatus_t lcdQueueResume(void) {
     qPaused = false;
-    if (flushInProgress) return LCD_OK;
-    flushInProgress = true;
-    return flush();
+    lcdStatus = LCD_OK;
+    if (qEntryCount > 0)
+        lcdTransportRequest();
+    return lcdStatus;
 }
 
 bool lcdQueueIsPaused(void) {
-    return qPaused && flushInProgress;
+    return qPaused && !flushInProgress;
 }
 
 bool lcdQueueIsFull(void) {
@@ -267,6 +355,13 @@ LCDStatus_t lcdGetStatus(void) {
     return lcdStatus;
 }
 
+LCDStatus_t lcdSetBusyFlagCheck(bool state) {
+    if (state && !lcdTransportCanRead())
+        return LCD_BUSY_FLAG_UNSUPPORTED;
+    bfCheck = state;
+    return LCD_OK;
+}
+
 /* API - printing characters and strings */
 
 LCDStatus_t lcdPrintChar(uint8_t c) {
@@ -307,6 +402,8 @@ LCDStatus_t lcdSetBacklightNow(bool state) {
 
 LCDStatus_t lcdClear(void) {
     QueueEntry_t e = { RS_INSTR_REG, CLEAR_DISPLAY_INSTR };
+    if (bfCheck)
+        return enqAndBeginFlushing(&e);
     LCDStatus_t status = enq(&e);
     if (status != LCD_OK) return status;
     // two dummy entries to simulate a delay on the I2C bus (amount might require tweaking)
@@ -318,6 +415,8 @@ LCDStatus_t lcdClear(void) {
 
 LCDStatus_t lcdReturnHome(void) {
     QueueEntry_t e = { RS_INSTR_REG, RETURN_HOME_INSTR };
+    if (bfCheck)
+        return enqAndBeginFlushing(&e);
     LCDStatus_t status = enq(&e);
     if (status != LCD_OK) return status;
     // two dummy entries to simulate a delay on the I2C bus (amount might require tweaking)
@@ -457,13 +556,18 @@ LCDStatus_t lcdInit(I2C_HandleTypeDef* hi2c, uint8_t address, uint8_t numOfLines
     4. clear display
     */
 
+    lcdTransportInit(lcdhi2c, lcdAddress);
+    bfWaiting = false;
+    bfReading = false;
+    bfReadOpen = false;
+
     uint8_t buffer[3] = { 0 };
     buffer[0] = INIT_8BIT_MODE | bl;
     buffer[1] = buffer[0] | EN_BIT;
     buffer[2] = buffer[0];
 
     for (uint8_t i = 0; i < 3; i++) {
-        if (HAL_I2C_Master_Transmit(lcdhi2c, lcdAddress, buffer, 3, 1000) != HAL_OK)
+        if (lcdTransportWriteNow(buffer, 3, EXEC_US) != LCD_OK)
             return LCD_I2C_TX_INIT_FAIL;
         HAL_Delay(5);
     }
@@ -472,9 +576,13 @@ LCDStatus_t lcdInit(I2C_HandleTypeDef* hi2c, uint8_t address, uint8_t numOfLines
     buffer[1] = buffer[0] | EN_BIT;
     buffer[2] = buffer[0];
 
-    if (HAL_I2C_Master_Transmit(lcdhi2c, lcdAddress, buffer, 3, 1000) != HAL_OK)
+    if (lcdTransportWriteNow(buffer, 3, EXEC_US) != LCD_OK)
         return LCD_I2C_TX_INIT_FAIL;
 
+    LCDStatus_t status = lcdTransportRegister(&busClient);
+    if (status != LCD_OK)
+        return status;
+
     QueueEntry_t e;
     e.rs = RS_INSTR_REG;
     e.data = FS_INSTR;
@@ -484,9 +592,5 @@ LCDStatus_t lcdInit(I2C_HandleTypeDef* hi2c, uint8_t address, uint8_t numOfLines
     e.data = DC_INSTR;
     enq(&e);
 
-    flushInProgress = true;
-    LCDStatus_t status = flush();
-    if (status != LCD_OK) return status;
-
-    return lcdClear();
+    return lcdClear();  // requests the bus for the whole queue
 }
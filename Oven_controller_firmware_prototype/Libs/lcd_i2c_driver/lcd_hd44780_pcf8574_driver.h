@@ -7,28 +7,21 @@
 # Key Features
 - Asynchronous DMA-based data transmission (no blocking transmissions, except for the ones in the lcdInit function)
 - LCD instructions are buffered in a circular queue
-- DMA and I2C are handled using the STM's HAL
+- DMA and I2C are handled using the STM's HAL, or directly through the LL register interface with LCD_TRANSPORT=LL (see lcd_transport.h)
+- LCD_TRANSPORT=GPIO drops the PCF8574: the HD44780 is wired to GPIO pins and whole lines are written in one timer-paced DMA transfer, without the CPU
+- The I2C bus can be shared with other asynchronous drivers through the i2c_bus arbiter, the queue doesn't need to be paused for their transfers
+- Optional busy flag checking (lcdSetBusyFlagCheck): clear and return home are followed by busy flag reads through the expander instead of a fixed number of dummy entries, so the next entry goes out as soon as the controller is done, also on buses too fast for the dummy entries
 
  # Limitations
-- If any other device is connected to the same I2C bus as the LCD, the queue must be paused before transmitting or receiving data from that device, and resumed after completion (relevant functions are provided)
+- Blocking transfers to other devices on the same bus must not overlap with the queue being flushed (pause it and wait for lcdQueueIsPaused, or do them before lcdInit)
 - No built-in conversion of variables to ASCII strings
 - No custom character generation (yet)
-- No busy flag checking
+- Busy flag checking needs an I2C transport and a module with R/W wired to P1 (the common ones are). Instructions with the usual 37 us execution time aren't checked, the bus time between two entries covers it up to 400 kHz (the PCF8574 itself is only specified for 100 kHz). At 100 kHz the dummy entries are long enough and the reads take longer (clearing and refreshing a 16x2 screen takes 23.95 ms instead of 22.68 ms in Host/LcdRefresh/lcd_refresh.c), hence it's off by default. Turn it on above 100 kHz, where the dummy entries end before a clear does.
 
 # Requirements:
 - Replace the included stm32f3xx_hal.h file according to your MCU
 - Enable I2C and DMA interrupts
-- In your main program file, implement HAL_I2C_MasterTxCpltCallback and HAL_I2C_ErrorCallback according to these minimal examples:
-
-void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) {
-    if (hi2c == &hi2c1)
-        lcdFlushQueue();
-}
-
-void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
-    if (hi2c == &hi2c1)
-        lcdi2cErrorHandler();
-}
+- Call i2cBusInit before lcdInit and route the HAL I2C callbacks to the arbiter (see i2c_bus.h)
 */
 
 #ifndef LCD_HD_PCF_H
@@ -36,6 +29,7 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c) {
 
 #include "stm32f3xx_hal.h"  // change if using a different MCU
 #include "stdbool.h"
+#include "i2c_bus.h"
 
 /* Status info */
 
@@ -46,14 +40,16 @@ typedef enum LCDStatus_t {
     LCD_QUEUE_EMPTY,
     LCD_I2C_TX_INIT_FAIL,       // Failed to initialise I2C DMA transmission.
     LCD_I2C_ERROR,              // There is a persisting I2C error. This results in pausing the queue.
+    LCD_I2C_BUS_FULL,           // Failed to register with the I2C bus arbiter.
+    LCD_BUSY_FLAG_UNSUPPORTED,  // The transport can't read the LCD back (GPIO transport).
 } LCDStatus_t;
 
 /* API functions */
 
 /**
  * @brief Initialise LCD to 4-bit mode with the provided settings
- * @note This function uses 3 5ms delays and 4 blocking transmissions
- * @param hi2c pointer to HAL's I2C handle struct
+ * @note This function uses 3 5ms delays and 4 blocking transmissions. The I2C bus arbiter must already be initialised.
+ * @param hi2c pointer to HAL's I2C handle struct (the arbiter's bus)
  * @param address LCD's I2C address (will be shifted internally)
  * @param numOfLines refers to cell addressing and display configuration (expected values: 1 or 2) 
  * @param cellHeight number of pixels along a cell's height (8 or 10)
@@ -87,13 +83,13 @@ LCDStatus_t lcdSetBacklightNow(bool state);
 
 /**
  * @brief Clears the LCD
- * @note Simulates a delay on the I2C bus by sending dummy bytes
+ * @note Simulates a delay on the I2C bus by sending dummy bytes, or waits for the busy flag with busy flag checking on
  */
 LCDStatus_t lcdClear(void);
 
 /**
  * @brief Moves the cursor to the starting position
- * @note Simulates a delay on the I2C bus by sending dummy bytes. If you only care about moving the cursor to row 0 and column 0, consider using lcdSetCursorPos(0, 0) - it's faster (doesn't require dummy bytes).
+ * @note Simulates a delay on the I2C bus by sending dummy bytes (or waits for the busy flag, see lcdClear). If you only care about moving the cursor to row 0 and column 0, consider using lcdSetCursorPos(0, 0) - it's faster (doesn't require dummy bytes).
  */
 LCDStatus_t lcdReturnHome(void);
 
@@ -160,16 +156,6 @@ LCDStatus_t lcdShiftDisplayL(void);
  */
 LCDStatus_t lcdSetCursorPos(uint8_t row, uint8_t col);
 
-/**
- * @brief Function to be called inside HAL_I2C_MasterTxCpltCallback
- */
-void lcdFlushQueue(void);
-
-/**
- * @brief Function to be called inside HAL_I2C_ErrorCallback. It prevents queue stalling if a transmission fails and HAL_I2C_MasterTxCpltCallback doesn't get called.
- */
-void lcdi2cErrorHandler(void);
-
 /* queue control and status */
 
 /**
@@ -202,4 +188,12 @@ bool lcdQueueIsFull(void);
  */
 LCDStatus_t lcdGetStatus(void);
 
+/**
+ * @brief Enables or disables busy flag checking, off by default
+ * @note Worth it only above 100 kHz, at 100 kHz the dummy entries are faster (see Limitations). Affects entries enqueued afterwards. Call before lcdInit to have the initialisation's clear checked too.
+ * @param state 
+ * @return LCD_OK or LCD_BUSY_FLAG_UNSUPPORTED (GPIO transport)
+ */
+LCDStatus_t lcdSetBusyFlagCheck(bool state);
+
 #endif
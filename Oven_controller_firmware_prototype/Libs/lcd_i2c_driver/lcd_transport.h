@@ -0,0 +1,134 @@
+/**
+ * @file lcd_transport.h
+ * @brief Transport used by the LCD driver to put its pin sequences on the display, selected at compile time. See lcd_transport_hal.c, lcd_transport_ll.c and lcd_transport_gpio.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- The driver expands each queue entry into a sequence of pin states in the PCF8574's bit layout (RS, RW, EN, BL, D4-D7 from bit 0), the transport outputs them
+- LCD_TRANSPORT=HAL (default): the states are the PCF8574's bytes, sent with HAL_I2C_Master_Transmit_DMA. Completions come through the HAL callbacks routed to the i2c_bus arbiter.
+- LCD_TRANSPORT=LL: same bytes, the I2C and DMA registers are driven directly through the LL headers. The I2C event interrupt only waits for the automatic STOP, then reports to the arbiter, which starts the next queued entry from the same interrupt.
+- LCD_TRANSPORT=GPIO: the HD44780 is wired to GPIO pins in 4-bit mode and the states become BSRR words (lcd_bsrr.h), written by a timer-paced DMA channel. A transfer holds as many entries as fit, e.g. a whole line, with the controller's execution times as idle words.
+- I2C transports send one entry per transfer and share the bus through the arbiter, the sensors keep using the HAL on it
+- Busy flag reads (lcdSetBusyFlagCheck): the I2C transports write two pin states and read the expander's port back after a repeated start, in one transfer. Both do it with HAL_I2C_Mem_Read_DMA, the states going out as a 16-bit memory address. The GPIO transport has no R/W line and can't read.
+
+# Limitations
+- The LL and GPIO transports need the ARM build (the fake HAL of the host build has no registers)
+- The LL transport keeps HAL's DMA handle of the I2C's TX channel (hdmatx) for the channel number only, no HAL transfer may use it
+- The GPIO transport owns TIM6 and DMA2 channel 3
+
+# Requirements:
+- LL transport: in stm32f3xx_it.c, let the transport take the I2C interrupts of its own transfers:
+
+void I2C1_EV_IRQHandler(void) {
+    if (lcdTransportEventIRQHandler())
+        return;
+    HAL_I2C_EV_IRQHandler(&hi2c1);
+}
+
+(same for I2C1_ER_IRQHandler with lcdTransportErrorIRQHandler). With the other transports both return false right away.
+- GPIO transport: call lcdTransportDmaIRQHandler from DMA2_Channel3_IRQHandler
+*/
+
+#ifndef LCD_TRANSPORT_H
+#define LCD_TRANSPORT_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+#include "lcd_hd44780_pcf8574_driver.h"
+
+#define LCD_TRANSPORT_MAX_SEQ   9   // pin states of one queue entry, with the end of a busy flag read before it
+
+/**
+ * @brief Prepares the transport, before the blocking writes of the LCD's initialisation
+ * @param hi2c pointer to HAL's I2C handle struct (ignored by the GPIO transport)
+ * @param address LCD's I2C address, already shifted (ignored by the GPIO transport)
+ */
+void lcdTransportInit(I2C_HandleTypeDef* hi2c, uint8_t address);
+
+/**
+ * @brief Outputs pin states right away, blocking
+ * @param seq pin states
+ * @param size state count (up to LCD_TRANSPORT_MAX_SEQ)
+ * @param execUs time the controller needs after the sequence, waited out before returning [us]
+ * @return LCD_OK or LCD_I2C_TX_INIT_FAIL
+ */
+LCDStatus_t lcdTransportWriteNow(const uint8_t* seq, uint8_t size, uint16_t execUs);
+
+/**
+ * @brief Registers the driver's callbacks: start is called when the transport is free for a transfer after lcdTransportRequest, complete and error when it ends
+ * @param client pointer to the callbacks (must stay valid)
+ */
+LCDStatus_t lcdTransportRegister(const I2CBusClient_t* client);
+
+/**
+ * @brief Asks for the client's start callback, possibly right away from this call
+ * @note Safe to call from interrupts
+ */
+void lcdTransportRequest(void);
+
+/**
+ * @brief Appends the pin states of one queue entry to the next transfer
+ * @param seq pin states, the LCD latches the data lines on EN's falling edges
+ * @param size state count (up to LCD_TRANSPORT_MAX_SEQ)
+ * @param execUs time the controller needs after the sequence before it takes the next one [us]
+ * @return false if it doesn't fit, start the transfer first
+ */
+bool lcdTransportAppend(const uint8_t* seq, uint8_t size, uint16_t execUs);
+
+/**
+ * @brief Starts a transfer of the appended states, its completion is reported to the client. Whatever was appended is consumed, also if the start fails.
+ * @return LCD_OK or LCD_I2C_TX_INIT_FAIL
+ */
+LCDStatus_t lcdTransportStart(void);
+
+/**
+ * @brief Checks whether the transport can read the LCD back (busy flag)
+ * @return bool
+ */
+bool lcdTransportCanRead(void);
+
+/**
+ * @brief Starts a transfer that outputs two pin states, then reads the port back after a repeated start. Its completion is reported to the client like lcdTransportStart's.
+ * @param first pin state
+ * @param second pin state, held while the port is read
+ * @return LCD_OK, LCD_I2C_TX_INIT_FAIL or LCD_BUSY_FLAG_UNSUPPORTED
+ */
+LCDStatus_t lcdTransportStartRead(uint8_t first, uint8_t second);
+
+/**
+ * @brief Returns the port state read by the last lcdTransportStartRead transfer
+ * @return uint8_t
+ */
+uint8_t lcdTransportGetRead(void);
+
+/**
+ * @brief Checks whether the last transfer failed
+ * @return bool
+ */
+bool lcdTransportHasError(void);
+
+/**
+ * @brief Checks whether a transfer started by the transport is still in progress
+ * @return bool
+ */
+bool lcdTransportIsBusy(void);
+
+/**
+ * @brief Handles the I2C event interrupt if it belongs to the transport's transfer
+ * @return true if it did, the HAL handler mustn't run then
+ */
+bool lcdTransportEventIRQHandler(void);
+
+/**
+ * @brief Handles the I2C error interrupt if it belongs to the transport's transfer
+ * @return true if it did, the HAL handler mustn't run then
+ */
+bool lcdTransportErrorIRQHandler(void);
+
+/**
+ * @brief Handles the end of a GPIO transport's DMA transfer
+ */
+void lcdTransportDmaIRQHandler(void);
+
+#endif
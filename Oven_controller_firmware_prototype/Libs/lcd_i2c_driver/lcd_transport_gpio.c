@@ -0,0 +1,209 @@
+/**
+ * @file lcd_transport_gpio.c
+ * @brief LCD transport driving the HD44780 directly on GPIO pins in 4-bit mode. See lcd_transport.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The appended entries are expanded into BSRR words (lcd_bsrr.c) in an SRAM buffer. TIM6 overflows every LCD_BSRR_WORD_US and each update event makes DMA2 channel 3 copy the next word into the port's BSRR, so a transfer of a whole line runs without the CPU. The channel's transfer complete interrupt stops the timer and reports to the driver, which either hands over the next batch from the same interrupt or lets the transport go idle.
+ *
+ * The I2C bus isn't involved, so the transport has its own single-client version of the arbiter's request and grant logic: a request while a transfer is running is kept pending and the client is asked again when it ends.
+ *
+ * The words of a sequence already contain the controller's execution time, so a transfer can start right after the previous one. The first word is written one timer period after the start, like all the others.
+ */
+
+#include "lcd_transport.h"
+#include "lcd_bsrr.h"
+#include "stm32f3xx_ll_tim.h"
+#include "stm32f3xx_ll_dma.h"
+#include "ccmram.h"
+
+// hardware used by the transport (RS, EN and D4-D7 pin numbers are in lcd_bsrr.h)
+#define LCD_GPIO_PORT       GPIOC
+#define LCD_GPIO_TIM        TIM6
+#define LCD_GPIO_DMA        DMA2
+#define LCD_GPIO_CHANNEL    LL_DMA_CHANNEL_3    // TIM6 update request
+#define LCD_GPIO_DMA_IRQn   DMA2_Channel3_IRQn
+#define LCD_GPIO_PINS       ((1UL << LCD_BSRR_RS_PIN) | (1UL << LCD_BSRR_EN_PIN) | (0xFUL << LCD_BSRR_D4_PIN))
+
+static uint32_t words[LCD_BSRR_WORDS_MAX];   // DMA source, must stay in SRAM
+static uint16_t wordCount = 0;
+
+static const I2CBusClient_t* transportClient;
+static volatile bool claimed = false;   // the client was given the transport and hasn't released it
+static volatile bool pending = false;
+static volatile bool running = false;   // a DMA transfer is in progress
+
+// asks the client for transfers until it starts one, must be called with claimed set
+CCMRAM_FUNC static void grantNext(void) {
+    while (1) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        bool again = pending;
+        pending = false;
+        if (!again)
+            claimed = false;
+        __set_PRIMASK(primask);
+
+        if (!again || transportClient->start())
+            return;
+    }
+}
+
+/* API functions */
+
+void lcdTransportInit(I2C_HandleTypeDef* hi2c, uint8_t address) {
+    (void)hi2c;
+    (void)address;
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    LCD_GPIO_PORT->BSRR = lcdBsrrWord(0);   // all lines low before they become outputs
+    GPIO_InitTypeDef gpio = { 0 };
+    gpio.Pin = LCD_GPIO_PINS;
+    gpio.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(LCD_GPIO_PORT, &gpio);
+
+    // APB1 timers run at twice the bus clock when it's divided
+    uint32_t timClock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+        timClock *= 2;
+    LL_TIM_DisableCounter(LCD_GPIO_TIM);
+    LL_TIM_SetPrescaler(LCD_GPIO_TIM, 0);
+    LL_TIM_SetAutoReload(LCD_GPIO_TIM, timClock / 1000000 * LCD_BSRR_WORD_US - 1);
+    LL_TIM_GenerateEvent_UPDATE(LCD_GPIO_TIM); // load the prescaler
+    LL_TIM_ClearFlag_UPDATE(LCD_GPIO_TIM);
+
+    LL_DMA_DisableChannel(LCD_GPIO_DMA, LCD_GPIO_CHANNEL);
+    LL_DMA_ConfigTransfer(LCD_GPIO_DMA, LCD_GPIO_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL
+        | LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD
+        | LL_DMA_PRIORITY_HIGH);
+    LL_DMA_SetPeriphAddress(LCD_GPIO_DMA, LCD_GPIO_CHANNEL, (uint32_t)&LCD_GPIO_PORT->BSRR);
+    LL_DMA_EnableIT_TC(LCD_GPIO_DMA, LCD_GPIO_CHANNEL);
+    HAL_NVIC_SetPriority(LCD_GPIO_DMA_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(LCD_GPIO_DMA_IRQn);
+}
+
+LCDStatus_t lcdTransportWriteNow(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    if (running)
+        return LCD_I2C_TX_INIT_FAIL;
+    uint16_t count = lcdBsrrEncode(seq, size, execUs, words, LCD_BSRR_WORDS_MAX);
+    if (count == 0)
+        return LCD_I2C_TX_INIT_FAIL;
+
+    // one word per timer period, polled
+    LL_TIM_DisableDMAReq_UPDATE(LCD_GPIO_TIM);
+    LL_TIM_SetCounter(LCD_GPIO_TIM, 0);
+    LL_TIM_ClearFlag_UPDATE(LCD_GPIO_TIM);
+    LL_TIM_EnableCounter(LCD_GPIO_TIM);
+    for (uint16_t i = 0; i < count; i++) {
+        while (!LL_TIM_IsActiveFlag_UPDATE(LCD_GPIO_TIM));
+        LL_TIM_ClearFlag_UPDATE(LCD_GPIO_TIM);
+        LCD_GPIO_PORT->BSRR = words[i];
+    }
+    LL_TIM_DisableCounter(LCD_GPIO_TIM);
+    return LCD_OK;
+}
+
+LCDStatus_t lcdTransportRegister(const I2CBusClient_t* client) {
+    transportClient = client;
+    return LCD_OK;
+}
+
+CCMRAM_FUNC void lcdTransportRequest(void) {
+    if (transportClient == NULL)
+        return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pending = true;
+    bool idle = !claimed;
+    claimed = true;
+    __set_PRIMASK(primask);
+
+    if (idle)
+        grantNext();
+}
+
+CCMRAM_FUNC bool lcdTransportAppend(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    if (running)
+        return false;
+    uint16_t count = lcdBsrrEncode(seq, size, execUs, &words[wordCount], LCD_BSRR_WORDS_MAX - wordCount);
+    wordCount += count;
+    return count > 0;
+}
+
+CCMRAM_FUNC LCDStatus_t lcdTransportStart(void) {
+    uint16_t count = wordCount;
+    wordCount = 0;
+    if (running || count == 0)
+        return LCD_I2C_TX_INIT_FAIL;
+
+    LL_DMA_DisableChannel(LCD_GPIO_DMA, LCD_GPIO_CHANNEL);
+    LL_DMA_ClearFlag_GI3(LCD_GPIO_DMA);
+    LL_DMA_SetMemoryAddress(LCD_GPIO_DMA, LCD_GPIO_CHANNEL, (uint32_t)words);
+    LL_DMA_SetDataLength(LCD_GPIO_DMA, LCD_GPIO_CHANNEL, count);
+    LL_DMA_EnableChannel(LCD_GPIO_DMA, LCD_GPIO_CHANNEL);
+
+    // drop a request left over from the previous transfer's last period, so the first word waits a full one
+    LL_TIM_DisableDMAReq_UPDATE(LCD_GPIO_TIM);
+    LL_TIM_SetCounter(LCD_GPIO_TIM, 0);
+    LL_TIM_ClearFlag_UPDATE(LCD_GPIO_TIM);
+    LL_TIM_EnableDMAReq_UPDATE(LCD_GPIO_TIM);
+
+    running = true;
+    LL_TIM_EnableCounter(LCD_GPIO_TIM);
+    return LCD_OK;
+}
+
+bool lcdTransportCanRead(void) {
+    return false;   // R/W isn't wired, the pins are outputs only
+}
+
+LCDStatus_t lcdTransportStartRead(uint8_t first, uint8_t second) {
+    (void)first;
+    (void)second;
+    return LCD_BUSY_FLAG_UNSUPPORTED;
+}
+
+uint8_t lcdTransportGetRead(void) {
+    return 0;
+}
+
+CCMRAM_FUNC bool lcdTransportHasError(void) {
+    return false;   // nothing to acknowledge on GPIO
+}
+
+bool lcdTransportIsBusy(void) {
+    return running;
+}
+
+bool lcdTransportEventIRQHandler(void) {
+    return false;
+}
+
+bool lcdTransportErrorIRQHandler(void) {
+    return false;
+}
+
+CCMRAM_FUNC void lcdTransportDmaIRQHandler(void) {
+    if (!LL_DMA_IsActiveFlag_TC3(LCD_GPIO_DMA))
+        return;
+    LL_DMA_ClearFlag_GI3(LCD_GPIO_DMA);
+    LL_TIM_DisableCounter(LCD_GPIO_TIM);
+    LL_DMA_DisableChannel(LCD_GPIO_DMA, LCD_GPIO_CHANNEL);
+    running = false;
+
+    if (transportClient == NULL || !claimed)   // a transfer started directly, not through a request
+        return;
+    if (transportClient->onComplete()) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        pending = true;
+        __set_PRIMASK(primask);
+    }
+    grantNext();
+}
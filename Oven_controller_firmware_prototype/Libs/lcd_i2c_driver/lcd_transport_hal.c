@@ -0,0 +1,100 @@
+/**
+ * @file lcd_transport_hal.c
+ * @brief LCD transport on the STM's HAL. See lcd_transport.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Transfers are started with HAL_I2C_Master_Transmit_DMA. The HAL's DMA and I2C interrupt handlers run the transfer to its end and call the HAL completion or error callback, which the application routes to the i2c_bus arbiter. The handle's error code is kept until the next transfer starts, so it tells whether the last one on the bus failed.
+ *
+ * A transfer holds one entry. At the expander's byte time (about 90 us at 100 kHz) each byte outlasts the controller's usual execution time, the driver's dummy entries or busy flag reads cover the longer ones.
+ */
+
+#include "lcd_transport.h"
+#include "ccmram.h"
+
+static I2C_HandleTypeDef* transportHi2c;
+static uint8_t transportAddress;
+static uint8_t busId;
+
+static uint8_t buffer[LCD_TRANSPORT_MAX_SEQ];   // DMA source, must stay in SRAM
+static uint8_t bufferSize = 0;
+static uint8_t readBuffer;                      // DMA destination, must stay in SRAM
+
+/* API functions */
+
+void lcdTransportInit(I2C_HandleTypeDef* hi2c, uint8_t address) {
+    transportHi2c = hi2c;
+    transportAddress = address;
+}
+
+LCDStatus_t lcdTransportWriteNow(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    (void)execUs;   // shorter than the transfer itself
+    uint8_t states[LCD_TRANSPORT_MAX_SEQ];
+    for (uint8_t i = 0; i < size; i++)
+        states[i] = seq[i];
+    if (HAL_I2C_Master_Transmit(transportHi2c, transportAddress, states, size, 1000) != HAL_OK)
+        return LCD_I2C_TX_INIT_FAIL;
+    return LCD_OK;
+}
+
+LCDStatus_t lcdTransportRegister(const I2CBusClient_t* client) {
+    if (i2cBusRegister(client, &busId) != I2C_BUS_OK)
+        return LCD_I2C_BUS_FULL;
+    return LCD_OK;
+}
+
+void lcdTransportRequest(void) {
+    i2cBusRequest(busId);
+}
+
+CCMRAM_FUNC bool lcdTransportAppend(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    (void)execUs;
+    if (bufferSize != 0)
+        return false;
+    for (uint8_t i = 0; i < size; i++)
+        buffer[i] = seq[i];
+    bufferSize = size;
+    return true;
+}
+
+CCMRAM_FUNC LCDStatus_t lcdTransportStart(void) {
+    uint8_t size = bufferSize;
+    bufferSize = 0;
+    if (HAL_I2C_Master_Transmit_DMA(transportHi2c, transportAddress, buffer, size) != HAL_OK)
+        return LCD_I2C_TX_INIT_FAIL;
+    return LCD_OK;
+}
+
+CCMRAM_FUNC bool lcdTransportCanRead(void) {
+    return true;
+}
+
+// the states go out as a 16-bit memory address, MSB first
+CCMRAM_FUNC LCDStatus_t lcdTransportStartRead(uint8_t first, uint8_t second) {
+    if (HAL_I2C_Mem_Read_DMA(transportHi2c, transportAddress, (uint16_t)((first << 8) | second), I2C_MEMADD_SIZE_16BIT, &readBuffer, 1) != HAL_OK)
+        return LCD_I2C_TX_INIT_FAIL;
+    return LCD_OK;
+}
+
+CCMRAM_FUNC uint8_t lcdTransportGetRead(void) {
+    return readBuffer;
+}
+
+CCMRAM_FUNC bool lcdTransportHasError(void) {
+    return HAL_I2C_GetError(transportHi2c) != HAL_I2C_ERROR_NONE;
+}
+
+bool lcdTransportIsBusy(void) {
+    return HAL_I2C_GetState(transportHi2c) != HAL_I2C_STATE_READY;
+}
+
+bool lcdTransportEventIRQHandler(void) {
+    return false;
+}
+
+bool lcdTransportErrorIRQHandler(void) {
+    return false;
+}
+
+void lcdTransportDmaIRQHandler(void) {
+}
@@ -0,0 +1,185 @@
+/**
+ * @file lcd_transport_ll.c
+ * @brief LCD transport on the LL register interface. See lcd_transport.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * A transfer is a single write in automatic end mode: the DMA channel feeds TXDR and the peripheral sends the STOP after the last byte, so the CPU only sees the STOP (or NACK) event at the end. No DMA interrupt is enabled. The event handler clears the transfer's interrupt and DMA enables, so that HAL transfers of the other clients find the peripheral the way the HAL leaves it, and reports to the arbiter. When the LCD keeps the bus, the arbiter calls the driver back from the same interrupt and lcdTransportStart reloads the DMA channel with the next entry.
+ *
+ * The DMA channel is configured once in lcdTransportInit (memory to peripheral, bytes, memory increment), so starting a transfer only writes the memory address and the count. Like the HAL transport, a transfer holds one entry and the blocking writes of the initialisation go through the HAL, as do the busy flag reads (the event handler leaves transfers it didn't start to the HAL).
+ */
+
+#include "lcd_transport.h"
+#include "stm32f3xx_ll_i2c.h"
+#include "stm32f3xx_ll_dma.h"
+#include "ccmram.h"
+
+static I2C_HandleTypeDef* transportHi2c;
+static I2C_TypeDef* transportI2c;
+static DMA_TypeDef* transportDma;
+static uint32_t transportChannel;
+static uint32_t transportFlagsClear;    // clears all of the channel's DMA flags
+static uint8_t transportAddress;
+static uint8_t busId;
+
+static uint8_t buffer[LCD_TRANSPORT_MAX_SEQ];   // DMA source, must stay in SRAM
+static uint8_t bufferSize = 0;
+static uint8_t readBuffer;                      // DMA destination, must stay in SRAM
+
+static volatile bool busy = false;
+static volatile bool failed = false;    // the current transfer was NACKed or hit a bus error
+static volatile bool lastFailed = false;
+static bool lastWasRead = false;        // the last transfer was a HAL read, its error is in the handle
+
+// leaves the peripheral and the DMA channel as the HAL expects them and reports to the arbiter
+CCMRAM_FUNC static void finish(void) {
+    LL_I2C_DisableIT_STOP(transportI2c);
+    LL_I2C_DisableIT_NACK(transportI2c);
+    LL_I2C_DisableIT_ERR(transportI2c);
+    LL_I2C_DisableDMAReq_TX(transportI2c);
+    LL_DMA_DisableChannel(transportDma, transportChannel);
+    transportDma->IFCR = transportFlagsClear;
+    transportI2c->CR2 = 0;
+
+    lastFailed = failed;
+    busy = false;
+    if (lastFailed)
+        i2cBusErrorHandler();
+    else
+        i2cBusTransferCompleteHandler();
+}
+
+/* API functions */
+
+void lcdTransportInit(I2C_HandleTypeDef* hi2c, uint8_t address) {
+    transportHi2c = hi2c;
+    transportI2c = hi2c->Instance;
+    transportDma = hi2c->hdmatx->DmaBaseAddress;
+    transportChannel = (hi2c->hdmatx->ChannelIndex >> 2) + LL_DMA_CHANNEL_1;
+    transportFlagsClear = DMA_IFCR_CGIF1 << hi2c->hdmatx->ChannelIndex;
+    transportAddress = address;
+
+    LL_DMA_DisableChannel(transportDma, transportChannel);
+    LL_DMA_ConfigTransfer(transportDma, transportChannel, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL
+        | LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE
+        | LL_DMA_PRIORITY_LOW);
+    LL_DMA_SetPeriphAddress(transportDma, transportChannel, LL_I2C_DMA_GetRegAddr(transportI2c, LL_I2C_DMA_REG_DATA_TRANSMIT));
+    LL_DMA_DisableIT_TC(transportDma, transportChannel);
+    LL_DMA_DisableIT_HT(transportDma, transportChannel);
+    LL_DMA_DisableIT_TE(transportDma, transportChannel);
+}
+
+LCDStatus_t lcdTransportWriteNow(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    (void)execUs;   // shorter than the transfer itself
+    uint8_t states[LCD_TRANSPORT_MAX_SEQ];
+    for (uint8_t i = 0; i < size; i++)
+        states[i] = seq[i];
+    if (HAL_I2C_Master_Transmit(transportHi2c, transportAddress, states, size, 1000) != HAL_OK)
+        return LCD_I2C_TX_INIT_FAIL;
+    return LCD_OK;
+}
+
+LCDStatus_t lcdTransportRegister(const I2CBusClient_t* client) {
+    if (i2cBusRegister(client, &busId) != I2C_BUS_OK)
+        return LCD_I2C_BUS_FULL;
+    return LCD_OK;
+}
+
+void lcdTransportRequest(void) {
+    i2cBusRequest(busId);
+}
+
+CCMRAM_FUNC bool lcdTransportAppend(const uint8_t* seq, uint8_t size, uint16_t execUs) {
+    (void)execUs;
+    if (bufferSize != 0)
+        return false;
+    for (uint8_t i = 0; i < size; i++)
+        buffer[i] = seq[i];
+    bufferSize = size;
+    return true;
+}
+
+CCMRAM_FUNC LCDStatus_t lcdTransportStart(void) {
+    uint8_t size = bufferSize;
+    bufferSize = 0;
+    if (busy || LL_I2C_IsActiveFlag_BUSY(transportI2c))
+        return LCD_I2C_TX_INIT_FAIL;
+
+    LL_DMA_DisableChannel(transportDma, transportChannel);
+    transportDma->IFCR = transportFlagsClear;
+    LL_DMA_SetMemoryAddress(transportDma, transportChannel, (uint32_t)buffer);
+    LL_DMA_SetDataLength(transportDma, transportChannel, size);
+    LL_DMA_EnableChannel(transportDma, transportChannel);
+
+    LL_I2C_ClearFlag_STOP(transportI2c);
+    LL_I2C_ClearFlag_NACK(transportI2c);
+    LL_I2C_EnableDMAReq_TX(transportI2c);
+    LL_I2C_EnableIT_STOP(transportI2c);
+    LL_I2C_EnableIT_NACK(transportI2c);
+    LL_I2C_EnableIT_ERR(transportI2c);
+
+    failed = false;
+    lastWasRead = false;
+    busy = true;
+    LL_I2C_HandleTransfer(transportI2c, transportAddress, LL_I2C_ADDRSLAVE_7BIT, size, LL_I2C_MODE_AUTOEND, LL_I2C_GENERATE_START_WRITE);
+    return LCD_OK;
+}
+
+CCMRAM_FUNC bool lcdTransportCanRead(void) {
+    return true;
+}
+
+// a short and rare transfer, left to the HAL like the sensors' reads: the states go out as a 16-bit memory address, MSB first
+CCMRAM_FUNC LCDStatus_t lcdTransportStartRead(uint8_t first, uint8_t second) {
+    lastWasRead = true;
+    if (busy || HAL_I2C_Mem_Read_DMA(transportHi2c, transportAddress, (uint16_t)((first << 8) | second), I2C_MEMADD_SIZE_16BIT, &readBuffer, 1) != HAL_OK)
+        return LCD_I2C_TX_INIT_FAIL;
+    return LCD_OK;
+}
+
+CCMRAM_FUNC uint8_t lcdTransportGetRead(void) {
+    return readBuffer;
+}
+
+CCMRAM_FUNC bool lcdTransportHasError(void) {
+    if (lastWasRead)
+        return HAL_I2C_GetError(transportHi2c) != HAL_I2C_ERROR_NONE;
+    return lastFailed;
+}
+
+bool lcdTransportIsBusy(void) {
+    return busy;
+}
+
+CCMRAM_FUNC bool lcdTransportEventIRQHandler(void) {
+    if (!busy)
+        return false;
+
+    if (LL_I2C_IsActiveFlag_NACK(transportI2c)) {   // the STOP follows automatically
+        LL_I2C_ClearFlag_NACK(transportI2c);
+        LL_I2C_ClearFlag_TXE(transportI2c);         // flush the byte the DMA already wrote
+        failed = true;
+    }
+    if (LL_I2C_IsActiveFlag_STOP(transportI2c)) {
+        LL_I2C_ClearFlag_STOP(transportI2c);
+        finish();
+    }
+    return true;
+}
+
+bool lcdTransportErrorIRQHandler(void) {
+    if (!busy)
+        return false;
+
+    // bus error or lost arbitration, the peripheral has released the bus and won't send the STOP
+    LL_I2C_ClearFlag_BERR(transportI2c);
+    LL_I2C_ClearFlag_ARLO(transportI2c);
+    LL_I2C_ClearFlag_OVR(transportI2c);
+    LL_I2C_ClearFlag_TXE(transportI2c);
+    failed = true;
+    finish();
+    return true;
+}
+
+void lcdTransportDmaIRQHandler(void) {
+}
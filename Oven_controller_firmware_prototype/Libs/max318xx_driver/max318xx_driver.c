@@ -0,0 +1,251 @@
+/**
+ * @file max318xx_driver.c
+ * @brief MAX31855/MAX31856 thermocouple converter driver implementation for STM32. See max318xx_driver.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * This file implements a non-blocking, DMA-based driver for several thermocouple converters sharing one SPI bus. A round reads the sensors one after another: the completion interrupt of each transfer releases its chip select, decodes and publishes the reading, and starts the next transfer. DMA and SPI are handled using the STM's HAL.
+ *
+ * Each published reading is guarded by a sequence counter that is odd while the interrupt writes it. max318xxGetReading retries the copy until it sees the same even value before and after it.
+ */
+
+#include "max318xx_driver.h"
+
+/* HARDWARE ABSTRACTION */
+
+// MAX31855: one 32-bit read-only frame, SPI mode 0
+#define MAX31855_FRAME_LEN          4
+#define MAX31855_FAULT_MASK         (uint32_t)0x07  // SCV, SCG, OC in bits 2..0, same order as MAX318XX_FAULT_*
+
+// MAX31856: register access, SPI mode 1 (or 3)
+#define MAX31856_WRITE_BIT          (uint8_t)0x80
+#define MAX31856_CR0                (uint8_t)0x00
+#define MAX31856_CJTH               (uint8_t)0x0A   // burst read from here: CJTH, CJTL, LTCBH, LTCBM, LTCBL, SR
+#define MAX31856_READ_LEN           7               // address byte + 6 data bytes
+
+#define CR0_CMODE_AUTO              (uint8_t)0x80
+#define CR0_OCFAULT_1               (uint8_t)0x10
+#define CR0_FILTER_50HZ             (uint8_t)0x01
+#define CR1_AVG_1                   (uint8_t)0x00
+#define CR1_TC_TYPE_K               (uint8_t)0x03
+
+#define SR_OPEN                     (uint8_t)0x01
+#define SR_OVUV                     (uint8_t)0x02
+#define SR_TC_LOW                   (uint8_t)0x04
+#define SR_TC_HIGH                  (uint8_t)0x08
+#define SR_CJ_LOW                   (uint8_t)0x10
+#define SR_CJ_HIGH                  (uint8_t)0x20
+#define SR_TC_RANGE                 (uint8_t)0x40
+#define SR_CJ_RANGE                 (uint8_t)0x80
+
+#define CONFIG_TIMEOUT_MS           10
+
+#define BUFFER_LEN                  MAX31856_READ_LEN
+
+/* DRIVER STATE */
+
+typedef struct Sensor_t {
+    MAX318xxType_t type;
+    GPIO_TypeDef* csPort;
+    uint16_t csPin;
+} Sensor_t;
+
+static SPI_HandleTypeDef* max318xxhspi;
+static Sensor_t sensors[MAX318XX_MAX_SENSORS];
+static uint8_t sensorCount = 0;
+
+static volatile MAX318xxReading_t readings[MAX318XX_MAX_SENSORS];
+static volatile uint32_t readingSeq[MAX318XX_MAX_SENSORS];     // odd while a reading is being written, 0 = never written
+
+static uint8_t txBuffer[BUFFER_LEN];
+static uint8_t rxBuffer[BUFFER_LEN];
+
+static volatile bool roundInProgress = false;
+static volatile uint8_t current = 0;
+static volatile uint32_t roundCount = 0;
+static volatile MAX318xxStatus_t max318xxStatus = MAX318XX_OK;
+
+/* HANDLING AND SENDING DATA */
+
+static void setClockPhase(MAX318xxType_t type) {
+    uint32_t phase = (type == MAX318XX_TYPE_MAX31856) ? SPI_PHASE_2EDGE : SPI_PHASE_1EDGE;
+    if (max318xxhspi->Init.CLKPhase == phase)
+        return;
+    // CPHA can only be changed with the peripheral disabled, the HAL enables it again at the start of the next transfer
+    __HAL_SPI_DISABLE(max318xxhspi);
+    MODIFY_REG(max318xxhspi->Instance->CR1, SPI_CR1_CPHA, phase);
+    max318xxhspi->Init.CLKPhase = phase;
+}
+
+static MAX318xxStatus_t startTransfer(uint8_t i) {
+    Sensor_t* s = &sensors[i];
+    uint16_t len;
+    setClockPhase(s->type);
+    for (uint8_t k = 0; k < BUFFER_LEN; k++)
+        txBuffer[k] = 0;
+    if (s->type == MAX318XX_TYPE_MAX31856) {
+        txBuffer[0] = MAX31856_CJTH;
+        len = MAX31856_READ_LEN;
+    } else {
+        len = MAX31855_FRAME_LEN;
+    }
+
+    HAL_GPIO_WritePin(s->csPort, s->csPin, GPIO_PIN_RESET);
+    if (HAL_SPI_TransmitReceive_DMA(max318xxhspi, txBuffer, rxBuffer, len) != HAL_OK) {
+        HAL_GPIO_WritePin(s->csPort, s->csPin, GPIO_PIN_SET);
+        return MAX318XX_SPI_INIT_FAIL;
+    }
+    return MAX318XX_OK;
+}
+
+static void decodeMax31855(MAX318xxReading_t* r) {
+    uint32_t frame = ((uint32_t)rxBuffer[0] << 24) | ((uint32_t)rxBuffer[1] << 16) | ((uint32_t)rxBuffer[2] << 8) | rxBuffer[3];
+    int32_t tc = (int32_t)frame >> 18;                  // 14-bit signed, 0.25 degC
+    int32_t cj = (int32_t)(frame << 16) >> 20;          // 12-bit signed, 0.0625 degC
+    r->temperature = tc * (1 << 14);
+    r->coldJunction = cj * (1 << 12);
+    r->faults = (uint8_t)(frame & MAX31855_FAULT_MASK);
+}
+
+static void decodeMax31856(MAX318xxReading_t* r) {
+    const uint8_t* d = &rxBuffer[1];
+    int32_t cj = (int16_t)(((uint16_t)d[0] << 8) | d[1]) >> 2;                                    // 14-bit signed, 2^-6 degC
+    int32_t tc = (int32_t)(((uint32_t)d[2] << 24) | ((uint32_t)d[3] << 16) | ((uint32_t)d[4] << 8)) >> 13;   // 19-bit signed, 2^-7 degC
+    uint8_t sr = d[5];
+    r->temperature = tc * (1 << 9);
+    r->coldJunction = cj * (1 << 10);
+
+    uint8_t f = 0;
+    if (sr & SR_OPEN) f |= MAX318XX_FAULT_OPEN;
+    if (sr & SR_OVUV) f |= MAX318XX_FAULT_OVUV;
+    if (sr & (SR_TC_LOW | SR_TC_HIGH)) f |= MAX318XX_FAULT_TC_LIMIT;
+    if (sr & (SR_CJ_LOW | SR_CJ_HIGH)) f |= MAX318XX_FAULT_CJ_LIMIT;
+    if (sr & SR_TC_RANGE) f |= MAX318XX_FAULT_TC_RANGE;
+    if (sr & SR_CJ_RANGE) f |= MAX318XX_FAULT_CJ_RANGE;
+    r->faults = f;
+}
+
+static void publish(uint8_t i, const MAX318xxReading_t* r) {
+    readingSeq[i]++;
+    readings[i].temperature = r->temperature;
+    readings[i].coldJunction = r->coldJunction;
+    readings[i].faults = r->faults;
+    readings[i].timestamp = r->timestamp;
+    readings[i].round = r->round;
+    readingSeq[i]++;
+}
+
+/* API functions */
+
+void max318xxInit(SPI_HandleTypeDef* hspi) {
+    max318xxhspi = hspi;
+    sensorCount = 0;
+    roundInProgress = false;
+    roundCount = 0;
+    max318xxStatus = MAX318XX_OK;
+}
+
+MAX318xxStatus_t max318xxAddSensor(MAX318xxType_t type, GPIO_TypeDef* csPort, uint16_t csPin, uint8_t* index) {
+    if (sensorCount >= MAX318XX_MAX_SENSORS)
+        return MAX318XX_TOO_MANY_SENSORS;
+
+    Sensor_t* s = &sensors[sensorCount];
+    s->type = type;
+    s->csPort = csPort;
+    s->csPin = csPin;
+    HAL_GPIO_WritePin(csPort, csPin, GPIO_PIN_SET);
+
+    if (type == MAX318XX_TYPE_MAX31856) {
+        // CR0 and CR1 in one burst write
+        uint8_t config[3] = { MAX31856_CR0 | MAX31856_WRITE_BIT, CR0_CMODE_AUTO | CR0_OCFAULT_1 | CR0_FILTER_50HZ, CR1_AVG_1 | CR1_TC_TYPE_K };
+        setClockPhase(type);
+        HAL_GPIO_WritePin(csPort, csPin, GPIO_PIN_RESET);
+        HAL_StatusTypeDef result = HAL_SPI_Transmit(max318xxhspi, config, sizeof(config), CONFIG_TIMEOUT_MS);
+        HAL_GPIO_WritePin(csPort, csPin, GPIO_PIN_SET);
+        if (result != HAL_OK)
+            return MAX318XX_SPI_INIT_FAIL;
+    }
+
+    readingSeq[sensorCount] = 0;
+    *index = sensorCount++;
+    return MAX318XX_OK;
+}
+
+MAX318xxStatus_t max318xxStartRound(void) {
+    if (roundInProgress)
+        return MAX318XX_BUSY;
+    if (sensorCount == 0)
+        return MAX318XX_OK;
+
+    roundInProgress = true;
+    current = 0;
+    max318xxStatus = startTransfer(0);
+    if (max318xxStatus != MAX318XX_OK)
+        roundInProgress = false;
+    return max318xxStatus;
+}
+
+bool max318xxIsBusy(void) {
+    return roundInProgress;
+}
+
+MAX318xxStatus_t max318xxGetReading(uint8_t index, MAX318xxReading_t* reading) {
+    if (index >= sensorCount)
+        return MAX318XX_NO_READING;
+    uint32_t seq;
+    do {
+        seq = readingSeq[index];
+        if (seq == 0)
+            return MAX318XX_NO_READING;
+        reading->temperature = readings[index].temperature;
+        reading->coldJunction = readings[index].coldJunction;
+        reading->faults = readings[index].faults;
+        reading->timestamp = readings[index].timestamp;
+        reading->round = readings[index].round;
+    } while ((seq & 1U) || seq != readingSeq[index]);
+    return MAX318XX_OK;
+}
+
+uint32_t max318xxGetRoundCount(void) {
+    return roundCount;
+}
+
+void max318xxTransferCompleteHandler(void) {
+    if (!roundInProgress)
+        return;
+    uint8_t i = current;
+    Sensor_t* s = &sensors[i];
+    HAL_GPIO_WritePin(s->csPort, s->csPin, GPIO_PIN_SET);
+
+    MAX318xxReading_t r;
+    if (s->type == MAX318XX_TYPE_MAX31856)
+        decodeMax31856(&r);
+    else
+        decodeMax31855(&r);
+    r.timestamp = HAL_GetTick();
+    r.round = roundCount + 1;
+    publish(i, &r);
+
+    if (++i < sensorCount) {
+        current = i;
+        max318xxStatus = startTransfer(i);
+        if (max318xxStatus == MAX318XX_OK)
+            return;
+    } else {
+        roundCount++;
+    }
+    roundInProgress = false;
+}
+
+void max318xxSpiErrorHandler(void) {
+    if (!roundInProgress)
+        return;
+    Sensor_t* s = &sensors[current];
+    HAL_GPIO_WritePin(s->csPort, s->csPin, GPIO_PIN_SET);
+    max318xxStatus = MAX318XX_SPI_ERROR;
+    roundInProgress = false;
+}
+
+MAX318xxStatus_t max318xxGetStatus(void) {
+    return max318xxStatus;
+}
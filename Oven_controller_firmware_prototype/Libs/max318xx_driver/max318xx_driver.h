@@ -0,0 +1,136 @@
+/**
+ * @file max318xx_driver.h
+ * @brief Public API for the MAX31855/MAX31856 thermocouple converter driver for STM32. See max318xx_driver.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Reads all registered converters in one burst: each transfer is started from the previous one's completion interrupt, with its own chip select
+- Asynchronous DMA-based transfers (no blocking, except for the MAX31856 configuration in max318xxAddSensor)
+- MAX31855 and MAX31856 on the same bus, the SPI clock phase is switched per chip
+- Fault bits decoded into a common format
+- Readings are timestamped and published with a sequence counter, so the main loop never sees a half-written reading
+- DMA and SPI are handled using the STM's HAL
+
+# Limitations
+- Both converters update their results about every 100 ms, reading them more often only returns the same values
+- The MAX31856 is configured for type K, continuous conversion and 50 Hz mains rejection
+
+# Requirements:
+- Replace the included stm32f3xx_hal.h file according to your MCU
+- Enable SPI and its RX/TX DMA interrupts
+- Chip select pins configured as push-pull outputs, initially high
+- In your main program file, implement HAL_SPI_TxRxCpltCallback and HAL_SPI_ErrorCallback according to these minimal examples:
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi == &hspi2)
+        max318xxTransferCompleteHandler();
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) {
+    if (hspi == &hspi2)
+        max318xxSpiErrorHandler();
+}
+*/
+
+#ifndef MAX318XX_DRIVER_H
+#define MAX318XX_DRIVER_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+
+#define MAX318XX_MAX_SENSORS    4
+
+// fault bits (common for both chips, a MAX31855 only reports the first three)
+#define MAX318XX_FAULT_OPEN         (uint8_t)0x01   // thermocouple open circuit
+#define MAX318XX_FAULT_SHORT_GND    (uint8_t)0x02   // MAX31855: short to GND
+#define MAX318XX_FAULT_SHORT_VCC    (uint8_t)0x04   // MAX31855: short to VCC
+#define MAX318XX_FAULT_OVUV         (uint8_t)0x08   // MAX31856: input over/under voltage
+#define MAX318XX_FAULT_TC_RANGE     (uint8_t)0x10   // MAX31856: thermocouple temperature out of range
+#define MAX318XX_FAULT_CJ_RANGE     (uint8_t)0x20   // MAX31856: cold junction out of range
+#define MAX318XX_FAULT_TC_LIMIT     (uint8_t)0x40   // MAX31856: thermocouple temperature above/below the set limits
+#define MAX318XX_FAULT_CJ_LIMIT     (uint8_t)0x80   // MAX31856: cold junction temperature above/below the set limits
+
+/* Status info */
+
+typedef enum MAX318xxStatus_t {
+    MAX318XX_OK,
+    MAX318XX_BUSY,              // A round is already in progress. The new one isn't started.
+    MAX318XX_TOO_MANY_SENSORS,  // MAX318XX_MAX_SENSORS are already registered.
+    MAX318XX_SPI_INIT_FAIL,     // Failed to start an SPI DMA transfer or to configure a MAX31856. The round is aborted.
+    MAX318XX_SPI_ERROR,         // The SPI reported an error during a transfer. The round is aborted.
+    MAX318XX_NO_READING,        // The sensor hasn't been read successfully yet.
+} MAX318xxStatus_t;
+
+typedef enum MAX318xxType_t {
+    MAX318XX_TYPE_MAX31855,
+    MAX318XX_TYPE_MAX31856,
+} MAX318xxType_t;
+
+typedef struct MAX318xxReading_t {
+    int32_t temperature;        // thermocouple temperature [degC, Q16]
+    int32_t coldJunction;       // cold-junction (chip) temperature [degC, Q16]
+    uint8_t faults;             // MAX318XX_FAULT_* bits
+    uint32_t timestamp;         // HAL tick at the end of the transfer [ms]
+    uint32_t round;             // number of the round the reading comes from
+} MAX318xxReading_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the driver
+ * @param hspi pointer to HAL's SPI handle struct (8-bit, master, software NSS, up to 5 MHz)
+ */
+void max318xxInit(SPI_HandleTypeDef* hspi);
+
+/**
+ * @brief Registers a converter. Sensors are read in the order of registration.
+ * @note Configures a MAX31856 with a blocking transfer. Call before starting any rounds.
+ * @param type chip type
+ * @param csPort chip select GPIO port
+ * @param csPin chip select GPIO pin
+ * @param index returns the sensor's index for max318xxGetReading
+ */
+MAX318xxStatus_t max318xxAddSensor(MAX318xxType_t type, GPIO_TypeDef* csPort, uint16_t csPin, uint8_t* index);
+
+/**
+ * @brief Starts reading all registered sensors, returns immediately
+ */
+MAX318xxStatus_t max318xxStartRound(void);
+
+/**
+ * @brief Checks whether a round is in progress
+ * @return bool
+ */
+bool max318xxIsBusy(void);
+
+/**
+ * @brief Copies the latest reading of a sensor
+ * @param index sensor index from max318xxAddSensor
+ * @param reading output
+ * @return MAX318XX_NO_READING if the sensor hasn't been read yet
+ */
+MAX318xxStatus_t max318xxGetReading(uint8_t index, MAX318xxReading_t* reading);
+
+/**
+ * @brief Returns the number of completed rounds
+ */
+uint32_t max318xxGetRoundCount(void);
+
+/**
+ * @brief Function to be called inside HAL_SPI_TxRxCpltCallback
+ */
+void max318xxTransferCompleteHandler(void);
+
+/**
+ * @brief Function to be called inside HAL_SPI_ErrorCallback. It releases the chip select and aborts the round.
+ */
+void max318xxSpiErrorHandler(void);
+
+/**
+ * @brief Returns the driver's status
+ * @return MAX318xxStatus_t
+ */
+MAX318xxStatus_t max318xxGetStatus(void);
+
+#endif
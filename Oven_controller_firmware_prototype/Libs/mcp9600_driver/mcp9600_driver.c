@@ -0,0 +1,190 @@
+/**
+ * @file mcp9600_driver.c
+ * @brief MCP9600 thermocouple EMF-to-temperature converter driver implementation for STM32. See mcp9600_driver.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * This file implements a non-blocking, DMA-based driver for MCP9600 converters on an I2C bus shared through the i2c_bus arbiter. A round reads the hot-junction and cold-junction registers of every sensor, one register per bus grant, so the LCD queue keeps flowing between the reads. DMA and I2C are handled using the STM's HAL.
+ *
+ * The converters run continuously, so a round is started every MCP9600_READ_PERIOD_MS (slightly longer than one conversion) and every round returns new results without reading the status register first.
+ *
+ * Each published reading is guarded by a sequence counter that is odd while the interrupt writes it, same as in the MAX318xx driver.
+ */
+
+#include "mcp9600_driver.h"
+
+/* HARDWARE ABSTRACTION */
+
+#define REG_HOT_JUNCTION            (uint8_t)0x00   // 16-bit signed, 0.0625 degC
+#define REG_COLD_JUNCTION           (uint8_t)0x02   // 16-bit signed, 0.0625 degC
+#define REG_SENSOR_CONFIG           (uint8_t)0x05
+#define REG_DEVICE_CONFIG           (uint8_t)0x06
+#define REG_DEVICE_ID               (uint8_t)0x20
+
+#define DEVICE_ID_MCP9600           (uint8_t)0x40
+
+#define SC_TYPE_K                   (uint8_t)0x00
+#define SC_FILTER_OFF               (uint8_t)0x00
+
+#define DC_CJ_RES_0_0625            (uint8_t)0x00
+#define DC_ADC_RES_16BIT            (uint8_t)0x20
+#define DC_BURST_1                  (uint8_t)0x00
+#define DC_MODE_NORMAL              (uint8_t)0x00
+
+#define CONFIG_TIMEOUT_MS           10
+
+/* DRIVER STATE */
+
+typedef enum Step_t {
+    STEP_HOT_JUNCTION,
+    STEP_COLD_JUNCTION,
+} Step_t;
+
+static uint8_t addresses[MCP9600_MAX_SENSORS];
+static uint8_t sensorCount = 0;
+static uint8_t busId;
+
+static volatile MCP9600Reading_t readings[MCP9600_MAX_SENSORS];
+static volatile uint32_t readingSeq[MCP9600_MAX_SENSORS];      // odd while a reading is being written, 0 = never written
+
+static uint8_t rxBuffer[2];
+static int32_t hotJunction;     // first half of the reading in progress
+
+static volatile bool roundInProgress = false;
+static volatile uint8_t current = 0;
+static volatile Step_t step = STEP_HOT_JUNCTION;
+static uint32_t roundStart = 0;
+static volatile uint32_t roundCount = 0;
+static volatile MCP9600Status_t mcp9600Status = MCP9600_OK;
+
+/* HANDLING AND SENDING DATA */
+
+static int32_t decodeTemperature(void) {
+    int32_t t = (int16_t)(((uint16_t)rxBuffer[0] << 8) | rxBuffer[1]);  // 2^-4 degC
+    return t * (1 << 12);
+}
+
+static void publish(uint8_t i, int32_t temperature, int32_t coldJunction) {
+    readingSeq[i]++;
+    readings[i].temperature = temperature;
+    readings[i].coldJunction = coldJunction;
+    readings[i].timestamp = HAL_GetTick();
+    readings[i].round = roundCount + 1;
+    readingSeq[i]++;
+}
+
+/* I2C bus client */
+
+static bool busStart(void) {
+    if (!roundInProgress)
+        return false;
+    uint8_t reg = (step == STEP_HOT_JUNCTION) ? REG_HOT_JUNCTION : REG_COLD_JUNCTION;
+    if (HAL_I2C_Mem_Read_DMA(i2cBusGetHandle(), addresses[current], reg, I2C_MEMADD_SIZE_8BIT, rxBuffer, sizeof(rxBuffer)) != HAL_OK) {
+        mcp9600Status = MCP9600_I2C_INIT_FAIL;
+        roundInProgress = false;
+        return false;
+    }
+    return true;
+}
+
+static bool busComplete(void) {
+    if (!roundInProgress)
+        return false;
+    if (step == STEP_HOT_JUNCTION) {
+        hotJunction = decodeTemperature();
+        step = STEP_COLD_JUNCTION;
+        return true;
+    }
+
+    publish(current, hotJunction, decodeTemperature());
+    step = STEP_HOT_JUNCTION;
+    if (++current < sensorCount)
+        return true;
+
+    roundCount++;
+    mcp9600Status = MCP9600_OK;
+    roundInProgress = false;
+    return false;
+}
+
+static bool busError(void) {
+    mcp9600Status = MCP9600_I2C_ERROR;
+    roundInProgress = false;
+    return false;
+}
+
+static const I2CBusClient_t busClient = { busStart, busComplete, busError };
+
+/* API functions */
+
+MCP9600Status_t mcp9600Init(void) {
+    sensorCount = 0;
+    roundInProgress = false;
+    roundCount = 0;
+    mcp9600Status = MCP9600_OK;
+    if (i2cBusRegister(&busClient, &busId) != I2C_BUS_OK)
+        return MCP9600_BUS_FULL;
+    return MCP9600_OK;
+}
+
+MCP9600Status_t mcp9600AddSensor(uint8_t address, uint8_t* index) {
+    if (sensorCount >= MCP9600_MAX_SENSORS)
+        return MCP9600_TOO_MANY_SENSORS;
+
+    I2C_HandleTypeDef* hi2c = i2cBusGetHandle();
+    uint16_t devAddress = (uint16_t)address << 1;
+    uint8_t id[2];
+    if (HAL_I2C_Mem_Read(hi2c, devAddress, REG_DEVICE_ID, I2C_MEMADD_SIZE_8BIT, id, sizeof(id), CONFIG_TIMEOUT_MS) != HAL_OK || id[0] != DEVICE_ID_MCP9600)
+        return MCP9600_NOT_FOUND;
+
+    uint8_t sensorConfig = SC_TYPE_K | SC_FILTER_OFF;
+    uint8_t deviceConfig = DC_CJ_RES_0_0625 | DC_ADC_RES_16BIT | DC_BURST_1 | DC_MODE_NORMAL;
+    if (HAL_I2C_Mem_Write(hi2c, devAddress, REG_SENSOR_CONFIG, I2C_MEMADD_SIZE_8BIT, &sensorConfig, 1, CONFIG_TIMEOUT_MS) != HAL_OK
+        || HAL_I2C_Mem_Write(hi2c, devAddress, REG_DEVICE_CONFIG, I2C_MEMADD_SIZE_8BIT, &deviceConfig, 1, CONFIG_TIMEOUT_MS) != HAL_OK)
+        return MCP9600_I2C_INIT_FAIL;
+
+    // the registers read zero until the first conversion after the configuration, the first round waits for it
+    roundStart = HAL_GetTick();
+    addresses[sensorCount] = (uint8_t)devAddress;
+    readingSeq[sensorCount] = 0;
+    *index = sensorCount++;
+    return MCP9600_OK;
+}
+
+void mcp9600Process(void) {
+    if (roundInProgress || sensorCount == 0)
+        return;
+    uint32_t now = HAL_GetTick();
+    if (now - roundStart < MCP9600_READ_PERIOD_MS)
+        return;
+
+    roundStart = now;
+    current = 0;
+    step = STEP_HOT_JUNCTION;
+    roundInProgress = true;
+    i2cBusRequest(busId);
+}
+
+MCP9600Status_t mcp9600GetReading(uint8_t index, MCP9600Reading_t* reading) {
+    if (index >= sensorCount)
+        return MCP9600_NO_READING;
+    uint32_t seq;
+    do {
+        seq = readingSeq[index];
+        if (seq == 0)
+            return MCP9600_NO_READING;
+        reading->temperature = readings[index].temperature;
+        reading->coldJunction = readings[index].coldJunction;
+        reading->timestamp = readings[index].timestamp;
+        reading->round = readings[index].round;
+    } while ((seq & 1U) || seq != readingSeq[index]);
+    return MCP9600_OK;
+}
+
+uint32_t mcp9600GetRoundCount(void) {
+    return roundCount;
+}
+
+MCP9600Status_t mcp9600GetStatus(void) {
+    return mcp9600Status;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file mcp9600_driver.h
+ * @brief Public API for the MCP9600 thermocouple EMF-to-temperature converter driver for STM32. See mcp9600_driver.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Asynchronous DMA-based register reads (no blocking, except for the configuration in mcp9600AddSensor)
+- Shares the I2C bus with the LCD (and other clients) through the i2c_bus arbiter, nothing has to be paused
+- Each register is read with one combined transaction: register address write, repeated start, 2-byte read
+- Reads are scheduled from the known conversion time instead of polling the status register, so the bus only carries reads that return fresh data
+- Readings are timestamped and published with a sequence counter, so the main loop never sees a half-written reading
+
+# Limitations
+- Up to MCP9600_MAX_SENSORS converters (addresses 0x60..0x67)
+- Configured for type K, no digital filter, 16-bit ADC (about 80 ms per conversion) and continuous conversion
+- Alert outputs aren't used
+
+# Requirements:
+- Replace the included stm32f3xx_hal.h file according to your MCU
+- Enable I2C interrupts and the I2C RX DMA
+- Call i2cBusInit before mcp9600Init and route the HAL I2C callbacks to the arbiter (see i2c_bus.h)
+- Call mcp9600Process periodically (e.g. from the main loop), at least every MCP9600_READ_PERIOD_MS
+*/
+
+#ifndef MCP9600_DRIVER_H
+#define MCP9600_DRIVER_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+#include "i2c_bus.h"
+
+#define MCP9600_MAX_SENSORS     4
+#define MCP9600_READ_PERIOD_MS  84      // 16-bit conversion time (80 ms) plus 5% margin for the converter's oscillator
+
+/* Status info */
+
+typedef enum MCP9600Status_t {
+    MCP9600_OK,
+    MCP9600_TOO_MANY_SENSORS,   // MCP9600_MAX_SENSORS are already registered.
+    MCP9600_NOT_FOUND,          // The device didn't acknowledge or its ID doesn't match.
+    MCP9600_I2C_INIT_FAIL,      // Failed to start an I2C DMA transfer or to configure a converter. The round is aborted.
+    MCP9600_I2C_ERROR,          // The I2C reported an error during a transfer. The round is aborted.
+    MCP9600_BUS_FULL,           // Failed to register with the I2C bus arbiter.
+    MCP9600_NO_READING,         // The sensor hasn't been read successfully yet.
+} MCP9600Status_t;
+
+typedef struct MCP9600Reading_t {
+    int32_t temperature;        // hot-junction (thermocouple) temperature, cold-junction compensated [degC, Q16]
+    int32_t coldJunction;       // cold-junction (chip) temperature [degC, Q16]
+    uint32_t timestamp;         // HAL tick at the end of the transfer [ms]
+    uint32_t round;             // number of the round the reading comes from
+} MCP9600Reading_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the driver and registers it with the I2C bus arbiter
+ */
+MCP9600Status_t mcp9600Init(void);
+
+/**
+ * @brief Checks and configures a converter. Sensors are read in the order of registration.
+ * @note Uses blocking transfers. Call before the bus is used asynchronously (e.g. before lcdInit) or with the other clients idle.
+ * @param address converter's 7-bit I2C address (will be shifted internally)
+ * @param index returns the sensor's index for mcp9600GetReading
+ */
+MCP9600Status_t mcp9600AddSensor(uint8_t address, uint8_t* index);
+
+/**
+ * @brief Starts a new round of reads once the previous conversion is complete, returns immediately
+ * @note Call periodically, it does nothing until MCP9600_READ_PERIOD_MS has passed since the last round started
+ */
+void mcp9600Process(void);
+
+/**
+ * @brief Copies the latest reading of a sensor
+ * @param index sensor index from mcp9600AddSensor
+ * @param reading output
+ * @return MCP9600_NO_READING if the sensor hasn't been read yet
+ */
+MCP9600Status_t mcp9600GetReading(uint8_t index, MCP9600Reading_t* reading);
+
+/**
+ * @brief Returns the number of completed rounds
+ */
+uint32_t mcp9600GetRoundCount(void);
+
+/**
+ * @brief Returns the driver's status
+ * @return MCP9600Status_t
+ */
+MCP9600Status_t mcp9600GetStatus(void);
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file mimo_controller.c
+ * @brief 2x2 decoupled controller implementation. See mimo_controller.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The two zones are modelled as rise = G * duty, G taken over the loops' time scale (see the header's Limitations). The PIDs compute "virtual" duties v, one per zone, and the decoupler turns them into heater duties u = D * v with D = G^-1 * diag(G), so that G * u = diag(G) * v: each PID only sees the gain of its own heater.
+ *
+ * The virtual duties aren't limited to 0 - 1: v = D^-1 * u = diag(G)^-1 * G * u, so both heaters at full power are v_i = 1 + g_ij / g_ii. mimoSetCoupling sets that as the loops' upper limit. With a limit of 1, two saturated loops asked for D * (1, 1), which with the oven's coupling kept the bottom heater nearly off during the preheat.
+ *
+ * When a heater duty saturates, the limit is charged to the loop of that heater's own zone: its virtual duty is corrected to the one that puts the heater exactly at the limit, the other heater's cross term is recalculated from the correction, and that loop's integral isn't allowed to grow further towards the limit in this step (conditional integration, like pidStep does for its own limits). Mapping the clamped duties back to both loops (v = D^-1 * u) would charge one heater's limit to both of them, which held the oven at a false equilibrium with the bottom heater clamped at 0. Tracking the corrected virtual duty (pidTrackOutput) drained the integral by the whole proportional kick of a setpoint step instead, and the zone then crept to its setpoint on the integral alone.
+ */
+
+#include "mimo_controller.h"
+#include "arm_math.h"
+
+#define N                   MIMO_ZONES
+#define MIN_DET_RATIO       0.1f    // det(G) must be at least this fraction of g00*g11 (cross-coupling below ~95% of the direct gains)
+
+static float clamp(float x, float lo, float hi) {
+    if (x < lo) return lo;
+    if (x > hi) return hi;
+    return x;
+}
+
+/* API functions */
+
+void mimoInit(MIMOController_t* mc, const PIDGains_t gains[MIMO_ZONES], float dt, MIMODecoupler_t mode) {
+    for (uint8_t i = 0; i < N; i++) {
+        pidInit(&mc->pid[i], gains[i], dt, 0.0f, 1.0f);
+        mc->crossLag[i] = 0.0f;
+        mc->output[i] = 0.0f;
+    }
+    mc->decouplerMode = mode;
+    mc->crossAlpha = 1.0f;
+
+    const float identity[N * N] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    mimoSetCoupling(mc, identity);
+}
+
+MIMOStatus_t mimoSetCoupling(MIMOController_t* mc, const float g[MIMO_ZONES * MIMO_ZONES]) {
+    float det = g[0] * g[3] - g[1] * g[2];
+    if (g[0] <= 0.0f || g[3] <= 0.0f || det < MIN_DET_RATIO * g[0] * g[3]) {
+        mc->status = MIMO_SINGULAR_COUPLING;
+        return mc->status;
+    }
+
+    float work[N * N];  // arm_mat_inverse_f32 overwrites its source
+    float inv[N * N];
+    float diag[N * N] = { g[0], 0.0f, 0.0f, g[3] };
+    float dec[N * N];
+    for (uint8_t i = 0; i < N * N; i++)
+        work[i] = g[i];
+
+    arm_matrix_instance_f32 workM, invM, diagM, decM;
+    arm_mat_init_f32(&workM, N, N, work);
+    arm_mat_init_f32(&invM, N, N, inv);
+    arm_mat_init_f32(&diagM, N, N, diag);
+    arm_mat_init_f32(&decM, N, N, dec);
+
+    if (arm_mat_inverse_f32(&workM, &invM) != ARM_MATH_SUCCESS || arm_mat_mult_f32(&invM, &diagM, &decM) != ARM_MATH_SUCCESS) {
+        mc->status = MIMO_SINGULAR_COUPLING;
+        return mc->status;
+    }
+
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            mc->coupling[i * N + j] = g[i * N + j];
+            mc->decoupler[i * N + j] = dec[i * N + j];
+        }
+    }
+    // the virtual duty that runs both heaters at full power (see the file comment)
+    for (uint8_t i = 0; i < N; i++)
+        mc->pid[i].outMax = (mc->decouplerMode == MIMO_DECOUPLER_OFF) ? 1.0f : 1.0f + g[i * N + (N - 1 - i)] / g[i * N + i];
+    mc->status = MIMO_OK;
+    return mc->status;
+}
+
+void mimoSetCrossLag(MIMOController_t* mc, float tau) {
+    float dt = mc->pid[0].dt;
+    mc->crossAlpha = (tau <= 0.0f) ? 1.0f : dt / (tau + dt);
+}
+
+MIMOStatus_t mimoGetStatus(const MIMOController_t* mc) {
+    return mc->status;
+}
+
+/* Control step */
+
+void mimoStep(MIMOController_t* mc, const float setpoint[MIMO_ZONES], const float measurement[MIMO_ZONES], float output[MIMO_ZONES]) {
+    float v[N];
+    float u[N];
+    float integral[N];
+    for (uint8_t i = 0; i < N; i++) {
+        integral[i] = mc->pid[i].integral;
+        v[i] = pidStep(&mc->pid[i], setpoint[i], measurement[i]);
+    }
+
+    arm_matrix_instance_f32 vM, uM, matM;
+    arm_mat_init_f32(&vM, N, 1, v);
+    arm_mat_init_f32(&uM, N, 1, u);
+
+    if (mc->decouplerMode == MIMO_DECOUPLER_OFF) {
+        for (uint8_t i = 0; i < N; i++)
+            u[i] = v[i];
+    } else {
+        arm_mat_init_f32(&matM, N, N, mc->decoupler);
+        arm_mat_mult_f32(&matM, &vM, &uM);
+        if (mc->decouplerMode == MIMO_DECOUPLER_DYNAMIC) {
+            for (uint8_t i = 0; i < N; i++) {
+                float direct = mc->decoupler[i * N + i] * v[i];
+                mc->crossLag[i] += mc->crossAlpha * (u[i] - direct - mc->crossLag[i]);
+                u[i] = direct + mc->crossLag[i];
+            }
+        }
+
+        // a heater that hits a limit is charged to its own zone's loop (see the file comment), the other heater's cross term follows
+        for (uint8_t i = 0; i < N; i++) {
+            float c = clamp(u[i], 0.0f, 1.0f);
+            if (c == u[i])
+                continue;
+            uint8_t k = (uint8_t)(N - 1 - i);
+            float dv = (c - u[i]) / mc->decoupler[i * N + i];
+            float dCross = mc->decoupler[k * N + i] * dv;
+            if (mc->decouplerMode == MIMO_DECOUPLER_DYNAMIC) {
+                dCross *= mc->crossAlpha;
+                mc->crossLag[k] += dCross;
+            }
+            u[i] = c;
+            u[k] += dCross;
+            PIDController_t* pid = &mc->pid[i];
+            float error = setpoint[i] - measurement[i];
+            if (dv < 0.0f && error > 0.0f && pid->integral > integral[i])
+                pid->integral = integral[i];
+            else if (dv > 0.0f && error < 0.0f && pid->integral < integral[i])
+                pid->integral = integral[i];
+        }
+    }
+
+    for (uint8_t i = 0; i < N; i++) {
+        float c = clamp(u[i], 0.0f, 1.0f);
+        mc->output[i] = c;
+        output[i] = c;
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file mimo_controller.h
+ * @brief Public API for the 2x2 decoupled controller used in the independent top/bottom heating mode. See mimo_controller.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Two PID loops (top and bottom zone) followed by a decoupler, so that each loop effectively only sees its own zone
+- Static decoupler D = G^-1 * diag(G), where G is the coupling matrix (zone rises at full power of each heater), or a dynamic one with the cross terms delayed by a first-order lag
+- Each loop's output range covers both heaters at full power, so a preheat with both loops saturated runs both heaters at full power
+- A saturated heater stops the integral of its own zone's PID (conditional integration through the decoupler) and the other heater follows, so there's no windup through the decoupler
+- Matrix operations use CMSIS-DSP (arm_mat_mult_f32, arm_mat_inverse_f32)
+
+# Limitations
+- G isn't estimated online. In closed loop both zones are held near one ratio of the heater duties, which only shows G along that direction. Identify it with a step test instead: from a cold oven, run one heater at full power for a few closed-loop time constants and record the rise of both zones, then repeat with the other heater after the oven has cooled down (Host/MimoZones/mimo_zones.c does it on the plant model).
+- Take G over the loops' time scale (minutes), not at steady state. With the heat going into the same walls, the steady-state matrix is close to singular and its decoupler asks for large opposite duty changes that the slow modes only follow after hours.
+- The dynamic decoupler only approximates the slower cross-coupling with a single time constant.
+*/
+
+#ifndef MIMO_CONTROLLER_H
+#define MIMO_CONTROLLER_H
+
+#include "pid_controller.h"
+#include "stdbool.h"
+#include "stdint.h"
+
+#define MIMO_ZONES      2
+#define MIMO_TOP        0
+#define MIMO_BOTTOM     1
+
+/* Status info */
+
+typedef enum MIMOStatus_t {
+    MIMO_OK,
+    MIMO_SINGULAR_COUPLING,     // The coupling matrix can't be inverted (or is badly conditioned). The previous decoupler is kept.
+} MIMOStatus_t;
+
+typedef enum MIMODecoupler_t {
+    MIMO_DECOUPLER_OFF,         // two plain PIDs
+    MIMO_DECOUPLER_STATIC,
+    MIMO_DECOUPLER_DYNAMIC,
+} MIMODecoupler_t;
+
+typedef struct MIMOController_t {
+    PIDController_t pid[MIMO_ZONES];
+    MIMODecoupler_t decouplerMode;
+    float coupling[MIMO_ZONES * MIMO_ZONES];    // G, row-major: temperature rise of zone i [degC] at full power of heater j, over the identification horizon
+    float decoupler[MIMO_ZONES * MIMO_ZONES];   // G^-1 * diag(G)
+    float crossLag[MIMO_ZONES];                 // dynamic decoupler state
+    float crossAlpha;
+    float output[MIMO_ZONES];
+    MIMOStatus_t status;
+} MIMOController_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises both loops with outputs limited to 0.0 - 1.0, and an identity coupling matrix
+ * @param mc pointer to the controller instance
+ * @param gains gains of the top and bottom loop
+ * @param dt sample time [s]
+ * @param mode decoupler type
+ */
+void mimoInit(MIMOController_t* mc, const PIDGains_t gains[MIMO_ZONES], float dt, MIMODecoupler_t mode);
+
+/**
+ * @brief Sets the coupling matrix and recalculates the decoupler
+ * @note With a decoupler, the output limit of loop i becomes 1 + g_ij / g_ii, the virtual duty that runs both heaters at full power
+ * @param mc pointer to the controller instance
+ * @param g row-major 2x2 matrix: temperature rise of zone i [degC] at full power of heater j
+ */
+MIMOStatus_t mimoSetCoupling(MIMOController_t* mc, const float g[MIMO_ZONES * MIMO_ZONES]);
+
+/**
+ * @brief Sets the time constant of the cross-coupling for the dynamic decoupler
+ * @param mc pointer to the controller instance
+ * @param tau time constant [s]
+ */
+void mimoSetCrossLag(MIMOController_t* mc, float tau);
+
+/**
+ * @brief Runs both loops and the decoupler
+ * @param mc pointer to the controller instance
+ * @param setpoint top and bottom setpoints [degC]
+ * @param measurement top and bottom temperatures [degC]
+ * @param output top and bottom heater duties (0.0 - 1.0)
+ */
+void mimoStep(MIMOController_t* mc, const float setpoint[MIMO_ZONES], const float measurement[MIMO_ZONES], float output[MIMO_ZONES]);
+
+/**
+ * @brief Returns the status of the latest decoupler update
+ * @return MIMOStatus_t
+ */
+MIMOStatus_t mimoGetStatus(const MIMOController_t* mc);
+
+#endif
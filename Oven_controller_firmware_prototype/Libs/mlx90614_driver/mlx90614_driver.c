@@ -0,0 +1,177 @@
+/**
+ * @file mlx90614_driver.c
+ * @brief MLX90614 infrared thermometer driver implementation for STM32. See mlx90614_driver.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * This file implements a non-blocking, DMA-based driver for an MLX90614 on an I2C bus shared through the i2c_bus arbiter. A round reads the object and the ambient temperature RAM registers, one SMBus "read word" per bus grant: command write, repeated start, then the low byte, the high byte and the PEC.
+ *
+ * The PEC is a CRC-8 (polynomial 0x07) over every byte of the transaction, including both address bytes. The completion interrupt feeds the 5 bytes to the CRC unit and compares the result with the received PEC, a mismatch aborts the round without publishing anything.
+ *
+ * Each published reading is guarded by a sequence counter that is odd while the interrupt writes it, same as in the MAX318xx driver.
+ */
+
+#include "mlx90614_driver.h"
+
+/* HARDWARE ABSTRACTION */
+
+#define RAM_TA                      (uint8_t)0x06   // ambient temperature
+#define RAM_TOBJ1                   (uint8_t)0x07   // object temperature, zone 1
+
+#define WORD_ERROR_FLAG             (uint16_t)0x8000
+#define KELVIN_OFFSET_Q16           (int32_t)17901158   // 273.15 * 65536
+
+/* DRIVER STATE */
+
+typedef enum Step_t {
+    STEP_OBJECT,
+    STEP_AMBIENT,
+} Step_t;
+
+static CRC_HandleTypeDef* mlxhcrc;
+static uint8_t mlxAddress;
+static uint8_t busId;
+
+static volatile MLX90614Reading_t reading;
+static volatile uint32_t readingSeq = 0;    // odd while the reading is being written, 0 = never written
+
+static uint8_t rxBuffer[3];                 // low byte, high byte, PEC
+static int32_t object;                      // first half of the reading in progress
+
+static volatile bool roundInProgress = false;
+static volatile Step_t step = STEP_OBJECT;
+static uint32_t roundStart = 0;
+static bool firstRound = true;
+static volatile uint32_t roundCount = 0;
+static volatile uint32_t pecErrorCount = 0;
+static volatile MLX90614Status_t mlx90614Status = MLX90614_OK;
+
+/* HANDLING AND SENDING DATA */
+
+static uint8_t command(void) {
+    return (step == STEP_OBJECT) ? RAM_TOBJ1 : RAM_TA;
+}
+
+static bool pecValid(void) {
+    uint8_t frame[5] = { mlxAddress, command(), mlxAddress | 1U, rxBuffer[0], rxBuffer[1] };
+    return (uint8_t)HAL_CRC_Calculate(mlxhcrc, (uint32_t*)frame, sizeof(frame)) == rxBuffer[2];
+}
+
+static int32_t decodeTemperature(uint16_t word) {    // 0.02 K per LSB
+    return (int32_t)(((int64_t)word * 131072 + 50) / 100) - KELVIN_OFFSET_Q16;
+}
+
+static void publish(int32_t ambient) {
+    readingSeq++;
+    reading.object = object;
+    reading.ambient = ambient;
+    reading.timestamp = HAL_GetTick();
+    reading.round = roundCount + 1;
+    readingSeq++;
+}
+
+/* I2C bus client */
+
+static bool busStart(void) {
+    if (!roundInProgress)
+        return false;
+    if (HAL_I2C_Mem_Read_DMA(i2cBusGetHandle(), mlxAddress, command(), I2C_MEMADD_SIZE_8BIT, rxBuffer, sizeof(rxBuffer)) != HAL_OK) {
+        mlx90614Status = MLX90614_I2C_INIT_FAIL;
+        roundInProgress = false;
+        return false;
+    }
+    return true;
+}
+
+static bool busComplete(void) {
+    if (!roundInProgress)
+        return false;
+    if (!pecValid()) {
+        pecErrorCount++;
+        mlx90614Status = MLX90614_PEC_ERROR;
+        roundInProgress = false;
+        return false;
+    }
+    uint16_t word = ((uint16_t)rxBuffer[1] << 8) | rxBuffer[0];
+    if (word & WORD_ERROR_FLAG) {
+        mlx90614Status = MLX90614_DATA_ERROR;
+        roundInProgress = false;
+        return false;
+    }
+
+    if (step == STEP_OBJECT) {
+        object = decodeTemperature(word);
+        step = STEP_AMBIENT;
+        return true;
+    }
+
+    publish(decodeTemperature(word));
+    roundCount++;
+    mlx90614Status = MLX90614_OK;
+    roundInProgress = false;
+    return false;
+}
+
+static bool busError(void) {
+    mlx90614Status = MLX90614_I2C_ERROR;
+    roundInProgress = false;
+    return false;
+}
+
+static const I2CBusClient_t busClient = { busStart, busComplete, busError };
+
+/* API functions */
+
+MLX90614Status_t mlx90614Init(CRC_HandleTypeDef* hcrc, uint8_t address) {
+    mlxhcrc = hcrc;
+    mlxAddress = address << 1;
+    readingSeq = 0;
+    roundInProgress = false;
+    firstRound = true;
+    roundCount = 0;
+    pecErrorCount = 0;
+    mlx90614Status = MLX90614_OK;
+    if (i2cBusRegister(&busClient, &busId) != I2C_BUS_OK)
+        return MLX90614_BUS_FULL;
+    return MLX90614_OK;
+}
+
+void mlx90614Process(void) {
+    if (roundInProgress)
+        return;
+    uint32_t now = HAL_GetTick();
+    if (!firstRound && now - roundStart < MLX90614_READ_PERIOD_MS)
+        return;
+
+    firstRound = false;
+    roundStart = now;
+    step = STEP_OBJECT;
+    roundInProgress = true;
+    i2cBusRequest(busId);
+}
+
+MLX90614Status_t mlx90614GetReading(MLX90614Reading_t* out) {
+    uint32_t seq;
+    do {
+        seq = readingSeq;
+        if (seq == 0)
+            return MLX90614_NO_READING;
+        out->object = reading.object;
+        out->ambient = reading.ambient;
+        out->timestamp = reading.timestamp;
+        out->round = reading.round;
+    } while ((seq & 1U) || seq != readingSeq);
+    return MLX90614_OK;
+}
+
+uint32_t mlx90614GetRoundCount(void) {
+    return roundCount;
+}
+
+uint32_t mlx90614GetPecErrorCount(void) {
+    return pecErrorCount;
+}
+
+MLX90614Status_t mlx90614GetStatus(void) {
+    return mlx90614Status;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file mlx90614_driver.h
+ * @brief Public API for the MLX90614 infrared thermometer driver for STM32. See mlx90614_driver.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Non-contact stone surface temperature (object temperature) and sensor ambient temperature
+- Asynchronous DMA-based SMBus "read word" transactions, sharing the I2C bus through the i2c_bus arbiter
+- Every word is checked against its SMBus PEC, computed by the hardware CRC unit. Readings with a wrong PEC or the error flag set are dropped and counted.
+- Readings are timestamped and published with a sequence counter, so the main loop never sees a half-written reading
+
+# Limitations
+- The MLX90614 only supports SMBus clocks up to 100 kHz
+- Uses the emissivity stored in the sensor's EEPROM (1.0 by default, a cordierite stone is about 0.9), it isn't changed by the driver
+- Only one sensor (the address can be chosen)
+
+# Requirements:
+- Replace the included stm32f3xx_hal.h file according to your MCU
+- Enable I2C interrupts and the I2C RX DMA
+- CRC unit configured for SMBus PEC: 8-bit polynomial 0x07, initial value 0, no bit reversal, byte input
+- Call i2cBusInit before mlx90614Init and route the HAL I2C callbacks to the arbiter (see i2c_bus.h)
+- Call mlx90614Process periodically (e.g. from the main loop)
+- To use the stone temperature in the state estimator: estUpdateStone(&est, reading.object / 65536.0f)
+*/
+
+#ifndef MLX90614_DRIVER_H
+#define MLX90614_DRIVER_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+#include "i2c_bus.h"
+
+#define MLX90614_DEFAULT_ADDRESS    0x5A
+#define MLX90614_READ_PERIOD_MS     100     // the sensor's IIR filter settles much slower, reading faster only returns nearly the same values
+
+/* Status info */
+
+typedef enum MLX90614Status_t {
+    MLX90614_OK,
+    MLX90614_I2C_INIT_FAIL,     // Failed to start an I2C DMA transfer. The round is aborted.
+    MLX90614_I2C_ERROR,         // The I2C reported an error during a transfer. The round is aborted.
+    MLX90614_PEC_ERROR,         // A word arrived with a wrong PEC. The round is aborted.
+    MLX90614_DATA_ERROR,        // The sensor set the error flag of a word. The round is aborted.
+    MLX90614_BUS_FULL,          // Failed to register with the I2C bus arbiter.
+    MLX90614_NO_READING,        // The sensor hasn't been read successfully yet.
+} MLX90614Status_t;
+
+typedef struct MLX90614Reading_t {
+    int32_t object;             // object (stone surface) temperature [degC, Q16]
+    int32_t ambient;            // sensor package temperature [degC, Q16]
+    uint32_t timestamp;         // HAL tick at the end of the transfer [ms]
+    uint32_t round;             // number of the round the reading comes from
+} MLX90614Reading_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the driver and registers it with the I2C bus arbiter
+ * @param hcrc pointer to HAL's CRC handle struct (configured for SMBus PEC)
+ * @param address sensor's 7-bit SMBus address (will be shifted internally)
+ */
+MLX90614Status_t mlx90614Init(CRC_HandleTypeDef* hcrc, uint8_t address);
+
+/**
+ * @brief Starts a new round of reads once MLX90614_READ_PERIOD_MS has passed since the last one started, returns immediately
+ */
+void mlx90614Process(void);
+
+/**
+ * @brief Copies the latest reading
+ * @param reading output
+ * @return MLX90614_NO_READING if the sensor hasn't been read yet
+ */
+MLX90614Status_t mlx90614GetReading(MLX90614Reading_t* reading);
+
+/**
+ * @brief Returns the number of completed rounds
+ */
+uint32_t mlx90614GetRoundCount(void);
+
+/**
+ * @brief Returns the number of words dropped because of a wrong PEC
+ */
+uint32_t mlx90614GetPecErrorCount(void);
+
+/**
+ * @brief Returns the driver's status
+ * @return MLX90614Status_t
+ */
+MLX90614Status_t mlx90614GetStatus(void);
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file mpc_controller.c
+ * @brief Model predictive controller implementation. See mpc_controller.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The oven is modelled as two first-order lags in series (elements -> chamber), discretised exactly for a zero-order hold. The measured air is a mix of both states, y = directShare*element + (1 - directShare)*chamber: the air has little capacity of its own and follows the elements within seconds, while the slow part (walls, stone) goes through the chamber lag. Over the horizon the predicted air rise is y = F*x0 + G*u, and the QP
+ *
+ *     minimise |y - r|^2 + moveWeight * |D*u|^2     (D*u: duty changes, including the one from the last applied duty)
+ *     subject to 0 <= u <= maxDuty, predicted heating rate <= maxRate, y <= r
+ *
+ * is solved with an accelerated (Nesterov) projected gradient method with the constant step 1/L, L being a Gershgorin bound of the Hessian's largest eigenvalue, restarting the momentum whenever it points against the projected gradient step (it converges in fewer iterations near the setpoint, where the constraints are active). The heating rate is limited twice in a forward pass over the horizon, which doubles as the projection onto the feasible set: the chamber node's rate (x1 - x2)/chamberTau by capping each predicted element rise, and the predicted air's rise over each period; the same pass caps the predicted air at the setpoint (less the estimated bias). With no duty the elements cool faster than the chamber warms (elementTau << chamberTau), so the air's limits can be met unless the chamber alone already carries the air over them.
+ */
+
+#include "mpc_controller.h"
+#include "math.h"
+
+#define N                   MPC_HORIZON
+#define CONVERGED_STEP      1e-4f   // stop iterating when no duty in the horizon moves more than this
+#define OBSERVER_GAIN_ELEM  0.2f    // correction of the element state per degC of air prediction error
+#define OBSERVER_GAIN_CHMB  0.5f    // correction of the chamber state per degC of air prediction error
+#define OBSERVER_GAIN_BIAS  0.05f   // integrating output disturbance, removes the steady-state offset caused by model errors
+
+static float clamp(float x, float lo, float hi) {
+    if (x < lo) return lo;
+    if (x > hi) return hi;
+    return x;
+}
+
+/* Initialisation */
+
+MPCStatus_t mpcInit(MPCController_t* mpc, const MPCModel_t* model, const MPCConfig_t* cfg, float ambient) {
+    mpc->cfg = *cfg;
+    mpc->ambient = ambient;
+    mpc->x[0] = 0.0f;
+    mpc->x[1] = 0.0f;
+    mpc->bias = 0.0f;
+    mpc->yMax = 0.0f;
+    mpc->uPrev = 0.0f;
+    mpc->iterations = 0;
+    for (uint8_t i = 0; i < N; i++)
+        mpc->u[i] = 0.0f;
+
+    if (model->gain <= 0.0f || model->elementTau <= 0.0f || model->chamberTau <= 0.0f || cfg->dt <= 0.0f
+        || model->directShare < 0.0f || model->directShare >= 1.0f) {
+        mpc->status = MPC_INVALID_MODEL;
+        return mpc->status;
+    }
+
+    float te = model->elementTau;
+    float tc = model->chamberTau;
+    mpc->a11 = expf(-cfg->dt / te);
+    mpc->a22 = expf(-cfg->dt / tc);
+    if (fabsf(te - tc) < 1e-3f * te)
+        mpc->a21 = cfg->dt / tc * mpc->a22;
+    else
+        mpc->a21 = te * (mpc->a11 - mpc->a22) / (te - tc);
+    mpc->b1 = model->gain * (1.0f - mpc->a11);
+    mpc->b2 = model->gain * (1.0f - mpc->a21 - mpc->a22);
+    mpc->c1 = model->directShare;
+    mpc->c2 = 1.0f - model->directShare;
+    mpc->invB1 = 1.0f / mpc->b1;
+    mpc->invBy = 1.0f / (mpc->c1 * mpc->b1 + mpc->c2 * mpc->b2);
+    mpc->elementMargin = cfg->maxRate * tc;
+
+    // free response F (row i: air rise i+1 periods ahead, from x0) and step responses g[k] = C*A^k*B
+    float g[N];
+    float fx1 = 1.0f, fx2 = 0.0f;   // A^k * e1
+    float fy1 = 0.0f, fy2 = 1.0f;   // A^k * e2
+    float sx1 = mpc->b1, sx2 = mpc->b2;
+    for (uint8_t i = 0; i < N; i++) {
+        float t;
+        t = mpc->a21 * fx1 + mpc->a22 * fx2; fx1 = mpc->a11 * fx1; fx2 = t;
+        t = mpc->a21 * fy1 + mpc->a22 * fy2; fy1 = mpc->a11 * fy1; fy2 = t;
+        mpc->F[i * 2 + 0] = mpc->c1 * fx1 + mpc->c2 * fx2;
+        mpc->F[i * 2 + 1] = mpc->c1 * fy1 + mpc->c2 * fy2;
+        g[i] = mpc->c1 * sx1 + mpc->c2 * sx2;
+        t = mpc->a21 * sx1 + mpc->a22 * sx2; sx1 = mpc->a11 * sx1; sx2 = t;
+    }
+
+    // G is lower triangular Toeplitz: G[i][j] = g[i - j]
+    for (uint8_t i = 0; i < N; i++)
+        for (uint8_t j = 0; j < N; j++)
+            mpc->Gt[j * N + i] = (j <= i) ? g[i - j] : 0.0f;
+
+    arm_mat_init_f32(&mpc->mGt, N, N, mpc->Gt);
+    arm_mat_init_f32(&mpc->mH, N, N, mpc->H);
+    arm_mat_init_f32(&mpc->mF, N, 2, mpc->F);
+
+    // H = G'*G + moveWeight*D'*D (G'*G from the rows of G', init only)
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j <= i; j++) {
+            float sum = 0.0f;
+            for (uint8_t k = 0; k < N; k++)
+                sum += mpc->Gt[i * N + k] * mpc->Gt[j * N + k];
+            mpc->H[i * N + j] = sum;
+            mpc->H[j * N + i] = sum;
+        }
+    }
+    float w = cfg->moveWeight;
+    for (uint8_t i = 0; i < N; i++) {
+        mpc->H[i * N + i] += (i < N - 1) ? 2.0f * w : w;
+        if (i > 0) {
+            mpc->H[i * N + i - 1] -= w;
+            mpc->H[(i - 1) * N + i] -= w;
+        }
+    }
+
+    float lipschitz = 0.0f;
+    for (uint8_t i = 0; i < N; i++) {
+        float rowSum = 0.0f;
+        for (uint8_t j = 0; j < N; j++)
+            rowSum += fabsf(mpc->H[i * N + j]);
+        if (rowSum > lipschitz)
+            lipschitz = rowSum;
+    }
+    mpc->stepSize = 1.0f / lipschitz;
+
+    mpc->status = MPC_OK;
+    return mpc->status;
+}
+
+/* QP solver */
+
+// clamps the duties and limits the predicted element rise, air rise (heating rate) and air (setpoint) along the horizon, in place
+static void project(MPCController_t* mpc, float* u) {
+    float x1 = mpc->x[0];
+    float x2 = mpc->x[1];
+    const float maxStep = mpc->cfg.maxRate * mpc->cfg.dt;
+    for (uint8_t k = 0; k < N; k++) {
+        float uk = clamp(u[k], 0.0f, mpc->cfg.maxDuty);
+        float x1Free = mpc->a11 * x1;
+        float x2Free = mpc->a21 * x1 + mpc->a22 * x2;
+        float uRate = (x2Free + mpc->elementMargin - x1Free) * mpc->invB1;
+        float uAir = (mpc->c1 * (x1 - x1Free) + mpc->c2 * (x2 - x2Free) + maxStep) * mpc->invBy;
+        if (uAir < uRate)
+            uRate = uAir;
+        float uTop = (mpc->yMax - mpc->c1 * x1Free - mpc->c2 * x2Free) * mpc->invBy;
+        if (uTop < uRate)
+            uRate = uTop;
+        if (uk > uRate)
+            uk = (uRate > 0.0f) ? uRate : 0.0f;
+        u[k] = uk;
+        x2 = x2Free + mpc->b2 * uk;
+        x1 = x1Free + mpc->b1 * uk;
+    }
+}
+
+static void solve(MPCController_t* mpc, float rise) {
+    float free[N];
+    float lin[N];
+    float grad[N];
+    arm_matrix_instance_f32 mx, mfree, mlin, mgrad;
+    arm_mat_init_f32(&mx, 2, 1, mpc->x);
+    arm_mat_init_f32(&mfree, N, 1, free);
+    arm_mat_init_f32(&mlin, N, 1, lin);
+    arm_mat_init_f32(&mgrad, N, 1, grad);
+
+    // linear term: G'*(F*x0 + bias - r) - moveWeight*uPrev*e0
+    arm_mat_mult_f32(&mpc->mF, &mx, &mfree);
+    for (uint8_t i = 0; i < N; i++)
+        free[i] += mpc->bias - rise;
+    arm_mat_mult_f32(&mpc->mGt, &mfree, &mlin);
+    lin[0] -= mpc->cfg.moveWeight * mpc->uPrev;
+
+    mpc->yMax = rise - mpc->bias;
+
+    // warm start: previous solution shifted by one period
+    for (uint8_t i = 0; i < N - 1; i++)
+        mpc->u[i] = mpc->u[i + 1];
+    project(mpc, mpc->u);
+
+    // accelerated (Nesterov) projected gradient, the gradient is evaluated at the extrapolated point v
+    float v[N];
+    float prev[N];
+    arm_matrix_instance_f32 mv;
+    arm_mat_init_f32(&mv, N, 1, v);
+    for (uint8_t i = 0; i < N; i++) {
+        v[i] = mpc->u[i];
+        prev[i] = mpc->u[i];
+    }
+    float t = 1.0f;
+
+    mpc->status = MPC_NOT_CONVERGED;
+    for (uint8_t it = 1; it <= MPC_MAX_ITERATIONS; it++) {
+        mpc->iterations = it;
+        arm_mat_mult_f32(&mpc->mH, &mv, &mgrad);
+        for (uint8_t i = 0; i < N; i++)
+            mpc->u[i] = v[i] - mpc->stepSize * (grad[i] + lin[i]);
+        project(mpc, mpc->u);
+
+        // adaptive restart: drop the momentum when it points against the projected gradient step
+        float progress = 0.0f;
+        for (uint8_t i = 0; i < N; i++)
+            progress += (v[i] - mpc->u[i]) * (mpc->u[i] - prev[i]);
+        if (progress > 0.0f)
+            t = 1.0f;
+        float tNext = 0.5f * (1.0f + sqrtf(1.0f + 4.0f * t * t));
+        float momentum = (t - 1.0f) / tNext;
+        t = tNext;
+
+        float maxStep = 0.0f;
+        for (uint8_t i = 0; i < N; i++) {
+            float d = mpc->u[i] - prev[i];
+            if (fabsf(d) > maxStep) maxStep = fabsf(d);
+            v[i] = mpc->u[i] + momentum * d;
+            prev[i] = mpc->u[i];
+        }
+        if (maxStep < CONVERGED_STEP) {
+            mpc->status = MPC_OK;
+            break;
+        }
+    }
+}
+
+/* Control step */
+
+float mpcStep(MPCController_t* mpc, float setpoint, float measurement) {
+    if (mpc->status == MPC_INVALID_MODEL)
+        return 0.0f;
+
+    // observer: correct the model state (already propagated with the applied duty) and the output bias with the measurement
+    float err = measurement - mpc->ambient - (mpc->c1 * mpc->x[0] + mpc->c2 * mpc->x[1]) - mpc->bias;
+    mpc->x[0] += OBSERVER_GAIN_ELEM * err;
+    mpc->x[1] += OBSERVER_GAIN_CHMB * err;
+    mpc->bias += OBSERVER_GAIN_BIAS * err;
+
+    solve(mpc, setpoint - mpc->ambient);
+
+    float duty = mpc->u[0];
+    mpc->uPrev = duty;
+
+    // propagate the model to the next control period
+    float x1 = mpc->x[0];
+    mpc->x[0] = mpc->a11 * x1 + mpc->b1 * duty;
+    mpc->x[1] = mpc->a21 * x1 + mpc->a22 * mpc->x[1] + mpc->b2 * duty;
+    return duty;
+}
+
+uint8_t mpcGetIterations(const MPCController_t* mpc) {
+    return mpc->iterations;
+}
+
+MPCStatus_t mpcGetStatus(const MPCController_t* mpc) {
+    return mpc->status;
+}
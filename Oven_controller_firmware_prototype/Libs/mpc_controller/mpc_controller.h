@@ -0,0 +1,105 @@
+/**
+ * @file mpc_controller.h
+ * @brief Public API for the experimental model predictive heating mode. See mpc_controller.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Offset-free tracking (the observer estimates a constant output disturbance)
+- Two-node oven model (heating elements, chamber) identified by a gain, two time constants and the share of the element rise the measured air follows directly
+- Solves a small constrained QP over MPC_HORIZON control periods in every step: tracking error plus a penalty on duty changes
+- Constraints: duty between 0 and a configurable maximum, maximum heating rate, predicted air not above the setpoint (no planned overshoot)
+- Fixed-size preallocated matrices, bounded iteration count (accelerated projected gradient method with adaptive restart, warm-started from the previous solution)
+
+# Limitations
+- Single loop (one chamber temperature, one total duty), meant to be combined with a power splitter for two heaters
+- The heating rate limit is enforced on the model's prediction (on the measured air and on the chamber node), the measured rate can exceed it if the model is off
+- The instance keeps CMSIS matrix descriptors pointing into itself, so it must not be copied or moved after mpcInit
+*/
+
+#ifndef MPC_CONTROLLER_H
+#define MPC_CONTROLLER_H
+
+#include "arm_math.h"
+#include "stdint.h"
+
+#define MPC_HORIZON         20  // prediction and control horizon [control periods]
+#define MPC_MAX_ITERATIONS  50  // QP iteration limit per step
+
+/* Status info */
+
+typedef enum MPCStatus_t {
+    MPC_OK,
+    MPC_NOT_CONVERGED,      // The QP hit the iteration limit. The best feasible solution found is used.
+    MPC_INVALID_MODEL,      // Non-positive gain or time constants, or a direct share outside 0.0 - <1.0. The controller outputs 0.
+} MPCStatus_t;
+
+typedef struct MPCModel_t {
+    float gain;             // chamber temperature rise at full duty, at steady state [degC]
+    float elementTau;       // heating element time constant [s]
+    float chamberTau;       // chamber time constant [s]
+    float directShare;      // share of the element rise that reaches the measured air within seconds (0.0 - <1.0), the rest goes through the chamber lag
+} MPCModel_t;
+
+typedef struct MPCConfig_t {
+    float dt;               // control period [s]
+    float maxDuty;          // SSR duty limit (0.0 - 1.0)
+    float maxRate;          // chamber heating rate limit [degC/s]
+    float moveWeight;       // penalty on duty changes relative to tracking error (in degC^2 per duty^2)
+} MPCConfig_t;
+
+typedef struct MPCController_t {
+    MPCConfig_t cfg;
+    float ambient;
+    // model (x = [element rise, chamber rise] above ambient)
+    float a11, a21, a22, b1, b2;
+    float c1, c2;                   // measured air = c1*element + c2*chamber
+    float invB1, invBy;
+    float elementMargin;            // element rise over chamber rise that corresponds to maxRate [degC]
+    float x[2];
+    float yMax;                     // model air rise that reaches the setpoint [degC]
+    float bias;                     // estimated output disturbance [degC]
+    // QP
+    float Gt[MPC_HORIZON * MPC_HORIZON];   // transposed step response matrix
+    float H[MPC_HORIZON * MPC_HORIZON];    // Hessian
+    float F[MPC_HORIZON * 2];              // free response matrix
+    float stepSize;
+    float u[MPC_HORIZON];                  // solution (warm start for the next step)
+    float uPrev;
+    arm_matrix_instance_f32 mGt, mH, mF;
+    uint8_t iterations;
+    MPCStatus_t status;
+} MPCController_t;
+
+/* API functions */
+
+/**
+ * @brief Builds the prediction matrices and resets the controller
+ * @param mpc pointer to the controller instance
+ * @param model oven model
+ * @param cfg controller settings
+ * @param ambient ambient temperature [degC]
+ */
+MPCStatus_t mpcInit(MPCController_t* mpc, const MPCModel_t* model, const MPCConfig_t* cfg, float ambient);
+
+/**
+ * @brief Runs the observer and solves the QP
+ * @param mpc pointer to the controller instance
+ * @param setpoint chamber setpoint [degC]
+ * @param measurement chamber temperature [degC]
+ * @return duty to apply during the next control period (0.0 - maxDuty)
+ */
+float mpcStep(MPCController_t* mpc, float setpoint, float measurement);
+
+/**
+ * @brief Returns the number of QP iterations used in the latest step
+ */
+uint8_t mpcGetIterations(const MPCController_t* mpc);
+
+/**
+ * @brief Returns the status of the latest step
+ * @return MPCStatus_t
+ */
+MPCStatus_t mpcGetStatus(const MPCController_t* mpc);
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file oled_gfx.c
+ * @brief Drawing primitives, text and bitmap blits on the OLED framebuffer. See oled_gfx.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * A column of up to 8 pixels at an arbitrary y touches at most two page bytes: the bits shifted down into the first page and the rest into the next one. Rectangles, glyphs and bitmaps are drawn as such columns, with a mask for the bits they cover, so neighbouring pixels of the same bytes are left alone. Single pixels and lines go through the same path and cost a framebuffer read each.
+ */
+
+#include "oled_gfx.h"
+#include "oled_ssd1306_driver.h"
+
+#define FONT_FIRST      0x20
+#define FONT_LAST       0x7F
+#define FONT_W          5
+
+// classic 5x7 font, one byte per column, bit 0 at the top
+static const uint8_t font[FONT_LAST - FONT_FIRST + 1][FONT_W] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 },   // ' '
+    { 0x00, 0x00, 0x5F, 0x00, 0x00 },   // '!'
+    { 0x00, 0x07, 0x00, 0x07, 0x00 },   // '"'
+    { 0x14, 0x7F, 0x14, 0x7F, 0x14 },   // '#'
+    { 0x24, 0x2A, 0x7F, 0x2A, 0x12 },   // '$'
+    { 0x23, 0x13, 0x08, 0x64, 0x62 },   // '%'
+    { 0x36, 0x49, 0x55, 0x22, 0x50 },   // '&'
+    { 0x00, 0x05, 0x03, 0x00, 0x00 },   // '''
+    { 0x00, 0x1C, 0x22, 0x41, 0x00 },   // '('
+    { 0x00, 0x41, 0x22, 0x1C, 0x00 },   // ')'
+    { 0x14, 0x08, 0x3E, 0x08, 0x14 },   // '*'
+    { 0x08, 0x08, 0x3E, 0x08, 0x08 },   // '+'
+    { 0x00, 0x50, 0x30, 0x00, 0x00 },   // ','
+    { 0x08, 0x08, 0x08, 0x08, 0x08 },   // '-'
+    { 0x00, 0x60, 0x60, 0x00, 0x00 },   // '.'
+    { 0x20, 0x10, 0x08, 0x04, 0x02 },   // '/'
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E },   // '0'
+    { 0x00, 0x42, 0x7F, 0x40, 0x00 },   // '1'
+    { 0x42, 0x61, 0x51, 0x49, 0x46 },   // '2'
+    { 0x21, 0x41, 0x45, 0x4B, 0x31 },   // '3'
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 },   // '4'
+    { 0x27, 0x45, 0x45, 0x45, 0x39 },   // '5'
+    { 0x3C, 0x4A, 0x49, 0x49, 0x30 },   // '6'
+    { 0x01, 0x71, 0x09, 0x05, 0x03 },   // '7'
+    { 0x36, 0x49, 0x49, 0x49, 0x36 },   // '8'
+    { 0x06, 0x49, 0x49, 0x29, 0x1E },   // '9'
+    { 0x00, 0x36, 0x36, 0x00, 0x00 },   // ':'
+    { 0x00, 0x56, 0x36, 0x00, 0x00 },   // ';'
+    { 0x08, 0x14, 0x22, 0x41, 0x00 },   // '<'
+    { 0x14, 0x14, 0x14, 0x14, 0x14 },   // '='
+    { 0x00, 0x41, 0x22, 0x14, 0x08 },   // '>'
+    { 0x02, 0x01, 0x51, 0x09, 0x06 },   // '?'
+    { 0x32, 0x49, 0x79, 0x41, 0x3E },   // '@'
+    { 0x7E, 0x11, 0x11, 0x11, 0x7E },   // 'A'
+    { 0x7F, 0x49, 0x49, 0x49, 0x36 },   // 'B'
+    { 0x3E, 0x41, 0x41, 0x41, 0x22 },   // 'C'
+    { 0x7F, 0x41, 0x41, 0x22, 0x1C },   // 'D'
+    { 0x7F, 0x49, 0x49, 0x49, 0x41 },   // 'E'
+    { 0x7F, 0x09, 0x09, 0x09, 0x01 },   // 'F'
+    { 0x3E, 0x41, 0x49, 0x49, 0x7A },   // 'G'
+    { 0x7F, 0x08, 0x08, 0x08, 0x7F },   // 'H'
+    { 0x00, 0x41, 0x7F, 0x41, 0x00 },   // 'I'
+    { 0x20, 0x40, 0x41, 0x3F, 0x01 },   // 'J'
+    { 0x7F, 0x08, 0x14, 0x22, 0x41 },   // 'K'
+    { 0x7F, 0x40, 0x40, 0x40, 0x40 },   // 'L'
+    { 0x7F, 0x02, 0x0C, 0x02, 0x7F },   // 'M'
+    { 0x7F, 0x04, 0x08, 0x10, 0x7F },   // 'N'
+    { 0x3E, 0x41, 0x41, 0x41, 0x3E },   // 'O'
+    { 0x7F, 0x09, 0x09, 0x09, 0x06 },   // 'P'
+    { 0x3E, 0x41, 0x51, 0x21, 0x5E },   // 'Q'
+    { 0x7F, 0x09, 0x19, 0x29, 0x46 },   // 'R'
+    { 0x46, 0x49, 0x49, 0x49, 0x31 },   // 'S'
+    { 0x01, 0x01, 0x7F, 0x01, 0x01 },   // 'T'
+    { 0x3F, 0x40, 0x40, 0x40, 0x3F },   // 'U'
+    { 0x1F, 0x20, 0x40, 0x20, 0x1F },   // 'V'
+    { 0x3F, 0x40, 0x38, 0x40, 0x3F },   // 'W'
+    { 0x63, 0x14, 0x08, 0x14, 0x63 },   // 'X'
+    { 0x07, 0x08, 0x70, 0x08, 0x07 },   // 'Y'
+    { 0x61, 0x51, 0x49, 0x45, 0x43 },   // 'Z'
+    { 0x00, 0x7F, 0x41, 0x41, 0x00 },   // '['
+    { 0x02, 0x04, 0x08, 0x10, 0x20 },   // '\'
+    { 0x00, 0x41, 0x41, 0x7F, 0x00 },   // ']'
+    { 0x04, 0x02, 0x01, 0x02, 0x04 },   // '^'
+    { 0x40, 0x40, 0x40, 0x40, 0x40 },   // '_'
+    { 0x00, 0x01, 0x02, 0x04, 0x00 },   // '`'
+    { 0x20, 0x54, 0x54, 0x54, 0x78 },   // 'a'
+    { 0x7F, 0x48, 0x44, 0x44, 0x38 },   // 'b'
+    { 0x38, 0x44, 0x44, 0x44, 0x20 },   // 'c'
+    { 0x38, 0x44, 0x44, 0x48, 0x7F },   // 'd'
+    { 0x38, 0x54, 0x54, 0x54, 0x18 },   // 'e'
+    { 0x08, 0x7E, 0x09, 0x01, 0x02 },   // 'f'
+    { 0x0C, 0x52, 0x52, 0x52, 0x3E },   // 'g'
+    { 0x7F, 0x08, 0x04, 0x04, 0x78 },   // 'h'
+    { 0x00, 0x44, 0x7D, 0x40, 0x00 },   // 'i'
+    { 0x20, 0x40, 0x44, 0x3D, 0x00 },   // 'j'
+    { 0x7F, 0x10, 0x28, 0x44, 0x00 },   // 'k'
+    { 0x00, 0x41, 0x7F, 0x40, 0x00 },   // 'l'
+    { 0x7C, 0x04, 0x18, 0x04, 0x78 },   // 'm'
+    { 0x7C, 0x08, 0x04, 0x04, 0x78 },   // 'n'
+    { 0x38, 0x44, 0x44, 0x44, 0x38 },   // 'o'
+    { 0x7C, 0x14, 0x14, 0x14, 0x08 },   // 'p'
+    { 0x08, 0x14, 0x14, 0x18, 0x7C },   // 'q'
+    { 0x7C, 0x08, 0x04, 0x04, 0x08 },   // 'r'
+    { 0x48, 0x54, 0x54, 0x54, 0x20 },   // 's'
+    { 0x04, 0x3F, 0x44, 0x40, 0x20 },   // 't'
+    { 0x3C, 0x40, 0x40, 0x20, 0x7C },   // 'u'
+    { 0x1C, 0x20, 0x40, 0x20, 0x1C },   // 'v'
+    { 0x3C, 0x40, 0x30, 0x40, 0x3C },   // 'w'
+    { 0x44, 0x28, 0x10, 0x28, 0x44 },   // 'x'
+    { 0x0C, 0x50, 0x50, 0x50, 0x3C },   // 'y'
+    { 0x44, 0x64, 0x54, 0x4C, 0x44 },   // 'z'
+    { 0x00, 0x08, 0x36, 0x41, 0x00 },   // '{'
+    { 0x00, 0x00, 0x7F, 0x00, 0x00 },   // '|'
+    { 0x00, 0x41, 0x36, 0x08, 0x00 },   // '}'
+    { 0x08, 0x04, 0x08, 0x10, 0x08 },   // '~'
+    { 0x00, 0x06, 0x09, 0x09, 0x06 },   // degree sign (0x7F)
+};
+
+// merges up to 8 bits of one column, starting at pixel row y (on a page boundary or not), clipped
+static void mergeColumn(int16_t x, int16_t y, uint8_t bits, uint8_t mask) {
+    if (x < 0 || x >= OLED_WIDTH || y <= -8 || y >= OLED_HEIGHT)
+        return;
+    int16_t page = (y >= 0) ? y / 8 : -1;
+    uint8_t shift = (uint8_t)(y - page * 8);
+    if (page >= 0)
+        oledMergeByte((uint8_t)page, (uint8_t)x, (uint8_t)(bits << shift), (uint8_t)(mask << shift));
+    if (shift != 0 && page + 1 < OLED_PAGES)
+        oledMergeByte((uint8_t)(page + 1), (uint8_t)x, (uint8_t)(bits >> (8 - shift)), (uint8_t)(mask >> (8 - shift)));
+}
+
+/* API functions */
+
+void oledGfxFill(bool on) {
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t x = 0; x < OLED_WIDTH; x++)
+            oledMergeByte(page, x, on ? 0xFF : 0, 0xFF);
+    }
+}
+
+void oledGfxPixel(int16_t x, int16_t y, bool on) {
+    mergeColumn(x, y, on ? 1 : 0, 1);
+}
+
+void oledGfxFillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on) {
+    int16_t x0 = (x < 0) ? 0 : x;
+    int16_t x1 = (x + w > OLED_WIDTH) ? OLED_WIDTH : x + w;
+    int16_t y0 = (y < 0) ? 0 : y;
+    int16_t y1 = (y + h > OLED_HEIGHT) ? OLED_HEIGHT : y + h;
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    for (int16_t page = y0 / 8; page <= (y1 - 1) / 8; page++) {
+        int16_t top = (y0 > page * 8) ? y0 - page * 8 : 0;
+        int16_t bottom = (y1 < page * 8 + 8) ? y1 - page * 8 : 8;
+        uint8_t mask = (uint8_t)((0xFFU << top) & (0xFFU >> (8 - bottom)));
+        for (int16_t col = x0; col < x1; col++)
+            oledMergeByte((uint8_t)page, (uint8_t)col, on ? mask : 0, mask);
+    }
+}
+
+void oledGfxRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on) {
+    if (w <= 0 || h <= 0)
+        return;
+    oledGfxFillRect(x, y, w, 1, on);
+    oledGfxFillRect(x, y + h - 1, w, 1, on);
+    oledGfxFillRect(x, y, 1, h, on);
+    oledGfxFillRect(x + w - 1, y, 1, h, on);
+}
+
+void oledGfxLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool on) {
+    int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int16_t dy = (y1 > y0) ? y0 - y1 : y1 - y0;     // negative
+    int16_t sx = (x0 < x1) ? 1 : -1;
+    int16_t sy = (y0 < y1) ? 1 : -1;
+    int16_t err = dx + dy;
+    while (1) {
+        oledGfxPixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1)
+            return;
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void oledGfxBlit(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h) {
+    for (int16_t row = 0; row * 8 < h; row++) {
+        int16_t rowH = (h - row * 8 < 8) ? h - row * 8 : 8;
+        uint8_t mask = (uint8_t)(0xFFU >> (8 - rowH));
+        for (int16_t i = 0; i < w; i++)
+            mergeColumn(x + i, y + row * 8, bitmap[row * w + i], mask);
+    }
+}
+
+int16_t oledGfxChar(int16_t x, int16_t y, char c) {
+    uint8_t code = (uint8_t)c;
+    if (code < FONT_FIRST || code > FONT_LAST)
+        code = '?';
+    const uint8_t* glyph = font[code - FONT_FIRST];
+    for (uint8_t i = 0; i < FONT_W; i++)
+        mergeColumn(x + i, y, glyph[i], 0xFF);
+    mergeColumn(x + FONT_W, y, 0, 0xFF);
+    return x + OLED_GFX_CHAR_W;
+}
+
+int16_t oledGfxStr(int16_t x, int16_t y, const char* str) {
+    while (*str)
+        x = oledGfxChar(x, y, *str++);
+    return x;
+}
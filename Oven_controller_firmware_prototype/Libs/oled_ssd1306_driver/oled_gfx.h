@@ -0,0 +1,81 @@
+/**
+ * @file oled_gfx.h
+ * @brief Drawing primitives, text and bitmap blits on the OLED framebuffer. See oled_gfx.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Everything is drawn through oledMergeByte, a whole page byte at a time where possible, so only the bytes that change become dirty
+- 5x7 font for ASCII 0x20-0x7E plus a degree sign as 0x7F (OLED_GFX_DEGREE), drawn in 6x8 cells with their background, so text can be overwritten without clearing it first
+- Bitmaps in the display's layout (page-major rows of vertical bytes, bit 0 at the top), at any y
+- Coordinates outside the display are clipped
+
+# Limitations
+- One colour: true lights the pixels, false clears them
+*/
+
+#ifndef OLED_GFX_H
+#define OLED_GFX_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#define OLED_GFX_CHAR_W     6       // cell width, 5 columns and a space
+#define OLED_GFX_CHAR_H     8
+#define OLED_GFX_DEGREE     "\x7F"
+
+/**
+ * @brief Fills the whole framebuffer
+ * @param on pixel value
+ */
+void oledGfxFill(bool on);
+
+/**
+ * @brief Sets one pixel
+ */
+void oledGfxPixel(int16_t x, int16_t y, bool on);
+
+/**
+ * @brief Fills a rectangle
+ * @param x left edge
+ * @param y top edge
+ * @param w width
+ * @param h height
+ * @param on pixel value
+ */
+void oledGfxFillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on);
+
+/**
+ * @brief Draws a rectangle's outline, one pixel wide
+ */
+void oledGfxRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on);
+
+/**
+ * @brief Draws a line
+ */
+void oledGfxLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool on);
+
+/**
+ * @brief Copies a bitmap into the framebuffer (opaque, its clear pixels clear the framebuffer's)
+ * @param x left edge
+ * @param y top edge, not necessarily on a page boundary
+ * @param bitmap (w * ((h + 7) / 8)) bytes: rows of 8 pixels from the top, each a column per byte with bit 0 at the top
+ * @param w width
+ * @param h height
+ */
+void oledGfxBlit(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h);
+
+/**
+ * @brief Draws a character cell
+ * @param c character, '?' for ones the font doesn't have
+ * @return x after the cell
+ */
+int16_t oledGfxChar(int16_t x, int16_t y, char c);
+
+/**
+ * @brief Draws a string on one line, no wrapping
+ * @return x after the last cell
+ */
+int16_t oledGfxStr(int16_t x, int16_t y, const char* str);
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * @file oled_ssd1306_driver.c
+ * @brief SSD1306/SH1106 128x64 I2C OLED driver implementation for STM32. See oled_ssd1306_driver.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * This file implements a non-blocking, DMA-based driver for graphical OLED modules on an I2C bus shared through the i2c_bus arbiter. Each page of the framebuffer has a dirty column range, widened by every byte whose value changes. An update covers the pages that were dirty when it was requested and sends one region per bus grant, so the LCD queue and the sensor reads keep flowing in between.
+ *
+ * A region is one transfer: its addressing commands, each with a control byte that has the continuation bit set, then a data control byte and the framebuffer bytes. On the SSD1306 the region is a column/page window in horizontal addressing mode and may span several pages. Adjacent dirty pages are merged while the clean bytes the union of their column ranges adds cost less than a transfer of their own (address, six commands and two control bytes). The SH1106 only has page addressing, so its regions are single pages.
+ *
+ * The region's bytes are copied into the SRAM transfer buffer and its dirty ranges are cleared in busStart, in one go, so a byte drawn while the region is on the wire is simply dirty again.
+ */
+
+#include "oled_ssd1306_driver.h"
+#include "ccmram.h"
+
+/* HARDWARE ABSTRACTION */
+
+#define CTRL_CMD_STREAM             (uint8_t)0x00   // all following bytes are commands
+#define CTRL_CMD_SINGLE             (uint8_t)0x80   // one command, then another control byte
+#define CTRL_DATA_STREAM            (uint8_t)0x40   // all following bytes are display data
+
+#define CMD_SET_COLUMN_RANGE        (uint8_t)0x21   // SSD1306, + start, end
+#define CMD_SET_PAGE_RANGE          (uint8_t)0x22   // SSD1306, + start, end
+#define CMD_SET_PAGE                (uint8_t)0xB0   // | page, page addressing mode
+#define CMD_SET_COLUMN_LOW          (uint8_t)0x00   // | low nibble, page addressing mode
+#define CMD_SET_COLUMN_HIGH         (uint8_t)0x10   // | high nibble, page addressing mode
+
+#define SH1106_COLUMN_OFFSET        2
+#define REGION_CMDS_MAX             6
+#define REGION_OVERHEAD             (1 + 2 * REGION_CMDS_MAX + 1)   // address, commands with their control bytes, data control byte
+#define CONFIG_TIMEOUT_MS           10
+
+static const uint8_t initSsd1306[] = {
+    0xAE,           // display off
+    0xD5, 0x80,     // clock divide ratio, oscillator frequency
+    0xA8, 0x3F,     // multiplex ratio: 64
+    0xD3, 0x00,     // display offset
+    0x40,           // start line 0
+    0x8D, 0x14,     // charge pump on
+    0x20, 0x00,     // horizontal addressing mode
+    0xA1,           // segment remap (column 127 at SEG0)
+    0xC8,           // COM scan direction remapped
+    0xDA, 0x12,     // COM pins: alternative configuration
+    0x81, 0xCF,     // contrast
+    0xD9, 0xF1,     // pre-charge period
+    0xDB, 0x40,     // VCOMH deselect level
+    0xA4,           // display follows RAM
+    0xA6,           // normal (not inverted)
+    0xAF,           // display on
+};
+
+static const uint8_t initSh1106[] = {
+    0xAE,           // display off
+    0xD5, 0x80,     // clock divide ratio, oscillator frequency
+    0xA8, 0x3F,     // multiplex ratio: 64
+    0xD3, 0x00,     // display offset
+    0x40,           // start line 0
+    0xAD, 0x8B,     // DC-DC converter on
+    0xA1,           // segment remap
+    0xC8,           // COM scan direction remapped
+    0xDA, 0x12,     // COM pins: alternative configuration
+    0x81, 0x80,     // contrast
+    0xD9, 0x22,     // pre-charge period
+    0xDB, 0x35,     // VCOM deselect level
+    0xA4,           // display follows RAM
+    0xA6,           // normal (not inverted)
+    0xAF,           // display on
+};
+
+/* DRIVER STATE */
+
+typedef struct Region_t {
+    uint8_t page0;
+    uint8_t page1;
+    uint8_t x0;
+    uint8_t x1;
+} Region_t;
+
+static OLEDController_t controller;
+static uint8_t oledAddress;
+static uint8_t busId;
+
+static uint8_t framebuffer[OLED_PAGES][OLED_WIDTH] CCMRAM_BSS;
+static volatile uint8_t dirtyMin[OLED_PAGES];   // dirty column range of each page, clean when min > max
+static volatile uint8_t dirtyMax[OLED_PAGES];
+
+static uint8_t xfer[2 * REGION_CMDS_MAX + 1 + OLED_XFER_DATA_MAX];  // DMA source, must stay in SRAM
+static uint16_t xferSize;
+static Region_t region;     // the region on the wire
+
+static volatile uint8_t updatePages = 0;    // pages the update still has to look at
+static volatile bool updating = false;
+static uint16_t updateBytes;
+static uint8_t updateTransfers;
+static volatile OLEDStats_t stats;
+static volatile OLEDStatus_t oledStatus = OLED_OK;
+
+/* DIRTY TRACKING */
+
+static inline bool isDirty(uint8_t page) {
+    return dirtyMin[page] <= dirtyMax[page];
+}
+
+static inline void markDirty(uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < dirtyMin[page])
+        dirtyMin[page] = x0;
+    if (x1 > dirtyMax[page])
+        dirtyMax[page] = x1;
+}
+
+static inline void markClean(uint8_t page) {
+    dirtyMin[page] = 0xFF;
+    dirtyMax[page] = 0;
+}
+
+// finds the next region of the update, drops the pages that turned out clean, returns false if there's none
+CCMRAM_FUNC static bool pickRegion(Region_t* r) {
+    uint8_t page = 0;
+    while (page < OLED_PAGES) {
+        if (updatePages & (1U << page)) {
+            if (isDirty(page))
+                break;
+            updatePages &= (uint8_t)~(1U << page);
+        }
+        page++;
+    }
+    if (page >= OLED_PAGES)
+        return false;
+
+    r->page0 = r->page1 = page;
+    r->x0 = dirtyMin[page];
+    r->x1 = dirtyMax[page];
+    if (controller != OLED_SSD1306)
+        return true;
+
+    // merge the following dirty pages while the window is cheaper than separate transfers
+    uint16_t separate = r->x1 - r->x0 + 1;
+    while (r->page1 + 1 < OLED_PAGES) {
+        uint8_t q = r->page1 + 1;
+        if (!(updatePages & (1U << q)) || !isDirty(q))
+            break;
+        uint8_t x0 = (dirtyMin[q] < r->x0) ? dirtyMin[q] : r->x0;
+        uint8_t x1 = (dirtyMax[q] > r->x1) ? dirtyMax[q] : r->x1;
+        uint16_t merged = (uint16_t)(x1 - x0 + 1) * (q - r->page0 + 1);
+        uint16_t own = dirtyMax[q] - dirtyMin[q] + 1;
+        if (merged > OLED_XFER_DATA_MAX || merged > separate + own + REGION_OVERHEAD)
+            break;
+        r->page1 = q;
+        r->x0 = x0;
+        r->x1 = x1;
+        separate += own + REGION_OVERHEAD;
+    }
+    return true;
+}
+
+// builds the region's transfer and marks its bytes as sent
+CCMRAM_FUNC static void prepareRegion(const Region_t* r) {
+    uint8_t cmds[REGION_CMDS_MAX];
+    uint8_t cmdCount = 0;
+    if (controller == OLED_SSD1306) {
+        cmds[cmdCount++] = CMD_SET_COLUMN_RANGE;
+        cmds[cmdCount++] = r->x0;
+        cmds[cmdCount++] = r->x1;
+        cmds[cmdCount++] = CMD_SET_PAGE_RANGE;
+        cmds[cmdCount++] = r->page0;
+        cmds[cmdCount++] = r->page1;
+    } else {
+        uint8_t column = r->x0 + SH1106_COLUMN_OFFSET;
+        cmds[cmdCount++] = CMD_SET_PAGE | r->page0;
+        cmds[cmdCount++] = CMD_SET_COLUMN_LOW | (column & 0x0F);
+        cmds[cmdCount++] = CMD_SET_COLUMN_HIGH | (column >> 4);
+    }
+
+    uint16_t n = 0;
+    for (uint8_t i = 0; i < cmdCount; i++) {
+        xfer[n++] = CTRL_CMD_SINGLE;
+        xfer[n++] = cmds[i];
+    }
+    xfer[n++] = CTRL_DATA_STREAM;
+    for (uint8_t page = r->page0; page <= r->page1; page++) {
+        for (uint8_t x = r->x0; x <= r->x1; x++)
+            xfer[n++] = framebuffer[page][x];
+        markClean(page);
+        updatePages &= (uint8_t)~(1U << page);
+    }
+    xferSize = n;
+}
+
+// ends the update if nothing is left, returns true if there is
+CCMRAM_FUNC static bool continueUpdate(void) {
+    Region_t next;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool more = pickRegion(&next);
+    if (!more && updating) {
+        stats.updates++;
+        stats.lastBytes = updateBytes;
+        stats.lastTransfers = updateTransfers;
+        updating = false;
+    }
+    __set_PRIMASK(primask);
+    return more;
+}
+
+/* I2C bus client */
+
+CCMRAM_FUNC static bool busStart(void) {
+    if (!pickRegion(&region))
+        return continueUpdate();    // nothing left, ends the update
+    prepareRegion(&region);
+    if (HAL_I2C_Master_Transmit_DMA(i2cBusGetHandle(), oledAddress, xfer, xferSize) != HAL_OK) {
+        for (uint8_t page = region.page0; page <= region.page1; page++)
+            markDirty(page, region.x0, region.x1);
+        oledStatus = OLED_I2C_INIT_FAIL;
+        updatePages = 0;
+        continueUpdate();
+        return false;
+    }
+    return true;
+}
+
+CCMRAM_FUNC static bool busComplete(void) {
+    updateBytes += 1 + xferSize;
+    updateTransfers++;
+    oledStatus = OLED_OK;
+    return continueUpdate();
+}
+
+static bool busError(void) {    // the region is sent again by the next update
+    for (uint8_t page = region.page0; page <= region.page1; page++)
+        markDirty(page, region.x0, region.x1);
+    oledStatus = OLED_I2C_ERROR;
+    updatePages = 0;
+    continueUpdate();
+    return false;
+}
+
+static const I2CBusClient_t busClient = { busStart, busComplete, busError };
+
+/* API functions */
+
+OLEDStatus_t oledInit(OLEDController_t ctrl, uint8_t address) {
+    controller = ctrl;
+    oledAddress = (uint8_t)(address << 1);
+    updatePages = 0;
+    updating = false;
+    stats.updates = 0;
+    stats.lastBytes = 0;
+    stats.lastTransfers = 0;
+    oledStatus = OLED_OK;
+
+    I2C_HandleTypeDef* hi2c = i2cBusGetHandle();
+    if (HAL_I2C_IsDeviceReady(hi2c, oledAddress, 2, CONFIG_TIMEOUT_MS) != HAL_OK)
+        return OLED_NOT_FOUND;
+
+    const uint8_t* init = (ctrl == OLED_SSD1306) ? initSsd1306 : initSh1106;
+    uint8_t size = (ctrl == OLED_SSD1306) ? sizeof(initSsd1306) : sizeof(initSh1106);
+    uint8_t buffer[sizeof(initSsd1306) + 1];
+    buffer[0] = CTRL_CMD_STREAM;
+    for (uint8_t i = 0; i < size; i++)
+        buffer[i + 1] = init[i];
+    if (HAL_I2C_Master_Transmit(hi2c, oledAddress, buffer, size + 1, CONFIG_TIMEOUT_MS) != HAL_OK)
+        return OLED_I2C_INIT_FAIL;
+
+    // the display RAM holds noise after power-up
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t x = 0; x < OLED_WIDTH; x++)
+            framebuffer[page][x] = 0;
+    }
+    oledInvalidate();
+
+    if (i2cBusRegister(&busClient, &busId) != I2C_BUS_OK)
+        return OLED_BUS_FULL;
+    return OLED_OK;
+}
+
+void oledMergeByte(uint8_t page, uint8_t x, uint8_t bits, uint8_t mask) {
+    if (page >= OLED_PAGES || x >= OLED_WIDTH)
+        return;
+    uint8_t old = framebuffer[page][x];
+    uint8_t value = (old & ~mask) | (bits & mask);
+    if (value == old)
+        return;
+    framebuffer[page][x] = value;
+    markDirty(page, x, x);
+}
+
+uint8_t oledGetByte(uint8_t page, uint8_t x) {
+    if (page >= OLED_PAGES || x >= OLED_WIDTH)
+        return 0;
+    return framebuffer[page][x];
+}
+
+void oledInvalidate(void) {
+    for (uint8_t page = 0; page < OLED_PAGES; page++)
+        markDirty(page, 0, OLED_WIDTH - 1);
+}
+
+OLEDStatus_t oledUpdate(void) {
+    uint8_t pages = 0;
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        if (isDirty(page))
+            pages |= 1U << page;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    updatePages |= pages;
+    bool start = !updating && updatePages != 0;
+    if (start) {
+        updating = true;
+        updateBytes = 0;
+        updateTransfers = 0;
+    }
+    __set_PRIMASK(primask);
+
+    if (start)
+        i2cBusRequest(busId);
+    return oledStatus;
+}
+
+bool oledIsBusy(void) {
+    return updating;
+}
+
+void oledGetStats(OLEDStats_t* s) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s->updates = stats.updates;
+    s->lastBytes = stats.lastBytes;
+    s->lastTransfers = stats.lastTransfers;
+    __set_PRIMASK(primask);
+}
+
+OLEDStatus_t oledGetStatus(void) {
+    return oledStatus;
+}
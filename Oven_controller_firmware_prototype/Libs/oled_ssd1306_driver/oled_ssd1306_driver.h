@@ -0,0 +1,113 @@
+/**
+ * @file oled_ssd1306_driver.h
+ * @brief Public API for the SSD1306/SH1106 128x64 I2C OLED driver for STM32. See oled_ssd1306_driver.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- 1 KB framebuffer in the display's own layout (8 pages of 128 one-byte columns), in CCM RAM when the firmware is built with OVEN_CCMRAM
+- Drawing only marks bytes that actually change, as a dirty column range per page, so redrawing unchanged content costs nothing on the bus
+- oledUpdate sends only the dirty regions, asynchronously. Each region is one DMA transfer carrying its addressing commands and its data. On the SSD1306, neighbouring dirty pages are merged into one window when that's cheaper than a transfer of their own.
+- Shares the I2C bus with the LCD and the sensors through the i2c_bus arbiter
+- Drawing primitives, a 5x7 font and bitmap blits in oled_gfx.h
+
+# Limitations
+- 128x64 modules only, no scrolling, contrast or inversion control
+- Regions are copied from the framebuffer into an SRAM buffer before their transfer (DMA can't read CCM RAM), up to OLED_XFER_DATA_MAX bytes each
+- Drawing during an update is fine, a byte changed after its region was copied is sent by the next update
+
+# Requirements:
+- Replace the included stm32f3xx_hal.h file according to your MCU
+- Enable I2C interrupts and the I2C TX DMA
+- Call i2cBusInit before oledInit and route the HAL I2C callbacks to the arbiter (see i2c_bus.h)
+*/
+
+#ifndef OLED_SSD1306_DRIVER_H
+#define OLED_SSD1306_DRIVER_H
+
+#include "stm32f3xx_hal.h"  // change if using a different MCU
+#include "stdbool.h"
+#include "i2c_bus.h"
+
+#define OLED_WIDTH              128
+#define OLED_HEIGHT             64
+#define OLED_PAGES              (OLED_HEIGHT / 8)
+#define OLED_XFER_DATA_MAX      256     // framebuffer bytes in one transfer (two full pages)
+
+/* Status info */
+
+typedef enum OLEDStatus_t {
+    OLED_OK,
+    OLED_NOT_FOUND,             // The display didn't acknowledge its address.
+    OLED_I2C_INIT_FAIL,         // Failed to send the initialisation commands or to start an I2C DMA transfer.
+    OLED_I2C_ERROR,             // The I2C reported an error during a transfer. The region is marked dirty again and the update ends.
+    OLED_BUS_FULL,              // Failed to register with the I2C bus arbiter.
+} OLEDStatus_t;
+
+typedef enum OLEDController_t {
+    OLED_SSD1306,
+    OLED_SH1106,                // 132-column RAM, the visible area starts at column 2, page addressing only
+} OLEDController_t;
+
+typedef struct OLEDStats_t {
+    uint32_t updates;           // completed updates
+    uint16_t lastBytes;         // bytes on the bus during the last update, address bytes included
+    uint8_t lastTransfers;      // transfers of the last update
+} OLEDStats_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the display, clears the framebuffer and registers the driver with the I2C bus arbiter
+ * @note Uses blocking transfers. Call before the bus is used asynchronously (e.g. before lcdInit) or with the other clients idle. The whole display is dirty afterwards, the first oledUpdate clears it.
+ * @param controller display's controller
+ * @param address display's 7-bit I2C address (0x3C or 0x3D, will be shifted internally)
+ */
+OLEDStatus_t oledInit(OLEDController_t controller, uint8_t address);
+
+/**
+ * @brief Changes bits of one framebuffer byte, marking it dirty if its value changes
+ * @param page page (row of 8 pixels), 0 at the top
+ * @param x column
+ * @param bits new values of the bits (bit 0 is the top pixel of the page)
+ * @param mask bits to change
+ */
+void oledMergeByte(uint8_t page, uint8_t x, uint8_t bits, uint8_t mask);
+
+/**
+ * @brief Reads a framebuffer byte
+ * @param page page (row of 8 pixels)
+ * @param x column
+ */
+uint8_t oledGetByte(uint8_t page, uint8_t x);
+
+/**
+ * @brief Marks the whole framebuffer dirty, so the next update resends everything
+ */
+void oledInvalidate(void);
+
+/**
+ * @brief Starts sending the dirty regions, returns immediately
+ * @note During an update, the call adds the newly dirty pages to it
+ */
+OLEDStatus_t oledUpdate(void);
+
+/**
+ * @brief Checks whether an update is in progress
+ * @return bool
+ */
+bool oledIsBusy(void);
+
+/**
+ * @brief Copies the transfer statistics
+ * @param stats output
+ */
+void oledGetStats(OLEDStats_t* stats);
+
+/**
+ * @brief Returns the driver's status
+ * @return OLEDStatus_t
+ */
+OLEDStatus_t oledGetStatus(void);
+
+#endif
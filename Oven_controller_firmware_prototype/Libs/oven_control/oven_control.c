@@ -0,0 +1,115 @@
+/**
+ * @file oven_control.c
+ * @brief Oven control loop implementation. See oven_control.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Each tick the profile engine gives the setpoint and the top heater's share, the PID turns the chamber error into a total power demand and the splitter divides it between the heaters. The splitter's table is only rebuilt when the share changes, at segment boundaries. If the heater output has to scale the duties down to stay under the current cap, the power that actually reaches the heaters is passed back to the PID as its applied output.
+ */
+
+#include "oven_control.h"
+#include "ccmram.h"
+
+const OvenControlConfig_t ovenControlDefaultConfig = {
+    .gains = { .kp = 0.06f, .ki = 0.0006f, .kd = 0.2f },
+    .derivativeFilter = 5.0f,
+    .dt = 1.0f,
+    .topPower = 1500.0f,
+    .bottomPower = 1200.0f,
+    .topCurrent = 6.5f,
+    .bottomCurrent = 5.2f,
+    .currentCap = 16.0f,
+};
+
+/* API functions */
+
+HeaterOutStatus_t ovenControlInit(OvenControl_t* oc, const OvenControlConfig_t* cfg) {
+    profileInit(&oc->profile, cfg->dt);
+    pidInit(&oc->pid, cfg->gains, cfg->dt, 0.0f, 1.0f);
+    pidSetDerivativeFilter(&oc->pid, cfg->derivativeFilter);
+    psplitInit(&oc->split, cfg->topPower, cfg->bottomPower, 0.5f);
+
+    float total = cfg->topPower + cfg->bottomPower;
+    oc->powerShare[HEATER_TOP] = cfg->topPower / total;
+    oc->powerShare[HEATER_BOTTOM] = cfg->bottomPower / total;
+    oc->chamber = 0.0f;
+    oc->setpoint = 0.0f;
+    oc->demand = 0.0f;
+    return heaterOutInit(&oc->heater, cfg->topCurrent, cfg->bottomCurrent, cfg->currentCap);
+}
+
+void ovenControlStart(OvenControl_t* oc, const BakeProgram_t* program, float chamber) {
+    pidReset(&oc->pid);
+    profileStart(&oc->profile, program, chamber);
+    oc->setpoint = chamber;
+}
+
+void ovenControlStop(OvenControl_t* oc) {
+    profileStop(&oc->profile);
+    heaterOutSetDutyQ15(&oc->heater, 0, 0);
+    oc->demand = 0.0f;
+}
+
+bool ovenControlCommand(OvenControl_t* oc, uint8_t command) {
+    ProfilePhase_t phase = profileGetPhase(&oc->profile);
+    bool running = (phase != PROFILE_IDLE && phase != PROFILE_DONE);
+    switch (command) {
+        case OVEN_CMD_PIZZA:
+            ovenControlStart(oc, &profilePizza, oc->chamber);
+            return true;
+        case OVEN_CMD_BREAD:
+            ovenControlStart(oc, &profileBread, oc->chamber);
+            return true;
+        case OVEN_CMD_STOP:
+            ovenControlStop(oc);
+            return true;
+        case OVEN_CMD_TOGGLE:
+            if (running)
+                ovenControlStop(oc);
+            else
+                ovenControlStart(oc, &profilePizza, oc->chamber);
+            return true;
+        default:
+            return false;
+    }
+}
+
+CCMRAM_FUNC ProfilePhase_t ovenControlStep(OvenControl_t* oc, float chamber) {
+    oc->chamber = chamber;
+    ProfileOutput_t out = { oc->setpoint, oc->split.ratio };
+    ProfilePhase_t phase = profileTick(&oc->profile, chamber, &out);
+    if (phase == PROFILE_IDLE || phase == PROFILE_DONE) {
+        heaterOutSetDutyQ15(&oc->heater, 0, 0);
+        oc->demand = 0.0f;
+        return phase;
+    }
+
+    if (out.topShare != oc->split.ratio)
+        psplitSetRatio(&oc->split, out.topShare);
+    oc->setpoint = out.setpoint;
+
+    float demand = pidStep(&oc->pid, out.setpoint, chamber);
+    uint16_t duty[HEATER_OUT_CHANNELS];
+    psplitApply(&oc->split, (uint16_t)(demand * (float)HEATER_OUT_DUTY_ONE + 0.5f), duty);
+
+    if (heaterOutSetDutyQ15(&oc->heater, duty[HEATER_TOP], duty[HEATER_BOTTOM]) == HEATER_OUT_OK) {
+        oc->demand = demand;
+    } else {
+        oc->demand = heaterOutGetDuty(&oc->heater, HEATER_TOP) * oc->powerShare[HEATER_TOP]
+                   + heaterOutGetDuty(&oc->heater, HEATER_BOTTOM) * oc->powerShare[HEATER_BOTTOM];
+        pidTrackOutput(&oc->pid, oc->demand);
+    }
+    return phase;
+}
+
+CCMRAM_FUNC uint8_t ovenControlHalfCycle(OvenControl_t* oc) {
+    return heaterOutNextHalfCycle(&oc->heater);
+}
+
+float ovenControlGetSetpoint(const OvenControl_t* oc) {
+    return oc->setpoint;
+}
+
+float ovenControlGetDemand(const OvenControl_t* oc) {
+    return oc->demand;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file oven_control.h
+ * @brief Public API for the oven control loop: bake profile, chamber PID, power split and heater output. See oven_control.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- One instance holds the complete loop, no hardware access and no global state, so the same code runs in the firmware and in any number of host simulations at once
+- Sensor side: one chamber temperature per control tick. Actuator side: the SSR mask for each mains half-cycle.
+- The heaters' power ratio follows the running segment of the bake program
+- Current cap scaling in the heater output is fed back to the PID (no integral windup)
+- Single-byte commands (start a program, stop, start/stop toggle for a button), so every input that changes the loop's behaviour can be recorded and replayed
+
+# Limitations
+- Single loop on the chamber temperature, the stone is only heated through the program's power ratio
+
+# Requirements:
+- Call ovenControlStep every cfg.dt seconds and ovenControlHalfCycle once per mains half-cycle
+*/
+
+#ifndef OVEN_CONTROL_H
+#define OVEN_CONTROL_H
+
+#include "bake_profile.h"
+#include "heater_output.h"
+#include "pid_controller.h"
+#include "power_splitter.h"
+
+#define OVEN_CMD_PIZZA          (uint8_t)'p'    // start the pizza program
+#define OVEN_CMD_BREAD          (uint8_t)'b'    // start the bread program
+#define OVEN_CMD_STOP           (uint8_t)'s'
+#define OVEN_CMD_TOGGLE         (uint8_t)'t'    // stop if a program is running, otherwise start the pizza program
+
+typedef struct OvenControlConfig_t {
+    PIDGains_t gains;               // demand (0.0 - 1.0 of the combined power) per degC
+    float derivativeFilter;         // [s] (0 = no filter)
+    float dt;                       // control period [s]
+    float topPower;                 // [W]
+    float bottomPower;              // [W]
+    float topCurrent;               // [A RMS]
+    float bottomCurrent;            // [A RMS]
+    float currentCap;               // [A RMS]
+} OvenControlConfig_t;
+
+extern const OvenControlConfig_t ovenControlDefaultConfig;   // the prototype's heaters, 1 s tick
+
+typedef struct OvenControl_t {
+    ProfileEngine_t profile;
+    PIDController_t pid;
+    PowerSplitter_t split;
+    HeaterOutput_t heater;
+    float powerShare[HEATER_OUT_CHANNELS];  // heater powers as a share of the combined power
+    float chamber;                  // latest measurement [degC]
+    float setpoint;                 // [degC]
+    float demand;                   // demand that reached the heaters (0.0 - 1.0)
+} OvenControl_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the loop with the heaters off and no program running
+ * @param oc pointer to the loop instance
+ * @param cfg configuration
+ * @return heater output status (HEATER_OUT_CAP_TOO_LOW if an element alone exceeds the current cap)
+ */
+HeaterOutStatus_t ovenControlInit(OvenControl_t* oc, const OvenControlConfig_t* cfg);
+
+/**
+ * @brief Starts a bake program
+ * @param oc pointer to the loop instance
+ * @param program program to run
+ * @param chamber current chamber temperature [degC]
+ */
+void ovenControlStart(OvenControl_t* oc, const BakeProgram_t* program, float chamber);
+
+/**
+ * @brief Stops the program and switches the heaters off
+ * @param oc pointer to the loop instance
+ */
+void ovenControlStop(OvenControl_t* oc);
+
+/**
+ * @brief Handles a command, programs start from the chamber temperature of the latest tick
+ * @param oc pointer to the loop instance
+ * @param command OVEN_CMD_*
+ * @return false if the command is unknown
+ */
+bool ovenControlCommand(OvenControl_t* oc, uint8_t command);
+
+/**
+ * @brief Runs one control tick
+ * @param oc pointer to the loop instance
+ * @param chamber measured chamber temperature [degC]
+ * @return program phase after the tick (the heaters are off when it's PROFILE_IDLE or PROFILE_DONE)
+ */
+ProfilePhase_t ovenControlStep(OvenControl_t* oc, float chamber);
+
+/**
+ * @brief Plans the next mains half-cycle
+ * @note Integer-only, safe to call from an interrupt
+ * @param oc pointer to the loop instance
+ * @return mask of the heaters to switch on (HEATER_TOP_BIT, HEATER_BOTTOM_BIT)
+ */
+uint8_t ovenControlHalfCycle(OvenControl_t* oc);
+
+/**
+ * @brief Returns the setpoint of the latest tick [degC]
+ */
+float ovenControlGetSetpoint(const OvenControl_t* oc);
+
+/**
+ * @brief Returns the power demand that reached the heaters in the latest tick, after current cap scaling (0.0 - 1.0)
+ */
+float ovenControlGetDemand(const OvenControl_t* oc);
+
+#endif
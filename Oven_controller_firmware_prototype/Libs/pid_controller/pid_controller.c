@@ -0,0 +1,81 @@
+/**
+ * @file pid_controller.c
+ * @brief PID controller implementation. See pid_controller.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The controller uses the parallel form u = kp*e + ki*integral(e) - kd*d(measurement)/dt. The integral term is stored already multiplied by ki, which makes ki changes bumpless by themselves; kp and kd changes are compensated in pidSetGains.
+ */
+
+#include "pid_controller.h"
+#include "ccmram.h"
+
+CCMRAM_FUNC static float clamp(float x, float lo, float hi) {
+    if (x < lo) return lo;
+    if (x > hi) return hi;
+    return x;
+}
+
+void pidInit(PIDController_t* pid, PIDGains_t gains, float dt, float outMin, float outMax) {
+    pid->gains = gains;
+    pid->dt = dt;
+    pid->invDt = 1.0f / dt;
+    pid->outMin = outMin;
+    pid->outMax = outMax;
+    pid->dAlpha = 1.0f;
+    pidReset(pid);
+}
+
+void pidSetDerivativeFilter(PIDController_t* pid, float tau) {
+    if (tau <= 0.0f)
+        pid->dAlpha = 1.0f;
+    else
+        pid->dAlpha = pid->dt / (tau + pid->dt);
+}
+
+void pidReset(PIDController_t* pid) {
+    pid->integral = 0.0f;
+    pid->dMeas = 0.0f;
+    pid->prevMeas = 0.0f;
+    pid->prevError = 0.0f;
+    pid->output = 0.0f;
+    pid->firstStep = true;
+}
+
+CCMRAM_FUNC float pidStep(PIDController_t* pid, float setpoint, float measurement) {
+    float error = setpoint - measurement;
+
+    if (pid->firstStep) {   // no derivative history yet
+        pid->prevMeas = measurement;
+        pid->firstStep = false;
+    }
+    pid->dMeas += pid->dAlpha * ((measurement - pid->prevMeas) * pid->invDt - pid->dMeas);
+    pid->prevMeas = measurement;
+    pid->prevError = error;
+
+    float pTerm = pid->gains.kp * error;
+    float dTerm = -pid->gains.kd * pid->dMeas;
+    float integral = pid->integral + pid->gains.ki * pid->dt * error;
+    float output = pTerm + integral + dTerm;
+
+    // conditional integration: don't let the integral grow further into a saturated output
+    if ((output > pid->outMax && error > 0.0f) || (output < pid->outMin && error < 0.0f))
+        integral = pid->integral;
+    pid->integral = clamp(integral, pid->outMin, pid->outMax);
+
+    pid->output = clamp(pTerm + pid->integral + dTerm, pid->outMin, pid->outMax);
+    return pid->output;
+}
+
+void pidSetGains(PIDController_t* pid, PIDGains_t gains) {
+    if (!pid->firstStep) {
+        pid->integral += (pid->gains.kp - gains.kp) * pid->prevError - (pid->gains.kd - gains.kd) * pid->dMeas;
+        pid->integral = clamp(pid->integral, pid->outMin, pid->outMax);
+    }
+    pid->gains = gains;
+}
+
+void pidTrackOutput(PIDController_t* pid, float appliedOutput) {
+    pid->integral = clamp(pid->integral + appliedOutput - pid->output, pid->outMin, pid->outMax);
+    pid->output = appliedOutput;
+}
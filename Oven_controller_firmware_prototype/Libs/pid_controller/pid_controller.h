@@ -0,0 +1,93 @@
+/**
+ * @file pid_controller.h
+ * @brief Public API for the PID controller used by the heating modes. See pid_controller.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Fixed sample time (the derivative uses a precomputed 1/dt, no divisions per step)
+- Derivative on measurement with an optional first-order filter (no derivative kick on setpoint changes)
+- Anti-windup by conditional integration, plus output tracking for saturation happening downstream (decouplers, power splitters)
+- Bumpless gain changes
+
+# Limitations
+- The controller has to be stepped at the sample time given to pidInit
+*/
+
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include "stdbool.h"
+
+typedef struct PIDGains_t {
+    float kp;
+    float ki;   // [1/s]
+    float kd;   // [s]
+} PIDGains_t;
+
+typedef struct PIDController_t {
+    PIDGains_t gains;
+    float dt;           // sample time [s]
+    float invDt;
+    float outMin;
+    float outMax;
+    float dAlpha;       // derivative filter coefficient (1 = no filtering)
+    float integral;     // integral term (already multiplied by ki)
+    float dMeas;        // filtered measurement derivative [unit/s]
+    float prevMeas;
+    float prevError;
+    float output;
+    bool firstStep;
+} PIDController_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the controller and resets its state
+ * @param pid pointer to the controller instance
+ * @param gains controller gains
+ * @param dt sample time [s]
+ * @param outMin lower output limit
+ * @param outMax upper output limit
+ */
+void pidInit(PIDController_t* pid, PIDGains_t gains, float dt, float outMin, float outMax);
+
+/**
+ * @brief Sets the time constant of the derivative filter
+ * @param pid pointer to the controller instance
+ * @param tau filter time constant [s] (0 disables the filter)
+ */
+void pidSetDerivativeFilter(PIDController_t* pid, float tau);
+
+/**
+ * @brief Calculates the controller output
+ * @param pid pointer to the controller instance
+ * @param setpoint
+ * @param measurement
+ * @return output, clamped to the limits
+ */
+float pidStep(PIDController_t* pid, float setpoint, float measurement);
+
+/**
+ * @brief Changes the gains without a step in the output
+ * @note The integral term absorbs the difference between the old and the new proportional and derivative terms
+ * @param pid pointer to the controller instance
+ * @param gains new gains
+ */
+void pidSetGains(PIDController_t* pid, PIDGains_t gains);
+
+/**
+ * @brief Informs the controller about the output that was actually applied
+ * @note Call after pidStep when the output is limited further downstream, so that the integral term doesn't wind up
+ * @param pid pointer to the controller instance
+ * @param appliedOutput output value that reached the actuator
+ */
+void pidTrackOutput(PIDController_t* pid, float appliedOutput);
+
+/**
+ * @brief Clears the integral and derivative state
+ * @param pid pointer to the controller instance
+ */
+void pidReset(PIDController_t* pid);
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file power_splitter.c
+ * @brief Power splitter implementation. See power_splitter.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Each heater's duty is piecewise linear in the demand (the pieces change where a heater saturates), so linear interpolation between table points is exact except in the segment containing a saturation point. The total power, top*Pt + bottom*Pb, is linear in the demand everywhere, so it stays exact even there, up to Q15 rounding.
+ */
+
+#include "power_splitter.h"
+#include "ccmram.h"
+
+#define SEGMENT_SHIFT   10      // log2(HEATER_OUT_DUTY_ONE / PSPLIT_TABLE_SEGMENTS)
+#define FRAC_MASK       ((1U << SEGMENT_SHIFT) - 1)
+
+_Static_assert((HEATER_OUT_DUTY_ONE >> SEGMENT_SHIFT) == PSPLIT_TABLE_SEGMENTS, "SEGMENT_SHIFT doesn't match PSPLIT_TABLE_SEGMENTS");
+
+static uint16_t toQ15(float d) {
+    if (d <= 0.0f) return 0;
+    if (d >= 1.0f) return HEATER_OUT_DUTY_ONE;
+    return (uint16_t)(d * (float)HEATER_OUT_DUTY_ONE + 0.5f);
+}
+
+void psplitInit(PowerSplitter_t* ps, float topPower, float bottomPower, float ratio) {
+    ps->power[HEATER_TOP] = topPower;
+    ps->power[HEATER_BOTTOM] = bottomPower;
+    psplitSetRatio(ps, ratio);
+}
+
+void psplitSetRatio(PowerSplitter_t* ps, float ratio) {
+    if (ratio < 0.0f) ratio = 0.0f;
+    if (ratio > 1.0f) ratio = 1.0f;
+    ps->ratio = ratio;
+
+    float pTop = ps->power[HEATER_TOP];
+    float pBottom = ps->power[HEATER_BOTTOM];
+    for (uint8_t i = 0; i <= PSPLIT_TABLE_SEGMENTS; i++) {
+        float total = (pTop + pBottom) * (float)i / PSPLIT_TABLE_SEGMENTS;
+        float top = total * ratio;
+        float bottom = total - top;
+        // redistribute what a saturated heater can't take
+        if (top > pTop) {
+            bottom += top - pTop;
+            top = pTop;
+        }
+        if (bottom > pBottom) {
+            top += bottom - pBottom;
+            bottom = pBottom;
+        }
+        ps->table[i][HEATER_TOP] = (pTop > 0.0f) ? toQ15(top / pTop) : 0;
+        ps->table[i][HEATER_BOTTOM] = (pBottom > 0.0f) ? toQ15(bottom / pBottom) : 0;
+    }
+}
+
+CCMRAM_FUNC void psplitApply(const PowerSplitter_t* ps, uint16_t demand, uint16_t duty[HEATER_OUT_CHANNELS]) {
+    if (demand >= HEATER_OUT_DUTY_ONE) {
+        duty[HEATER_TOP] = ps->table[PSPLIT_TABLE_SEGMENTS][HEATER_TOP];
+        duty[HEATER_BOTTOM] = ps->table[PSPLIT_TABLE_SEGMENTS][HEATER_BOTTOM];
+        return;
+    }
+    uint16_t i = demand >> SEGMENT_SHIFT;
+    int32_t frac = demand & FRAC_MASK;
+    for (uint8_t ch = 0; ch < HEATER_OUT_CHANNELS; ch++) {
+        int32_t d0 = ps->table[i][ch];
+        int32_t d1 = ps->table[i + 1][ch];
+        duty[ch] = (uint16_t)(d0 + (((d1 - d0) * frac) >> SEGMENT_SHIFT));
+    }
+}
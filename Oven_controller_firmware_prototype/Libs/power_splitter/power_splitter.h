@@ -0,0 +1,58 @@
+/**
+ * @file power_splitter.h
+ * @brief Public API for the single-loop variable power ratio heating mode. See power_splitter.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Maps one control output (total power demand) to top and bottom heater duties according to a user-set power ratio
+- Saturation redistribution: when one heater can't take its share, the rest goes to the other one, so the total power always matches the demand
+- Works with heaters of different power
+- Integer-only per tick: the split is precomputed into a Q15 table whenever the ratio changes and linearly interpolated
+
+# Limitations
+- Near the demand at which one of the heaters saturates, the split between the heaters (but not the total) can be off by up to 1/PSPLIT_TABLE_SEGMENTS of the combined power
+*/
+
+#ifndef POWER_SPLITTER_H
+#define POWER_SPLITTER_H
+
+#include "heater_output.h"
+#include "stdint.h"
+
+#define PSPLIT_TABLE_SEGMENTS   32  // must be a power of 2
+
+typedef struct PowerSplitter_t {
+    float power[HEATER_OUT_CHANNELS];   // heater powers [W]
+    float ratio;                        // top heater's share of the power (0.0 - 1.0)
+    uint16_t table[PSPLIT_TABLE_SEGMENTS + 1][HEATER_OUT_CHANNELS];  // duties (Q15) at evenly spaced demands
+} PowerSplitter_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the splitter
+ * @param ps pointer to the splitter instance
+ * @param topPower top heater power [W]
+ * @param bottomPower bottom heater power [W]
+ * @param ratio top heater's share of the power (0.0 - 1.0)
+ */
+void psplitInit(PowerSplitter_t* ps, float topPower, float bottomPower, float ratio);
+
+/**
+ * @brief Changes the power ratio and recalculates the table
+ * @note Not meant for every tick, it evaluates the split in float at all table points
+ * @param ps pointer to the splitter instance
+ * @param ratio top heater's share of the power (0.0 - 1.0)
+ */
+void psplitSetRatio(PowerSplitter_t* ps, float ratio);
+
+/**
+ * @brief Splits the demand between the heaters
+ * @param ps pointer to the splitter instance
+ * @param demand total power demand as a fraction of both heaters' combined power (0 - HEATER_OUT_DUTY_ONE)
+ * @param duty output duties (Q15), indexed by HeaterChannel_t, ready for heaterOutSetDutyQ15
+ */
+void psplitApply(const PowerSplitter_t* ps, uint16_t demand, uint16_t duty[HEATER_OUT_CHANNELS]);
+
+#endif
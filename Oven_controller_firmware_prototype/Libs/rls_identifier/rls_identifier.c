@@ -0,0 +1,108 @@
+/**
+ * @file rls_identifier.c
+ * @brief Online first-order model identifier implementation. See rls_identifier.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The discrete model T(k) = a*T(k-1) + b*u(k-1-delay) + c is fitted in its incremental form, dT(k) = (a - 1)*T(k-1) + b*u + c. For a slow oven, a is very close to 1 and would lose most of its significant digits in single precision, while (a - 1) doesn't. Temperatures are scaled by TEMP_SCALE so that all three regressors are of similar magnitude. With a known ambient the temperature regressor is taken relative to it and c is pinned to 0 (its regressor and covariance row are zero), so the same update runs as a 2-parameter fit.
+ */
+
+#include "rls_identifier.h"
+#include "math.h"
+
+#define TEMP_SCALE      0.01f   // regression works on hundreds of degC
+#define P_INIT          1000.0f
+#define P_TRACE_MAX     10000.0f // forgetting is suspended above this (covariance windup protection)
+
+void rlsInit(RLSIdentifier_t* rls, float dt, float forgetting, uint8_t delay) {
+    rls->dt = dt;
+    rls->forgetting = forgetting;
+    rls->delay = (delay < RLS_MAX_DELAY) ? delay : RLS_MAX_DELAY - 1;
+    rls->bufIdx = 0;
+    rls->primed = false;
+    rls->samples = 0;
+    rls->prevTemp = 0.0f;
+    rls->ambient = 0.0f;
+    rls->ambientKnown = false;
+    for (uint8_t i = 0; i < RLS_MAX_DELAY; i++)
+        rls->dutyBuf[i] = 0.0f;
+    for (uint8_t i = 0; i < 3; i++) {
+        rls->theta[i] = 0.0f;
+        for (uint8_t j = 0; j < 3; j++)
+            rls->P[i * 3 + j] = (i == j) ? P_INIT : 0.0f;
+    }
+}
+
+// with a known ambient the offset parameter is pinned to 0 and drops out of the covariance
+static void resetCovariance(RLSIdentifier_t* rls) {
+    for (uint8_t i = 0; i < 9; i++)
+        rls->P[i] = (i % 4 == 0) ? P_INIT : 0.0f;
+    if (rls->ambientKnown)
+        rls->P[8] = 0.0f;
+}
+
+void rlsSetAmbient(RLSIdentifier_t* rls, float ambient) {
+    rls->ambient = ambient * TEMP_SCALE;
+    rls->ambientKnown = true;
+    rls->theta[2] = 0.0f;
+    resetCovariance(rls);
+}
+
+void rlsUpdate(RLSIdentifier_t* rls, float duty, float temp) {
+    rls->dutyBuf[rls->bufIdx] = duty;
+    float u = rls->dutyBuf[(rls->bufIdx - rls->delay) & (RLS_MAX_DELAY - 1)];
+    rls->bufIdx = (rls->bufIdx + 1) & (RLS_MAX_DELAY - 1);
+
+    float t = temp * TEMP_SCALE;
+    if (!rls->primed) {
+        rls->prevTemp = t;
+        rls->primed = true;
+        return;
+    }
+
+    float phi[3] = { rls->prevTemp - rls->ambient, u, rls->ambientKnown ? 0.0f : 1.0f };
+    float y = t - rls->prevTemp;
+    rls->prevTemp = t;
+
+    // Pphi = P*phi, den = lambda + phi'*P*phi
+    float Pphi[3];
+    for (uint8_t i = 0; i < 3; i++)
+        Pphi[i] = rls->P[i * 3] * phi[0] + rls->P[i * 3 + 1] * phi[1] + rls->P[i * 3 + 2] * phi[2];
+    float trace = rls->P[0] + rls->P[4] + rls->P[8];
+    float lambda = (trace > P_TRACE_MAX) ? 1.0f : rls->forgetting;
+    float den = lambda + phi[0] * Pphi[0] + phi[1] * Pphi[1] + phi[2] * Pphi[2];
+    float invDen = 1.0f / den;
+
+    float err = y - (rls->theta[0] * phi[0] + rls->theta[1] * phi[1] + rls->theta[2] * phi[2]);
+    float invLambda = 1.0f / lambda;
+    for (uint8_t i = 0; i < 3; i++)
+        rls->theta[i] += Pphi[i] * invDen * err;
+
+    // P = (P - Pphi*Pphi'/den) / lambda, only the upper triangle is computed and mirrored so that rounding can't make P asymmetric
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t j = i; j < 3; j++) {
+            float v = (rls->P[i * 3 + j] - Pphi[i] * Pphi[j] * invDen) * invLambda;
+            rls->P[i * 3 + j] = v;
+            rls->P[j * 3 + i] = v;
+        }
+    }
+    // a non-positive diagonal means P lost definiteness, start over from the current estimate
+    if (rls->P[0] <= 0.0f || rls->P[4] <= 0.0f || (!rls->ambientKnown && rls->P[8] <= 0.0f))
+        resetCovariance(rls);
+    rls->samples++;
+}
+
+bool rlsGetModel(const RLSIdentifier_t* rls, RLSModel_t* model) {
+    float am1 = rls->theta[0];
+    float b = rls->theta[1];
+    if (rls->samples < 3 || am1 >= 0.0f || am1 <= -1.0f || b <= 0.0f)
+        return false;
+    model->gain = -b / am1 / TEMP_SCALE;
+    model->tau = -rls->dt / log1pf(am1);
+    model->ambient = (rls->ambient - rls->theta[2] / am1) / TEMP_SCALE;
+    return true;
+}
+
+float rlsGetUncertainty(const RLSIdentifier_t* rls) {
+    return rls->P[0] + rls->P[4] + rls->P[8];
+}
@@ -0,0 +1,88 @@
+/**
+ * @file rls_identifier.h
+ * @brief Public API for the online identifier of a first-order oven model. See rls_identifier.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Recursive least squares with exponential forgetting, fitting dT/dt = (K*u(t - deadTime) - (T - Tamb)) / tau
+- Identifies the gain, the time constant and the ambient temperature at the same time, or only the first two when the ambient is known (rlsSetAmbient)
+- Allocation-free, fixed 3-parameter model (about 60 floating-point operations per sample)
+- Covariance windup protection for long periods without excitation (e.g. holding a setpoint)
+
+# Limitations
+- The dead time is not identified, it has to be known (in samples)
+- The sample period should be a fair fraction of the time constant (seconds, not milliseconds), otherwise the fit gets dominated by sensor noise
+- With the ambient identified too, closed-loop data around a hold is poorly conditioned: the fit tends to take the slow parts of the oven (stone, walls) for a hot ambient and a fast local mode for the oven. Fix the ambient when it's known.
+*/
+
+#ifndef RLS_IDENTIFIER_H
+#define RLS_IDENTIFIER_H
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#define RLS_MAX_DELAY   32  // dead time buffer length [samples] (power of 2)
+
+typedef struct RLSModel_t {
+    float gain;     // temperature rise at full duty, at steady state [degC]
+    float tau;      // time constant [s]
+    float ambient;  // [degC]
+} RLSModel_t;
+
+typedef struct RLSIdentifier_t {
+    float dt;
+    float forgetting;
+    float theta[3];         // [a - 1, b, c] of dT = (a - 1)*T + b*u + c, in scaled units
+    float P[9];             // covariance
+    float dutyBuf[RLS_MAX_DELAY];
+    uint8_t bufIdx;
+    uint8_t delay;
+    float prevTemp;
+    float ambient;          // scaled, only used when ambientKnown
+    bool ambientKnown;
+    bool primed;
+    uint32_t samples;
+} RLSIdentifier_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the identifier with an uninformative prior
+ * @param rls pointer to the identifier instance
+ * @param dt sample period [s]
+ * @param forgetting forgetting factor (e.g. 0.99 - 0.999; memory is about dt / (1 - forgetting))
+ * @param delay dead time [samples] (less than RLS_MAX_DELAY)
+ */
+void rlsInit(RLSIdentifier_t* rls, float dt, float forgetting, uint8_t delay);
+
+/**
+ * @brief Fixes the ambient temperature instead of identifying it (e.g. from the thermocouple converter's cold junction), which leaves a 2-parameter fit
+ * @param rls pointer to the identifier instance
+ * @param ambient [degC]
+ */
+void rlsSetAmbient(RLSIdentifier_t* rls, float ambient);
+
+/**
+ * @brief Feeds one sample
+ * @param rls pointer to the identifier instance
+ * @param duty heater duty applied during the last period (0.0 - 1.0)
+ * @param temp temperature measured at the end of the period [degC]
+ */
+void rlsUpdate(RLSIdentifier_t* rls, float duty, float temp);
+
+/**
+ * @brief Converts the current estimate into a physical model
+ * @param rls pointer to the identifier instance
+ * @param model output
+ * @return false if the estimate isn't physically meaningful (yet)
+ */
+bool rlsGetModel(const RLSIdentifier_t* rls, RLSModel_t* model);
+
+/**
+ * @brief Returns the trace of the parameter covariance (lower means more confident)
+ * @param rls pointer to the identifier instance
+ */
+float rlsGetUncertainty(const RLSIdentifier_t* rls);
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file smith_predictor.c
+ * @brief Smith predictor implementation. See smith_predictor.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * The PID sees measurement + model - delayedModel instead of the measurement. When the model matches the oven, the delayed model output cancels the measured response and the PID effectively controls the delay-free model, while model errors and disturbances still reach it through the measurement. The model works on the temperature rise, so the ambient temperature cancels out and doesn't have to be known.
+ */
+
+#include "smith_predictor.h"
+#include "math.h"
+
+_Static_assert((SMITH_DELAY_LEN & (SMITH_DELAY_LEN - 1)) == 0, "SMITH_DELAY_LEN must be a power of 2");
+
+#define DELAY_MASK  (SMITH_DELAY_LEN - 1)
+
+SmithStatus_t smithInit(SmithPredictor_t* sp, PIDController_t* pid, SmithModel_t model) {
+    sp->pid = pid;
+    sp->a = expf(-pid->dt / model.tau);
+    sp->b = model.gain * (1.0f - sp->a);
+    sp->model = 0.0f;
+    sp->head = 0;
+    sp->output = 0.0f;
+    for (uint16_t i = 0; i < SMITH_DELAY_LEN; i++)
+        sp->delayLine[i] = 0.0f;
+
+    float delay = roundf(model.deadTime / pid->dt);
+    if (delay > DELAY_MASK) {
+        sp->delay = DELAY_MASK;
+        sp->status = SMITH_DELAY_CLAMPED;
+    } else {
+        sp->delay = (delay > 0.0f) ? (uint16_t)delay : 0;
+        sp->status = SMITH_OK;
+    }
+    return sp->status;
+}
+
+float smithStep(SmithPredictor_t* sp, float setpoint, float measurement) {
+    // advance the model by the output applied during the previous sample
+    sp->model = sp->a * sp->model + sp->b * sp->output;
+    sp->delayLine[sp->head] = sp->model;
+    float delayed = sp->delayLine[(sp->head - sp->delay) & DELAY_MASK];
+    sp->head = (sp->head + 1) & DELAY_MASK;
+
+    sp->output = pidStep(sp->pid, setpoint, measurement + sp->model - delayed);
+    return sp->output;
+}
+
+void smithTrackOutput(SmithPredictor_t* sp, float appliedOutput) {
+    sp->output = appliedOutput;
+    pidTrackOutput(sp->pid, appliedOutput);
+}
+
+SmithStatus_t smithGetStatus(const SmithPredictor_t* sp) {
+    return sp->status;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file smith_predictor.h
+ * @brief Public API for the Smith predictor heating mode. See smith_predictor.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Dead-time compensation wrapped around an existing PID controller, so the PID can be tuned for the delay-free part of the oven
+- First-order model with dead time (gain, time constant, delay)
+- Fixed-size delay line (SMITH_DELAY_LEN samples, set at compile time), no allocation and O(1) work per step
+
+# Limitations
+- The dead time is rounded to whole PID sample periods and clamped to SMITH_DELAY_LEN - 1 samples
+- A wrong dead time degrades the response faster than a wrong gain or time constant, identify it with the heaters at a representative temperature
+*/
+
+#ifndef SMITH_PREDICTOR_H
+#define SMITH_PREDICTOR_H
+
+#include "pid_controller.h"
+#include "stdint.h"
+
+#ifndef SMITH_DELAY_LEN
+#define SMITH_DELAY_LEN     128     // delay line length [PID samples], must be a power of 2
+#endif
+
+/* Status info */
+
+typedef enum SmithStatus_t {
+    SMITH_OK,
+    SMITH_DELAY_CLAMPED,    // The dead time doesn't fit into the delay line. The longest possible delay is used.
+} SmithStatus_t;
+
+typedef struct SmithModel_t {
+    float gain;             // steady-state temperature rise at full output [degC]
+    float tau;              // time constant [s]
+    float deadTime;         // [s]
+} SmithModel_t;
+
+typedef struct SmithPredictor_t {
+    PIDController_t* pid;
+    float a;                            // model pole
+    float b;                            // model input gain
+    float model;                        // delay-free model output (rise above ambient) [degC]
+    float delayLine[SMITH_DELAY_LEN];   // model output history
+    uint16_t head;
+    uint16_t delay;                     // [samples]
+    float output;                       // output applied during the current sample
+    SmithStatus_t status;
+} SmithPredictor_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the predictor. The PID has to be initialised beforehand, its sample time is used for the model.
+ * @param sp pointer to the predictor instance
+ * @param pid pointer to an initialised PID controller
+ * @param model oven model
+ * @return SmithStatus_t
+ */
+SmithStatus_t smithInit(SmithPredictor_t* sp, PIDController_t* pid, SmithModel_t model);
+
+/**
+ * @brief Runs one control step
+ * @param sp pointer to the predictor instance
+ * @param setpoint [degC]
+ * @param measurement [degC]
+ * @return PID output
+ */
+float smithStep(SmithPredictor_t* sp, float setpoint, float measurement);
+
+/**
+ * @brief Informs the predictor and the PID about the output that was actually applied
+ * @note Call after smithStep when the output is limited further downstream, otherwise the model drifts from the oven
+ * @param sp pointer to the predictor instance
+ * @param appliedOutput output value that reached the actuator
+ */
+void smithTrackOutput(SmithPredictor_t* sp, float appliedOutput);
+
+/**
+ * @brief Returns the status of the latest initialisation
+ * @return SmithStatus_t
+ */
+SmithStatus_t smithGetStatus(const SmithPredictor_t* sp);
+
+#endif
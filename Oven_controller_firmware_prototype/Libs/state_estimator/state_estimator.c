@@ -0,0 +1,227 @@
+/**
+ * @file state_estimator.c
+ * @brief Kalman filter implementation. See state_estimator.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * All temperatures are kept as rise above ambient, which makes the model linear without an offset term. The continuous model is discretised once in estInit with the forward Euler method (the smallest time constant of the default model is the 3 s lag of the top sensor, 30 steps at 10 Hz, so that's accurate enough). The measurement matrix only selects the two sensor states, so C*P and P*C' are copied out of P instead of being multiplied.
+ */
+
+#include "state_estimator.h"
+
+const EstModel_t estDefaultModel = {
+    .topPower = 1500.0f,
+    .bottomPower = 1200.0f,
+    .elementCapacity = 150.0f,
+    .chamberCapacity = 8100.0f,     // air and walls
+    .stoneCapacity = 2650.0f,       // stone and bottom element
+    .elementToChamber = 4.0f,
+    .elementToStone = 3.5f,
+    .chamberToStone = 6.0f,         // air to stone and to the bottom element
+    .chamberLoss = 2.4f,
+    .stoneLoss = 0.0f,
+    .topSensorTau = 3.0f,
+    .bottomSensorTau = 15.0f,
+    .processNoise = { 0.5f, 0.05f, 0.02f, 0.01f, 0.01f, 0.001f },
+    .sensorNoise = { 0.5f, 0.5f },
+    .stoneSensorNoise = 2.0f,
+};
+
+static const uint8_t sensorIdx[EST_NY] = { EST_TOP_SENSOR, EST_BOT_SENSOR };
+
+#define IDX(r, c)   ((r) * EST_NX + (c))
+
+/* Initialisation */
+
+void estInit(StateEstimator_t* est, const EstModel_t* model, float dt, float ambient) {
+    const EstModel_t* m = model;
+    est->dt = dt;
+    est->ambient = ambient;
+
+    float ac[EST_NX * EST_NX] = { 0 };
+    float bc[EST_NX * EST_NU] = { 0 };
+
+    ac[IDX(EST_ELEMENT, EST_ELEMENT)] = -(m->elementToChamber + m->elementToStone) / m->elementCapacity;
+    ac[IDX(EST_ELEMENT, EST_CHAMBER)] = m->elementToChamber / m->elementCapacity;
+    ac[IDX(EST_ELEMENT, EST_STONE)] = m->elementToStone / m->elementCapacity;
+
+    ac[IDX(EST_CHAMBER, EST_ELEMENT)] = m->elementToChamber / m->chamberCapacity;
+    ac[IDX(EST_CHAMBER, EST_CHAMBER)] = -(m->elementToChamber + m->chamberToStone + m->chamberLoss) / m->chamberCapacity;
+    ac[IDX(EST_CHAMBER, EST_STONE)] = m->chamberToStone / m->chamberCapacity;
+    ac[IDX(EST_CHAMBER, EST_DISTURBANCE)] = 1.0f;
+
+    ac[IDX(EST_STONE, EST_ELEMENT)] = m->elementToStone / m->stoneCapacity;
+    ac[IDX(EST_STONE, EST_CHAMBER)] = m->chamberToStone / m->stoneCapacity;
+    ac[IDX(EST_STONE, EST_STONE)] = -(m->elementToStone + m->chamberToStone + m->stoneLoss) / m->stoneCapacity;
+
+    ac[IDX(EST_TOP_SENSOR, EST_CHAMBER)] = 1.0f / m->topSensorTau;
+    ac[IDX(EST_TOP_SENSOR, EST_TOP_SENSOR)] = -1.0f / m->topSensorTau;
+    ac[IDX(EST_BOT_SENSOR, EST_STONE)] = 1.0f / m->bottomSensorTau;
+    ac[IDX(EST_BOT_SENSOR, EST_BOT_SENSOR)] = -1.0f / m->bottomSensorTau;
+
+    bc[EST_ELEMENT * EST_NU + 0] = m->topPower / m->elementCapacity;
+    bc[EST_STONE * EST_NU + 1] = m->bottomPower / m->stoneCapacity;
+
+    for (uint8_t r = 0; r < EST_NX; r++) {
+        for (uint8_t c = 0; c < EST_NX; c++)
+            est->A[IDX(r, c)] = (r == c ? 1.0f : 0.0f) + ac[IDX(r, c)] * dt;
+        for (uint8_t c = 0; c < EST_NU; c++)
+            est->B[r * EST_NU + c] = bc[r * EST_NU + c] * dt;
+        est->Q[r] = m->processNoise[r] * m->processNoise[r];
+    }
+    for (uint8_t k = 0; k < EST_NY; k++)
+        est->R[k] = m->sensorNoise[k] * m->sensorNoise[k];
+    est->Rstone = m->stoneSensorNoise * m->stoneSensorNoise;
+
+    arm_mat_init_f32(&est->mx, EST_NX, 1, est->x);
+    arm_mat_init_f32(&est->mP, EST_NX, EST_NX, est->P);
+    arm_mat_init_f32(&est->mA, EST_NX, EST_NX, est->A);
+    arm_mat_init_f32(&est->mAt, EST_NX, EST_NX, est->At);
+    arm_mat_init_f32(&est->mB, EST_NX, EST_NU, est->B);
+    arm_mat_init_f32(&est->mTmpNN, EST_NX, EST_NX, est->tmpNN);
+    arm_mat_init_f32(&est->mTmpNN2, EST_NX, EST_NX, est->tmpNN2);
+    arm_mat_init_f32(&est->mK, EST_NX, EST_NY, est->K);
+    arm_mat_init_f32(&est->mPCt, EST_NX, EST_NY, est->PCt);
+    arm_mat_init_f32(&est->mCP, EST_NY, EST_NX, est->CP);
+    arm_mat_init_f32(&est->mS, EST_NY, EST_NY, est->S);
+    arm_mat_init_f32(&est->mSinv, EST_NY, EST_NY, est->Sinv);
+
+    arm_mat_trans_f32(&est->mA, &est->mAt);
+
+    estReset(est, ambient, ambient);
+}
+
+void estReset(StateEstimator_t* est, float top, float bottom) {
+    float t = top - est->ambient;
+    float b = bottom - est->ambient;
+    est->x[EST_ELEMENT] = t;
+    est->x[EST_CHAMBER] = t;
+    est->x[EST_STONE] = b;
+    est->x[EST_TOP_SENSOR] = t;
+    est->x[EST_BOT_SENSOR] = b;
+    est->x[EST_DISTURBANCE] = 0.0f;
+    est->stoneRate = 0.0f;
+    est->status = EST_OK;
+
+    // the hidden states are uncertain, the sensor states are known up to the sensor noise
+    for (uint8_t i = 0; i < EST_NX * EST_NX; i++)
+        est->P[i] = 0.0f;
+    est->P[IDX(EST_ELEMENT, EST_ELEMENT)] = 100.0f;
+    est->P[IDX(EST_CHAMBER, EST_CHAMBER)] = 25.0f;
+    est->P[IDX(EST_STONE, EST_STONE)] = 25.0f;
+    est->P[IDX(EST_TOP_SENSOR, EST_TOP_SENSOR)] = est->R[0];
+    est->P[IDX(EST_BOT_SENSOR, EST_BOT_SENSOR)] = est->R[1];
+    est->P[IDX(EST_DISTURBANCE, EST_DISTURBANCE)] = 0.01f;
+}
+
+/* Filter step */
+
+static void predict(StateEstimator_t* est, const float duty[EST_NU]) {
+    // x = A*x + B*u
+    float xPrev[EST_NX];
+    float bu[EST_NX];
+    float u[EST_NU] = { duty[0], duty[1] };
+    arm_matrix_instance_f32 mxPrev, mu, mbu;
+    arm_mat_init_f32(&mxPrev, EST_NX, 1, xPrev);
+    arm_mat_init_f32(&mu, EST_NU, 1, u);
+    arm_mat_init_f32(&mbu, EST_NX, 1, bu);
+
+    for (uint8_t i = 0; i < EST_NX; i++)
+        xPrev[i] = est->x[i];
+    arm_mat_mult_f32(&est->mA, &mxPrev, &est->mx);
+    arm_mat_mult_f32(&est->mB, &mu, &mbu);
+    arm_mat_add_f32(&est->mx, &mbu, &est->mx);
+
+    // P = A*P*A' + Q
+    arm_mat_mult_f32(&est->mA, &est->mP, &est->mTmpNN);
+    arm_mat_mult_f32(&est->mTmpNN, &est->mAt, &est->mP);
+    for (uint8_t i = 0; i < EST_NX; i++)
+        est->P[IDX(i, i)] += est->Q[i];
+}
+
+static EstStatus_t update(StateEstimator_t* est, const float measurement[EST_NY]) {
+    // P*C' and C*P are columns/rows of P, S = C*P*C' + R
+    for (uint8_t i = 0; i < EST_NX; i++) {
+        for (uint8_t k = 0; k < EST_NY; k++) {
+            est->PCt[i * EST_NY + k] = est->P[IDX(i, sensorIdx[k])];
+            est->CP[k * EST_NX + i] = est->P[IDX(sensorIdx[k], i)];
+        }
+    }
+    for (uint8_t k = 0; k < EST_NY; k++)
+        for (uint8_t l = 0; l < EST_NY; l++)
+            est->S[k * EST_NY + l] = est->P[IDX(sensorIdx[k], sensorIdx[l])] + (k == l ? est->R[k] : 0.0f);
+
+    if (arm_mat_inverse_f32(&est->mS, &est->mSinv) != ARM_MATH_SUCCESS)
+        return EST_SINGULAR_INNOVATION;
+
+    // K = P*C' * S^-1
+    arm_mat_mult_f32(&est->mPCt, &est->mSinv, &est->mK);
+
+    // x = x + K*(y - C*x)
+    float innov[EST_NY];
+    float corr[EST_NX];
+    arm_matrix_instance_f32 minnov, mcorr;
+    arm_mat_init_f32(&minnov, EST_NY, 1, innov);
+    arm_mat_init_f32(&mcorr, EST_NX, 1, corr);
+    for (uint8_t k = 0; k < EST_NY; k++)
+        innov[k] = measurement[k] - est->ambient - est->x[sensorIdx[k]];
+    arm_mat_mult_f32(&est->mK, &minnov, &mcorr);
+    arm_mat_add_f32(&est->mx, &mcorr, &est->mx);
+
+    // P = P - K*C*P, kept symmetric against rounding errors
+    arm_mat_mult_f32(&est->mK, &est->mCP, &est->mTmpNN);
+    arm_mat_sub_f32(&est->mP, &est->mTmpNN, &est->mTmpNN2);
+    for (uint8_t r = 0; r < EST_NX; r++) {
+        est->P[IDX(r, r)] = est->tmpNN2[IDX(r, r)];
+        for (uint8_t c = r + 1; c < EST_NX; c++) {
+            float v = 0.5f * (est->tmpNN2[IDX(r, c)] + est->tmpNN2[IDX(c, r)]);
+            est->P[IDX(r, c)] = v;
+            est->P[IDX(c, r)] = v;
+        }
+    }
+    return EST_OK;
+}
+
+EstStatus_t estStep(StateEstimator_t* est, const float duty[EST_NU], const float measurement[EST_NY]) {
+    predict(est, duty);
+    est->status = update(est, measurement);
+
+    // stone heating rate from the model at the updated state
+    float next = 0.0f;
+    for (uint8_t c = 0; c < EST_NX; c++)
+        next += est->A[IDX(EST_STONE, c)] * est->x[c];
+    for (uint8_t c = 0; c < EST_NU; c++)
+        next += est->B[EST_STONE * EST_NU + c] * duty[c];
+    est->stoneRate = (next - est->x[EST_STONE]) / est->dt;
+
+    return est->status;
+}
+
+EstStatus_t estUpdateStone(StateEstimator_t* est, float stone) {
+    // C selects the stone state, so S is a scalar and K = P(:, stone) / S
+    float s = est->P[IDX(EST_STONE, EST_STONE)] + est->Rstone;
+    if (s <= 0.0f)
+        return EST_SINGULAR_INNOVATION;
+
+    float pc[EST_NX];
+    for (uint8_t i = 0; i < EST_NX; i++)
+        pc[i] = est->P[IDX(i, EST_STONE)];
+
+    float innov = stone - est->ambient - est->x[EST_STONE];
+    for (uint8_t i = 0; i < EST_NX; i++)
+        est->x[i] += pc[i] / s * innov;
+
+    // P = P - K*C*P = P - P(:, stone) * P(stone, :) / S, symmetric by construction
+    for (uint8_t r = 0; r < EST_NX; r++)
+        for (uint8_t c = 0; c < EST_NX; c++)
+            est->P[IDX(r, c)] -= pc[r] * pc[c] / s;
+    return EST_OK;
+}
+
+void estGetState(const StateEstimator_t* est, EstState_t* state) {
+    state->element = est->x[EST_ELEMENT] + est->ambient;
+    state->chamber = est->x[EST_CHAMBER] + est->ambient;
+    state->stone = est->x[EST_STONE] + est->ambient;
+    state->stoneRate = est->stoneRate;
+    state->disturbance = est->x[EST_DISTURBANCE];
+}
@@ -0,0 +1,143 @@
+/**
+ * @file state_estimator.h
+ * @brief Public API for the Kalman filter estimating the oven's internal temperatures. See state_estimator.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Linear Kalman filter over a lumped thermal model: top element, chamber air, stone, both sensors (with their own lag) and an unmodelled heat-loss disturbance
+- Estimates the stone and element temperatures and the stone heating rate from the two sensors and both heater duties
+- Optional direct measurement of the stone surface (e.g. an IR thermometer), fused with a scalar update between the regular steps
+- Fixed-size, preallocated matrices; all matrix operations use CMSIS-DSP
+- Designed for a 10 Hz control loop (one predict/update step is well below 1 ms on the STM32F303 at 72 MHz)
+
+# Limitations
+- The model is linearised (radiation is approximated with an equivalent conductance), so it's only accurate around the temperature it was identified at
+- The instance keeps CMSIS matrix descriptors pointing into itself, so it must not be copied or moved after estInit
+*/
+
+#ifndef STATE_ESTIMATOR_H
+#define STATE_ESTIMATOR_H
+
+#include "arm_math.h"
+#include "stdbool.h"
+
+#define EST_NX          6   // number of states
+#define EST_NU          2   // number of inputs (top and bottom heater duty)
+#define EST_NY          2   // number of measurements (top and bottom sensor)
+
+// state indices
+#define EST_ELEMENT     0
+#define EST_CHAMBER     1
+#define EST_STONE       2
+#define EST_TOP_SENSOR  3
+#define EST_BOT_SENSOR  4
+#define EST_DISTURBANCE 5   // unmodelled heat loss of the chamber [degC/s]
+
+/* Status info */
+
+typedef enum EstStatus_t {
+    EST_OK,
+    EST_SINGULAR_INNOVATION,    // The innovation covariance couldn't be inverted. The measurement update was skipped.
+} EstStatus_t;
+
+/* Model */
+
+typedef struct EstModel_t {
+    float topPower;             // [W]
+    float bottomPower;          // [W]
+    float elementCapacity;      // [J/K]
+    float chamberCapacity;      // [J/K]
+    float stoneCapacity;        // [J/K]
+    float elementToChamber;     // [W/K]
+    float elementToStone;       // [W/K] (linearised radiation)
+    float chamberToStone;       // [W/K]
+    float chamberLoss;          // to ambient [W/K]
+    float stoneLoss;            // to ambient [W/K]
+    float topSensorTau;         // [s]
+    float bottomSensorTau;      // [s]
+    float processNoise[EST_NX]; // standard deviation per step [degC] ([degC/s] for the disturbance)
+    float sensorNoise[EST_NY];  // standard deviation [degC]
+    float stoneSensorNoise;     // standard deviation of the direct stone measurement [degC]
+} EstModel_t;
+
+/**
+ * @brief Model of the prototype oven (20 x 20 cm stone, 1.5 kW top and 1.2 kW bottom element), lumped from the host thermal plant's parameters
+ */
+extern const EstModel_t estDefaultModel;
+
+typedef struct StateEstimator_t {
+    float dt;
+    float ambient;
+    float x[EST_NX];                // state, as rise above ambient [degC]
+    float P[EST_NX * EST_NX];       // state covariance
+    float A[EST_NX * EST_NX];
+    float At[EST_NX * EST_NX];
+    float B[EST_NX * EST_NU];
+    float Q[EST_NX];                // diagonal process noise covariance
+    float R[EST_NY];                // diagonal measurement noise covariance
+    float Rstone;                   // direct stone measurement noise covariance
+    float stoneRate;                // [degC/s]
+    // workspace
+    float tmpNN[EST_NX * EST_NX];
+    float tmpNN2[EST_NX * EST_NX];
+    float K[EST_NX * EST_NY];
+    float PCt[EST_NX * EST_NY];
+    float CP[EST_NY * EST_NX];
+    float S[EST_NY * EST_NY];
+    float Sinv[EST_NY * EST_NY];
+    arm_matrix_instance_f32 mx, mP, mA, mAt, mB, mTmpNN, mTmpNN2, mK, mPCt, mCP, mS, mSinv;
+    EstStatus_t status;
+} StateEstimator_t;
+
+typedef struct EstState_t {
+    float element;      // [degC]
+    float chamber;      // [degC]
+    float stone;        // [degC]
+    float stoneRate;    // [degC/s]
+    float disturbance;  // [degC/s]
+} EstState_t;
+
+/* API functions */
+
+/**
+ * @brief Initialises the filter with all temperatures at ambient
+ * @param est pointer to the estimator instance
+ * @param model pointer to the thermal model
+ * @param dt step period [s]
+ * @param ambient ambient temperature [degC]
+ */
+void estInit(StateEstimator_t* est, const EstModel_t* model, float dt, float ambient);
+
+/**
+ * @brief Resets all temperatures to the given values (e.g. when the oven is started warm)
+ * @param est pointer to the estimator instance
+ * @param top top sensor temperature [degC]
+ * @param bottom bottom sensor temperature [degC]
+ */
+void estReset(StateEstimator_t* est, float top, float bottom);
+
+/**
+ * @brief Runs one predict/update step
+ * @param est pointer to the estimator instance
+ * @param duty top and bottom heater duties applied during the previous period (0.0 - 1.0)
+ * @param measurement top and bottom sensor temperatures [degC]
+ */
+EstStatus_t estStep(StateEstimator_t* est, const float duty[EST_NU], const float measurement[EST_NY]);
+
+/**
+ * @brief Corrects the estimate with a direct stone temperature measurement
+ * @note Call after estStep, at most once per step. Nothing is predicted, so the measurement should be recent.
+ * @param est pointer to the estimator instance
+ * @param stone measured stone surface temperature [degC]
+ */
+EstStatus_t estUpdateStone(StateEstimator_t* est, float stone);
+
+/**
+ * @brief Returns the current estimate
+ * @param est pointer to the estimator instance
+ * @param state output
+ */
+void estGetState(const StateEstimator_t* est, EstState_t* state);
+
+#endif
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+Generates type_k_table.h and type_k_table.c, the lookup tables used by thermocouple.c.
+
+The reference is the NIST ITS-90 type K forward polynomial E(T) (emf in mV). The inverse table is built by numerically
+inverting it instead of using the NIST inverse polynomials, which are themselves only accurate to about 0.05 degC.
+
+Inverse table (emf -> temperature): breakpoints are placed greedily, each segment is made as long as possible while the
+linear interpolation (evaluated exactly like thermocouple.c does it, in integers) stays within MAX_ERROR_C of the
+reference at every integer microvolt. A coarse index over the emf range maps an emf to the first candidate segment.
+
+Forward table (temperature -> emf), used for cold-junction compensation: evenly spaced breakpoints over the
+cold-junction range, the spacing is the largest power of two degC that keeps the error within MAX_CJ_ERROR_UV.
+
+Usage: python3 gen_type_k_table.py [output directory] (writes both files next to this script by default). The build runs it
+into the build tree and fails if the output differs from the committed files.
+
+Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+"""
+
+import math
+import os
+import sys
+
+T_MIN = -200.0          # degC
+T_MAX = 1372.0
+MAX_ERROR_C = 0.05      # interpolation budget, leaves margin for the cold-junction compensation and the Q16 rounding within the 0.1 degC spec
+INDEX_SHIFT = 9         # coarse index bucket = 512 uV
+
+CJ_MIN = -48.0          # degC, power of two multiple of the spacing
+CJ_MAX = 144.0
+MAX_CJ_ERROR_UV = 0.5   # ~0.013 degC, plus up to 1 uV from rounding the breakpoints and the result
+
+NEG = [0.0, 0.394501280250e-1, 0.236223735980e-4, -0.328589067840e-6, -0.499048287770e-8, -0.675090591730e-10,
+       -0.574103274280e-12, -0.310888728940e-14, -0.104516093650e-16, -0.198892668780e-19, -0.163226974860e-22]
+POS = [-0.176004136860e-1, 0.389212049750e-1, 0.185587700320e-4, -0.994575928740e-7, 0.318409457190e-9,
+       -0.560728448890e-12, 0.560750590590e-15, -0.320207200030e-18, 0.971511471520e-22, -0.121047212750e-25]
+A0, A1, A2 = 0.118597600000e0, -0.118343200000e-3, 0.126968600000e3
+
+
+def emf_mv(t):
+    """NIST ITS-90 type K reference function [mV]"""
+    if t < 0.0:
+        return sum(c * t ** i for i, c in enumerate(NEG))
+    return sum(c * t ** i for i, c in enumerate(POS)) + A0 * math.exp(A1 * (t - A2) ** 2)
+
+
+def emf_uv(t):
+    return emf_mv(t) * 1000.0
+
+
+def temp_of_uv(uv):
+    """Inverse of emf_uv by bisection"""
+    lo, hi = T_MIN - 1.0, T_MAX + 1.0
+    for _ in range(60):
+        mid = 0.5 * (lo + hi)
+        if emf_uv(mid) < uv:
+            lo = mid
+        else:
+            hi = mid
+    return 0.5 * (lo + hi)
+
+
+def q16(x):
+    return int(round(x * 65536.0))
+
+
+def eval_segment(uv, uv0, t0_q16, slope_q32):
+    # same integer arithmetic as thermocouple.c
+    return t0_q16 + (((uv - uv0) * slope_q32) >> 16)
+
+
+def build_inverse():
+    uv_min = int(math.ceil(emf_uv(T_MIN)))
+    uv_max = int(math.floor(emf_uv(T_MAX)))
+    ref = {uv: temp_of_uv(uv) for uv in range(uv_min, uv_max + 1)}
+
+    def fits(a, b):
+        t0, t1 = q16(ref[a]), q16(ref[b])
+        slope = int(round((t1 - t0) * 65536.0 / (b - a)))
+        for uv in range(a, b + 1):
+            if abs(eval_segment(uv, a, t0, slope) / 65536.0 - ref[uv]) > MAX_ERROR_C:
+                return None
+        return slope
+
+    points, slopes = [uv_min], []
+    a = uv_min
+    while a < uv_max:
+        # exponential then binary search for the longest segment that fits
+        step = 64
+        while a + step < uv_max and fits(a, a + step) is not None:
+            step *= 2
+        lo, hi = step // 2 if step > 64 else 1, min(step, uv_max - a)
+        if fits(a, a + hi) is not None:
+            lo = hi
+        while hi - lo > 1:
+            mid = (lo + hi) // 2
+            if fits(a, a + mid) is not None:
+                lo = mid
+            else:
+                hi = mid
+        b = a + lo
+        slopes.append(fits(a, b))
+        points.append(b)
+        a = b
+
+    temps = [q16(ref[p]) for p in points]
+
+    # verify the whole range
+    worst = 0.0
+    seg = 0
+    for uv in range(uv_min, uv_max + 1):
+        while seg < len(slopes) - 1 and uv >= points[seg + 1]:
+            seg += 1
+        err = abs(eval_segment(uv, points[seg], temps[seg], slopes[seg]) / 65536.0 - ref[uv])
+        worst = max(worst, err)
+    assert worst <= 0.1, worst
+
+    buckets = ((uv_max - uv_min) >> INDEX_SHIFT) + 1
+    index = []
+    for k in range(buckets):
+        start = uv_min + (k << INDEX_SHIFT)
+        s = 0
+        while s < len(slopes) - 1 and start >= points[s + 1]:
+            s += 1
+        index.append(s)
+    return uv_min, uv_max, points, temps, slopes, index, worst
+
+
+def build_forward():
+    spacing_log2 = 0
+    while True:
+        spacing = 2.0 ** (spacing_log2 + 1)
+        xs = [CJ_MIN + i * spacing for i in range(int((CJ_MAX - CJ_MIN) / spacing) + 1)]
+        ok = True
+        for i in range(len(xs) - 1):
+            e0, e1 = emf_uv(xs[i]), emf_uv(xs[i + 1])
+            for k in range(1, 64):
+                t = xs[i] + spacing * k / 64
+                if abs(e0 + (e1 - e0) * k / 64 - emf_uv(t)) > MAX_CJ_ERROR_UV:
+                    ok = False
+        if not ok or (CJ_MAX - CJ_MIN) % spacing != 0:
+            break
+        spacing_log2 += 1
+    spacing = 2.0 ** spacing_log2
+    xs = [CJ_MIN + i * spacing for i in range(int((CJ_MAX - CJ_MIN) / spacing) + 1)]
+    return spacing_log2, [int(round(emf_uv(x))) for x in xs]
+
+
+def table(values, per_line=8):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    assert abs(emf_mv(500.0) - 20.644) < 0.001
+    uv_min, uv_max, points, temps, slopes, index, worst = build_inverse()
+    cj_shift, cj_uv = build_forward()
+
+    assert len(slopes) < 256
+    max_steps = max(sum(1 for p in points[index[k] + 1:-1] if p <= min(uv_max, uv_min + ((k + 1) << INDEX_SHIFT) - 1))
+                    for k in range(len(index)))
+    here = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    banner = """ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details."""
+
+    with open(os.path.join(here, "type_k_table.h"), "w", encoding="utf-8", newline="\n") as f:
+        f.write(f"""/**
+ * @file type_k_table.h
+ * @brief Type K lookup tables. GENERATED by gen_type_k_table.py, do not edit.
+{banner}
+ */
+
+#ifndef TYPE_K_TABLE_H
+#define TYPE_K_TABLE_H
+
+#include "stdint.h"
+
+#define TC_K_UV_MIN             {uv_min}    // emf at {T_MIN:g} degC [uV]
+#define TC_K_UV_MAX             {uv_max}    // emf at {T_MAX:g} degC [uV]
+#define TC_K_INV_SEGMENTS       {len(slopes)}
+#define TC_K_INV_INDEX_SHIFT    {INDEX_SHIFT}       // coarse index bucket = {1 << INDEX_SHIFT} uV
+#define TC_K_INV_INDEX_SIZE     {len(index)}
+#define TC_K_INV_MAX_STEPS      {max_steps}       // most breakpoints inside one bucket
+
+#define TC_K_FWD_MIN            ({int(CJ_MIN)})     // first forward breakpoint [degC]
+#define TC_K_FWD_SHIFT          {cj_shift}       // forward breakpoint spacing = {2 ** cj_shift} degC
+#define TC_K_FWD_POINTS         {len(cj_uv)}
+
+extern const int32_t tcKInvUv[TC_K_INV_SEGMENTS + 1];       // breakpoints [uV]
+extern const int32_t tcKInvTemp[TC_K_INV_SEGMENTS + 1];     // temperatures at the breakpoints [degC, Q16]
+extern const int32_t tcKInvSlope[TC_K_INV_SEGMENTS];        // segment slopes [degC/uV, Q32]
+extern const uint8_t tcKInvIndex[TC_K_INV_INDEX_SIZE];      // first segment of each coarse bucket
+extern const int32_t tcKFwdUv[TC_K_FWD_POINTS];             // emf at the forward breakpoints [uV]
+
+#endif
+""")
+
+    with open(os.path.join(here, "type_k_table.c"), "w", encoding="utf-8", newline="\n") as f:
+        f.write(f"""/**
+ * @file type_k_table.c
+ * @brief Type K lookup tables. GENERATED by gen_type_k_table.py, do not edit.
+{banner}
+ *
+ * Inverse table: {len(slopes)} segments, {T_MIN:g} degC to {T_MAX:g} degC, worst error {worst:.4f} degC against the NIST ITS-90 reference function.
+ * Forward table: {len(cj_uv)} points, {CJ_MIN:g} degC to {CJ_MAX:g} degC every {2 ** cj_shift} degC, interpolation error within {MAX_CJ_ERROR_UV:g} uV.
+ */
+
+#include "type_k_table.h"
+
+const int32_t tcKInvUv[TC_K_INV_SEGMENTS + 1] = {{
+{table(points)}
+}};
+
+const int32_t tcKInvTemp[TC_K_INV_SEGMENTS + 1] = {{
+{table(temps)}
+}};
+
+const int32_t tcKInvSlope[TC_K_INV_SEGMENTS] = {{
+{table(slopes)}
+}};
+
+const uint8_t tcKInvIndex[TC_K_INV_INDEX_SIZE] = {{
+{table(index, 16)}
+}};
+
+const int32_t tcKFwdUv[TC_K_FWD_POINTS] = {{
+{table(cj_uv)}
+}};
+""")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,74 @@
+/**
+ * @file thermocouple.c
+ * @brief Type K thermocouple conversion implementation. See thermocouple.h for API details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Inverse lookup: the coarse index gives the first segment that can contain the emf (indexed by (emf - TC_K_UV_MIN) >> TC_K_INV_INDEX_SHIFT), then at most TC_K_INV_MAX_STEPS comparisons find the actual segment. The segment slope is stored in Q32 degC per uV, so the interpolation is one 32x32->64 bit multiplication (a single SMULL on the Cortex-M4) and a shift.
+ *
+ * Forward lookup: evenly spaced breakpoints, the index and the fraction come straight from the Q16 temperature by shifting.
+ */
+
+#include "thermocouple.h"
+#include "type_k_table.h"
+
+// Factory calibration of the internal temperature sensor (STM32F303 datasheet, "Temperature sensor calibration values")
+#define TS_CAL1             (*(const uint16_t*)0x1FFFF7B8)  // raw reading at 30 degC, VDDA = 3.3 V
+#define TS_CAL1_TEMP        30
+#define TS_AVG_SLOPE_Q16    12279   // 1 / (4.3 mV/degC) in degC per ADC count (3.3 V / 4096), Q16
+
+#define FWD_FRAC_BITS       (16 + TC_K_FWD_SHIFT)
+#define FWD_MIN_Q16         (TC_K_FWD_MIN * TC_Q16_ONE)
+#define FWD_MAX_Q16         ((TC_K_FWD_MIN + ((TC_K_FWD_POINTS - 1) << TC_K_FWD_SHIFT)) * TC_Q16_ONE)
+
+/* API functions */
+
+TCStatus_t tcTypeKToCelsius(int32_t microvolts, int32_t* tempQ16) {
+    if (microvolts <= TC_K_UV_MIN) {
+        *tempQ16 = tcKInvTemp[0];
+        return (microvolts == TC_K_UV_MIN) ? TC_OK : TC_OUT_OF_RANGE;
+    }
+    if (microvolts >= TC_K_UV_MAX) {
+        *tempQ16 = tcKInvTemp[TC_K_INV_SEGMENTS];
+        return (microvolts == TC_K_UV_MAX) ? TC_OK : TC_OUT_OF_RANGE;
+    }
+
+    uint8_t seg = tcKInvIndex[(uint32_t)(microvolts - TC_K_UV_MIN) >> TC_K_INV_INDEX_SHIFT];
+    while (microvolts >= tcKInvUv[seg + 1])
+        seg++;
+
+    int64_t delta = (int64_t)(microvolts - tcKInvUv[seg]) * tcKInvSlope[seg];
+    *tempQ16 = tcKInvTemp[seg] + (int32_t)(delta >> 16);
+    return TC_OK;
+}
+
+TCStatus_t tcTypeKToMicrovolts(int32_t tempQ16, int32_t* microvolts) {
+    if (tempQ16 <= FWD_MIN_Q16) {
+        *microvolts = tcKFwdUv[0];
+        return (tempQ16 == FWD_MIN_Q16) ? TC_OK : TC_OUT_OF_RANGE;
+    }
+    if (tempQ16 >= FWD_MAX_Q16) {
+        *microvolts = tcKFwdUv[TC_K_FWD_POINTS - 1];
+        return (tempQ16 == FWD_MAX_Q16) ? TC_OK : TC_OUT_OF_RANGE;
+    }
+
+    uint32_t pos = (uint32_t)(tempQ16 - FWD_MIN_Q16);
+    uint32_t i = pos >> FWD_FRAC_BITS;
+    int32_t frac = (int32_t)(pos & ((1U << FWD_FRAC_BITS) - 1));
+    int32_t v0 = tcKFwdUv[i];
+    int32_t v1 = tcKFwdUv[i + 1];
+    // round to the nearest microvolt
+    *microvolts = v0 + (((v1 - v0) * frac + (1 << (FWD_FRAC_BITS - 1))) >> FWD_FRAC_BITS);
+    return TC_OK;
+}
+
+TCStatus_t tcConvert(int32_t microvolts, int32_t coldJunctionQ16, int32_t* tempQ16) {
+    int32_t cjMicrovolts;
+    TCStatus_t cjStatus = tcTypeKToMicrovolts(coldJunctionQ16, &cjMicrovolts);
+    TCStatus_t status = tcTypeKToCelsius(microvolts + cjMicrovolts, tempQ16);
+    return (cjStatus != TC_OK) ? cjStatus : status;
+}
+
+int32_t tcInternalSensorToCelsius(uint16_t adcRaw) {
+    return TS_CAL1_TEMP * TC_Q16_ONE + ((int32_t)TS_CAL1 - (int32_t)adcRaw) * TS_AVG_SLOPE_Q16;
+}
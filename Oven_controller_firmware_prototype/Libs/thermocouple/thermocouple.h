@@ -0,0 +1,73 @@
+/**
+ * @file thermocouple.h
+ * @brief Public API for the type K thermocouple conversion. See thermocouple.c for implementation details.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+# Key Features
+- Integer-only conversion of the thermocouple emf to temperature in Q16 degC, within +-0.1 degC of the NIST ITS-90 reference over the whole -200 - 1372 degC range, also with cold-junction compensation (the emf table alone is within +-0.05 degC, Host/Thermocouple/tc_error.c measures both)
+- Uneven-breakpoint piecewise-linear table with a coarse index, so the lookup takes a bounded number of steps without a binary search
+- Cold-junction compensation through a forward table (-48 - 144 degC), with the cold-junction temperature from the MCU's internal sensor or any external reference
+- Tables are generated by gen_type_k_table.py, which also verifies the error bound at every microvolt
+
+# Limitations
+- The internal temperature sensor measures the die, not the thermocouple terminals, and its typical accuracy is only a few degC. Prefer an external reference near the connector when it's available.
+- The internal sensor conversion assumes VDDA = 3.3 V (the calibration voltage)
+
+# Requirements:
+- Run gen_type_k_table.py after changing the table parameters and commit both generated files. With Python 3 available, the build fails when they don't match the script.
+*/
+
+#ifndef THERMOCOUPLE_H
+#define THERMOCOUPLE_H
+
+#include "stdint.h"
+
+#define TC_Q16_ONE      65536   // 1 degC in Q16
+
+#define TC_FLOAT_TO_Q16(x)  ((int32_t)((x) * (float)TC_Q16_ONE))
+#define TC_Q16_TO_FLOAT(x)  ((float)(x) * (1.0f / (float)TC_Q16_ONE))
+
+/* Status info */
+
+typedef enum TCStatus_t {
+    TC_OK,
+    TC_OUT_OF_RANGE,        // The emf or the cold-junction temperature is outside the tables. The result is clamped to the range limit.
+} TCStatus_t;
+
+/* API functions */
+
+/**
+ * @brief Converts a cold-junction-compensated emf (junction at 0 degC) to temperature
+ * @param microvolts [uV]
+ * @param tempQ16 output temperature [degC, Q16]
+ * @return TCStatus_t
+ */
+TCStatus_t tcTypeKToCelsius(int32_t microvolts, int32_t* tempQ16);
+
+/**
+ * @brief Converts a temperature to the emf it would produce with the reference junction at 0 degC
+ * @note Covers the cold-junction range only (-48 - 144 degC)
+ * @param tempQ16 [degC, Q16]
+ * @param microvolts output emf [uV]
+ * @return TCStatus_t
+ */
+TCStatus_t tcTypeKToMicrovolts(int32_t tempQ16, int32_t* microvolts);
+
+/**
+ * @brief Converts a measured emf to the hot junction temperature with cold-junction compensation
+ * @param microvolts measured emf [uV]
+ * @param coldJunctionQ16 cold-junction temperature [degC, Q16]
+ * @param tempQ16 output temperature [degC, Q16]
+ * @return TCStatus_t
+ */
+TCStatus_t tcConvert(int32_t microvolts, int32_t coldJunctionQ16, int32_t* tempQ16);
+
+/**
+ * @brief Converts a reading of the internal temperature sensor (ADC1 channel 16) using the factory calibration
+ * @param adcRaw 12-bit right-aligned conversion result at VDDA = 3.3 V
+ * @return die temperature [degC, Q16]
+ */
+int32_t tcInternalSensorToCelsius(uint16_t adcRaw);
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file type_k_table.c
+ * @brief Type K lookup tables. GENERATED by gen_type_k_table.py, do not edit.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ *
+ * Inverse table: 56 segments, -200 degC to 1372 degC, worst error 0.0500 degC against the NIST ITS-90 reference function.
+ * Forward table: 49 points, -48 degC to 144 degC every 4 degC, interpolation error within 0.5 uV.
+ */
+
+#include "type_k_table.h"
+
+const int32_t tcKInvUv[TC_K_INV_SEGMENTS + 1] = {
+    -5891, -5798, -5694, -5578, -5450, -5308, -5152, -4981,
+    -4793, -4587, -4362, -4117, -3850, -3559, -3242, -2897,
+    -2520, -2108, -1656, -1161, -614, 20, 780, 1679,
+    3027, 4615, 5686, 6889, 9015, 10254, 11582, 13189,
+    15132, 17369, 20271, 25118, 27482, 29481, 31306, 33033,
+    34700, 36328, 37925, 39492, 41022, 42503, 43924, 45279,
+    46566, 47788, 48952, 50066, 51142, 52192, 53233, 54287,
+    54886,
+};
+
+const int32_t tcKInvTemp[TC_K_INV_SEGMENTS + 1] = {
+    -13105467, -12719767, -12316115, -11893539, -11454646, -10995191, -10517785, -10021667,
+    -9503506, -8963104, -8400236, -7814628, -7203698, -6565142, -5896835, -5196746,
+    -4459019, -3680120, -2853005, -1974595, -1031434, 33214, 1281269, 2728808,
+    4864848, 7377628, 9096560, 11056571, 14540318, 16545915, 18667844, 21206444,
+    24247194, 27719924, 32194020, 39649369, 43308028, 46426273, 49298283, 52041643,
+    54715491, 57352715, 59965677, 62555485, 65110007, 67608473, 70031352, 72367267,
+    74611499, 76767937, 78847626, 80863633, 82836636, 84787868, 86748510, 88760099,
+    89914688,
+};
+
+const int32_t tcKInvSlope[TC_K_INV_SEGMENTS] = {
+    271798228, 254362860, 238740868, 224713216, 212048189, 200559485, 190137949, 180628720,
+    171921289, 163947188, 156646555, 149954713, 143808955, 138164566, 132988501, 128243174,
+    123897876, 119924355, 116297935, 112999999, 110051690, 107621753, 105523822, 103848307,
+    103701228, 105183873, 106775795, 107389860, 106084588, 104715918, 103528120, 102562322,
+    101738415, 101038717, 100803332, 101427190, 102229767, 103134273, 104104714, 105118958,
+    106162845, 107227976, 108312481, 109420362, 110560073, 111742293, 112978986, 114279711,
+    115650017, 117091493, 118600570, 120169818, 121786610, 123431925, 125077321, 126322445,
+};
+
+const uint8_t tcKInvIndex[TC_K_INV_INDEX_SIZE] = {
+    0, 4, 7, 10, 12, 13, 15, 16, 17, 18, 19, 20, 21, 21, 22, 23,
+    23, 23, 24, 24, 24, 25, 25, 26, 26, 27, 27, 27, 27, 27, 28, 28,
+    29, 29, 29, 30, 30, 30, 31, 31, 31, 31, 32, 32, 32, 32, 33, 33,
+    33, 33, 33, 33, 34, 34, 34, 34, 34, 34, 34, 34, 34, 35, 35, 35,
+    35, 35, 36, 36, 36, 36, 37, 37, 37, 38, 38, 38, 38, 39, 39, 39,
+    40, 40, 40, 41, 41, 41, 42, 42, 42, 43, 43, 43, 44, 44, 44, 45,
+    45, 45, 46, 46, 47, 47, 47, 48, 48, 49, 49, 49, 50, 50, 51, 51,
+    52, 52, 53, 53, 54, 54, 55,
+};
+
+const int32_t tcKFwdUv[TC_K_FWD_POINTS] = {
+    -1818, -1673, -1527, -1380, -1231, -1081, -930, -778,
+    -624, -470, -314, -157, 0, 158, 317, 477,
+    637, 798, 960, 1122, 1285, 1448, 1612, 1776,
+    1941, 2106, 2271, 2436, 2602, 2768, 2934, 3100,
+    3267, 3433, 3599, 3765, 3931, 4096, 4262, 4427,
+    4591, 4756, 4920, 5084, 5247, 5410, 5572, 5735,
+    5896,
+};
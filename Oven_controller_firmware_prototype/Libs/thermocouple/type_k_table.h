@@ -0,0 +1,30 @@
+/**
+ * @file type_k_table.h
+ * @brief Type K lookup tables. GENERATED by gen_type_k_table.py, do not edit.
+ * @author Mateusz Stelmaszyński
+ * @copyright Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+ */
+
+#ifndef TYPE_K_TABLE_H
+#define TYPE_K_TABLE_H
+
+#include "stdint.h"
+
+#define TC_K_UV_MIN             -5891    // emf at -200 degC [uV]
+#define TC_K_UV_MAX             54886    // emf at 1372 degC [uV]
+#define TC_K_INV_SEGMENTS       56
+#define TC_K_INV_INDEX_SHIFT    9       // coarse index bucket = 512 uV
+#define TC_K_INV_INDEX_SIZE     119
+#define TC_K_INV_MAX_STEPS      4       // most breakpoints inside one bucket
+
+#define TC_K_FWD_MIN            (-48)     // first forward breakpoint [degC]
+#define TC_K_FWD_SHIFT          2       // forward breakpoint spacing = 4 degC
+#define TC_K_FWD_POINTS         49
+
+extern const int32_t tcKInvUv[TC_K_INV_SEGMENTS + 1];       // breakpoints [uV]
+extern const int32_t tcKInvTemp[TC_K_INV_SEGMENTS + 1];     // temperatures at the breakpoints [degC, Q16]
+extern const int32_t tcKInvSlope[TC_K_INV_SEGMENTS];        // segment slopes [degC/uV, Q32]
+extern const uint8_t tcKInvIndex[TC_K_INV_INDEX_SIZE];      // first segment of each coarse bucket
+extern const int32_t tcKFwdUv[TC_K_FWD_POINTS];             // emf at the forward breakpoints [uV]
+
+#endif
@@ -0,0 +1,84 @@
+//
+// DWT stand-in for the Renode platform in stm32f303re.repl: CYCCNT counts executed instructions.
+// Author: Mateusz Stelmaszyński
+// Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+//
+// Renode doesn't model pipeline or flash wait-state timing, so a cycle count wouldn't mean anything. Instruction
+// counts do: they are exact and repeatable, and the benchmark firmware (Bench/) reports them through the same
+// DWT->CYCCNT reads it uses on the board. Only CTRL.CYCCNTENA and CYCCNT are implemented.
+//
+using System;
+using Antmicro.Renode.Core;
+using Antmicro.Renode.Logging;
+using Antmicro.Renode.Peripherals.Bus;
+using Antmicro.Renode.Peripherals.CPU;
+
+namespace Antmicro.Renode.Peripherals.Miscellaneous
+{
+    public class DwtInstructionCounter : IDoubleWordPeripheral, IKnownSize
+    {
+        public DwtInstructionCounter(TranslationCPU cpu)
+        {
+            this.cpu = cpu;
+            Reset();
+        }
+
+        public void Reset()
+        {
+            control = 0;
+            frozenCount = 0;
+            origin = cpu.ExecutedInstructions;
+        }
+
+        public uint ReadDoubleWord(long offset)
+        {
+            switch(offset)
+            {
+                case ControlOffset:
+                    return control;
+                case CycleCountOffset:
+                    return Enabled ? (uint)(cpu.ExecutedInstructions - origin) : frozenCount;
+                default:
+                    this.Log(LogLevel.Warning, "Unhandled read at 0x{0:X}", offset);
+                    return 0;
+            }
+        }
+
+        public void WriteDoubleWord(long offset, uint value)
+        {
+            switch(offset)
+            {
+                case ControlOffset:
+                    var count = ReadDoubleWord(CycleCountOffset);
+                    control = value & CycleCountEnable;
+                    SetCount(count);
+                    break;
+                case CycleCountOffset:
+                    SetCount(value);
+                    break;
+                default:
+                    this.Log(LogLevel.Warning, "Unhandled write of 0x{0:X} at 0x{1:X}", value, offset);
+                    break;
+            }
+        }
+
+        public long Size => 0x1000;
+
+        private bool Enabled => (control & CycleCountEnable) != 0;
+
+        private void SetCount(uint count)
+        {
+            frozenCount = count;
+            origin = cpu.ExecutedInstructions - count;
+        }
+
+        private readonly TranslationCPU cpu;
+        private uint control;
+        private uint frozenCount;
+        private ulong origin;
+
+        private const long ControlOffset = 0x0;
+        private const long CycleCountOffset = 0x4;
+        private const uint CycleCountEnable = 0x1;
+    }
+}
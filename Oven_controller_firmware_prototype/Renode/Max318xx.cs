@@ -0,0 +1,138 @@
+//
+// MAX31855 and MAX31856 thermocouple converters sharing one SPI bus, for the Renode platform in stm32f303re.repl.
+// Author: Mateusz Stelmaszyński
+// Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+//
+// Renode's SPI controllers take a single peripheral, so one model answers for both chips. They are told apart by their
+// chip selects (active low), wired as GPIO inputs: 0 = MAX31855, 1 = MAX31856. The conversion is latched when a chip
+// is selected.
+// - MAX31855: the 32-bit frame, thermocouple in D31..D18 (0.25 degC), cold junction in D15..D4 (0.0625 degC), no faults
+// - MAX31856: an address byte (bit 7 set for a write), then registers with auto-increment. CR0..CJTO are stored, CJTH..SR
+//   read the conversion (cold junction 2^-6 degC, thermocouple 2^-7 degC), SR is 0.
+// The temperatures are degC, settable from the monitor: "sysbus.spi2.thermocouples Max31855Temperature 250".
+// "sysbus.spi2.thermocouples Max31856Register 1" returns a stored register, Frames counts the finished transfers.
+//
+using System;
+using Antmicro.Renode.Core;
+
+namespace Antmicro.Renode.Peripherals.SPI
+{
+    public class Max318xx : ISPIPeripheral, IGPIOReceiver
+    {
+        public Max318xx()
+        {
+            Max31855Temperature = 25;
+            Max31856Temperature = 25;
+            ColdJunction = 25;
+            Reset();
+        }
+
+        public void Reset()
+        {
+            selected = None;
+            position = 0;
+            Array.Clear(registers, 0, registers.Length);
+            Frames = 0;
+        }
+
+        public void OnGPIO(int number, bool value)
+        {
+            if(!value && selected == None)
+            {
+                selected = number;
+                position = 0;
+                Latch();
+            }
+            else if(value && selected == number)
+            {
+                if(position > 0)
+                {
+                    Frames++;
+                }
+                selected = None;
+            }
+        }
+
+        public byte Transmit(byte data)
+        {
+            byte reply = 0;
+            if(selected == Max31855)
+            {
+                reply = position < max31855Frame.Length ? max31855Frame[position] : (byte)0;
+            }
+            else if(selected == Max31856)
+            {
+                if(position == 0)
+                {
+                    address = data & AddressMask;
+                    writing = (data & WriteBit) != 0;
+                }
+                else
+                {
+                    if(writing)
+                    {
+                        registers[address] = data;
+                    }
+                    else
+                    {
+                        reply = registers[address];
+                    }
+                    address = (address + 1) & AddressMask;
+                }
+            }
+            position++;
+            return reply;
+        }
+
+        public void FinishTransmission()
+        {
+        }
+
+        public byte Max31856Register(int address)
+        {
+            return registers[address & AddressMask];
+        }
+
+        public decimal Max31855Temperature { get; set; }
+
+        public decimal Max31856Temperature { get; set; }
+
+        public decimal ColdJunction { get; set; }
+
+        public ulong Frames { get; private set; }
+
+        private void Latch()
+        {
+            var thermocouple = (uint)(int)Math.Round(Max31855Temperature * 4) & 0x3FFF;
+            var coldJunction = (uint)(int)Math.Round(ColdJunction * 16) & 0xFFF;
+            var frame = (thermocouple << 18) | (coldJunction << 4);
+            for(var i = 0; i < max31855Frame.Length; i++)
+            {
+                max31855Frame[i] = (byte)(frame >> (24 - 8 * i));
+            }
+
+            var cj = (uint)(int)Math.Round(ColdJunction * 64) << 2;
+            var tc = (uint)(int)Math.Round(Max31856Temperature * 128) << 5;
+            registers[Cjth] = (byte)(cj >> 8);
+            registers[Cjth + 1] = (byte)cj;
+            registers[Cjth + 2] = (byte)(tc >> 16);
+            registers[Cjth + 3] = (byte)(tc >> 8);
+            registers[Cjth + 4] = (byte)tc;
+            registers[Cjth + 5] = 0;
+        }
+
+        private readonly byte[] max31855Frame = new byte[4];
+        private readonly byte[] registers = new byte[16];
+        private int selected;
+        private int position;
+        private int address;
+        private bool writing;
+
+        private const int None = -1;
+        private const int Max31855 = 0;
+        private const int Max31856 = 1;
+        private const int WriteBit = 0x80;
+        private const int AddressMask = 0x0F;
+        private const int Cjth = 0x0A;
+    }
+}
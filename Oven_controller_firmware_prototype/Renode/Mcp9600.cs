@@ -0,0 +1,64 @@
+//
+// MCP9600 thermocouple amplifier stub for the Renode platform in stm32f303re.repl.
+// Author: Mateusz Stelmaszyński
+// Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+//
+// A write sets the register pointer, reads return the register big-endian. Both junctions read Temperature (degC,
+// 1/16 degC per LSB), settable from the monitor: "sysbus.i2c1.mcp9600 Temperature 180".
+//
+using System;
+using System.Linq;
+
+namespace Antmicro.Renode.Peripherals.I2C
+{
+    public class Mcp9600 : II2CPeripheral
+    {
+        public Mcp9600()
+        {
+            Temperature = 25;
+            Reset();
+        }
+
+        public void Reset()
+        {
+            pointer = 0;
+        }
+
+        public void Write(byte[] data)
+        {
+            if(data.Length > 0)
+            {
+                pointer = data[0];
+            }
+        }
+
+        public byte[] Read(int count = 1)
+        {
+            ushort word = 0;
+            switch(pointer)
+            {
+                case HotJunction:
+                case ColdJunction:
+                    word = (ushort)(short)Math.Round(Temperature * 16);
+                    break;
+                case DeviceId:
+                    word = 0x4011;
+                    break;
+            }
+            var reply = new byte[] { (byte)(word >> 8), (byte)word };
+            return Enumerable.Range(0, count).Select(i => i < reply.Length ? reply[i] : (byte)0).ToArray();
+        }
+
+        public void FinishTransmission()
+        {
+        }
+
+        public decimal Temperature { get; set; }
+
+        private byte pointer;
+
+        private const byte HotJunction = 0x00;
+        private const byte ColdJunction = 0x02;
+        private const byte DeviceId = 0x20;
+    }
+}
@@ -0,0 +1,94 @@
+//
+// MLX90614 infrared thermometer stub for the Renode platform in stm32f303re.repl.
+// Author: Mateusz Stelmaszyński
+// Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+//
+// SMBus "read word": a write sets the command, a read returns the RAM register low byte first, then the PEC (CRC-8,
+// polynomial 0x07, over both address bytes, the command and the data). Ta reads Ambient and Tobj1 reads Object (degC,
+// 0.02 K per LSB), settable from the monitor: "sysbus.i2c1.mlx90614 Object 230". Other registers read 0. Reads counts
+// the words read.
+//
+using System;
+using System.Linq;
+
+namespace Antmicro.Renode.Peripherals.I2C
+{
+    public class Mlx90614 : II2CPeripheral
+    {
+        public Mlx90614(int address = 0x5A)
+        {
+            this.address = (byte)address;
+            Object = 25;
+            Ambient = 25;
+            Reset();
+        }
+
+        public void Reset()
+        {
+            command = 0;
+            Reads = 0;
+        }
+
+        public void Write(byte[] data)
+        {
+            if(data.Length > 0)
+            {
+                command = data[0];
+            }
+        }
+
+        public byte[] Read(int count = 1)
+        {
+            ushort word = 0;
+            switch(command)
+            {
+                case AmbientRegister:
+                    word = ToWord(Ambient);
+                    break;
+                case ObjectRegister:
+                    word = ToWord(Object);
+                    break;
+            }
+            var transaction = new byte[] { (byte)(address << 1), command, (byte)((address << 1) | 1), (byte)word, (byte)(word >> 8) };
+            var reply = new byte[] { transaction[3], transaction[4], Pec(transaction) };
+            Reads++;
+            return Enumerable.Range(0, count).Select(i => i < reply.Length ? reply[i] : (byte)0).ToArray();
+        }
+
+        public void FinishTransmission()
+        {
+        }
+
+        public decimal Object { get; set; }
+
+        public decimal Ambient { get; set; }
+
+        public ulong Reads { get; private set; }
+
+        private static ushort ToWord(decimal celsius)
+        {
+            // bit 15 is the error flag
+            return (ushort)Math.Max(0, Math.Min(0x7FFF, Math.Round((celsius + 273.15m) * 50)));
+        }
+
+        private static byte Pec(byte[] data)
+        {
+            byte crc = 0;
+            foreach(var b in data)
+            {
+                crc ^= b;
+                for(var i = 0; i < 8; i++)
+                {
+                    crc = (byte)((crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : crc << 1);
+                }
+            }
+            return crc;
+        }
+
+        private readonly byte address;
+        private byte command;
+
+        private const byte AmbientRegister = 0x06;
+        private const byte ObjectRegister = 0x07;
+    }
+}
@@ -0,0 +1,147 @@
+//
+// HD44780 character LCD behind a PCF8574 I2C expander, for the Renode platform in stm32f303re.repl.
+// Author: Mateusz Stelmaszyński
+// Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+//
+// Expander wiring of the usual backpack modules: P0 = RS, P1 = RW, P2 = EN, P3 = backlight, P4..P7 = D4..D7.
+// The controller latches on the falling edge of EN. It starts in 8-bit mode, where only D7..D4 are wired and the low
+// data bits read as 0, until a function set switches it to 4-bit mode (high nibble first). Same behaviour as the LCD
+// model of the host build (Host/Src/host_board.c).
+//
+// Monitor/Robot access: "sysbus.i2c1.lcd Line 0" returns the visible text of a row.
+//
+using System;
+using System.Linq;
+using System.Text;
+using Antmicro.Renode.Logging;
+
+namespace Antmicro.Renode.Peripherals.I2C
+{
+    public class Pcf8574Hd44780 : II2CPeripheral
+    {
+        public Pcf8574Hd44780(int columns = 16, int rows = 2)
+        {
+            Columns = columns;
+            Rows = rows;
+            Reset();
+        }
+
+        public void Reset()
+        {
+            port = 0;
+            highNibble = true;
+            eightBitMode = true;
+            addressCounter = 0;
+            for(var i = 0; i < ddram.Length; i++)
+            {
+                ddram[i] = (byte)' ';
+            }
+        }
+
+        public void Write(byte[] data)
+        {
+            foreach(var b in data)
+            {
+                if((port & EnBit) != 0 && (b & EnBit) == 0)
+                {
+                    Strobe(port);
+                }
+                port = b;
+            }
+        }
+
+        public byte[] Read(int count = 1)
+        {
+            return Enumerable.Repeat(port, count).ToArray();
+        }
+
+        public void FinishTransmission()
+        {
+        }
+
+        public string Line(int row)
+        {
+            if(row < 0 || row >= Rows)
+            {
+                return "";
+            }
+            var text = new StringBuilder();
+            for(var col = 0; col < Columns; col++)
+            {
+                text.Append((char)ddram[(RowStart[row] + col) & (DdramSize - 1)]);
+            }
+            return text.ToString();
+        }
+
+        public int Columns { get; }
+        public int Rows { get; }
+        public bool Backlight => (port & BacklightBit) != 0;
+
+        private void Strobe(byte value)
+        {
+            var nibble = (byte)(value >> 4);
+            var rs = (value & RsBit) != 0;
+            if(eightBitMode)
+            {
+                Execute(rs, (byte)(nibble << 4));
+                highNibble = true;
+            }
+            else if(highNibble)
+            {
+                pendingNibble = nibble;
+                highNibble = false;
+            }
+            else
+            {
+                Execute(rs, (byte)((pendingNibble << 4) | nibble));
+                highNibble = true;
+            }
+        }
+
+        private void Execute(bool rs, byte value)
+        {
+            if(rs)
+            {
+                ddram[addressCounter] = value;
+                addressCounter = (addressCounter + 1) & (DdramSize - 1);
+            }
+            else if((value & 0x80) != 0)
+            {
+                addressCounter = value & 0x7F;
+            }
+            else if((value & 0x20) != 0)
+            {
+                eightBitMode = (value & 0x10) != 0;
+            }
+            else if((value & 0x02) != 0)
+            {
+                addressCounter = 0;
+            }
+            else if(value == 0x01)
+            {
+                for(var i = 0; i < ddram.Length; i++)
+                {
+                    ddram[i] = (byte)' ';
+                }
+                addressCounter = 0;
+            }
+            else
+            {
+                this.Log(LogLevel.Noisy, "Instruction 0x{0:X2} ignored", value);
+            }
+        }
+
+        private byte port;
+        private byte pendingNibble;
+        private bool highNibble;
+        private bool eightBitMode;
+        private int addressCounter;
+        private readonly byte[] ddram = new byte[DdramSize];
+
+        private const int DdramSize = 0x80;
+        private const byte RsBit = 0x01;
+        private const byte EnBit = 0x04;
+        private const byte BacklightBit = 0x08;
+        private static readonly int[] RowStart = { 0x00, 0x40, 0x14, 0x54 };
+    }
+}
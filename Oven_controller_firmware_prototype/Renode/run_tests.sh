@@ -0,0 +1,19 @@
+#!/bin/sh
+# Runs the Renode tests (oven.robot) against the ARM images of the Debug preset.
+# Build them first: cmake --preset Debug && cmake --build --preset Debug
+# Extra arguments go to renode-test, e.g. --include or --show-log.
+#
+# Author: Mateusz Stelmaszyński
+# Copyright (c) 2025 Mateusz Stelmaszyński. Licensed under the MIT License. See the LICENSE file in the root directory of this repository for details.
+
+set -e
+cd "$(dirname "$0")/.."
+
+for elf in build/Debug/Oven_controller_firmware_prototype.elf build/Debug/Bench/oven_bench.elf; do
+    if [ ! -f "$elf" ]; then
+        echo "missing $elf, build the Debug preset first" >&2
+        exit 2
+    fi
+done
+
+exec renode-test "$@" Renode/oven.robot
@@ -0,0 +1,57 @@
+#
+# Lists what the linker placed in CCM RAM (see Libs/ccmram/ccmram.h).
+#
+# include() it and call oven_ccmram_report(<target>) to print the table after each build of an ARM executable,
+# or run it directly: cmake -DNM=arm-none-eabi-nm -DELF=<file.elf> -P cmake/ccmram_report.cmake
+#
+
+set(CCMRAM_START 0x10000000)
+set(CCMRAM_SIZE 16384)
+
+if(NOT CMAKE_SCRIPT_MODE_FILE)
+    function(oven_ccmram_report target)
+        add_custom_command(TARGET ${target} POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -DNM=${CMAKE_NM} -DELF=$<TARGET_FILE:${target}> -P ${CMAKE_CURRENT_FUNCTION_LIST_FILE}
+            VERBATIM
+        )
+    endfunction()
+    return()
+endif()
+
+execute_process(
+    COMMAND ${NM} --print-size --size-sort --reverse-sort ${ELF}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${ELF}")
+endif()
+
+math(EXPR ccmEnd "${CCMRAM_START} + ${CCMRAM_SIZE}")
+set(code 0)
+set(data 0)
+set(lines "")
+string(REPLACE "\n" ";" symbols "${symbols}")
+foreach(line IN LISTS symbols)
+    # <address> <size> <type> <name>
+    if(NOT line MATCHES "^([0-9a-fA-F]+) ([0-9a-fA-F]+) ([a-zA-Z]) (.+)$")
+        continue()
+    endif()
+    set(name ${CMAKE_MATCH_4})
+    set(type ${CMAKE_MATCH_3})
+    math(EXPR address "0x${CMAKE_MATCH_1}")
+    math(EXPR size "0x${CMAKE_MATCH_2}")
+    if(address LESS ${CCMRAM_START} OR NOT address LESS ccmEnd)
+        continue()
+    endif()
+    if(type MATCHES "^[tT]$")
+        math(EXPR code "${code} + ${size}")
+    else()
+        math(EXPR data "${data} + ${size}")
+    endif()
+    string(APPEND lines "  ${size}\t${type}\t${name}\n")
+endforeach()
+
+get_filename_component(elfName ${ELF} NAME)
+math(EXPR total "${code} + ${data}")
+message("CCM RAM in ${elfName}: ${code} B code, ${data} B data, ${total} of ${CCMRAM_SIZE} B\n${lines}")